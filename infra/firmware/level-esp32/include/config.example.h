@@ -12,7 +12,14 @@ static const char* MQTT_HOST = "CHANGE_ME";
 static const uint16_t MQTT_PORT = 1883;
 static const char* MQTT_USER = nullptr;
 static const char* MQTT_PASS = nullptr;
+// Unique per device and stable: the broker keeps the persistent session under this id.
 static const char* MQTT_CLIENT_ID = "waterlevel-esp32";
+// 4 = MQTT 3.1.1; 5 = MQTT 5 (topic aliases, session expiry) once test_mqtt5_broker_interop
+// has passed against your broker.
+static const uint8_t MQTT_PROTOCOL_VERSION = 4;
+// TLS: PEM of the CA that signed the broker certificate (and MQTT_PORT = 8883); nullptr = plain TCP.
+// MQTT_HOST must be the name in the certificate. See infra/mosquitto/make-dev-certs.sh.
+static const char* MQTT_TLS_CA_CERT = nullptr;
 
 // Topic prefix (base) -> <PREFIX>/WateringController/...
 static const char* MQTT_PREFIX = "home/veranda";
@@ -0,0 +1,171 @@
+#include "level_duty_cycle.h"
+
+LevelDutyCycle::LevelDutyCycle(LevelNodeHal& hal, LevelRtcState& rtc, const LevelDutyCycleConfig& config)
+  : hal_(hal),
+    rtc_(rtc),
+    config_(config),
+    logic_(config.publishIntervalMs, config.filter),
+    state_(DutyCycleState::Sampling),
+    cause_(WakeCause::PowerOn),
+    samplesTaken_(0),
+    lastSampleMs_(0),
+    wifiStartMs_(0),
+    usingFastConnect_(false),
+    sensorWakeWithoutChange_(false)
+{
+}
+
+void LevelDutyCycle::Begin(WakeCause cause)
+{
+  if (cause == WakeCause::PowerOn || rtc_.magic != LEVEL_RTC_MAGIC)
+  {
+    rtc_ = LevelRtcState{};
+    rtc_.magic = LEVEL_RTC_MAGIC;
+  }
+
+  rtc_.wakeCount++;
+  cause_ = cause;
+  logic_.Restore(rtc_.lastMask, rtc_.lastPublishMs);
+  state_ = DutyCycleState::Sampling;
+  samplesTaken_ = 0;
+  sensorWakeWithoutChange_ = false;
+}
+
+void LevelDutyCycle::Step()
+{
+  const uint32_t uptimeMs = hal_.UptimeMs();
+  if (state_ != DutyCycleState::Sleeping && uptimeMs >= config_.awakeBudgetMs)
+  {
+    Sleep(true);
+    return;
+  }
+
+  switch (state_)
+  {
+    case DutyCycleState::Sampling:
+      StepSampling(uptimeMs);
+      break;
+
+    case DutyCycleState::ConnectingWifi:
+      if (hal_.WifiConnected())
+      {
+        if (!usingFastConnect_)
+        {
+          hal_.CaptureWifi(rtc_.wifi);
+          rtc_.wifi.valid = true;
+        }
+        hal_.BeginMqtt();
+        state_ = DutyCycleState::ConnectingMqtt;
+      }
+      else if (usingFastConnect_ && uptimeMs - wifiStartMs_ >= config_.fastConnectTimeoutMs)
+      {
+        // The AP moved or the lease is gone: forget the cache and do a full connect.
+        rtc_.wifi.valid = false;
+        usingFastConnect_ = false;
+        hal_.BeginWifi(rtc_.wifi);
+      }
+      break;
+
+    case DutyCycleState::ConnectingMqtt:
+      if (hal_.MqttConnected())
+      {
+        if (!hal_.Publish(logic_.BuildSnapshot(logic_.FilteredMask()), uptimeMs))
+        {
+          Sleep(true);
+          return;
+        }
+        rtc_.lastWakeToPublishMs = uptimeMs;
+        state_ = DutyCycleState::AwaitingAck;
+      }
+      break;
+
+    case DutyCycleState::AwaitingAck:
+      if (hal_.PublishAcked())
+      {
+        logic_.MarkPublished(logic_.FilteredMask(), hal_.RtcNowMs());
+        rtc_.hasPublished = true;
+        rtc_.lastMask = logic_.LastMask();
+        rtc_.lastPublishMs = logic_.LastPublishMs();
+        rtc_.lastWakeToAckMs = uptimeMs;
+        Sleep(false);
+      }
+      break;
+
+    case DutyCycleState::Sleeping:
+      break;
+  }
+}
+
+void LevelDutyCycle::StepSampling(uint32_t uptimeMs)
+{
+  if (samplesTaken_ > 0 && uptimeMs - lastSampleMs_ < config_.sampleSpacingMs)
+  {
+    return;
+  }
+
+  logic_.FilterMask(hal_.ReadSensors());
+  lastSampleMs_ = uptimeMs;
+  if (++samplesTaken_ < config_.sampleCount)
+  {
+    return;
+  }
+
+  const SensorMask<SENSOR_COUNT> sensors = logic_.FilteredMask();
+  const bool changed = logic_.HasChanged(sensors);
+  const bool empty = changed && logic_.BuildSnapshot(sensors).levelPercent == 0;
+  const bool firstPublish = cause_ == WakeCause::PowerOn || !rtc_.hasPublished;
+  if (!firstPublish && !empty && !logic_.ShouldPublish(changed, hal_.RtcNowMs()))
+  {
+    // Nothing to report: sleep again without powering up Wi-Fi.
+    sensorWakeWithoutChange_ = cause_ == WakeCause::SensorChange && !changed;
+    Sleep(false);
+    return;
+  }
+
+  usingFastConnect_ = rtc_.wifi.valid;
+  wifiStartMs_ = uptimeMs;
+  hal_.BeginWifi(rtc_.wifi);
+  state_ = DutyCycleState::ConnectingWifi;
+}
+
+void LevelDutyCycle::Sleep(bool publishFailed)
+{
+  uint32_t timerMs = config_.checkIntervalMs;
+  if (publishFailed)
+  {
+    timerMs = config_.retryIntervalMs;
+  }
+  else if (rtc_.hasPublished)
+  {
+    const uint32_t sincePublishMs = hal_.RtcNowMs() - rtc_.lastPublishMs;
+    const uint32_t untilPeriodicMs =
+      sincePublishMs >= config_.publishIntervalMs ? 0 : config_.publishIntervalMs - sincePublishMs;
+    timerMs = untilPeriodicMs < timerMs ? untilPeriodicMs : timerMs;
+  }
+
+  // EXT1 has one trigger level for all pins: with water present, wake when any wet
+  // sensor falls dry (the safety-relevant direction); rises are caught by the timer.
+  const SensorMask<SENSOR_COUNT> allPins = static_cast<SensorMask<SENSOR_COUNT>>((1u << SENSOR_COUNT) - 1);
+  const SensorMask<SENSOR_COUNT> wet = logic_.FilteredMask();
+  SensorMask<SENSOR_COUNT> wakePins = wet != 0 ? wet : allPins;
+  const bool wakeOnAnyHigh = wet == 0;
+  if (sensorWakeWithoutChange_)
+  {
+    // The pins are flickering; stay on the timer for a while instead of waking on every slosh.
+    wakePins = 0;
+    timerMs = config_.sensorLockoutMs < timerMs ? config_.sensorLockoutMs : timerMs;
+  }
+
+  state_ = DutyCycleState::Sleeping;
+  hal_.DeepSleep(timerMs, wakePins, wakeOnAnyHigh);
+}
+
+DutyCycleState LevelDutyCycle::State() const
+{
+  return state_;
+}
+
+const WaterLevelLogic<SENSOR_COUNT>& LevelDutyCycle::Logic() const
+{
+  return logic_;
+}
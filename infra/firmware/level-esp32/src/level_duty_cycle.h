@@ -0,0 +1,132 @@
+#ifndef LEVEL_DUTY_CYCLE_H
+#define LEVEL_DUTY_CYCLE_H
+
+#include <cstdint>
+#include "sensor_debouncer.h"
+#include "water_level_logic.h"
+
+static constexpr uint32_t LEVEL_RTC_MAGIC = 0x4C564C31;
+
+/// <summary>
+/// Access point and lease of the last successful connection, reused to skip the
+/// scan and DHCP on the next wake.
+/// </summary>
+struct WifiFastConnect
+{
+  bool valid;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+/// <summary>
+/// State that survives deep sleep in RTC memory. Plain data only; validated by magic.
+/// </summary>
+struct LevelRtcState
+{
+  uint32_t magic;
+  uint32_t wakeCount;
+  bool hasPublished;
+  SensorMask<SENSOR_COUNT> lastMask;
+  uint32_t lastPublishMs;
+  uint32_t lastWakeToPublishMs;
+  uint32_t lastWakeToAckMs;
+  WifiFastConnect wifi;
+};
+
+enum class WakeCause : uint8_t
+{
+  PowerOn,
+  Timer,
+  SensorChange
+};
+
+enum class DutyCycleState : uint8_t
+{
+  Sampling,
+  ConnectingWifi,
+  ConnectingMqtt,
+  AwaitingAck,
+  Sleeping
+};
+
+/// <summary>
+/// Hardware seams of the duty-cycled level node.
+/// </summary>
+class LevelNodeHal
+{
+public:
+  // Milliseconds since this wake.
+  virtual uint32_t UptimeMs() = 0;
+  // Milliseconds on a clock that keeps running through deep sleep.
+  virtual uint32_t RtcNowMs() = 0;
+  virtual SensorMask<SENSOR_COUNT> ReadSensors() = 0;
+  // Starts connecting; with a valid cache, to that BSSID/channel with its static IP.
+  virtual void BeginWifi(const WifiFastConnect& cached) = 0;
+  virtual bool WifiConnected() = 0;
+  virtual void CaptureWifi(WifiFastConnect& cached) = 0;
+  virtual void BeginMqtt() = 0;
+  virtual bool MqttConnected() = 0;
+  virtual bool Publish(const WaterLevelSnapshot<SENSOR_COUNT>& snapshot, uint32_t wakeToPublishMs) = 0;
+  virtual bool PublishAcked() = 0;
+  // Does not return on the device. wakePins is empty for a timer-only sleep.
+  virtual void DeepSleep(uint32_t timerMs, SensorMask<SENSOR_COUNT> wakePins, bool wakeOnAnyHigh) = 0;
+
+protected:
+  ~LevelNodeHal() = default;
+};
+
+struct LevelDutyCycleConfig
+{
+  uint32_t publishIntervalMs;
+  // Longest timer sleep between checks.
+  uint32_t checkIntervalMs;
+  // Timer sleep after a wake that could not publish.
+  uint32_t retryIntervalMs;
+  // Timer-only sleep after a sensor wake that showed no change (sloshing).
+  uint32_t sensorLockoutMs;
+  uint8_t sampleCount;
+  uint32_t sampleSpacingMs;
+  // Time the cached BSSID/IP gets before falling back to a full connect.
+  uint32_t fastConnectTimeoutMs;
+  // Hard limit on time awake per wake.
+  uint32_t awakeBudgetMs;
+  WaterLevelFilterConfig filter;
+};
+
+/// <summary>
+/// One wake of the battery level node: sample, publish only when needed, then
+/// arm the timer and sensor wake sources and deep sleep. Drive it with Step().
+/// </summary>
+class LevelDutyCycle
+{
+public:
+  LevelDutyCycle(LevelNodeHal& hal, LevelRtcState& rtc, const LevelDutyCycleConfig& config);
+
+  void Begin(WakeCause cause);
+  void Step();
+
+  DutyCycleState State() const;
+  const WaterLevelLogic<SENSOR_COUNT>& Logic() const;
+
+private:
+  void StepSampling(uint32_t uptimeMs);
+  void Sleep(bool publishFailed);
+
+  LevelNodeHal& hal_;
+  LevelRtcState& rtc_;
+  LevelDutyCycleConfig config_;
+  WaterLevelLogic<SENSOR_COUNT> logic_;
+  DutyCycleState state_;
+  WakeCause cause_;
+  uint8_t samplesTaken_;
+  uint32_t lastSampleMs_;
+  uint32_t wifiStartMs_;
+  bool usingFastConnect_;
+  bool sensorWakeWithoutChange_;
+};
+
+#endif
@@ -0,0 +1,365 @@
+#include "level_history_log.h"
+
+static constexpr uint8_t RECORD_MAGIC = 0x4C;
+static constexpr size_t RECORD_CRC_OFFSET = 16;
+
+static uint32_t crc32(const uint8_t* data, size_t length)
+{
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+static void putU32(uint8_t* at, uint32_t value)
+{
+  at[0] = static_cast<uint8_t>(value);
+  at[1] = static_cast<uint8_t>(value >> 8);
+  at[2] = static_cast<uint8_t>(value >> 16);
+  at[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static uint32_t getU32(const uint8_t* at)
+{
+  return static_cast<uint32_t>(at[0]) | (static_cast<uint32_t>(at[1]) << 8) |
+         (static_cast<uint32_t>(at[2]) << 16) | (static_cast<uint32_t>(at[3]) << 24);
+}
+
+LevelHistoryLog::LevelHistoryLog(LevelLogStorage& storage)
+  : storage_(storage),
+    slotsPerSegment_(0),
+    capacity_(0),
+    nextSeq_(1),
+    oldestSeq_(1),
+    replayedThrough_(0),
+    lastOfflineSeq_(0),
+    lost_(0),
+    corrupt_(0)
+{
+}
+
+size_t LevelHistoryLog::Open()
+{
+  slotsPerSegment_ = storage_.SegmentSize() / RECORD_SIZE;
+  capacity_ = storage_.SegmentCount() * slotsPerSegment_;
+  nextSeq_ = 1;
+  oldestSeq_ = 1;
+  replayedThrough_ = 0;
+  lastOfflineSeq_ = 0;
+  lost_ = 0;
+  corrupt_ = 0;
+
+  size_t intact = 0;
+  uint32_t newest = 0;
+  uint32_t oldest = UINT32_MAX;
+  for (size_t slot = 0; slot < capacity_; slot++)
+  {
+    uint8_t bytes[RECORD_SIZE];
+    if (!ReadSlot(slot, bytes) || bytes[0] != RECORD_MAGIC)
+    {
+      // Never written since the segment was erased.
+      continue;
+    }
+
+    const uint32_t seq = getU32(&bytes[4]);
+    const uint8_t kind = bytes[1];
+    if (getU32(&bytes[RECORD_CRC_OFFSET]) != crc32(bytes, RECORD_CRC_OFFSET) || seq == 0 ||
+        seq % capacity_ != slot || kind < static_cast<uint8_t>(Kind::Offline) || kind > static_cast<uint8_t>(Kind::Replayed))
+    {
+      corrupt_++;
+      continue;
+    }
+
+    intact++;
+    newest = seq > newest ? seq : newest;
+    oldest = seq < oldest ? seq : oldest;
+    if (kind == static_cast<uint8_t>(Kind::Replayed))
+    {
+      const uint32_t through = getU32(&bytes[12]);
+      replayedThrough_ = through > replayedThrough_ ? through : replayedThrough_;
+    }
+    else if (kind == static_cast<uint8_t>(Kind::Offline) && seq > lastOfflineSeq_)
+    {
+      lastOfflineSeq_ = seq;
+    }
+  }
+
+  if (intact > 0)
+  {
+    nextSeq_ = newest + 1;
+    oldestSeq_ = oldest;
+  }
+  return intact;
+}
+
+size_t LevelHistoryLog::Capacity() const
+{
+  return capacity_;
+}
+
+bool LevelHistoryLog::Append(uint32_t measuredAt, uint32_t mask, bool sent)
+{
+  const uint32_t seq = nextSeq_;
+  if (!AppendRecord(sent ? Kind::Sent : Kind::Offline, measuredAt, mask))
+  {
+    return false;
+  }
+
+  if (!sent)
+  {
+    lastOfflineSeq_ = seq;
+  }
+  return true;
+}
+
+uint32_t LevelHistoryLog::NewestSeq() const
+{
+  return nextSeq_ - 1;
+}
+
+bool LevelHistoryLog::HasPending() const
+{
+  return lastOfflineSeq_ > replayedThrough_;
+}
+
+size_t LevelHistoryLog::NextBatch(LevelReading* out, size_t max)
+{
+  size_t count = 0;
+  const uint32_t first = replayedThrough_ + 1 > oldestSeq_ ? replayedThrough_ + 1 : oldestSeq_;
+  for (uint32_t seq = first; seq < nextSeq_ && count < max; seq++)
+  {
+    Record record;
+    if (ReadRecord(seq, record) && record.kind == Kind::Offline)
+    {
+      out[count++] = { record.seq, record.measuredAt, record.value };
+    }
+  }
+
+  if (count == 0 && HasPending())
+  {
+    // Everything pending was overwritten or torn; there is nothing left to replay.
+    replayedThrough_ = lastOfflineSeq_;
+  }
+  return count;
+}
+
+bool LevelHistoryLog::MarkReplayed(uint32_t throughSeq)
+{
+  if (!AppendRecord(Kind::Replayed, 0, throughSeq))
+  {
+    return false;
+  }
+
+  replayedThrough_ = throughSeq > replayedThrough_ ? throughSeq : replayedThrough_;
+  return true;
+}
+
+bool LevelHistoryLog::MarkDelivered(uint32_t seq)
+{
+  if (seq <= replayedThrough_)
+  {
+    return true;
+  }
+  if (seq >= nextSeq_)
+  {
+    return false;
+  }
+
+  const uint32_t first = replayedThrough_ + 1 > oldestSeq_ ? replayedThrough_ + 1 : oldestSeq_;
+  for (uint32_t older = first; older < seq; older++)
+  {
+    Record record;
+    if (ReadRecord(older, record) && record.kind == Kind::Offline)
+    {
+      return false;
+    }
+  }
+  return MarkReplayed(seq);
+}
+
+size_t LevelHistoryLog::Find(uint32_t from, uint32_t to, uint32_t afterSeq, LevelReading* out, size_t max)
+{
+  size_t count = 0;
+  const uint32_t first = afterSeq + 1 > oldestSeq_ ? afterSeq + 1 : oldestSeq_;
+  for (uint32_t seq = first; seq < nextSeq_ && count < max; seq++)
+  {
+    Record record;
+    if (ReadRecord(seq, record) && record.kind != Kind::Replayed && record.measuredAt >= from && record.measuredAt <= to)
+    {
+      out[count++] = { record.seq, record.measuredAt, record.value };
+    }
+  }
+  return count;
+}
+
+uint32_t LevelHistoryLog::Lost() const
+{
+  return lost_;
+}
+
+uint32_t LevelHistoryLog::Corrupt() const
+{
+  return corrupt_;
+}
+
+bool LevelHistoryLog::ReadSlot(size_t slot, uint8_t* bytes)
+{
+  return storage_.Read(slot / slotsPerSegment_, (slot % slotsPerSegment_) * RECORD_SIZE, bytes, RECORD_SIZE);
+}
+
+bool LevelHistoryLog::ReadRecord(uint32_t seq, Record& record)
+{
+  uint8_t bytes[RECORD_SIZE];
+  if (capacity_ == 0 || !ReadSlot(seq % capacity_, bytes))
+  {
+    return false;
+  }
+
+  if (bytes[0] != RECORD_MAGIC || getU32(&bytes[RECORD_CRC_OFFSET]) != crc32(bytes, RECORD_CRC_OFFSET) ||
+      getU32(&bytes[4]) != seq)
+  {
+    return false;
+  }
+
+  record.kind = static_cast<Kind>(bytes[1]);
+  record.seq = seq;
+  record.measuredAt = getU32(&bytes[8]);
+  record.value = getU32(&bytes[12]);
+  return true;
+}
+
+bool LevelHistoryLog::AppendRecord(Kind kind, uint32_t measuredAt, uint32_t value)
+{
+  if (capacity_ == 0)
+  {
+    return false;
+  }
+
+  const uint32_t seq = nextSeq_;
+  const size_t slot = seq % capacity_;
+  if (slot % slotsPerSegment_ == 0 && !EraseSegmentAt(seq))
+  {
+    return false;
+  }
+
+  uint8_t bytes[RECORD_SIZE];
+  bytes[0] = RECORD_MAGIC;
+  bytes[1] = static_cast<uint8_t>(kind);
+  bytes[2] = 0;
+  bytes[3] = 0;
+  putU32(&bytes[4], seq);
+  putU32(&bytes[8], measuredAt);
+  putU32(&bytes[12], value);
+  putU32(&bytes[RECORD_CRC_OFFSET], crc32(bytes, RECORD_CRC_OFFSET));
+  if (!storage_.Write(slot / slotsPerSegment_, (slot % slotsPerSegment_) * RECORD_SIZE, bytes, RECORD_SIZE))
+  {
+    // The slot may hold a torn record now; the next append rewrites it with the same seq.
+    return false;
+  }
+
+  nextSeq_ = seq + 1;
+  return true;
+}
+
+bool LevelHistoryLog::EraseSegmentAt(uint32_t seq)
+{
+  // In the first lap the segment holds nothing; after that it holds the previous
+  // lap's seqs from seq - capacity onwards, which are dropped together.
+  const bool wrapped = seq >= capacity_;
+  const uint32_t dropFrom = wrapped ? seq - static_cast<uint32_t>(capacity_) : 0;
+  const uint32_t dropTo = dropFrom + static_cast<uint32_t>(slotsPerSegment_);
+  uint32_t pendingDropped = 0;
+  for (uint32_t dropped = dropFrom > oldestSeq_ ? dropFrom : oldestSeq_; wrapped && dropped < dropTo; dropped++)
+  {
+    Record record;
+    if (ReadRecord(dropped, record) && record.kind == Kind::Offline && record.seq > replayedThrough_)
+    {
+      pendingDropped++;
+    }
+  }
+
+  if (!storage_.Erase((seq % capacity_) / slotsPerSegment_))
+  {
+    return false;
+  }
+  lost_ += pendingDropped;
+  if (wrapped && dropTo > oldestSeq_)
+  {
+    oldestSeq_ = dropTo;
+  }
+  return true;
+}
+
+static bool parseDigits(const char* text, size_t count, uint32_t& value)
+{
+  value = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (text[i] < '0' || text[i] > '9')
+    {
+      return false;
+    }
+    value = value * 10 + static_cast<uint32_t>(text[i] - '0');
+  }
+  return true;
+}
+
+bool ParseUtcTimestamp(const char* text, uint32_t& unixSeconds)
+{
+  if (text == nullptr)
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < 20; i++)
+  {
+    if (text[i] == '\0')
+    {
+      return false;
+    }
+  }
+  if (text[20] != '\0' || text[4] != '-' || text[7] != '-' || text[10] != 'T' || text[13] != ':' ||
+      text[16] != ':' || text[19] != 'Z')
+  {
+    return false;
+  }
+
+  uint32_t year;
+  uint32_t month;
+  uint32_t day;
+  uint32_t hour;
+  uint32_t minute;
+  uint32_t second;
+  if (!parseDigits(text, 4, year) || !parseDigits(text + 5, 2, month) || !parseDigits(text + 8, 2, day) ||
+      !parseDigits(text + 11, 2, hour) || !parseDigits(text + 14, 2, minute) || !parseDigits(text + 17, 2, second))
+  {
+    return false;
+  }
+  if (year < 1970 || year > 2105 || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 ||
+      second > 59)
+  {
+    return false;
+  }
+
+  // Days since 1970-01-01 in the proleptic Gregorian calendar (March-based year).
+  const uint32_t y = month <= 2 ? year - 1 : year;
+  const uint32_t era = y / 400;
+  const uint32_t yearOfEra = y - era * 400;
+  const uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  const uint64_t days = static_cast<uint64_t>(era) * 146097 + dayOfEra - 719468;
+  const uint64_t seconds = days * 86400ULL + hour * 3600ULL + minute * 60ULL + second;
+  if (seconds > UINT32_MAX)
+  {
+    return false;
+  }
+
+  unixSeconds = static_cast<uint32_t>(seconds);
+  return true;
+}
@@ -0,0 +1,128 @@
+#ifndef LEVEL_HISTORY_LOG_H
+#define LEVEL_HISTORY_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// <summary>
+/// Flash the history log lives in, split into equal segments: LittleFS files on the
+/// node, memory in the tests. The log only writes at the end of a segment (or over
+/// its own failed write) and empties a segment whole before reusing it, so a record
+/// never rewrites flash that holds older records. Write must be durable once it
+/// returns true; Read fails for bytes not written since the segment was erased.
+/// </summary>
+class LevelLogStorage
+{
+public:
+  virtual size_t SegmentCount() const = 0;
+  virtual size_t SegmentSize() const = 0;
+  virtual bool Read(size_t segment, size_t offset, uint8_t* data, size_t length) = 0;
+  virtual bool Write(size_t segment, size_t offset, const uint8_t* data, size_t length) = 0;
+  virtual bool Erase(size_t segment) = 0;
+
+protected:
+  ~LevelLogStorage() = default;
+};
+
+/// <summary>
+/// One logged level reading. measuredAt is Unix time in seconds (UTC).
+/// </summary>
+struct LevelReading
+{
+  uint32_t seq;
+  uint32_t measuredAt;
+  uint32_t mask;
+};
+
+/// <summary>
+/// Store-and-forward ring of level readings. Each storage segment is split into fixed
+/// 20-byte slots and record seq always lives in slot seq % Capacity(), counted across
+/// the segments in order, so appends walk the whole store once per lap and nothing
+/// (no header, no index) is ever rewritten in between. Entering a segment erases it,
+/// so once the ring is full the oldest segment's records are dropped together.
+///
+/// Record layout, little-endian:
+///   0  magic 0x4C       1  kind (1 offline, 2 sent, 3 replayed marker)
+///   2  reserved (0)     4  seq (starts at 1)
+///   8  measuredAt       12 sensor mask, or the last replayed seq for a marker
+///   16 CRC-32 of bytes 0..15
+///
+/// Open() rebuilds the state by scanning every slot, so after a power cut the log
+/// resumes behind the newest intact record; a torn record fails its CRC and is
+/// skipped. Offline readings stay pending until a replayed marker covers them.
+/// Owned by loop().
+/// </summary>
+class LevelHistoryLog
+{
+public:
+  static constexpr size_t RECORD_SIZE = 20;
+
+  explicit LevelHistoryLog(LevelLogStorage& storage);
+
+  // Returns the number of intact records found.
+  size_t Open();
+  size_t Capacity() const;
+
+  // sent is false while the reading is not known to have reached the broker; it is
+  // replayed unless MarkDelivered() gets to it first.
+  bool Append(uint32_t measuredAt, uint32_t mask, bool sent);
+  // Seq of the last appended record, 0 before the first.
+  uint32_t NewestSeq() const;
+
+  bool HasPending() const;
+  // The oldest pending readings, in order. Returns how many were written to out.
+  size_t NextBatch(LevelReading* out, size_t max);
+  // Records that every pending reading up to throughSeq has been delivered.
+  bool MarkReplayed(uint32_t throughSeq);
+  // Records that the reading with this seq was acknowledged as a live publish. Only
+  // moves the replay point when nothing older is pending; otherwise the reading is
+  // replayed with the older ones and reaches the broker twice. True once seq is covered.
+  bool MarkDelivered(uint32_t seq);
+
+  // Readings measured in [from, to] with a seq above afterSeq, in order. Page through
+  // a range by passing the last returned seq as afterSeq.
+  size_t Find(uint32_t from, uint32_t to, uint32_t afterSeq, LevelReading* out, size_t max);
+
+  // Pending readings overwritten before they were replayed, since Open().
+  uint32_t Lost() const;
+  // Slots that failed their CRC or sat in the wrong slot at the last Open().
+  uint32_t Corrupt() const;
+
+private:
+  enum class Kind : uint8_t
+  {
+    Offline = 1,
+    Sent = 2,
+    Replayed = 3
+  };
+
+  struct Record
+  {
+    Kind kind;
+    uint32_t seq;
+    uint32_t measuredAt;
+    uint32_t value;
+  };
+
+  bool ReadSlot(size_t slot, uint8_t* bytes);
+  bool ReadRecord(uint32_t seq, Record& record);
+  bool AppendRecord(Kind kind, uint32_t measuredAt, uint32_t value);
+  bool EraseSegmentAt(uint32_t seq);
+
+  LevelLogStorage& storage_;
+  size_t slotsPerSegment_;
+  size_t capacity_;
+  uint32_t nextSeq_;
+  uint32_t oldestSeq_;
+  uint32_t replayedThrough_;
+  uint32_t lastOfflineSeq_;
+  uint32_t lost_;
+  uint32_t corrupt_;
+};
+
+/// <summary>
+/// Parses "YYYY-MM-DDTHH:MM:SSZ" into Unix seconds. Returns false for anything else.
+/// </summary>
+bool ParseUtcTimestamp(const char* text, uint32_t& unixSeconds);
+
+#endif
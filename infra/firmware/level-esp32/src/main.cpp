@@ -5,36 +5,232 @@
 #include <ArduinoOTA.h>
 #include <WebServer.h>
 #include <Preferences.h>
+#include <LittleFS.h>
 #include <time.h>
+#include <sys/time.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+#include <atomic>
 #include "config.h"
+#include "boot_timeline.h"
+#include "connectivity_manager.h"
+#include "iso_timestamp.h"
+#include "level_duty_cycle.h"
+#include "level_history_log.h"
+#include "publish_ack_tracker.h"
+#include "sensor_debouncer.h"
+#include "spsc_ring.h"
 #include "water_level_logic.h"
 
+static_assert(sizeof(SENSOR_PINS) / sizeof(SENSOR_PINS[0]) == SENSOR_COUNT, "SENSOR_PINS must list one pin per sensor");
+
+static const uint32_t SENSOR_SETTLE_US = 20000;
+static const uint32_t LOOP_IDLE_WAIT_MS = 50;
+// Short enough for the config portal's web server to stay responsive.
+static const uint32_t LOOP_PORTAL_WAIT_MS = 10;
+static const uint32_t LEVEL_SAMPLE_INTERVAL_MS = 50;
+
+// Slosh filter: 8 of the last 10 samples (500 ms) must disagree before a sensor flips.
+// Change publishes: bursts of 3, then at most one every 5 s. Tuned with test_water_level_filter_bench.
+static const WaterLevelFilterConfig LEVEL_FILTER{ 10, 8, 5000, 3 };
+static const size_t SENSOR_EDGE_QUEUE_CAPACITY = 64;
+
+// Level transitions are kept in a flash ring so a broker or Wi-Fi outage leaves no gap.
+// 20 bytes per record: 8 segments of one 4 KiB flash block hold about 1600 transitions.
+// Replays and history query replies carry up to 16 readings per message.
+static const char LEVEL_HISTORY_DIR[] = "/level_history";
+static const size_t LEVEL_HISTORY_SEGMENTS = 8;
+static const size_t LEVEL_HISTORY_SEGMENT_BYTES = 4096;
+static const size_t LEVEL_HISTORY_BATCH = 16;
+static const uint32_t LEVEL_HISTORY_ACK_TIMEOUT_MS = 30000;
+// Before NTP sets the clock, time() counts from 1970.
+static const time_t CLOCK_SET_AFTER = 1700000000;
+// A state publish without its PUBACK after this long is sent again.
+static const uint32_t STATE_ACK_TIMEOUT_MS = 30000;
+static const size_t PUBLISH_ACK_QUEUE_CAPACITY = 16;
+// The broker declares the node offline (via the will) 1.5 keep-alives after its last packet.
+static const uint16_t MQTT_KEEP_ALIVE_SECONDS = 15;
+// MQTT 5: how long the broker keeps an awake node's session after a disconnect.
+static const uint32_t MQTT_SESSION_EXPIRY_SECONDS = 24UL * 60UL * 60UL;
+static const char* MQTT_AVAILABILITY_ONLINE = "online";
+static const char* MQTT_AVAILABILITY_OFFLINE = "offline";
+// Last TLS session with the broker. RTC memory outlives deep sleep and soft resets, so a
+// wake resumes the session instead of paying for a full handshake.
+RTC_NOINIT_ATTR static AsyncMqttClientInternals::TlsSessionRecord tlsSession;
+
+// Battery builds (env:esp32-s3-deepsleep) duty-cycle through deep sleep instead of staying awake.
+#ifndef LEVEL_DEEP_SLEEP
+#define LEVEL_DEEP_SLEEP 0
+#endif
+
 static AsyncMqttClient mqttClient;
-static bool mqttConnected = false;
-static uint32_t lastMqttAttemptMs = 0;
-static uint32_t wifiConnectStartMs = 0;
+// Written by the AsyncTCP connect/disconnect callbacks, read by loop().
+static std::atomic<bool> mqttConnected{ false };
+static std::atomic<uint32_t> mqttConnectedAtMs{ 0 };
+static std::atomic<bool> mqttSessionPresent{ false };
+static bool publishedSinceConnect = false;
+static BootTimeline bootTimeline;
 
-static WaterLevelLogic logic(PUBLISH_INTERVAL_MS);
+static WaterLevelLogic<SENSOR_COUNT> logic(PUBLISH_INTERVAL_MS, LEVEL_FILTER);
+static uint32_t lastSampleMs = 0;
 static bool otaReady = false;
-static bool configPortalActive = false;
+static bool configServerRoutesAdded = false;
 static WebServer configServer(80);
 static Preferences preferences;
 static String wifiSsid;
 static String wifiPassword;
 
-static String isoUtcNow()
+static SpscRing<SensorEdge, SENSOR_EDGE_QUEUE_CAPACITY> sensorEdges;
+static SensorDebouncer debouncer(SENSOR_SETTLE_US);
+static uint32_t handledEdgeDrops = 0;
+static TaskHandle_t loopTask = nullptr;
+// PUBACKs from the MQTT task; a level only counts as published once its ack is drained.
+static SpscRing<uint16_t, PUBLISH_ACK_QUEUE_CAPACITY> publishAcks;
+static PublishAckTracker stateAck(STATE_ACK_TIMEOUT_MS);
+
+/// <summary>
+/// History log segments as LittleFS files <dir>/0 .. <dir>/N-1; a missing file is an
+/// erased segment. A LittleFS write rewrites the file from the written block to its end,
+/// so records only ever go to the end of a one-block file: each costs one block program
+/// however large the log is, and LittleFS spreads those over the free blocks.
+/// One file is kept open at a time.
+/// </summary>
+class LittleFsLogStorage : public LevelLogStorage
 {
-  time_t now = time(nullptr);
-  if (now < 1700000000)
+public:
+  bool Begin(const char* dir, size_t segmentCount, size_t segmentSize)
+  {
+    if (!LittleFS.begin(true))
+    {
+      return false;
+    }
+    // Single preallocated file used by earlier firmware.
+    LittleFS.remove("/level_history.bin");
+    if (!LittleFS.exists(dir) && !LittleFS.mkdir(dir))
+    {
+      return false;
+    }
+
+    dir_ = dir;
+    segmentCount_ = segmentCount;
+    segmentSize_ = segmentSize;
+    return true;
+  }
+
+  size_t SegmentCount() const override
+  {
+    return segmentCount_;
+  }
+
+  size_t SegmentSize() const override
+  {
+    return segmentSize_;
+  }
+
+  bool Read(size_t segment, size_t offset, uint8_t* data, size_t length) override
+  {
+    return Select(segment, false) && file_.seek(offset) && file_.read(data, length) == length;
+  }
+
+  bool Write(size_t segment, size_t offset, const uint8_t* data, size_t length) override
+  {
+    if (!Select(segment, true) || !file_.seek(offset) || file_.write(data, length) != length)
+    {
+      return false;
+    }
+    // LittleFS commits on sync; after a power cut the file holds this record or the one before.
+    file_.flush();
+    return true;
+  }
+
+  bool Erase(size_t segment) override
+  {
+    if (segment == openSegment_)
+    {
+      file_.close();
+      openSegment_ = SIZE_MAX;
+    }
+    const String path = SegmentPath(segment);
+    return !LittleFS.exists(path) || LittleFS.remove(path);
+  }
+
+private:
+  String SegmentPath(size_t segment) const
   {
-    return String("1970-01-01T00:00:00Z");
+    return String(dir_) + "/" + String(static_cast<unsigned>(segment));
   }
 
-  struct tm tmUtc;
-  gmtime_r(&now, &tmUtc);
-  char buf[25];
-  strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tmUtc);
-  return String(buf);
+  // Opens the segment's file unless it is the open one; create makes a missing one.
+  bool Select(size_t segment, bool create)
+  {
+    if (segment == openSegment_ && file_)
+    {
+      return true;
+    }
+    if (file_)
+    {
+      file_.close();
+    }
+    openSegment_ = SIZE_MAX;
+
+    const String path = SegmentPath(segment);
+    if (LittleFS.exists(path))
+    {
+      file_ = LittleFS.open(path, "r+");
+    }
+    else if (create)
+    {
+      file_ = LittleFS.open(path, "w+");
+    }
+    if (!file_)
+    {
+      return false;
+    }
+    openSegment_ = segment;
+    return true;
+  }
+
+  File file_;
+  const char* dir_ = nullptr;
+  size_t segmentCount_ = 0;
+  size_t segmentSize_ = 0;
+  size_t openSegment_ = SIZE_MAX;
+};
+
+/// <summary>
+/// A history range requested on waterlevel/cmd, served one page per loop.
+/// </summary>
+struct HistoryQuery
+{
+  uint32_t from;
+  uint32_t to;
+  uint32_t afterSeq;
+  char requestId[40];
+};
+
+static LittleFsLogStorage historyStorage;
+static LevelHistoryLog historyLog(historyStorage);
+static bool historyReady = false;
+static bool subscribedSinceConnect = false;
+static bool subscribedThisBoot = false;
+static bool transitionLogged = false;
+static SensorMask<SENSOR_COUNT> loggedMask = 0;
+// The newest logged reading and the state publish that carried it (0 if none did).
+static uint32_t loggedSeq = 0;
+static uint16_t loggedPacketId = 0;
+// The replay batch awaiting its PUBACK.
+static uint16_t historyPacketId = 0;
+static bool historyBatchAcked = false;
+static uint32_t historyBatchThroughSeq = 0;
+static uint32_t historyBatchSentMs = 0;
+// Written by the MQTT task while clear, then owned by loop() until it clears it again.
+static HistoryQuery historyQuery;
+static std::atomic<bool> historyQueryPending{ false };
+
+static IsoTimestamp isoUtcNow()
+{
+  const time_t now = time(nullptr);
+  return FormatIsoUtc(now < CLOCK_SET_AFTER ? 0 : now);
 }
 
 static void loadWifiCredentials()
@@ -61,13 +257,8 @@ static void saveWifiCredentials(const String& ssid, const String& password)
 
 static void startConfigPortal()
 {
-  if (configPortalActive)
-  {
-    return;
-  }
-
-  configPortalActive = true;
-  WiFi.mode(WIFI_AP);
+  // AP+STA: the station keeps retrying while the portal is up.
+  WiFi.mode(WIFI_AP_STA);
   if (WIFI_AP_PASSWORD && strlen(WIFI_AP_PASSWORD) >= 8)
   {
     WiFi.softAP(WIFI_AP_SSID, WIFI_AP_PASSWORD);
@@ -77,6 +268,14 @@ static void startConfigPortal()
     WiFi.softAP(WIFI_AP_SSID);
   }
 
+  if (configServerRoutesAdded)
+  {
+    configServer.begin();
+    return;
+  }
+
+  configServerRoutesAdded = true;
+
   configServer.on("/", HTTP_GET, []()
   {
     const char page[] =
@@ -110,45 +309,110 @@ static void startConfigPortal()
   configServer.begin();
 }
 
-static String topicWaterLevel()
+static void stopConfigPortal()
 {
-  return String(MQTT_PREFIX) + "/WateringController/waterlevel/state";
+  configServer.stop();
+  WiFi.softAPdisconnect(true);
+  WiFi.mode(WIFI_STA);
 }
 
-static void ensureWifi()
+// Station attempts time out after WIFI_CONNECT_TIMEOUT_MS. Retries start fast and back off
+// to the maximum; the config portal opens once the station has been down this long.
+static const uint32_t WIFI_PORTAL_AFTER_MS = 3UL * 60UL * 1000UL;
+static const uint32_t RECONNECT_FIRST_RETRY_MS = 250;
+static const uint32_t RECONNECT_BACKOFF_BASE_MS = 1000;
+static const uint32_t RECONNECT_BACKOFF_MAX_MS = 60UL * 1000UL;
+
+/// <summary>
+/// Arduino WiFi and AsyncMqttClient side of the connectivity manager (awake node only).
+/// </summary>
+class EspConnectivityHal : public ConnectivityHal
 {
-  if (configPortalActive)
+public:
+  void BeginWifi() override
   {
-    return;
+    bootTimeline.Mark(BootPhase::WifiBegin, millis());
+    WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str());
   }
 
-  if (WiFi.status() == WL_CONNECTED)
+  void StartPortal() override
   {
-    wifiConnectStartMs = 0;
-    return;
+    startConfigPortal();
   }
 
-  if (wifiSsid.length() == 0)
+  void StopPortal() override
   {
-    startConfigPortal();
-    return;
+    stopConfigPortal();
   }
 
-  WiFi.mode(WIFI_STA);
-  if (wifiConnectStartMs == 0)
+  void BeginMqtt() override
   {
-    wifiConnectStartMs = millis();
-    WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str());
+    bootTimeline.Mark(BootPhase::MqttConnecting, millis());
+    bootTimeline.CountMqttAttempt();
+    mqttClient.connect();
   }
-  else if (millis() - wifiConnectStartMs > WIFI_CONNECT_TIMEOUT_MS)
+
+  uint32_t Random() override
   {
-    startConfigPortal();
+    return esp_random();
   }
+};
+
+static EspConnectivityHal connectivityHal;
+static ConnectivityManager connectivity(connectivityHal, {
+  WIFI_CONNECT_TIMEOUT_MS,
+  RECONNECT_FIRST_RETRY_MS,
+  RECONNECT_BACKOFF_BASE_MS,
+  RECONNECT_BACKOFF_MAX_MS,
+  WIFI_PORTAL_AFTER_MS
+});
+
+// Set by the WiFi event task and the MQTT task, read by loop(). Drops are counted so a
+// drop and reconnect between two loop passes is still seen.
+static std::atomic<bool> wifiLinkUp{ false };
+static std::atomic<uint32_t> wifiLinkDrops{ 0 };
+static uint32_t handledWifiLinkDrops = 0;
+static std::atomic<uint32_t> mqttLinkDrops{ 0 };
+static uint32_t handledMqttLinkDrops = 0;
+
+// Topics fit AsyncMqttClient's default maximum topic length; built once in setup().
+static const size_t MQTT_TOPIC_MAX_LENGTH = 128;
+static char topicWaterLevel[MQTT_TOPIC_MAX_LENGTH + 1];
+static char topicWaterLevelDiagBoot[MQTT_TOPIC_MAX_LENGTH + 1];
+static char topicWaterLevelHistory[MQTT_TOPIC_MAX_LENGTH + 1];
+static char topicWaterLevelCmd[MQTT_TOPIC_MAX_LENGTH + 1];
+static char topicWaterLevelAvailability[MQTT_TOPIC_MAX_LENGTH + 1];
+
+static void buildTopics()
+{
+  snprintf(topicWaterLevel, sizeof(topicWaterLevel), "%s/WateringController/waterlevel/state", MQTT_PREFIX);
+  snprintf(topicWaterLevelHistory, sizeof(topicWaterLevelHistory), "%s/WateringController/waterlevel/history", MQTT_PREFIX);
+  snprintf(topicWaterLevelCmd, sizeof(topicWaterLevelCmd), "%s/WateringController/waterlevel/cmd", MQTT_PREFIX);
+  snprintf(topicWaterLevelDiagBoot, sizeof(topicWaterLevelDiagBoot), "%s/WateringController/waterlevel/diag/boot", MQTT_PREFIX);
+  snprintf(topicWaterLevelAvailability, sizeof(topicWaterLevelAvailability), "%s/WateringController/waterlevel/availability", MQTT_PREFIX);
+}
+
+/// <summary>
+/// Serializes a JSON document straight into a reserved MQTT packet, without an
+/// intermediate payload String. Returns the packet id, or 0 when nothing was sent.
+/// </summary>
+static uint16_t publishJson(const char* topic, const JsonDocument& doc, uint8_t qos, bool retain,
+                            AsyncMqttClientInternals::OutPriority priority)
+{
+  const size_t length = measureJson(doc);
+  char* payload = mqttClient.beginPublish(topic, qos, retain, length, priority);
+  if (payload == nullptr)
+  {
+    return 0;
+  }
+
+  serializeJson(doc, payload, length);
+  return mqttClient.endPublish(length);
 }
 
-static void ensureOta()
+static void beginOta()
 {
-  if (!OTA_ENABLED || otaReady || WiFi.status() != WL_CONNECTED)
+  if (!OTA_ENABLED || otaReady)
   {
     return;
   }
@@ -163,21 +427,72 @@ static void ensureOta()
   otaReady = true;
 }
 
-static void ensureMqtt()
+/// <summary>
+/// Feeds WiFi and MQTT link events to the connectivity manager and runs its retry deadlines.
+/// </summary>
+static void syncConnectivity()
 {
-  if (mqttConnected || WiFi.status() != WL_CONNECTED)
+  const uint32_t now = millis();
+  const uint32_t wifiDrops = wifiLinkDrops;
+  if (wifiDrops != handledWifiLinkDrops)
   {
-    return;
+    handledWifiLinkDrops = wifiDrops;
+    connectivity.OnWifiDisconnected(now);
+  }
+  if (wifiLinkUp && connectivity.Wifi() != LinkState::Up)
+  {
+    connectivity.OnWifiConnected(now);
+    bootTimeline.Mark(BootPhase::WifiConnected, now);
+    beginOta();
   }
 
-  const uint32_t now = millis();
-  if (now - lastMqttAttemptMs < 5000)
+  const uint32_t mqttDrops = mqttLinkDrops;
+  if (mqttDrops != handledMqttLinkDrops)
+  {
+    handledMqttLinkDrops = mqttDrops;
+    connectivity.OnMqttDisconnected(now);
+  }
+  if (mqttConnected && connectivity.Mqtt() != LinkState::Up)
+  {
+    const uint32_t reconnects = connectivity.Stats().reconnects;
+    connectivity.OnMqttConnected(mqttConnectedAtMs);
+    const ConnectivityStats& stats = connectivity.Stats();
+    if (stats.reconnects != reconnects)
+    {
+      Serial.printf(
+        "MQTT back after %ums offline (%u reconnects, max %ums)\n",
+        static_cast<unsigned>(stats.lastReconnectMs),
+        static_cast<unsigned>(stats.reconnects),
+        static_cast<unsigned>(stats.maxReconnectMs));
+    }
+  }
+  connectivity.Step(now);
+}
+
+static void syncMqttSession()
+{
+  if (mqttConnected)
   {
+    bootTimeline.Mark(BootPhase::MqttConnected, mqttConnectedAtMs);
+    // A session the broker resumed still holds the subscription this boot sent.
+    const bool resumed = mqttSessionPresent && subscribedThisBoot;
+    if (!subscribedSinceConnect && (resumed || mqttClient.subscribe(topicWaterLevelCmd, 1) != 0))
+    {
+      subscribedSinceConnect = true;
+      subscribedThisBoot = true;
+      mqttClient.publish(topicWaterLevelAvailability, 1, true, MQTT_AVAILABILITY_ONLINE);
+      bootTimeline.Mark(BootPhase::Subscribed, millis());
+    }
     return;
   }
 
-  lastMqttAttemptMs = now;
-  mqttClient.connect();
+  publishedSinceConnect = false;
+  subscribedSinceConnect = false;
+  // Unacknowledged state and replay batches are sent again after the reconnect; a
+  // logged reading whose publish was not acknowledged is left to the replay.
+  stateAck.Reset();
+  historyPacketId = 0;
+  loggedPacketId = 0;
 }
 
 static void ensureTime()
@@ -190,90 +505,694 @@ static void ensureTime()
   }
 }
 
-static std::array<bool, 4> readSensors()
+static std::array<bool, SENSOR_COUNT> readSensors()
 {
-  std::array<bool, 4> sensors{ { false, false, false, false } };
-  for (int i = 0; i < 4; i++)
+  std::array<bool, SENSOR_COUNT> sensors{};
+  for (size_t i = 0; i < SENSOR_COUNT; i++)
   {
     sensors[i] = digitalRead(SENSOR_PINS[i]) == HIGH;
   }
   return sensors;
 }
 
-static void publishState(const std::array<bool, 4>& sensors)
+/// <summary>
+/// GPIO edge interrupt: records the new pin level and wakes loop(). All sensor
+/// interrupts run on the core that attached them, so the ring has a single producer.
+/// </summary>
+static void IRAM_ATTR onSensorEdge(void* arg)
 {
-  if (!mqttConnected)
+  const uint8_t sensor = static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg));
+  const SensorEdge edge{ static_cast<uint32_t>(micros()), sensor, digitalRead(SENSOR_PINS[sensor]) == HIGH };
+  sensorEdges.TryPush(edge);
+
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(loopTask, &higherPriorityTaskWoken);
+  if (higherPriorityTaskWoken)
   {
-    return;
+    portYIELD_FROM_ISR();
   }
+}
+
+static void drainSensorEdges()
+{
+  SensorEdge edge;
+  while (sensorEdges.TryPop(edge))
+  {
+    debouncer.OnEdge(edge);
+  }
+
+  if (sensorEdges.DroppedCount() != handledEdgeDrops)
+  {
+    // Lost edges leave the raw view behind the pins; resample them as fresh edges.
+    handledEdgeDrops = sensorEdges.DroppedCount();
+    const uint32_t nowUs = micros();
+    const std::array<bool, SENSOR_COUNT> sensors = readSensors();
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+    {
+      debouncer.OnEdge({ nowUs, i, sensors[i] });
+    }
+  }
+}
+
+/// <summary>
+/// Feeds the debounced state into the vote window at a fixed sample rate.
+/// </summary>
+static void sampleSensors(uint32_t nowMs)
+{
+  if (nowMs - lastSampleMs > LEVEL_SAMPLE_INTERVAL_MS * LEVEL_FILTER.voteWindow)
+  {
+    // After a stall, catching up would only replay the same state.
+    lastSampleMs = nowMs - LEVEL_SAMPLE_INTERVAL_MS;
+  }
+
+  while (nowMs - lastSampleMs >= LEVEL_SAMPLE_INTERVAL_MS)
+  {
+    logic.Filter(debouncer.Stable());
+    lastSampleMs += LEVEL_SAMPLE_INTERVAL_MS;
+  }
+}
+
+static uint32_t loopWaitMs(uint32_t nowMs)
+{
+  uint32_t waitMs = LOOP_IDLE_WAIT_MS;
+
+  const uint32_t sinceSampleMs = nowMs - lastSampleMs;
+  const uint32_t untilSampleMs = sinceSampleMs >= LEVEL_SAMPLE_INTERVAL_MS ? 0 : LEVEL_SAMPLE_INTERVAL_MS - sinceSampleMs;
+  waitMs = untilSampleMs < waitMs ? untilSampleMs : waitMs;
+
+  const uint32_t untilSettledUs = debouncer.UsUntilSettled(micros());
+  if (untilSettledUs != UINT32_MAX)
+  {
+    const uint32_t untilSettledMs = (untilSettledUs + 999) / 1000;
+    waitMs = untilSettledMs < waitMs ? untilSettledMs : waitMs;
+  }
+
+  return waitMs;
+}
 
-  WaterLevelSnapshot snapshot = logic.BuildSnapshot(sensors);
+/// <summary>
+/// Publishes a level snapshot; wakeToPublishMs is only sent by the deep-sleep node,
+/// publishToAckMs (the previous publish's ack latency) only by the awake node.
+/// Returns the packet id, or 0 when nothing was sent.
+/// </summary>
+static uint16_t publishSnapshot(const WaterLevelSnapshot<SENSOR_COUNT>& snapshot, int32_t wakeToPublishMs, int32_t publishToAckMs)
+{
   JsonDocument doc;
   doc["levelPercent"] = snapshot.levelPercent;
   JsonArray arr = doc["sensors"].to<JsonArray>();
-  for (int i = 0; i < 4; i++)
+  for (bool wet : snapshot.sensors)
+  {
+    arr.add(wet);
+  }
+  if (snapshot.levelLiters >= 0)
+  {
+    doc["levelLiters"] = snapshot.levelLiters;
+  }
+
+  if (wakeToPublishMs >= 0)
+  {
+    doc["wakeToPublishMs"] = wakeToPublishMs;
+    if (MQTT_TLS_CA_CERT != nullptr)
+    {
+      // Each wake boots afresh, so the last handshake is the one of this wake.
+      const AsyncMqttClientInternals::TlsHandshakeStats& tls = mqttClient.tlsStats();
+      doc["tlsHandshakeMs"] = tls.lastMs;
+      doc["tlsResumed"] = tls.lastResumed;
+      doc["tlsHeapBytes"] = tls.lastHeapBytes;
+    }
+  }
+  if (publishToAckMs >= 0)
+  {
+    doc["publishToAckMs"] = publishToAckMs;
+  }
+
+  const IsoTimestamp nowIso = isoUtcNow();
+  doc["measuredAt"] = nowIso.CStr();
+  doc["reportedAt"] = nowIso.CStr();
+
+  return publishJson(topicWaterLevel, doc, 1, true, AsyncMqttClientInternals::OutPriority::STATE);
+}
+
+/// <summary>
+/// Records a new filtered level in the history log. It stays pending (and is replayed
+/// later) until the PUBACK of packetId, the publish that carried it, is drained.
+/// </summary>
+static void logTransition(SensorMask<SENSOR_COUNT> mask, uint16_t packetId)
+{
+  if (transitionLogged && mask == loggedMask)
+  {
+    return;
+  }
+
+  const time_t now = time(nullptr);
+  if (!historyReady || now < CLOCK_SET_AFTER)
+  {
+    // Without a set clock the reading has no usable measuredAt.
+    return;
+  }
+
+  if (historyLog.Append(static_cast<uint32_t>(now), mask, false))
+  {
+    loggedMask = mask;
+    transitionLogged = true;
+    loggedSeq = historyLog.NewestSeq();
+    loggedPacketId = packetId;
+  }
+}
+
+/// <summary>
+/// Publishes the level and awaits its PUBACK; it is only marked published on the ack.
+/// Returns the packet id, or 0 when offline or refused.
+/// </summary>
+static uint16_t publishState(SensorMask<SENSOR_COUNT> mask, uint32_t nowMs)
+{
+  if (!mqttConnected)
+  {
+    return 0;
+  }
+
+  const int32_t publishToAckMs = stateAck.AckCount() > 0 ? static_cast<int32_t>(stateAck.LastLatencyMs()) : -1;
+  const uint16_t packetId = publishSnapshot(logic.BuildSnapshot(mask), -1, publishToAckMs);
+  stateAck.Sent(packetId, mask, nowMs);
+  if (packetId != 0)
+  {
+    publishedSinceConnect = true;
+    bootTimeline.Mark(BootPhase::FirstPublish, millis());
+  }
+  return packetId;
+}
+
+/// <summary>
+/// Commits acknowledged state publishes and replay batches.
+/// </summary>
+static void drainPublishAcks(uint32_t nowMs)
+{
+  uint16_t packetId;
+  while (publishAcks.TryPop(packetId))
+  {
+    PublishAck ack;
+    if (stateAck.Acked(packetId, nowMs, ack))
+    {
+      logic.MarkPublished(static_cast<SensorMask<SENSOR_COUNT>>(ack.value), ack.sentMs);
+      if (packetId == loggedPacketId && historyReady)
+      {
+        historyLog.MarkDelivered(loggedSeq);
+        loggedPacketId = 0;
+      }
+    }
+    else if (packetId == historyPacketId)
+    {
+      historyBatchAcked = true;
+    }
+  }
+}
+
+/// <summary>
+/// Publishes logged readings on waterlevel/history. requestId is null for a replay.
+/// </summary>
+static uint16_t publishHistory(const LevelReading* readings, size_t count, const char* requestId, bool complete)
+{
+  JsonDocument doc;
+  JsonArray entries = doc["readings"].to<JsonArray>();
+  for (size_t i = 0; i < count; i++)
+  {
+    const WaterLevelSnapshot<SENSOR_COUNT> snapshot =
+      logic.BuildSnapshot(static_cast<SensorMask<SENSOR_COUNT>>(readings[i].mask));
+    JsonObject entry = entries.add<JsonObject>();
+    entry["seq"] = readings[i].seq;
+    entry["levelPercent"] = snapshot.levelPercent;
+    JsonArray sensors = entry["sensors"].to<JsonArray>();
+    for (bool wet : snapshot.sensors)
+    {
+      sensors.add(wet);
+    }
+    if (snapshot.levelLiters >= 0)
+    {
+      entry["levelLiters"] = snapshot.levelLiters;
+    }
+    entry["measuredAt"] = FormatIsoUtc(static_cast<time_t>(readings[i].measuredAt)).CStr();
+  }
+
+  if (requestId != nullptr)
+  {
+    doc["requestId"] = requestId;
+    doc["complete"] = complete;
+  }
+  doc["reportedAt"] = isoUtcNow().CStr();
+
+  return publishJson(topicWaterLevelHistory, doc, 1, false, AsyncMqttClientInternals::OutPriority::STATE);
+}
+
+/// <summary>
+/// Replays readings logged while offline, one batch at a time: the next batch goes out
+/// once the broker has acknowledged the previous one.
+/// </summary>
+static void replayHistory(uint32_t nowMs)
+{
+  if (!historyReady || !mqttConnected)
+  {
+    return;
+  }
+
+  if (historyPacketId != 0)
   {
-    arr.add(snapshot.sensors[i]);
+    if (historyBatchAcked)
+    {
+      historyLog.MarkReplayed(historyBatchThroughSeq);
+      historyPacketId = 0;
+    }
+    else if (nowMs - historyBatchSentMs < LEVEL_HISTORY_ACK_TIMEOUT_MS)
+    {
+      return;
+    }
   }
 
-  const String nowIso = isoUtcNow();
-  doc["measuredAt"] = nowIso;
-  doc["reportedAt"] = nowIso;
+  if (!historyLog.HasPending())
+  {
+    return;
+  }
+
+  LevelReading batch[LEVEL_HISTORY_BATCH];
+  const size_t count = historyLog.NextBatch(batch, LEVEL_HISTORY_BATCH);
+  if (count == 0)
+  {
+    return;
+  }
 
-  String payload;
-  serializeJson(doc, payload);
-  mqttClient.publish(
-    topicWaterLevel().c_str(),
-    1,
-    true,
-    payload.c_str(),
-    payload.length());
+  historyBatchAcked = false;
+  historyBatchThroughSeq = batch[count - 1].seq;
+  historyBatchSentMs = nowMs;
+  historyPacketId = publishHistory(batch, count, nullptr, false);
 }
 
+/// <summary>
+/// Sends the next page of a history query once the previous one has left the out queue.
+/// </summary>
+static void serveHistoryQuery()
+{
+  if (!historyQueryPending || !mqttConnected || mqttClient.outQueue().queued() > 0)
+  {
+    return;
+  }
+
+  LevelReading page[LEVEL_HISTORY_BATCH];
+  const size_t count =
+    historyReady ? historyLog.Find(historyQuery.from, historyQuery.to, historyQuery.afterSeq, page, LEVEL_HISTORY_BATCH) : 0;
+  const bool complete = count < LEVEL_HISTORY_BATCH;
+  if (publishHistory(page, count, historyQuery.requestId, complete) == 0)
+  {
+    return;
+  }
+
+  if (complete)
+  {
+    historyQueryPending = false;
+    return;
+  }
+  historyQuery.afterSeq = page[count - 1].seq;
+}
+
+/// <summary>
+/// Runs on the MQTT task. Takes a history query when none is being served; a query
+/// that arrives meanwhile is ignored and has to be repeated.
+/// </summary>
+static void onMqttMessage(
+  char* topic,
+  char* payload,
+  AsyncMqttClientMessageProperties,
+  size_t len,
+  size_t index,
+  size_t total)
+{
+  // Commands are small; a payload split over several chunks is not one of ours.
+  if (index != 0 || len != total || strcmp(topic, topicWaterLevelCmd) != 0 || historyQueryPending)
+  {
+    return;
+  }
+
+  JsonDocument doc;
+  if (deserializeJson(doc, payload, len) || strcmp(doc["action"] | "", "history") != 0)
+  {
+    return;
+  }
+
+  HistoryQuery query{};
+  if (!ParseUtcTimestamp(doc["from"] | "", query.from) || !ParseUtcTimestamp(doc["to"] | "", query.to))
+  {
+    return;
+  }
+  strlcpy(query.requestId, doc["requestId"] | "", sizeof(query.requestId));
+  historyQuery = query;
+  historyQueryPending = true;
+}
+
+/// <summary>
+/// Adds handshake counts, durations and heap use of the TLS connections so far.
+/// </summary>
+static void addTlsStats(JsonObject target)
+{
+  const AsyncMqttClientInternals::TlsHandshakeStats& tls = mqttClient.tlsStats();
+  target["full"] = tls.full;
+  target["resumed"] = tls.resumed;
+  target["failed"] = tls.failed;
+  target["lastMs"] = tls.lastMs;
+  target["lastResumed"] = tls.lastResumed;
+  target["lastHeapBytes"] = tls.lastHeapBytes;
+  target["maxHeapBytes"] = tls.maxHeapBytes;
+  target["meanFullMs"] = tls.full == 0 ? 0 : static_cast<uint32_t>(tls.totalFullMs / tls.full);
+  target["maxFullMs"] = tls.maxFullMs;
+  target["meanResumedMs"] = tls.resumed == 0 ? 0 : static_cast<uint32_t>(tls.totalResumedMs / tls.resumed);
+  target["maxResumedMs"] = tls.maxResumedMs;
+  target["contextHeapBytes"] = tls.contextHeapBytes;
+  target["lastError"] = tls.lastError;
+}
+
+/// <summary>
+/// Publishes how long this boot took to reach each phase, once per boot.
+/// </summary>
+static void publishBootDiag()
+{
+  JsonDocument doc;
+  doc["resetReason"] = ResetReasonName(esp_reset_reason());
+  JsonArray phases = doc["phases"].to<JsonArray>();
+  for (size_t i = 0; i < BootTimeline::PHASE_COUNT; i++)
+  {
+    const BootPhase phase = static_cast<BootPhase>(i);
+    if (!bootTimeline.Has(phase))
+    {
+      continue;
+    }
+    JsonObject entry = phases.add<JsonObject>();
+    entry["name"] = BootTimeline::PhaseName(phase);
+    entry["atMs"] = bootTimeline.At(phase);
+    entry["stepMs"] = bootTimeline.SincePrevious(phase);
+  }
+  doc["mqttAttempts"] = bootTimeline.MqttAttempts();
+  if (MQTT_TLS_CA_CERT != nullptr)
+  {
+    addTlsStats(doc["tls"].to<JsonObject>());
+  }
+  doc["reportedAt"] = isoUtcNow().CStr();
+
+  publishJson(topicWaterLevelDiagBoot, doc, 1, true, AsyncMqttClientInternals::OutPriority::DIAGNOSTIC);
+  bootTimeline.MarkReported();
+  Serial.print("boot diag: ");
+  serializeJson(doc, Serial);
+  Serial.println();
+}
+
+#if LEVEL_DEEP_SLEEP
+static const LevelDutyCycleConfig DUTY_CYCLE_CONFIG{
+  PUBLISH_INTERVAL_MS,
+  PUBLISH_INTERVAL_MS,
+  60UL * 1000UL,
+  30UL * 1000UL,
+  5,
+  10,
+  1000,
+  6000,
+  { 5, 3, 0, 1 }
+};
+
+RTC_DATA_ATTR static LevelRtcState rtcState;
+static std::atomic<uint16_t> pendingPacketId{ 0 };
+static std::atomic<uint16_t> ackedPacketId{ 0 };
+static bool deepSleepMode = false;
+
+/// <summary>
+/// ESP32 side of the duty cycle: Wi-Fi fast connect, MQTT publish/ack, deep sleep.
+/// </summary>
+class EspLevelNodeHal : public LevelNodeHal
+{
+public:
+  uint32_t UptimeMs() override
+  {
+    return millis();
+  }
+
+  uint32_t RtcNowMs() override
+  {
+    // System time is kept by the RTC timer through deep sleep.
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    return static_cast<uint32_t>(static_cast<uint64_t>(now.tv_sec) * 1000ULL + now.tv_usec / 1000);
+  }
+
+  SensorMask<SENSOR_COUNT> ReadSensors() override
+  {
+    return WaterLevelLogic<SENSOR_COUNT>::ToMask(readSensors());
+  }
+
+  void BeginWifi(const WifiFastConnect& cached) override
+  {
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+    if (cached.valid)
+    {
+      WiFi.config(IPAddress(cached.ip), IPAddress(cached.gateway), IPAddress(cached.subnet), IPAddress(cached.dns));
+      WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str(), cached.channel, cached.bssid);
+      return;
+    }
+
+    WiFi.disconnect();
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str());
+  }
+
+  bool WifiConnected() override
+  {
+    return WiFi.status() == WL_CONNECTED;
+  }
+
+  void CaptureWifi(WifiFastConnect& cached) override
+  {
+    memcpy(cached.bssid, WiFi.BSSID(), sizeof(cached.bssid));
+    cached.channel = static_cast<uint8_t>(WiFi.channel());
+    cached.ip = static_cast<uint32_t>(WiFi.localIP());
+    cached.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+    cached.subnet = static_cast<uint32_t>(WiFi.subnetMask());
+    cached.dns = static_cast<uint32_t>(WiFi.dnsIP());
+  }
+
+  void BeginMqtt() override
+  {
+    mqttClient.connect();
+  }
+
+  bool MqttConnected() override
+  {
+    return mqttConnected;
+  }
+
+  bool Publish(const WaterLevelSnapshot<SENSOR_COUNT>& snapshot, uint32_t wakeToPublishMs) override
+  {
+    const uint16_t packetId = publishSnapshot(snapshot, static_cast<int32_t>(wakeToPublishMs), -1);
+    pendingPacketId = packetId;
+    return packetId != 0;
+  }
+
+  bool PublishAcked() override
+  {
+    return pendingPacketId != 0 && ackedPacketId == pendingPacketId;
+  }
+
+  void DeepSleep(uint32_t timerMs, SensorMask<SENSOR_COUNT> wakePins, bool wakeOnAnyHigh) override
+  {
+    Serial.printf(
+      "wake %u: publish %ums, ack %ums; sleeping %ums\n",
+      static_cast<unsigned>(rtcState.wakeCount),
+      static_cast<unsigned>(rtcState.lastWakeToPublishMs),
+      static_cast<unsigned>(rtcState.lastWakeToAckMs),
+      static_cast<unsigned>(timerMs));
+    Serial.flush();
+
+    mqttClient.disconnect(true);
+    WiFi.disconnect(true);
+    esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(timerMs) * 1000ULL);
+    uint64_t gpioMask = 0;
+    for (size_t i = 0; i < SENSOR_COUNT; i++)
+    {
+      if (wakePins & (1u << i))
+      {
+        gpioMask |= 1ULL << SENSOR_PINS[i];
+      }
+    }
+    if (gpioMask != 0)
+    {
+      esp_sleep_enable_ext1_wakeup(gpioMask, wakeOnAnyHigh ? ESP_EXT1_WAKEUP_ANY_HIGH : ESP_EXT1_WAKEUP_ANY_LOW);
+    }
+    esp_deep_sleep_start();
+  }
+};
+
+static EspLevelNodeHal nodeHal;
+static LevelDutyCycle dutyCycle(nodeHal, rtcState, DUTY_CYCLE_CONFIG);
+
+static WakeCause readWakeCause()
+{
+  switch (esp_sleep_get_wakeup_cause())
+  {
+    case ESP_SLEEP_WAKEUP_TIMER:
+      return WakeCause::Timer;
+    case ESP_SLEEP_WAKEUP_EXT1:
+      return WakeCause::SensorChange;
+    default:
+      return WakeCause::PowerOn;
+  }
+}
+#endif
+
 void setup()
 {
+  bootTimeline.Mark(BootPhase::Setup, millis());
   Serial.begin(115200);
-  for (int i = 0; i < 4; i++)
+  loopTask = xTaskGetCurrentTaskHandle();
+  for (size_t i = 0; i < SENSOR_COUNT; i++)
   {
     pinMode(SENSOR_PINS[i], INPUT);
   }
 
   loadWifiCredentials();
-
-  ensureWifi();
-  ensureOta();
-  ensureTime();
+  buildTopics();
   mqttClient.setServer(MQTT_HOST, MQTT_PORT);
   mqttClient.setCredentials(MQTT_USER, MQTT_PASS);
   mqttClient.setClientId(MQTT_CLIENT_ID);
-  mqttClient.onConnect([](bool) { mqttConnected = true; });
-  mqttClient.onDisconnect([](AsyncMqttClientDisconnectReason) { mqttConnected = false; });
+  mqttClient.setProtocolVersion(MQTT_PROTOCOL_VERSION);
+  if (MQTT_TLS_CA_CERT != nullptr)
+  {
+    mqttClient.setTls(MQTT_TLS_CA_CERT);
+    mqttClient.setTlsSessionRecord(&tlsSession);
+  }
+  mqttClient.onConnect([](bool sessionPresent)
+  {
+    mqttConnectedAtMs = millis();
+    mqttSessionPresent = sessionPresent;
+    mqttConnected = true;
+  });
+  mqttClient.onDisconnect([](AsyncMqttClientDisconnectReason)
+  {
+    mqttConnected = false;
+    mqttLinkDrops++;
+  });
+
+#if LEVEL_DEEP_SLEEP
+  // Without credentials the node stays awake so the config portal can run.
+  deepSleepMode = wifiSsid.length() > 0;
+  if (deepSleepMode)
+  {
+    mqttClient.onPublish([](uint16_t packetId) { ackedPacketId = packetId; });
+    ensureTime();
+    dutyCycle.Begin(readWakeCause());
+    return;
+  }
+#endif
+
+  // Awake nodes keep a persistent session and an availability will. A sleeping node
+  // drops its connection on purpose and is judged by staleness instead.
+  mqttClient.setCleanSession(false);
+  mqttClient.setSessionExpiry(MQTT_SESSION_EXPIRY_SECONDS);
+  mqttClient.setKeepAlive(MQTT_KEEP_ALIVE_SECONDS);
+  mqttClient.setWill(topicWaterLevelAvailability, 1, true, MQTT_AVAILABILITY_OFFLINE);
+
+  historyReady = historyStorage.Begin(LEVEL_HISTORY_DIR, LEVEL_HISTORY_SEGMENTS, LEVEL_HISTORY_SEGMENT_BYTES);
+  if (historyReady)
+  {
+    const size_t records = historyLog.Open();
+    Serial.printf("history log: %u records, %u corrupt\n", static_cast<unsigned>(records), static_cast<unsigned>(historyLog.Corrupt()));
+  }
+  else
+  {
+    Serial.println("History log unavailable; readings taken offline will be lost.");
+  }
+  mqttClient.onMessage(onMqttMessage);
+  mqttClient.onPublish([](uint16_t packetId)
+  {
+    publishAcks.TryPush(packetId);
+    xTaskNotifyGive(loopTask);
+  });
+
+  debouncer.Reset(readSensors());
+  logic.Filter(debouncer.Stable());
+  lastSampleMs = millis();
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+  {
+    attachInterruptArg(digitalPinToInterrupt(SENSOR_PINS[i]), onSensorEdge, reinterpret_cast<void*>(static_cast<uintptr_t>(i)), CHANGE);
+  }
+
+  // The connectivity manager owns every retry; the driver must not reconnect behind its back.
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t)
+  {
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+    {
+      wifiLinkUp = true;
+      xTaskNotifyGive(loopTask);
+    }
+    else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+    {
+      wifiLinkUp = false;
+      wifiLinkDrops++;
+      xTaskNotifyGive(loopTask);
+    }
+  });
+  connectivity.Begin(wifiSsid.length() > 0, millis());
+  ensureTime();
 }
 
 void loop()
 {
-  ensureWifi();
-  ensureOta();
+#if LEVEL_DEEP_SLEEP
+  if (deepSleepMode)
+  {
+    dutyCycle.Step();
+    delay(1);
+    return;
+  }
+#endif
+
+  syncConnectivity();
+  syncMqttSession();
   ensureTime();
-  ensureMqtt();
   ArduinoOTA.handle();
-
-  if (configPortalActive)
+  if (connectivity.PortalActive())
   {
     configServer.handleClient();
-    delay(10);
-    return;
   }
 
-  std::array<bool, 4> sensors = readSensors();
+  drainSensorEdges();
+  debouncer.Update(micros());
   const uint32_t nowMs = millis();
-  const bool changed = logic.HasChanged(sensors);
+  sampleSensors(nowMs);
+  drainPublishAcks(nowMs);
+  const SensorMask<SENSOR_COUNT> mask = logic.FilteredMask();
+  // Compared with the last level the broker acknowledged, so an unconfirmed change is retried.
+  const bool changed = logic.HasChanged(mask);
 
-  if (logic.ShouldPublish(changed, nowMs))
+  // An empty barrel is never held back by the rate limit; the pump relies on it.
+  const bool empty = changed && logic.BuildSnapshot(mask).levelPercent == 0;
+  // A new connection gets the current level right away instead of at the next interval.
+  const bool connectPublish = mqttConnected && !publishedSinceConnect;
+  // This level is already on its way; only an overdue ack sends it again.
+  const bool awaitingAck = stateAck.Pending() && stateAck.PendingValue() == mask && !stateAck.Overdue(nowMs);
+  uint16_t packetId = 0;
+  if (connectPublish || (!awaitingAck && (logic.ShouldPublish(changed, nowMs) || empty)))
+  {
+    packetId = publishState(mask, nowMs);
+  }
+  logTransition(mask, packetId);
+  replayHistory(nowMs);
+  serveHistoryQuery();
+  if (bootTimeline.ReportDue())
   {
-    publishState(sensors);
-    logic.MarkPublished(sensors, nowMs);
+    publishBootDiag();
   }
 
-  delay(50);
+  // Sleep until a sensor edge, the next settle deadline, the next sample or housekeeping.
+  uint32_t waitMs = connectivity.MsUntilNextStep(millis(), loopWaitMs(millis()));
+  if (connectivity.PortalActive() && waitMs > LOOP_PORTAL_WAIT_MS)
+  {
+    waitMs = LOOP_PORTAL_WAIT_MS;
+  }
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
 }
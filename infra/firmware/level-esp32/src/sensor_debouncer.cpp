@@ -0,0 +1,90 @@
+#include "sensor_debouncer.h"
+
+SensorDebouncer::SensorDebouncer(uint32_t settleUs)
+  : raw_{},
+    stable_{},
+    lastEdgeUs_{},
+    pendingMask_(0),
+    settleUs_(settleUs),
+    rejectedGlitches_(0)
+{
+}
+
+void SensorDebouncer::Reset(const std::array<bool, SENSOR_COUNT>& levels)
+{
+  raw_ = levels;
+  stable_ = levels;
+  pendingMask_ = 0;
+}
+
+void SensorDebouncer::OnEdge(const SensorEdge& edge)
+{
+  if (edge.sensor >= SENSOR_COUNT)
+  {
+    return;
+  }
+
+  const uint8_t bit = static_cast<uint8_t>(1u << edge.sensor);
+  raw_[edge.sensor] = edge.level;
+  lastEdgeUs_[edge.sensor] = edge.atUs;
+  if (edge.level != stable_[edge.sensor])
+  {
+    pendingMask_ |= bit;
+  }
+  else if (pendingMask_ & bit)
+  {
+    pendingMask_ &= static_cast<uint8_t>(~bit);
+    rejectedGlitches_++;
+  }
+}
+
+bool SensorDebouncer::Update(uint32_t nowUs)
+{
+  bool changed = false;
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+  {
+    const uint8_t bit = static_cast<uint8_t>(1u << i);
+    if ((pendingMask_ & bit) && (nowUs - lastEdgeUs_[i]) >= settleUs_)
+    {
+      stable_[i] = raw_[i];
+      pendingMask_ &= static_cast<uint8_t>(~bit);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+bool SensorDebouncer::HasPending() const
+{
+  return pendingMask_ != 0;
+}
+
+uint32_t SensorDebouncer::UsUntilSettled(uint32_t nowUs) const
+{
+  uint32_t earliest = UINT32_MAX;
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+  {
+    if (!(pendingMask_ & (1u << i)))
+    {
+      continue;
+    }
+
+    const uint32_t elapsedUs = nowUs - lastEdgeUs_[i];
+    const uint32_t remainingUs = elapsedUs >= settleUs_ ? 0 : settleUs_ - elapsedUs;
+    if (remainingUs < earliest)
+    {
+      earliest = remainingUs;
+    }
+  }
+  return earliest;
+}
+
+const std::array<bool, SENSOR_COUNT>& SensorDebouncer::Stable() const
+{
+  return stable_;
+}
+
+uint32_t SensorDebouncer::RejectedGlitches() const
+{
+  return rejectedGlitches_;
+}
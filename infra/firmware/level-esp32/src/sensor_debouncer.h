@@ -0,0 +1,56 @@
+#ifndef SENSOR_DEBOUNCER_H
+#define SENSOR_DEBOUNCER_H
+
+#include <array>
+#include <cstdint>
+
+static constexpr uint8_t SENSOR_COUNT = 4;
+
+/// <summary>
+/// One GPIO edge captured in the sensor interrupt.
+/// </summary>
+struct SensorEdge
+{
+  uint32_t atUs;
+  uint8_t sensor;
+  bool level;
+};
+
+/// <summary>
+/// Turns raw sensor edges into stable sensor states. A sensor only takes a new
+/// state after its input has been quiet for the settle time; pulses that return
+/// to the stable state earlier are rejected as glitches.
+/// </summary>
+class SensorDebouncer
+{
+public:
+  explicit SensorDebouncer(uint32_t settleUs);
+
+  void Reset(const std::array<bool, SENSOR_COUNT>& levels);
+  void OnEdge(const SensorEdge& edge);
+
+  /// <summary>
+  /// Commits every sensor that has settled by nowUs. Returns true if a stable state changed.
+  /// </summary>
+  bool Update(uint32_t nowUs);
+
+  bool HasPending() const;
+
+  /// <summary>
+  /// Time until the earliest pending sensor settles; 0 when one is due, UINT32_MAX when none is pending.
+  /// </summary>
+  uint32_t UsUntilSettled(uint32_t nowUs) const;
+
+  const std::array<bool, SENSOR_COUNT>& Stable() const;
+  uint32_t RejectedGlitches() const;
+
+private:
+  std::array<bool, SENSOR_COUNT> raw_;
+  std::array<bool, SENSOR_COUNT> stable_;
+  std::array<uint32_t, SENSOR_COUNT> lastEdgeUs_;
+  uint8_t pendingMask_;
+  uint32_t settleUs_;
+  uint32_t rejectedGlitches_;
+};
+
+#endif
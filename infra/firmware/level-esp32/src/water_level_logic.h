@@ -2,37 +2,468 @@
 #define WATER_LEVEL_LOGIC_H
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+
+/// <summary>
+/// Smallest unsigned type with one bit per sensor; bit i is sensor i (bottom → top).
+/// </summary>
+template <size_t N>
+using SensorMask = std::conditional_t<(N <= 8), uint8_t, std::conditional_t<(N <= 16), uint16_t, uint32_t>>;
 
 /// <summary>
 /// Snapshot of water level sensor readings.
 /// </summary>
+template <size_t N = 4>
 struct WaterLevelSnapshot
 {
-  std::array<bool, 4> sensors;
+  std::array<bool, N> sensors;
   int levelPercent;
+  // -1 when the calibration has no volume data.
+  int levelLiters;
+};
+
+/// <summary>
+/// How the sensor pattern maps to a level step. WetCount counts wet sensors;
+/// HighestWet uses the highest wet sensor and ignores dry gaps below it.
+/// </summary>
+enum class WaterLevelMode : uint8_t
+{
+  WetCount,
+  HighestWet
+};
+
+/// <summary>
+/// Percent and liters per level step. Step 0 is "no sensor wet"; step i is
+/// i wet sensors (WetCount) or sensor i-1 being the highest wet one (HighestWet).
+/// </summary>
+template <size_t N>
+struct WaterLevelCalibration
+{
+  std::array<uint8_t, N + 1> percent;
+  std::array<int32_t, N + 1> liters;
+};
+
+/// <summary>
+/// One point of the tank fill curve, measured from the tank bottom.
+/// </summary>
+struct TankFillPoint
+{
+  uint16_t heightMm;
+  uint32_t liters;
+};
+
+/// <summary>
+/// Evenly spaced sensors in a straight tank: step i is i * 100 / N percent.
+/// </summary>
+template <size_t N>
+constexpr WaterLevelCalibration<N> LinearCalibration()
+{
+  WaterLevelCalibration<N> calibration{};
+  for (size_t i = 0; i <= N; i++)
+  {
+    calibration.percent[i] = static_cast<uint8_t>((i * 100) / N);
+    calibration.liters[i] = -1;
+  }
+  return calibration;
+}
+
+template <size_t P>
+constexpr uint32_t TankLitersAt(const std::array<TankFillPoint, P>& fillCurve, uint16_t heightMm)
+{
+  if (heightMm <= fillCurve[0].heightMm)
+  {
+    return fillCurve[0].liters;
+  }
+
+  for (size_t i = 1; i < P; i++)
+  {
+    if (heightMm <= fillCurve[i].heightMm)
+    {
+      const TankFillPoint& low = fillCurve[i - 1];
+      const TankFillPoint& high = fillCurve[i];
+      const uint32_t spanMm = high.heightMm - low.heightMm;
+      return low.liters + static_cast<uint32_t>(
+        (static_cast<uint64_t>(high.liters - low.liters) * (heightMm - low.heightMm) + spanMm / 2) / spanMm);
+    }
+  }
+
+  return fillCurve[P - 1].liters;
+}
+
+/// <summary>
+/// Builds a calibration from sensor mount heights and the tank fill curve, so a
+/// non-cylindrical tank reports volume-correct percent. A sensor reading wet means
+/// the water reaches at least its height; below the lowest sensor counts as empty.
+/// </summary>
+template <size_t N, size_t P>
+constexpr WaterLevelCalibration<N> CalibrationFromHeights(
+  const std::array<uint16_t, N>& sensorHeightsMm,
+  const std::array<TankFillPoint, P>& fillCurve)
+{
+  static_assert(P >= 2, "The fill curve needs at least two points");
+
+  WaterLevelCalibration<N> calibration{};
+  const uint32_t capacityLiters = fillCurve[P - 1].liters;
+  for (size_t i = 0; i < N; i++)
+  {
+    const uint32_t liters = TankLitersAt(fillCurve, sensorHeightsMm[i]);
+    const uint32_t percent = capacityLiters == 0 ? 0 : (liters * 100 + capacityLiters / 2) / capacityLiters;
+    calibration.liters[i + 1] = static_cast<int32_t>(liters);
+    calibration.percent[i + 1] = static_cast<uint8_t>(percent > 100 ? 100 : percent);
+  }
+  return calibration;
+}
+
+/// <summary>
+/// Slosh filter and change-publish rate limit. The defaults disable both.
+/// </summary>
+struct WaterLevelFilterConfig
+{
+  // Samples kept per sensor (1..16).
+  uint8_t voteWindow = 1;
+  // Samples within the window that must disagree before a sensor flips. A value
+  // above voteWindow / 2 + 1 adds hysteresis on top of the majority vote.
+  uint8_t voteThreshold = 1;
+  // Token bucket for change publishes: one token per spacing, at most burst tokens. 0 = unlimited.
+  uint32_t publishSpacingMs = 0;
+  uint8_t publishBurst = 1;
 };
 
 /// <summary>
-/// Encapsulates water level change detection and publish timing.
+/// Encapsulates water level change detection and publish timing for N sensors.
+/// Sensor state is kept as a SensorMask; the std::array overloads pack and unpack it.
 /// </summary>
+template <size_t N = 4>
 class WaterLevelLogic
 {
+  static_assert(N >= 1 && N <= 32, "WaterLevelLogic supports 1 to 32 sensors");
+
 public:
+  using Mask = SensorMask<N>;
+  using Sensors = std::array<bool, N>;
+
   explicit WaterLevelLogic(uint32_t publishIntervalMs);
+  WaterLevelLogic(uint32_t publishIntervalMs, const WaterLevelFilterConfig& filter);
+  WaterLevelLogic(
+    uint32_t publishIntervalMs,
+    const WaterLevelFilterConfig& filter,
+    const WaterLevelCalibration<N>& calibration,
+    WaterLevelMode mode);
 
-  WaterLevelSnapshot BuildSnapshot(const std::array<bool, 4>& sensors) const;
-  bool HasChanged(const std::array<bool, 4>& sensors) const;
+  static Mask ToMask(const Sensors& sensors);
+  static Sensors ToSensors(Mask mask);
+
+  /// <summary>
+  /// Adds one sample to the vote window and returns the filtered sensor states.
+  /// </summary>
+  Sensors Filter(const Sensors& sample);
+  Mask FilterMask(Mask sample);
+
+  WaterLevelSnapshot<N> BuildSnapshot(const Sensors& sensors) const;
+  WaterLevelSnapshot<N> BuildSnapshot(Mask mask) const;
+  size_t LevelStep(Mask mask) const;
+
+  bool HasChanged(const Sensors& sensors) const;
+  bool HasChanged(Mask mask) const;
+
+  /// <summary>
+  /// Change publishes need a token from the bucket; periodic publishes are never limited.
+  /// </summary>
   bool ShouldPublish(bool changed, uint32_t nowMs) const;
-  void MarkPublished(const std::array<bool, 4>& sensors, uint32_t nowMs);
+  void MarkPublished(const Sensors& sensors, uint32_t nowMs);
+  void MarkPublished(Mask mask, uint32_t nowMs);
+
+  /// <summary>
+  /// Restores the last published state, e.g. from RTC memory after a deep-sleep wake.
+  /// </summary>
+  void Restore(Mask lastMask, uint32_t lastPublishMs);
+
+  /// <summary>
+  /// Time until the bucket holds a token again; 0 when a change can be published now.
+  /// </summary>
+  uint32_t MsUntilChangePublishAllowed(uint32_t nowMs) const;
 
-  const std::array<bool, 4>& LastSensors() const;
+  Sensors LastSensors() const;
+  Mask LastMask() const;
+  Sensors FilteredSensors() const;
+  Mask FilteredMask() const;
   uint32_t LastPublishMs() const;
 
 private:
-  std::array<bool, 4> lastSensors_;
+  uint8_t AvailableTokens(uint32_t nowMs) const;
+
+  Mask lastMask_;
   uint32_t lastPublishMs_;
   uint32_t publishIntervalMs_;
+  WaterLevelFilterConfig filter_;
+  WaterLevelCalibration<N> calibration_;
+  WaterLevelMode mode_;
+  std::array<uint16_t, N> history_;
+  Mask filteredMask_;
+  bool hasSamples_;
+  uint8_t tokens_;
+  uint32_t lastRefillMs_;
 };
 
+template <size_t N>
+WaterLevelLogic<N>::WaterLevelLogic(uint32_t publishIntervalMs)
+  : WaterLevelLogic(publishIntervalMs, WaterLevelFilterConfig{})
+{
+}
+
+template <size_t N>
+WaterLevelLogic<N>::WaterLevelLogic(uint32_t publishIntervalMs, const WaterLevelFilterConfig& filter)
+  : WaterLevelLogic(publishIntervalMs, filter, LinearCalibration<N>(), WaterLevelMode::WetCount)
+{
+}
+
+template <size_t N>
+WaterLevelLogic<N>::WaterLevelLogic(
+  uint32_t publishIntervalMs,
+  const WaterLevelFilterConfig& filter,
+  const WaterLevelCalibration<N>& calibration,
+  WaterLevelMode mode)
+  : lastMask_(0),
+    lastPublishMs_(0),
+    publishIntervalMs_(publishIntervalMs),
+    filter_(filter),
+    calibration_(calibration),
+    mode_(mode),
+    history_{},
+    filteredMask_(0),
+    hasSamples_(false),
+    tokens_(0),
+    lastRefillMs_(0)
+{
+  if (filter_.voteWindow < 1)
+  {
+    filter_.voteWindow = 1;
+  }
+  if (filter_.voteWindow > 16)
+  {
+    filter_.voteWindow = 16;
+  }
+  if (filter_.voteThreshold < 1)
+  {
+    filter_.voteThreshold = 1;
+  }
+  if (filter_.voteThreshold > filter_.voteWindow)
+  {
+    filter_.voteThreshold = filter_.voteWindow;
+  }
+  if (filter_.publishBurst < 1)
+  {
+    filter_.publishBurst = 1;
+  }
+  tokens_ = filter_.publishBurst;
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Mask WaterLevelLogic<N>::ToMask(const Sensors& sensors)
+{
+  Mask mask = 0;
+  for (size_t i = 0; i < N; i++)
+  {
+    if (sensors[i])
+    {
+      mask = static_cast<Mask>(mask | (Mask{ 1 } << i));
+    }
+  }
+  return mask;
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Sensors WaterLevelLogic<N>::ToSensors(Mask mask)
+{
+  Sensors sensors{};
+  for (size_t i = 0; i < N; i++)
+  {
+    sensors[i] = ((mask >> i) & 1u) != 0;
+  }
+  return sensors;
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Sensors WaterLevelLogic<N>::Filter(const Sensors& sample)
+{
+  return ToSensors(FilterMask(ToMask(sample)));
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Mask WaterLevelLogic<N>::FilterMask(Mask sample)
+{
+  const uint16_t windowMask = static_cast<uint16_t>((1u << filter_.voteWindow) - 1);
+  for (size_t i = 0; i < N; i++)
+  {
+    const Mask bit = static_cast<Mask>(Mask{ 1 } << i);
+    const bool wet = (sample & bit) != 0;
+    if (!hasSamples_)
+    {
+      // The first sample fills the whole window so start-up is not delayed.
+      history_[i] = wet ? windowMask : 0;
+      continue;
+    }
+
+    history_[i] = static_cast<uint16_t>(((history_[i] << 1) | (wet ? 1 : 0)) & windowMask);
+    const uint8_t wetSamples = static_cast<uint8_t>(__builtin_popcount(history_[i]));
+    const bool filteredWet = (filteredMask_ & bit) != 0;
+    const uint8_t disagreeing = filteredWet ? static_cast<uint8_t>(filter_.voteWindow - wetSamples) : wetSamples;
+    if (disagreeing >= filter_.voteThreshold)
+    {
+      filteredMask_ = static_cast<Mask>(filteredMask_ ^ bit);
+    }
+  }
+
+  if (!hasSamples_)
+  {
+    filteredMask_ = sample;
+    hasSamples_ = true;
+  }
+  return filteredMask_;
+}
+
+template <size_t N>
+size_t WaterLevelLogic<N>::LevelStep(Mask mask) const
+{
+  if (mode_ == WaterLevelMode::HighestWet)
+  {
+    return mask == 0 ? 0 : 32 - static_cast<size_t>(__builtin_clz(static_cast<uint32_t>(mask)));
+  }
+
+  return static_cast<size_t>(__builtin_popcount(static_cast<uint32_t>(mask)));
+}
+
+template <size_t N>
+WaterLevelSnapshot<N> WaterLevelLogic<N>::BuildSnapshot(const Sensors& sensors) const
+{
+  return BuildSnapshot(ToMask(sensors));
+}
+
+template <size_t N>
+WaterLevelSnapshot<N> WaterLevelLogic<N>::BuildSnapshot(Mask mask) const
+{
+  const size_t step = LevelStep(mask);
+  WaterLevelSnapshot<N> snapshot;
+  snapshot.sensors = ToSensors(mask);
+  snapshot.levelPercent = calibration_.percent[step];
+  snapshot.levelLiters = calibration_.liters[step];
+  return snapshot;
+}
+
+template <size_t N>
+bool WaterLevelLogic<N>::HasChanged(const Sensors& sensors) const
+{
+  return HasChanged(ToMask(sensors));
+}
+
+template <size_t N>
+bool WaterLevelLogic<N>::HasChanged(Mask mask) const
+{
+  return mask != lastMask_;
+}
+
+template <size_t N>
+bool WaterLevelLogic<N>::ShouldPublish(bool changed, uint32_t nowMs) const
+{
+  if (changed && AvailableTokens(nowMs) > 0)
+  {
+    return true;
+  }
+
+  return (nowMs - lastPublishMs_) >= publishIntervalMs_;
+}
+
+template <size_t N>
+void WaterLevelLogic<N>::MarkPublished(const Sensors& sensors, uint32_t nowMs)
+{
+  MarkPublished(ToMask(sensors), nowMs);
+}
+
+template <size_t N>
+void WaterLevelLogic<N>::MarkPublished(Mask mask, uint32_t nowMs)
+{
+  if (filter_.publishSpacingMs > 0 && mask != lastMask_)
+  {
+    const uint8_t available = AvailableTokens(nowMs);
+    if (available >= filter_.publishBurst)
+    {
+      lastRefillMs_ = nowMs;
+    }
+    else
+    {
+      lastRefillMs_ += static_cast<uint32_t>(available - tokens_) * filter_.publishSpacingMs;
+    }
+    tokens_ = available > 0 ? static_cast<uint8_t>(available - 1) : 0;
+  }
+
+  lastMask_ = mask;
+  lastPublishMs_ = nowMs;
+}
+
+template <size_t N>
+void WaterLevelLogic<N>::Restore(Mask lastMask, uint32_t lastPublishMs)
+{
+  lastMask_ = lastMask;
+  lastPublishMs_ = lastPublishMs;
+}
+
+template <size_t N>
+uint32_t WaterLevelLogic<N>::MsUntilChangePublishAllowed(uint32_t nowMs) const
+{
+  if (AvailableTokens(nowMs) > 0)
+  {
+    return 0;
+  }
+
+  return filter_.publishSpacingMs - (nowMs - lastRefillMs_);
+}
+
+template <size_t N>
+uint8_t WaterLevelLogic<N>::AvailableTokens(uint32_t nowMs) const
+{
+  if (filter_.publishSpacingMs == 0)
+  {
+    return filter_.publishBurst;
+  }
+
+  const uint32_t refilled = (nowMs - lastRefillMs_) / filter_.publishSpacingMs;
+  const uint32_t available = tokens_ + refilled;
+  return available >= filter_.publishBurst ? filter_.publishBurst : static_cast<uint8_t>(available);
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Sensors WaterLevelLogic<N>::LastSensors() const
+{
+  return ToSensors(lastMask_);
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Mask WaterLevelLogic<N>::LastMask() const
+{
+  return lastMask_;
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Sensors WaterLevelLogic<N>::FilteredSensors() const
+{
+  return ToSensors(filteredMask_);
+}
+
+template <size_t N>
+typename WaterLevelLogic<N>::Mask WaterLevelLogic<N>::FilteredMask() const
+{
+  return filteredMask_;
+}
+
+template <size_t N>
+uint32_t WaterLevelLogic<N>::LastPublishMs() const
+{
+  return lastPublishMs_;
+}
+
+// The 4-sensor node is compiled once in water_level_logic.cpp.
+extern template class WaterLevelLogic<4>;
+
 #endif
@@ -0,0 +1,312 @@
+#include <unity.h>
+#include <cstring>
+#include "level_duty_cycle.h"
+
+/// <summary>
+/// Scripted node: connection and ack latencies are given in ms after the matching Begin call.
+/// </summary>
+class FakeHal : public LevelNodeHal
+{
+public:
+  uint32_t UptimeMs() override { return uptimeMs; }
+  uint32_t RtcNowMs() override { return rtcMs; }
+
+  SensorMask<SENSOR_COUNT> ReadSensors() override
+  {
+    reads++;
+    return sampleIndex < sampleCount ? samples[sampleIndex++] : sensors;
+  }
+
+  void BeginWifi(const WifiFastConnect& cached) override
+  {
+    wifiBegins++;
+    lastBeginFast = cached.valid;
+    wifiUpAtMs = uptimeMs + (cached.valid ? (fastConnectWorks ? fastConnectMs : 0xFFFFFFFFu - uptimeMs) : fullConnectMs);
+  }
+
+  bool WifiConnected() override { return uptimeMs >= wifiUpAtMs; }
+
+  void CaptureWifi(WifiFastConnect& cached) override
+  {
+    captures++;
+    cached.channel = 6;
+    cached.ip = 0x0A00000Au;
+    const uint8_t bssid[6] = { 1, 2, 3, 4, 5, 6 };
+    memcpy(cached.bssid, bssid, sizeof(bssid));
+  }
+
+  void BeginMqtt() override { mqttUpAtMs = uptimeMs + mqttConnectMs; }
+  bool MqttConnected() override { return uptimeMs >= mqttUpAtMs; }
+
+  bool Publish(const WaterLevelSnapshot<SENSOR_COUNT>& snapshot, uint32_t wakeToPublishMs) override
+  {
+    publishes++;
+    publishedPercent = snapshot.levelPercent;
+    publishedWakeToPublishMs = wakeToPublishMs;
+    ackAtMs = uptimeMs + ackMs;
+    return true;
+  }
+
+  bool PublishAcked() override { return acksWork && uptimeMs >= ackAtMs; }
+
+  void DeepSleep(uint32_t timerMs, SensorMask<SENSOR_COUNT> wakePins, bool wakeOnAnyHigh) override
+  {
+    sleeps++;
+    sleepTimerMs = timerMs;
+    sleepWakePins = wakePins;
+    sleepOnAnyHigh = wakeOnAnyHigh;
+    sleptAtUptimeMs = uptimeMs;
+    sleptAtRtcMs = rtcMs;
+  }
+
+  /// <summary>
+  /// Starts a new wake after sleeping for the armed timer (or less).
+  /// </summary>
+  void Wake(uint32_t sleptMs)
+  {
+    rtcMs += sleptMs;
+    uptimeMs = 0;
+    sampleIndex = 0;
+    sampleCount = 0;
+    wifiUpAtMs = 0xFFFFFFFFu;
+    mqttUpAtMs = 0xFFFFFFFFu;
+  }
+
+  uint32_t uptimeMs = 0;
+  uint32_t rtcMs = 1000;
+  SensorMask<SENSOR_COUNT> sensors = 0x3;
+  SensorMask<SENSOR_COUNT> samples[8] = {};
+  int sampleCount = 0;
+  int sampleIndex = 0;
+  uint32_t fullConnectMs = 1800;
+  uint32_t fastConnectMs = 250;
+  bool fastConnectWorks = true;
+  uint32_t mqttConnectMs = 40;
+  uint32_t ackMs = 15;
+  bool acksWork = true;
+
+  uint32_t wifiUpAtMs = 0xFFFFFFFFu;
+  uint32_t mqttUpAtMs = 0xFFFFFFFFu;
+  uint32_t ackAtMs = 0xFFFFFFFFu;
+  int reads = 0;
+  int wifiBegins = 0;
+  bool lastBeginFast = false;
+  int captures = 0;
+  int publishes = 0;
+  int publishedPercent = -1;
+  uint32_t publishedWakeToPublishMs = 0;
+  int sleeps = 0;
+  uint32_t sleepTimerMs = 0;
+  SensorMask<SENSOR_COUNT> sleepWakePins = 0;
+  bool sleepOnAnyHigh = false;
+  uint32_t sleptAtUptimeMs = 0;
+  uint32_t sleptAtRtcMs = 0;
+};
+
+static LevelDutyCycleConfig testConfig()
+{
+  LevelDutyCycleConfig config{};
+  config.publishIntervalMs = 300000;
+  config.checkIntervalMs = 120000;
+  config.retryIntervalMs = 60000;
+  config.sensorLockoutMs = 30000;
+  config.sampleCount = 5;
+  config.sampleSpacingMs = 10;
+  config.fastConnectTimeoutMs = 1000;
+  config.awakeBudgetMs = 5000;
+  config.filter.voteWindow = 5;
+  config.filter.voteThreshold = 3;
+  return config;
+}
+
+/// <summary>
+/// Runs one wake until the node sleeps, advancing both clocks 1 ms per step.
+/// </summary>
+static void runWake(LevelDutyCycle& cycle, FakeHal& hal, WakeCause cause)
+{
+  cycle.Begin(cause);
+  for (int i = 0; i < 20000 && cycle.State() != DutyCycleState::Sleeping; i++)
+  {
+    cycle.Step();
+    hal.uptimeMs++;
+    hal.rtcMs++;
+  }
+  TEST_ASSERT_TRUE(cycle.State() == DutyCycleState::Sleeping);
+}
+
+void test_power_on_publishes_and_caches_wifi()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+
+  runWake(cycle, hal, WakeCause::PowerOn);
+  TEST_ASSERT_EQUAL_INT(1, hal.publishes);
+  TEST_ASSERT_EQUAL_INT(50, hal.publishedPercent);
+  TEST_ASSERT_FALSE(hal.lastBeginFast);
+  TEST_ASSERT_EQUAL_INT(1, hal.captures);
+  TEST_ASSERT_TRUE(rtc.wifi.valid);
+  TEST_ASSERT_TRUE(rtc.hasPublished);
+  TEST_ASSERT_EQUAL_UINT32(0x3, rtc.lastMask);
+  TEST_ASSERT_EQUAL_UINT32(hal.publishedWakeToPublishMs, rtc.lastWakeToPublishMs);
+  TEST_ASSERT_EQUAL_UINT32(hal.publishedWakeToPublishMs + 15, rtc.lastWakeToAckMs);
+
+  // Next check is the sooner of the check interval and the periodic publish.
+  TEST_ASSERT_EQUAL_UINT32(120000, hal.sleepTimerMs);
+  TEST_ASSERT_EQUAL_UINT32(0x3, hal.sleepWakePins);
+  TEST_ASSERT_FALSE(hal.sleepOnAnyHigh);
+}
+
+void test_timer_wake_without_change_skips_wifi()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+  runWake(cycle, hal, WakeCause::PowerOn);
+
+  hal.Wake(hal.sleepTimerMs);
+  runWake(cycle, hal, WakeCause::Timer);
+  TEST_ASSERT_EQUAL_INT(1, hal.wifiBegins);
+  TEST_ASSERT_EQUAL_INT(1, hal.publishes);
+  TEST_ASSERT_EQUAL_UINT32(4 * 10, hal.sleptAtUptimeMs);
+  TEST_ASSERT_EQUAL_INT(2, static_cast<int>(rtc.wakeCount));
+
+  TEST_ASSERT_EQUAL_UINT32(120000, hal.sleepTimerMs);
+
+  // The last timer before the periodic publish is shortened to land on it.
+  hal.Wake(hal.sleepTimerMs);
+  runWake(cycle, hal, WakeCause::Timer);
+  TEST_ASSERT_EQUAL_INT(1, hal.publishes);
+  TEST_ASSERT_EQUAL_UINT32(300000 - (hal.sleptAtRtcMs - rtc.lastPublishMs), hal.sleepTimerMs);
+
+  hal.Wake(hal.sleepTimerMs);
+  runWake(cycle, hal, WakeCause::Timer);
+  TEST_ASSERT_EQUAL_INT(2, hal.publishes);
+  TEST_ASSERT_TRUE(hal.lastBeginFast);
+}
+
+void test_sensor_wake_publishes_through_fast_connect()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+  runWake(cycle, hal, WakeCause::PowerOn);
+  const uint32_t fullWakeToPublishMs = rtc.lastWakeToPublishMs;
+
+  hal.sensors = 0x1;
+  hal.Wake(5000);
+  runWake(cycle, hal, WakeCause::SensorChange);
+  TEST_ASSERT_EQUAL_INT(2, hal.publishes);
+  TEST_ASSERT_TRUE(hal.lastBeginFast);
+  TEST_ASSERT_EQUAL_INT(25, hal.publishedPercent);
+  TEST_ASSERT_EQUAL_INT(1, hal.captures);
+  TEST_ASSERT_LESS_THAN(fullWakeToPublishMs, rtc.lastWakeToPublishMs);
+  // 5 samples + fast connect + MQTT connect.
+  TEST_ASSERT_LESS_OR_EQUAL(40 + 250 + 40 + 2, rtc.lastWakeToPublishMs);
+}
+
+void test_failed_fast_connect_falls_back_and_recaches()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+  runWake(cycle, hal, WakeCause::PowerOn);
+
+  hal.fastConnectWorks = false;
+  hal.sensors = 0x7;
+  hal.Wake(5000);
+  runWake(cycle, hal, WakeCause::SensorChange);
+  TEST_ASSERT_EQUAL_INT(3, hal.wifiBegins);
+  TEST_ASSERT_FALSE(hal.lastBeginFast);
+  TEST_ASSERT_EQUAL_INT(2, hal.captures);
+  TEST_ASSERT_TRUE(rtc.wifi.valid);
+  TEST_ASSERT_EQUAL_INT(2, hal.publishes);
+}
+
+void test_sloshing_sensor_wake_falls_back_to_timer()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+  runWake(cycle, hal, WakeCause::PowerOn);
+
+  // Woken by a wave: one low sample, then the sensor reads wet again.
+  hal.samples[0] = 0x1;
+  hal.samples[1] = 0x3;
+  hal.samples[2] = 0x3;
+  hal.samples[3] = 0x1;
+  hal.samples[4] = 0x3;
+  hal.Wake(2000);
+  hal.sampleCount = 5;
+  runWake(cycle, hal, WakeCause::SensorChange);
+
+  TEST_ASSERT_EQUAL_INT(1, hal.publishes);
+  TEST_ASSERT_EQUAL_UINT32(0, hal.sleepWakePins);
+  TEST_ASSERT_EQUAL_UINT32(30000, hal.sleepTimerMs);
+}
+
+void test_empty_tank_arms_rising_wake_and_bypasses_interval()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+  runWake(cycle, hal, WakeCause::PowerOn);
+
+  hal.sensors = 0;
+  hal.Wake(1000);
+  runWake(cycle, hal, WakeCause::SensorChange);
+  TEST_ASSERT_EQUAL_INT(2, hal.publishes);
+  TEST_ASSERT_EQUAL_INT(0, hal.publishedPercent);
+  TEST_ASSERT_EQUAL_UINT32(0xF, hal.sleepWakePins);
+  TEST_ASSERT_TRUE(hal.sleepOnAnyHigh);
+}
+
+void test_awake_budget_sleeps_and_retries_next_wake()
+{
+  FakeHal hal;
+  hal.acksWork = false;
+  LevelRtcState rtc{};
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+  runWake(cycle, hal, WakeCause::PowerOn);
+
+  TEST_ASSERT_EQUAL_UINT32(5000, hal.sleptAtUptimeMs);
+  TEST_ASSERT_EQUAL_UINT32(60000, hal.sleepTimerMs);
+  TEST_ASSERT_FALSE(rtc.hasPublished);
+
+  hal.acksWork = true;
+  hal.Wake(hal.sleepTimerMs);
+  runWake(cycle, hal, WakeCause::Timer);
+  TEST_ASSERT_EQUAL_INT(2, hal.publishes);
+  TEST_ASSERT_TRUE(rtc.hasPublished);
+}
+
+void test_rtc_state_is_reset_on_power_on_or_bad_magic()
+{
+  FakeHal hal;
+  LevelRtcState rtc{};
+  rtc.magic = 0x12345678u;
+  rtc.hasPublished = true;
+  rtc.lastMask = 0x3;
+  rtc.wifi.valid = true;
+  LevelDutyCycle cycle(hal, rtc, testConfig());
+
+  runWake(cycle, hal, WakeCause::Timer);
+  TEST_ASSERT_EQUAL_UINT32(LEVEL_RTC_MAGIC, rtc.magic);
+  TEST_ASSERT_EQUAL_INT(1, static_cast<int>(rtc.wakeCount));
+  TEST_ASSERT_FALSE(hal.lastBeginFast);
+  TEST_ASSERT_EQUAL_INT(1, hal.publishes);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_power_on_publishes_and_caches_wifi);
+  RUN_TEST(test_timer_wake_without_change_skips_wifi);
+  RUN_TEST(test_sensor_wake_publishes_through_fast_connect);
+  RUN_TEST(test_failed_fast_connect_falls_back_and_recaches);
+  RUN_TEST(test_sloshing_sensor_wake_falls_back_to_timer);
+  RUN_TEST(test_empty_tank_arms_rising_wake_and_bypasses_interval);
+  RUN_TEST(test_awake_budget_sleeps_and_retries_next_wake);
+  RUN_TEST(test_rtc_state_is_reset_on_power_on_or_bad_magic);
+  return UNITY_END();
+}
@@ -0,0 +1,355 @@
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "level_history_log.h"
+
+/// <summary>
+/// Flash stand-in with segments that grow as they are written. A power cut can be
+/// scheduled to land in the middle of a write: only the first tornBytes of that
+/// write reach the store, the rest of the slot is left blank.
+/// </summary>
+class FakeStorage : public LevelLogStorage
+{
+public:
+  FakeStorage(size_t segmentCount, size_t slotsPerSegment)
+    : segments(segmentCount),
+      segmentSize(slotsPerSegment * LevelHistoryLog::RECORD_SIZE)
+  {
+  }
+
+  size_t SegmentCount() const override
+  {
+    return segments.size();
+  }
+
+  size_t SegmentSize() const override
+  {
+    return segmentSize;
+  }
+
+  bool Read(size_t segment, size_t offset, uint8_t* data, size_t length) override
+  {
+    if (segment >= segments.size() || offset + length > segments[segment].size())
+    {
+      return false;
+    }
+    memcpy(data, &segments[segment][offset], length);
+    return true;
+  }
+
+  bool Write(size_t segment, size_t offset, const uint8_t* data, size_t length) override
+  {
+    writes++;
+    if (segment >= segments.size() || offset + length > segmentSize || powerCut)
+    {
+      return false;
+    }
+    std::vector<uint8_t>& bytes = segments[segment];
+    if (offset < bytes.size())
+    {
+      rewrites++;
+    }
+    if (bytes.size() < offset + length)
+    {
+      bytes.resize(offset + length, 0);
+    }
+    if (cutAfterWrites > 0 && writes == cutAfterWrites)
+    {
+      memset(&bytes[offset], 0, length);
+      memcpy(&bytes[offset], data, tornBytes);
+      powerCut = true;
+      return false;
+    }
+    memcpy(&bytes[offset], data, length);
+    return true;
+  }
+
+  bool Erase(size_t segment) override
+  {
+    erases++;
+    segments[segment].clear();
+    return true;
+  }
+
+  std::vector<std::vector<uint8_t>> segments;
+  size_t segmentSize;
+  size_t writes = 0;
+  // Writes that did not land at the end of their segment.
+  size_t rewrites = 0;
+  size_t erases = 0;
+  size_t cutAfterWrites = 0;
+  size_t tornBytes = 0;
+  bool powerCut = false;
+};
+
+static const uint32_t T0 = 1768460100;  // 2026-01-15T06:55:00Z
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_empty_store_opens_empty()
+{
+  FakeStorage erased(2, 5);
+  LevelHistoryLog log(erased);
+  TEST_ASSERT_EQUAL_UINT32(0, log.Open());
+  TEST_ASSERT_EQUAL_UINT32(10, log.Capacity());
+  TEST_ASSERT_FALSE(log.HasPending());
+
+  FakeStorage zeroed(2, 5);
+  zeroed.segments[0].assign(zeroed.segmentSize, 0);
+  LevelHistoryLog zeroedLog(zeroed);
+  TEST_ASSERT_EQUAL_UINT32(0, zeroedLog.Open());
+  TEST_ASSERT_EQUAL_UINT32(0, zeroedLog.Corrupt());
+}
+
+void test_record_layout()
+{
+  FakeStorage storage(1, 4);
+  LevelHistoryLog log(storage);
+  log.Open();
+  TEST_ASSERT_TRUE(log.Append(T0, 0x3, false));
+
+  // Seq 1 lands in slot 1.
+  const uint8_t expected[16] = { 0x4C, 1, 0, 0, 1, 0, 0, 0, 0x44, 0x8F, 0x68, 0x69, 0x03, 0, 0, 0 };
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, &storage.segments[0][LevelHistoryLog::RECORD_SIZE], sizeof(expected));
+  // CRC-32 (IEEE) of the first 16 bytes, little-endian.
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < sizeof(expected); i++)
+  {
+    crc ^= expected[i];
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+  }
+  crc = ~crc;
+  const uint8_t* stored = &storage.segments[0][LevelHistoryLog::RECORD_SIZE + 16];
+  TEST_ASSERT_EQUAL_UINT32(crc, stored[0] | (stored[1] << 8) | (stored[2] << 16) | (static_cast<uint32_t>(stored[3]) << 24));
+}
+
+void test_offline_readings_replay_in_batches_until_marked()
+{
+  FakeStorage storage(4, 8);
+  LevelHistoryLog log(storage);
+  log.Open();
+  log.Append(T0, 0xF, true);
+  for (uint32_t i = 0; i < 5; i++)
+  {
+    TEST_ASSERT_TRUE(log.Append(T0 + 60 + i, i, false));
+  }
+  TEST_ASSERT_TRUE(log.HasPending());
+
+  LevelReading batch[3];
+  TEST_ASSERT_EQUAL_UINT32(3, log.NextBatch(batch, 3));
+  TEST_ASSERT_EQUAL_UINT32(2, batch[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(T0 + 60, batch[0].measuredAt);
+  TEST_ASSERT_EQUAL_UINT32(0, batch[0].mask);
+  TEST_ASSERT_EQUAL_UINT32(4, batch[2].seq);
+  // Unacknowledged batches come back unchanged.
+  TEST_ASSERT_EQUAL_UINT32(3, log.NextBatch(batch, 3));
+  TEST_ASSERT_EQUAL_UINT32(2, batch[0].seq);
+
+  TEST_ASSERT_TRUE(log.MarkReplayed(batch[2].seq));
+  TEST_ASSERT_EQUAL_UINT32(2, log.NextBatch(batch, 3));
+  TEST_ASSERT_EQUAL_UINT32(5, batch[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(T0 + 64, batch[1].measuredAt);
+  TEST_ASSERT_TRUE(log.MarkReplayed(batch[1].seq));
+  TEST_ASSERT_FALSE(log.HasPending());
+  TEST_ASSERT_EQUAL_UINT32(0, log.NextBatch(batch, 3));
+}
+
+void test_acked_live_reading_is_not_replayed()
+{
+  FakeStorage storage(4, 8);
+  {
+    LevelHistoryLog log(storage);
+    log.Open();
+    TEST_ASSERT_EQUAL_UINT32(0, log.NewestSeq());
+    log.Append(T0, 0x1, false);
+    TEST_ASSERT_EQUAL_UINT32(1, log.NewestSeq());
+    TEST_ASSERT_TRUE(log.MarkDelivered(1));
+    TEST_ASSERT_FALSE(log.HasPending());
+    TEST_ASSERT_FALSE(log.MarkDelivered(log.NewestSeq() + 1));
+
+    // A reading whose publish was never acknowledged keeps newer ones pending too.
+    log.Append(T0 + 10, 0x3, false);
+    const uint32_t unacked = log.NewestSeq();
+    log.Append(T0 + 20, 0x7, false);
+    TEST_ASSERT_FALSE(log.MarkDelivered(log.NewestSeq()));
+    LevelReading batch[4];
+    TEST_ASSERT_EQUAL_UINT32(2, log.NextBatch(batch, 4));
+    TEST_ASSERT_EQUAL_UINT32(unacked, batch[0].seq);
+  }
+
+  LevelHistoryLog reopened(storage);
+  reopened.Open();
+  LevelReading batch[4];
+  TEST_ASSERT_EQUAL_UINT32(2, reopened.NextBatch(batch, 4));
+  TEST_ASSERT_EQUAL_UINT32(T0 + 10, batch[0].measuredAt);
+}
+
+void test_reopen_resumes_after_power_cut()
+{
+  FakeStorage storage(4, 8);
+  {
+    LevelHistoryLog log(storage);
+    log.Open();
+    log.Append(T0, 0x1, false);
+    log.Append(T0 + 10, 0x3, false);
+    log.MarkReplayed(1);
+    log.Append(T0 + 20, 0x7, false);
+  }
+
+  LevelHistoryLog reopened(storage);
+  TEST_ASSERT_EQUAL_UINT32(4, reopened.Open());
+  TEST_ASSERT_TRUE(reopened.HasPending());
+  LevelReading batch[4];
+  TEST_ASSERT_EQUAL_UINT32(2, reopened.NextBatch(batch, 4));
+  TEST_ASSERT_EQUAL_UINT32(2, batch[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(4, batch[1].seq);
+
+  // New records continue the sequence.
+  reopened.Append(T0 + 30, 0xF, true);
+  LevelReading all[8];
+  TEST_ASSERT_EQUAL_UINT32(4, reopened.Find(0, UINT32_MAX, 0, all, 8));
+  TEST_ASSERT_EQUAL_UINT32(5, all[3].seq);
+}
+
+void test_torn_write_is_skipped_and_rewritten()
+{
+  FakeStorage storage(4, 8);
+  {
+    LevelHistoryLog log(storage);
+    log.Open();
+    log.Append(T0, 0x1, false);
+    log.Append(T0 + 10, 0x3, false);
+    storage.cutAfterWrites = storage.writes + 1;
+    storage.tornBytes = 9;
+    TEST_ASSERT_FALSE(log.Append(T0 + 20, 0x7, false));
+  }
+
+  storage.powerCut = false;
+  LevelHistoryLog reopened(storage);
+  TEST_ASSERT_EQUAL_UINT32(2, reopened.Open());
+  TEST_ASSERT_EQUAL_UINT32(1, reopened.Corrupt());
+  LevelReading batch[4];
+  TEST_ASSERT_EQUAL_UINT32(2, reopened.NextBatch(batch, 4));
+  TEST_ASSERT_EQUAL_UINT32(2, batch[1].seq);
+
+  // The next record reuses the torn slot.
+  TEST_ASSERT_TRUE(reopened.Append(T0 + 30, 0xF, false));
+  LevelHistoryLog again(storage);
+  TEST_ASSERT_EQUAL_UINT32(3, again.Open());
+  TEST_ASSERT_EQUAL_UINT32(0, again.Corrupt());
+  TEST_ASSERT_EQUAL_UINT32(3, again.NextBatch(batch, 4));
+  TEST_ASSERT_EQUAL_UINT32(3, batch[2].seq);
+  TEST_ASSERT_EQUAL_UINT32(T0 + 30, batch[2].measuredAt);
+  TEST_ASSERT_EQUAL_UINT32(1, storage.rewrites);
+}
+
+void test_full_ring_drops_oldest_segment()
+{
+  FakeStorage storage(2, 4);
+  LevelHistoryLog log(storage);
+  log.Open();
+  for (uint32_t i = 0; i < 12; i++)
+  {
+    TEST_ASSERT_TRUE(log.Append(T0 + i, i, false));
+  }
+  // Seq 8 took segment 0 back (seqs 1-3), seq 12 segment 1 (seqs 4-7).
+  TEST_ASSERT_EQUAL_UINT32(7, log.Lost());
+
+  LevelReading batch[16];
+  TEST_ASSERT_EQUAL_UINT32(5, log.NextBatch(batch, 16));
+  TEST_ASSERT_EQUAL_UINT32(8, batch[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(12, batch[4].seq);
+
+  LevelHistoryLog reopened(storage);
+  TEST_ASSERT_EQUAL_UINT32(5, reopened.Open());
+  TEST_ASSERT_EQUAL_UINT32(5, reopened.NextBatch(batch, 16));
+  TEST_ASSERT_EQUAL_UINT32(8, batch[0].seq);
+  // Records only ever go to the end of a segment; each segment is erased once per lap.
+  TEST_ASSERT_EQUAL_UINT32(12, storage.writes);
+  TEST_ASSERT_EQUAL_UINT32(0, storage.rewrites);
+  TEST_ASSERT_EQUAL_UINT32(3, storage.erases);
+}
+
+void test_replayed_marker_survives_wrap()
+{
+  FakeStorage storage(2, 4);
+  LevelHistoryLog log(storage);
+  log.Open();
+  for (uint32_t i = 0; i < 6; i++)
+  {
+    log.Append(T0 + i, i, false);
+  }
+  log.MarkReplayed(6);
+  log.Append(T0 + 10, 0x1, true);
+  log.Append(T0 + 11, 0x3, false);
+
+  LevelHistoryLog reopened(storage);
+  reopened.Open();
+  LevelReading batch[8];
+  TEST_ASSERT_EQUAL_UINT32(1, reopened.NextBatch(batch, 8));
+  TEST_ASSERT_EQUAL_UINT32(9, batch[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(0, log.Lost());
+}
+
+void test_find_pages_through_a_time_range()
+{
+  FakeStorage storage(4, 16);
+  LevelHistoryLog log(storage);
+  log.Open();
+  for (uint32_t i = 0; i < 10; i++)
+  {
+    log.Append(T0 + i * 60, i, i % 2 == 0);
+  }
+  log.MarkReplayed(10);
+
+  LevelReading page[3];
+  TEST_ASSERT_EQUAL_UINT32(3, log.Find(T0 + 120, T0 + 420, 0, page, 3));
+  TEST_ASSERT_EQUAL_UINT32(3, page[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(5, page[2].seq);
+  TEST_ASSERT_EQUAL_UINT32(3, log.Find(T0 + 120, T0 + 420, page[2].seq, page, 3));
+  TEST_ASSERT_EQUAL_UINT32(8, page[2].seq);
+  TEST_ASSERT_EQUAL_UINT32(0, log.Find(T0 + 120, T0 + 420, page[2].seq, page, 3));
+  TEST_ASSERT_EQUAL_UINT32(0, log.Find(T0 + 1000, T0 + 2000, 0, page, 3));
+}
+
+void test_parse_utc_timestamp()
+{
+  uint32_t seconds = 0;
+  TEST_ASSERT_TRUE(ParseUtcTimestamp("2026-01-15T06:55:00Z", seconds));
+  TEST_ASSERT_EQUAL_UINT32(T0, seconds);
+  TEST_ASSERT_TRUE(ParseUtcTimestamp("1970-01-01T00:00:00Z", seconds));
+  TEST_ASSERT_EQUAL_UINT32(0, seconds);
+  TEST_ASSERT_TRUE(ParseUtcTimestamp("2024-02-29T23:59:59Z", seconds));
+  TEST_ASSERT_EQUAL_UINT32(1709251199, seconds);
+
+  TEST_ASSERT_FALSE(ParseUtcTimestamp("2026-01-15T06:55:00", seconds));
+  TEST_ASSERT_FALSE(ParseUtcTimestamp("2026-01-15T06:55:00.000Z", seconds));
+  TEST_ASSERT_FALSE(ParseUtcTimestamp("2026-13-15T06:55:00Z", seconds));
+  TEST_ASSERT_FALSE(ParseUtcTimestamp("2026-01-15 06:55:00Z", seconds));
+  TEST_ASSERT_FALSE(ParseUtcTimestamp(nullptr, seconds));
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_store_opens_empty);
+  RUN_TEST(test_record_layout);
+  RUN_TEST(test_offline_readings_replay_in_batches_until_marked);
+  RUN_TEST(test_acked_live_reading_is_not_replayed);
+  RUN_TEST(test_reopen_resumes_after_power_cut);
+  RUN_TEST(test_torn_write_is_skipped_and_rewritten);
+  RUN_TEST(test_full_ring_drops_oldest_segment);
+  RUN_TEST(test_replayed_marker_survives_wrap);
+  RUN_TEST(test_find_pages_through_a_time_range);
+  RUN_TEST(test_parse_utc_timestamp);
+  return UNITY_END();
+}
@@ -0,0 +1,265 @@
+#include <unity.h>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "sensor_debouncer.h"
+#include "spsc_ring.h"
+#include "water_level_logic.h"
+
+static const uint32_t SETTLE_US = 20000;
+
+static std::array<bool, SENSOR_COUNT> levels(bool a, bool b, bool c, bool d)
+{
+  return { { a, b, c, d } };
+}
+
+/// <summary>
+/// Replays an edge trace the way loop() does: wake on every edge and on the settle
+/// deadline, publish when the debounced state differs from the last published one.
+/// Returns the publish times.
+/// </summary>
+static std::vector<uint32_t> replay(
+  const std::vector<SensorEdge>& trace,
+  SensorDebouncer& debouncer,
+  WaterLevelLogic<SENSOR_COUNT>& logic,
+  std::vector<std::array<bool, SENSOR_COUNT>>* published = nullptr)
+{
+  std::vector<uint32_t> publishUs;
+  size_t next = 0;
+  uint32_t nowUs = trace.empty() ? 0 : trace[0].atUs;
+  while (true)
+  {
+    while (next < trace.size() && trace[next].atUs == nowUs)
+    {
+      debouncer.OnEdge(trace[next++]);
+    }
+    debouncer.Update(nowUs);
+    if (logic.HasChanged(debouncer.Stable()))
+    {
+      publishUs.push_back(nowUs);
+      if (published)
+      {
+        published->push_back(debouncer.Stable());
+      }
+      logic.MarkPublished(debouncer.Stable(), nowUs / 1000);
+    }
+
+    const uint32_t untilSettledUs = debouncer.UsUntilSettled(nowUs);
+    if (next >= trace.size() && untilSettledUs == UINT32_MAX)
+    {
+      break;
+    }
+    uint32_t wakeUs = untilSettledUs == UINT32_MAX ? trace[next].atUs : nowUs + untilSettledUs;
+    if (next < trace.size() && static_cast<int32_t>(trace[next].atUs - wakeUs) < 0)
+    {
+      wakeUs = trace[next].atUs;
+    }
+    nowUs = wakeUs;
+  }
+  return publishUs;
+}
+
+void test_clean_edge_settles_after_quiet_period()
+{
+  SensorDebouncer debouncer(SETTLE_US);
+  debouncer.Reset(levels(false, false, false, false));
+  debouncer.OnEdge({ 1000, 0, true });
+
+  TEST_ASSERT_TRUE(debouncer.HasPending());
+  TEST_ASSERT_EQUAL_UINT32(SETTLE_US, debouncer.UsUntilSettled(1000));
+  TEST_ASSERT_FALSE(debouncer.Update(1000 + SETTLE_US - 1));
+  TEST_ASSERT_FALSE(debouncer.Stable()[0]);
+  TEST_ASSERT_TRUE(debouncer.Update(1000 + SETTLE_US));
+  TEST_ASSERT_TRUE(debouncer.Stable()[0]);
+  TEST_ASSERT_FALSE(debouncer.HasPending());
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, debouncer.UsUntilSettled(50000));
+}
+
+void test_bounce_burst_commits_once_after_last_edge()
+{
+  SensorDebouncer debouncer(SETTLE_US);
+  WaterLevelLogic logic(60000);
+  debouncer.Reset(levels(false, false, false, false));
+
+  const std::vector<SensorEdge> trace = {
+    { 10000, 1, true }, { 10300, 1, false }, { 10900, 1, true }, { 11200, 1, false },
+    { 12500, 1, true }, { 13100, 1, false }, { 14000, 1, true }
+  };
+  const std::vector<uint32_t> publishes = replay(trace, debouncer, logic);
+
+  TEST_ASSERT_EQUAL_INT(1, static_cast<int>(publishes.size()));
+  TEST_ASSERT_EQUAL_UINT32(14000 + SETTLE_US, publishes[0]);
+  TEST_ASSERT_TRUE(debouncer.Stable()[1]);
+  TEST_ASSERT_EQUAL_UINT32(3, debouncer.RejectedGlitches());
+}
+
+void test_short_glitch_is_rejected()
+{
+  SensorDebouncer debouncer(SETTLE_US);
+  WaterLevelLogic logic(60000);
+  debouncer.Reset(levels(true, true, false, false));
+  logic.MarkPublished(levels(true, true, false, false), 0);
+
+  const std::vector<SensorEdge> trace = {
+    { 5000, 1, false }, { 9000, 1, true }, { 30000, 3, true }, { 30050, 3, false }
+  };
+  const std::vector<uint32_t> publishes = replay(trace, debouncer, logic);
+
+  TEST_ASSERT_EQUAL_INT(0, static_cast<int>(publishes.size()));
+  TEST_ASSERT_EQUAL_UINT32(2, debouncer.RejectedGlitches());
+  TEST_ASSERT_TRUE(debouncer.Stable() == levels(true, true, false, false));
+}
+
+void test_earliest_pending_sensor_and_micros_wraparound()
+{
+  SensorDebouncer debouncer(SETTLE_US);
+  debouncer.Reset(levels(false, false, false, false));
+
+  const uint32_t start = 0xFFFFF000u;
+  debouncer.OnEdge({ start, 2, true });
+  debouncer.OnEdge({ start + 8000, 0, true });
+  TEST_ASSERT_EQUAL_UINT32(SETTLE_US - 10000, debouncer.UsUntilSettled(start + 10000));
+
+  TEST_ASSERT_TRUE(debouncer.Update(start + SETTLE_US));
+  TEST_ASSERT_TRUE(debouncer.Stable() == levels(false, false, true, false));
+  TEST_ASSERT_EQUAL_UINT32(8000, debouncer.UsUntilSettled(start + SETTLE_US));
+  TEST_ASSERT_TRUE(debouncer.Update(start + SETTLE_US + 8000));
+  TEST_ASSERT_TRUE(debouncer.Stable() == levels(true, false, true, false));
+}
+
+void test_edges_through_ring_resync_after_overflow()
+{
+  SpscRing<SensorEdge, 4> ring;
+  SensorDebouncer debouncer(SETTLE_US);
+  debouncer.Reset(levels(false, false, false, false));
+
+  // A burst larger than the ring: the last edges are lost.
+  bool level = false;
+  for (uint32_t i = 0; i < 7; i++)
+  {
+    level = !level;
+    ring.TryPush({ 1000 + i * 100, 0, level });
+  }
+  TEST_ASSERT_EQUAL_UINT32(3, ring.DroppedCount());
+
+  SensorEdge edge;
+  while (ring.TryPop(edge))
+  {
+    debouncer.OnEdge(edge);
+  }
+  // The consumer resamples the pin (now high) as a fresh edge.
+  debouncer.OnEdge({ 2000, 0, true });
+  debouncer.Update(2000 + SETTLE_US);
+  TEST_ASSERT_TRUE(debouncer.Stable()[0]);
+}
+
+/// <summary>
+/// Synthetic float-switch traces: water rises and falls through the sensors, every
+/// transition bounces for up to 15 ms and sloshing adds isolated sub-millisecond
+/// spikes. Each real transition must be published once, on the settle deadline.
+/// Also reports how many publishes the old 50 ms digitalRead poll would have made.
+/// </summary>
+void test_synthetic_float_switch_traces()
+{
+  srand(11);
+  int transitions = 0;
+  int polledPublishes = 0;
+  int debouncedPublishes = 0;
+  uint32_t maxLatencyUs = 0;
+
+  for (int trace = 0; trace < 200; trace++)
+  {
+    std::vector<SensorEdge> edges;
+    std::vector<uint32_t> settleUs;
+    std::array<bool, SENSOR_COUNT> truth = levels(false, false, false, false);
+    uint32_t now = static_cast<uint32_t>(rand());
+    const uint32_t traceStart = now;
+    int filled = 0;
+
+    for (int step = 0; step < 12; step++)
+    {
+      now += 200000 + rand() % 800000;
+      if (rand() % 3 == 0)
+      {
+        // Slosh spike on a random dry sensor.
+        const uint8_t sensor = static_cast<uint8_t>(rand() % SENSOR_COUNT);
+        if (!truth[sensor])
+        {
+          edges.push_back({ now, sensor, true });
+          edges.push_back({ now + 100 + rand() % 800, sensor, false });
+          now += 2000;
+          continue;
+        }
+      }
+
+      const bool rising = filled == 0 || (filled < SENSOR_COUNT && rand() % 2 == 0);
+      const uint8_t sensor = static_cast<uint8_t>(rising ? filled : filled - 1);
+      const bool target = rising;
+      bool level = !target;
+      const int bounces = rand() % 6;
+      for (int b = 0; b < bounces * 2; b++)
+      {
+        level = !level;
+        edges.push_back({ now, sensor, level });
+        now += 100 + rand() % 2500;
+      }
+      edges.push_back({ now, sensor, target });
+      settleUs.push_back(now + SETTLE_US);
+      truth[sensor] = target;
+      filled += rising ? 1 : -1;
+      transitions++;
+    }
+
+    SensorDebouncer debouncer(SETTLE_US);
+    WaterLevelLogic logic(0xFFFFFFFFu);
+    debouncer.Reset(levels(false, false, false, false));
+    std::vector<std::array<bool, SENSOR_COUNT>> published;
+    const std::vector<uint32_t> publishes = replay(edges, debouncer, logic, &published);
+
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(settleUs.size()), static_cast<int>(publishes.size()));
+    for (size_t i = 0; i < publishes.size(); i++)
+    {
+      const uint32_t latencyUs = publishes[i] - settleUs[i];
+      maxLatencyUs = latencyUs > maxLatencyUs ? latencyUs : maxLatencyUs;
+    }
+    TEST_ASSERT_TRUE(debouncer.Stable() == truth);
+    debouncedPublishes += static_cast<int>(publishes.size());
+
+    // Old loop: sample the raw trace every 50 ms and publish on any difference.
+    std::array<bool, SENSOR_COUNT> raw = levels(false, false, false, false);
+    std::array<bool, SENSOR_COUNT> last = raw;
+    size_t next = 0;
+    for (uint32_t sample = traceStart; sample - traceStart <= now - traceStart + 100000; sample += 50000)
+    {
+      while (next < edges.size() && static_cast<int32_t>(edges[next].atUs - sample) <= 0)
+      {
+        raw[edges[next].sensor] = edges[next].level;
+        next++;
+      }
+      if (raw != last)
+      {
+        polledPublishes++;
+        last = raw;
+      }
+    }
+  }
+
+  char line[128];
+  snprintf(line, sizeof(line), "%d transitions: debounced %d publishes (max %u us after settle), 50 ms poll %d publishes",
+    transitions, debouncedPublishes, static_cast<unsigned>(maxLatencyUs), polledPublishes);
+  TEST_MESSAGE(line);
+  TEST_ASSERT_EQUAL_UINT32(0, maxLatencyUs);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_clean_edge_settles_after_quiet_period);
+  RUN_TEST(test_bounce_burst_commits_once_after_last_edge);
+  RUN_TEST(test_short_glitch_is_rejected);
+  RUN_TEST(test_earliest_pending_sensor_and_micros_wraparound);
+  RUN_TEST(test_edges_through_ring_resync_after_overflow);
+  RUN_TEST(test_synthetic_float_switch_traces);
+  return UNITY_END();
+}
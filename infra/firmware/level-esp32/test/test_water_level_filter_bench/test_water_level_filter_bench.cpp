@@ -0,0 +1,227 @@
+#include <unity.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "water_level_logic.h"
+
+// Replays noisy sensor traces through WaterLevelLogic and reports false publishes
+// against detection latency for a set of filter settings.
+// Run with: pio test -e native -f test_water_level_filter_bench -v
+
+static const uint32_t SAMPLE_MS = 50;
+static const uint32_t TRACE_MS = 6UL * 60UL * 60UL * 1000UL;
+static const int TRACES = 4;
+
+struct Trace
+{
+  std::vector<std::array<bool, 4>> truth;
+  std::vector<std::array<bool, 4>> noisy;
+};
+
+static std::array<bool, 4> sensorsForCount(int wet)
+{
+  std::array<bool, 4> sensors{ { false, false, false, false } };
+  for (int i = 0; i < wet; i++)
+  {
+    sensors[i] = true;
+  }
+  return sensors;
+}
+
+/// <summary>
+/// The water surface moves one sensor every few minutes. The sensors next to the
+/// surface flicker: rarely when calm, often while the pump runs or wind moves the tank.
+/// </summary>
+static Trace buildTrace(unsigned seed)
+{
+  srand(seed);
+  Trace trace;
+  const size_t samples = TRACE_MS / SAMPLE_MS;
+  trace.truth.reserve(samples);
+  trace.noisy.reserve(samples);
+
+  int wet = 2;
+  size_t nextMove = 2400 + rand() % 7200;
+  size_t sloshUntil = 0;
+  for (size_t i = 0; i < samples; i++)
+  {
+    if (i == nextMove)
+    {
+      wet = wet == 0 ? 1 : wet == 4 ? 3 : wet + (rand() % 2 == 0 ? 1 : -1);
+      nextMove = i + 2400 + rand() % 7200;
+    }
+    if (i > sloshUntil && rand() % 6000 == 0)
+    {
+      sloshUntil = i + 600 + rand() % 6000;
+    }
+
+    const int flickerPerMille = i < sloshUntil ? 250 : 5;
+    std::array<bool, 4> noisy = sensorsForCount(wet);
+    if (wet > 0 && rand() % 1000 < flickerPerMille)
+    {
+      noisy[wet - 1] = false;
+    }
+    if (wet < 4 && rand() % 1000 < flickerPerMille)
+    {
+      noisy[wet] = true;
+    }
+
+    trace.truth.push_back(sensorsForCount(wet));
+    trace.noisy.push_back(noisy);
+  }
+  return trace;
+}
+
+struct FilterResult
+{
+  int changePublishes;
+  int falsePublishes;
+  int transitions;
+  int missed;
+  uint32_t meanLatencyMs;
+  uint32_t p95LatencyMs;
+};
+
+/// <summary>
+/// Mirrors the level loop: filter each sample, publish on change when the bucket
+/// allows (or immediately when empty). Periodic publishes are left out.
+/// </summary>
+static FilterResult run(const std::vector<Trace>& traces, const WaterLevelFilterConfig& filter)
+{
+  FilterResult result{};
+  std::vector<uint32_t> latencies;
+  for (const Trace& trace : traces)
+  {
+    WaterLevelLogic logic(0xFFFFFFFFu, filter);
+    logic.Filter(trace.truth[0]);
+    logic.MarkPublished(trace.truth[0], 0);
+
+    size_t changedAt = 0;
+    bool detected = true;
+    for (size_t i = 1; i < trace.noisy.size(); i++)
+    {
+      const uint32_t nowMs = static_cast<uint32_t>(i * SAMPLE_MS);
+      if (trace.truth[i] != trace.truth[i - 1])
+      {
+        if (!detected)
+        {
+          result.missed++;
+        }
+        result.transitions++;
+        changedAt = i;
+        detected = false;
+      }
+
+      const std::array<bool, 4>& sensors = logic.Filter(trace.noisy[i]);
+      const bool changed = logic.HasChanged(sensors);
+      const bool empty = changed && logic.BuildSnapshot(sensors).levelPercent == 0;
+      if (!logic.ShouldPublish(changed, nowMs) && !empty)
+      {
+        continue;
+      }
+
+      logic.MarkPublished(sensors, nowMs);
+      result.changePublishes++;
+      if (sensors != trace.truth[i])
+      {
+        result.falsePublishes++;
+      }
+      else if (!detected)
+      {
+        latencies.push_back(static_cast<uint32_t>((i - changedAt) * SAMPLE_MS));
+        detected = true;
+      }
+    }
+  }
+
+  if (!latencies.empty())
+  {
+    uint64_t total = 0;
+    for (uint32_t latency : latencies)
+    {
+      total += latency;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.meanLatencyMs = static_cast<uint32_t>(total / latencies.size());
+    result.p95LatencyMs = latencies[latencies.size() * 95 / 100];
+  }
+  return result;
+}
+
+static WaterLevelFilterConfig config(uint8_t window, uint8_t threshold, uint32_t spacingMs, uint8_t burst)
+{
+  WaterLevelFilterConfig filter;
+  filter.voteWindow = window;
+  filter.voteThreshold = threshold;
+  filter.publishSpacingMs = spacingMs;
+  filter.publishBurst = burst;
+  return filter;
+}
+
+void test_bench_false_publishes_vs_latency()
+{
+  std::vector<Trace> traces;
+  for (int i = 0; i < TRACES; i++)
+  {
+    traces.push_back(buildTrace(100 + i));
+  }
+  const double hours = static_cast<double>(TRACE_MS) * TRACES / 3600000.0;
+
+  struct Case
+  {
+    const char* name;
+    WaterLevelFilterConfig filter;
+  };
+  const Case cases[] = {
+    { "unfiltered", config(1, 1, 0, 1) },
+    { "vote 3/2", config(3, 2, 0, 1) },
+    { "vote 5/3", config(5, 3, 0, 1) },
+    { "vote 6/4", config(6, 4, 0, 1) },
+    { "vote 6/4 bucket 5s x3", config(6, 4, 5000, 3) },
+    { "vote 8/6", config(8, 6, 0, 1) },
+    { "vote 8/6 bucket 5s x3", config(8, 6, 5000, 3) },
+    { "vote 10/8 bucket 5s x3", config(10, 8, 5000, 3) },
+    { "vote 12/9 bucket 30s x1", config(12, 9, 30000, 1) }
+  };
+
+  FilterResult unfiltered{};
+  FilterResult chosen{};
+  for (const Case& entry : cases)
+  {
+    const FilterResult result = run(traces, entry.filter);
+    char line[200];
+    snprintf(line, sizeof(line),
+      "%-24s publishes/h %7.1f  false/h %7.1f  latency mean %5u ms p95 %5u ms  missed %d/%d",
+      entry.name,
+      result.changePublishes / hours,
+      result.falsePublishes / hours,
+      static_cast<unsigned>(result.meanLatencyMs),
+      static_cast<unsigned>(result.p95LatencyMs),
+      result.missed,
+      result.transitions);
+    TEST_MESSAGE(line);
+
+    if (entry.filter.voteWindow == 1)
+    {
+      unfiltered = result;
+    }
+    if (entry.filter.voteWindow == 10 && entry.filter.publishSpacingMs == 5000)
+    {
+      chosen = result;
+    }
+  }
+
+  // The firmware default (vote 10/8, bucket 5 s x3) must cut false publishes by at least 10x and still see every transition quickly.
+  TEST_ASSERT_TRUE(chosen.falsePublishes * 10 <= unfiltered.falsePublishes);
+  TEST_ASSERT_EQUAL_INT(0, chosen.missed);
+  TEST_ASSERT_LESS_OR_EQUAL(1000, chosen.p95LatencyMs);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_false_publishes_vs_latency);
+  return UNITY_END();
+}
@@ -0,0 +1,195 @@
+#include <unity.h>
+#include <array>
+#include <type_traits>
+#include "water_level_logic.h"
+
+static std::array<bool, 4> sensors(bool a, bool b, bool c, bool d)
+{
+  return { { a, b, c, d } };
+}
+
+void test_level_percent()
+{
+  WaterLevelLogic logic(1000);
+  auto snap = logic.BuildSnapshot(sensors(false, false, false, false));
+  TEST_ASSERT_EQUAL_INT(0, snap.levelPercent);
+
+  snap = logic.BuildSnapshot(sensors(true, false, true, false));
+  TEST_ASSERT_EQUAL_INT(50, snap.levelPercent);
+
+  snap = logic.BuildSnapshot(sensors(true, true, true, true));
+  TEST_ASSERT_EQUAL_INT(100, snap.levelPercent);
+}
+
+void test_change_detection()
+{
+  WaterLevelLogic logic(1000);
+  TEST_ASSERT_FALSE(logic.HasChanged(sensors(false, false, false, false)));
+  TEST_ASSERT_TRUE(logic.HasChanged(sensors(true, false, false, false)));
+  logic.MarkPublished(sensors(true, false, false, false), 100);
+  TEST_ASSERT_FALSE(logic.HasChanged(sensors(true, false, false, false)));
+}
+
+void test_should_publish()
+{
+  WaterLevelLogic logic(1000);
+  TEST_ASSERT_TRUE(logic.ShouldPublish(true, 100));
+  logic.MarkPublished(sensors(false, false, false, false), 100);
+  TEST_ASSERT_FALSE(logic.ShouldPublish(false, 500));
+  TEST_ASSERT_TRUE(logic.ShouldPublish(false, 1101));
+}
+
+void test_default_filter_passes_samples_through()
+{
+  WaterLevelLogic logic(1000);
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, false, false, false)) == sensors(true, false, false, false));
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, true, false, false)) == sensors(true, true, false, false));
+  TEST_ASSERT_TRUE(logic.Filter(sensors(false, false, false, false)) == sensors(false, false, false, false));
+}
+
+void test_majority_vote_rejects_flicker()
+{
+  WaterLevelFilterConfig filter;
+  filter.voteWindow = 5;
+  filter.voteThreshold = 3;
+  WaterLevelLogic logic(1000, filter);
+
+  logic.Filter(sensors(true, true, false, false));
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, false, false, false)) == sensors(true, true, false, false));
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, true, true, false)) == sensors(true, true, false, false));
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, false, false, false)) == sensors(true, true, false, false));
+
+  // Third disagreeing sample in the window flips the sensor.
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, false, false, false)) == sensors(true, false, false, false));
+}
+
+void test_hysteresis_needs_more_than_majority()
+{
+  WaterLevelFilterConfig filter;
+  filter.voteWindow = 6;
+  filter.voteThreshold = 5;
+  WaterLevelLogic logic(1000, filter);
+
+  logic.Filter(sensors(false, false, false, false));
+  for (int i = 0; i < 4; i++)
+  {
+    TEST_ASSERT_FALSE(logic.Filter(sensors(true, false, false, false))[0]);
+  }
+  TEST_ASSERT_TRUE(logic.Filter(sensors(true, false, false, false))[0]);
+
+  // Going back needs five dry samples as well.
+  for (int i = 0; i < 4; i++)
+  {
+    TEST_ASSERT_TRUE(logic.Filter(sensors(false, false, false, false))[0]);
+  }
+  TEST_ASSERT_FALSE(logic.Filter(sensors(false, false, false, false))[0]);
+}
+
+void test_token_bucket_spaces_change_publishes()
+{
+  WaterLevelFilterConfig filter;
+  filter.publishSpacingMs = 1000;
+  filter.publishBurst = 2;
+  WaterLevelLogic logic(60000, filter);
+
+  TEST_ASSERT_TRUE(logic.ShouldPublish(true, 100));
+  logic.MarkPublished(sensors(true, false, false, false), 100);
+  TEST_ASSERT_TRUE(logic.ShouldPublish(true, 200));
+  logic.MarkPublished(sensors(true, true, false, false), 200);
+
+  // The first token was taken at 100, so the next one is due at 1100.
+  TEST_ASSERT_FALSE(logic.ShouldPublish(true, 300));
+  TEST_ASSERT_EQUAL_UINT32(900, logic.MsUntilChangePublishAllowed(200));
+  TEST_ASSERT_EQUAL_UINT32(100, logic.MsUntilChangePublishAllowed(1000));
+  TEST_ASSERT_TRUE(logic.ShouldPublish(true, 1100));
+  logic.MarkPublished(sensors(true, false, false, false), 1100);
+  TEST_ASSERT_FALSE(logic.ShouldPublish(true, 2099));
+  TEST_ASSERT_TRUE(logic.ShouldPublish(true, 2100));
+
+  // Periodic publishes are not limited and do not use tokens.
+  TEST_ASSERT_TRUE(logic.ShouldPublish(false, 61200));
+  logic.MarkPublished(sensors(true, false, false, false), 61200);
+  TEST_ASSERT_TRUE(logic.ShouldPublish(true, 61201));
+}
+
+// Tapered barrel: narrow at the bottom, wide at the top (heights in mm, volume in liters).
+static constexpr std::array<TankFillPoint, 4> TAPERED_TANK{ { { 0, 0 }, { 200, 30 }, { 500, 110 }, { 800, 220 } } };
+static constexpr std::array<uint16_t, 8> PROBE_HEIGHTS{ { 50, 150, 250, 350, 450, 550, 650, 750 } };
+static constexpr WaterLevelCalibration<8> TAPERED_CALIBRATION = CalibrationFromHeights(PROBE_HEIGHTS, TAPERED_TANK);
+
+static_assert(std::is_same<SensorMask<4>, uint8_t>::value, "4 sensors fit a byte");
+static_assert(std::is_same<SensorMask<16>, uint16_t>::value, "16 sensors fit 16 bits");
+static_assert(TAPERED_CALIBRATION.liters[1] == 8, "50 mm is a quarter of the first 30 l segment");
+static_assert(TAPERED_CALIBRATION.percent[8] == 92, "750 mm holds 202 of 220 l");
+
+void test_mask_round_trip_and_level_steps()
+{
+  WaterLevelLogic<12> logic(1000);
+  std::array<bool, 12> probes{};
+  probes[0] = true;
+  probes[1] = true;
+  probes[2] = true;
+  probes[9] = true;
+
+  const uint16_t mask = WaterLevelLogic<12>::ToMask(probes);
+  TEST_ASSERT_EQUAL_UINT32(0x207, mask);
+  TEST_ASSERT_TRUE(WaterLevelLogic<12>::ToSensors(mask) == probes);
+  TEST_ASSERT_EQUAL_UINT32(4, logic.LevelStep(mask));
+  TEST_ASSERT_EQUAL_INT(33, logic.BuildSnapshot(probes).levelPercent);
+  TEST_ASSERT_EQUAL_INT(-1, logic.BuildSnapshot(probes).levelLiters);
+
+  WaterLevelLogic<12> highest(1000, WaterLevelFilterConfig{}, LinearCalibration<12>(), WaterLevelMode::HighestWet);
+  TEST_ASSERT_EQUAL_UINT32(10, highest.LevelStep(mask));
+  TEST_ASSERT_EQUAL_UINT32(0, highest.LevelStep(0));
+  TEST_ASSERT_EQUAL_INT(83, highest.BuildSnapshot(mask).levelPercent);
+}
+
+void test_calibration_from_sensor_heights()
+{
+  WaterLevelLogic<8> logic(1000, WaterLevelFilterConfig{}, TAPERED_CALIBRATION, WaterLevelMode::WetCount);
+  TEST_ASSERT_EQUAL_INT(0, logic.BuildSnapshot(0x00).levelPercent);
+  TEST_ASSERT_EQUAL_INT(0, logic.BuildSnapshot(0x00).levelLiters);
+
+  // Four probes wet: water reaches 350 mm = 30 + 80 * 150 / 300 = 70 l of 220.
+  const WaterLevelSnapshot<8> half = logic.BuildSnapshot(0x0F);
+  TEST_ASSERT_EQUAL_INT(70, half.levelLiters);
+  TEST_ASSERT_EQUAL_INT(32, half.levelPercent);
+
+  const WaterLevelSnapshot<8> full = logic.BuildSnapshot(0xFF);
+  TEST_ASSERT_EQUAL_INT(202, full.levelLiters);
+  TEST_ASSERT_EQUAL_INT(92, full.levelPercent);
+}
+
+void test_sixteen_sensor_filter_and_change_detection()
+{
+  WaterLevelFilterConfig filter;
+  filter.voteWindow = 3;
+  filter.voteThreshold = 2;
+  WaterLevelLogic<16> logic(1000, filter);
+
+  TEST_ASSERT_EQUAL_UINT32(0x00FF, logic.FilterMask(0x00FF));
+  TEST_ASSERT_EQUAL_UINT32(0x00FF, logic.FilterMask(0x80FF));
+  TEST_ASSERT_EQUAL_UINT32(0x00FF, logic.FilterMask(0x01FF));
+  TEST_ASSERT_EQUAL_UINT32(0x01FF, logic.FilterMask(0x03FF));
+
+  TEST_ASSERT_TRUE(logic.HasChanged(logic.FilteredMask()));
+  logic.MarkPublished(logic.FilteredMask(), 10);
+  TEST_ASSERT_FALSE(logic.HasChanged(logic.FilteredSensors()));
+  TEST_ASSERT_EQUAL_UINT32(0x01FF, logic.LastMask());
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_level_percent);
+  RUN_TEST(test_change_detection);
+  RUN_TEST(test_should_publish);
+  RUN_TEST(test_default_filter_passes_samples_through);
+  RUN_TEST(test_majority_vote_rejects_flicker);
+  RUN_TEST(test_hysteresis_needs_more_than_majority);
+  RUN_TEST(test_token_bucket_spaces_change_publishes);
+  RUN_TEST(test_mask_round_trip_and_level_steps);
+  RUN_TEST(test_calibration_from_sensor_heights);
+  RUN_TEST(test_sixteen_sensor_filter_and_change_detection);
+  return UNITY_END();
+}
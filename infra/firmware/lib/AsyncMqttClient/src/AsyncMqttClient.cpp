@@ -0,0 +1,877 @@
+#include "AsyncMqttClient.hpp"
+
+AsyncMqttClient::AsyncMqttClient()
+: _client()
+, _outPackets()
+, _queue(_outPackets)
+, _reservedPublish(nullptr)
+, _lastError(AsyncMqttClientError::NOT_CONNECTED)
+, _state(DISCONNECTED)
+, _disconnectReason(AsyncMqttClientDisconnectReason::TCP_DISCONNECTED)
+, _lastClientActivity(0)
+, _lastServerActivity(0)
+, _lastPingRequestTime(0)
+, _generatedClientId{0}
+, _ip()
+, _host(nullptr)
+, _useIp(false)
+#if ASYNC_TCP_SSL_ENABLED
+, _secure(false)
+#endif
+, _port(0)
+, _keepAlive(15)
+, _connectionKeepAlive(15)
+, _cleanSession(true)
+, _protocolVersion(AsyncMqttClientInternals::ProtocolVersion.V3_1_1)
+, _sessionExpiry(0)
+, _clientId(nullptr)
+, _username(nullptr)
+, _password(nullptr)
+, _willTopic(nullptr)
+, _willPayload(nullptr)
+, _willPayloadLength(0)
+, _willQos(0)
+, _willRetain(false)
+#if ASYNC_TCP_SSL_ENABLED
+, _secureServerFingerprints()
+#endif
+, _onConnectUserCallbacks()
+, _onDisconnectUserCallbacks()
+, _onSubscribeUserCallbacks()
+, _onUnsubscribeUserCallbacks()
+, _onMessageUserCallbacks()
+, _onPublishUserCallbacks()
+, _parser(this)
+, _topicBuffer(nullptr)
+, _topicAliases()
+#if defined(ESP32)
+, _tls()
+#endif
+, _pendingPubRels() {
+  _client.onConnect([](void* obj, AsyncClient* c) { (static_cast<AsyncMqttClient*>(obj))->_onConnect(); }, this);
+  _client.onDisconnect([](void* obj, AsyncClient* c) { (static_cast<AsyncMqttClient*>(obj))->_onDisconnect(); }, this);
+  // _client.onError([](void* obj, AsyncClient* c, int8_t error) { (static_cast<AsyncMqttClient*>(obj))->_onError(error); }, this);
+  // _client.onTimeout([](void* obj, AsyncClient* c, uint32_t time) { (static_cast<AsyncMqttClient*>(obj))->_onTimeout(); }, this);
+  _client.onAck([](void* obj, AsyncClient* c, size_t len, uint32_t time) { (static_cast<AsyncMqttClient*>(obj))->_onAck(len); }, this);
+  _client.onData([](void* obj, AsyncClient* c, void* data, size_t len) { (static_cast<AsyncMqttClient*>(obj))->_onData(static_cast<char*>(data), len); }, this);
+  _client.onPoll([](void* obj, AsyncClient* c) { (static_cast<AsyncMqttClient*>(obj))->_onPoll(); }, this);
+  _client.setNoDelay(true);  // send small packets immediately (PINGREQ/DISCONN are only 2 bytes)
+#ifdef ESP32
+  sprintf(_generatedClientId, "esp32-%06llx", ESP.getEfuseMac());
+  _xSemaphore = xSemaphoreCreateMutex();
+#elif defined(ESP8266)
+  sprintf(_generatedClientId, "esp8266-%06x", ESP.getChipId());
+#endif
+  _clientId = _generatedClientId;
+
+  setMaxTopicLength(128);
+}
+
+AsyncMqttClient::~AsyncMqttClient() {
+  abortPublish();
+  delete[] _topicBuffer;
+  _clear();
+  _pendingPubRels.clear();
+  _pendingPubRels.shrink_to_fit();
+  _clearQueue(false);  // _clear() doesn't clear session data
+#ifdef ESP32
+  vSemaphoreDelete(_xSemaphore);
+#endif
+}
+
+AsyncMqttClient& AsyncMqttClient::setKeepAlive(uint16_t keepAlive) {
+  _keepAlive = keepAlive;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setClientId(const char* clientId) {
+  _clientId = clientId;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setCleanSession(bool cleanSession) {
+  _cleanSession = cleanSession;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setProtocolVersion(uint8_t protocolVersion) {
+  _protocolVersion = protocolVersion;
+  _parser.setProtocolVersion(protocolVersion);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setSessionExpiry(uint32_t seconds) {
+  _sessionExpiry = seconds;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setMaxTopicLength(uint16_t maxTopicLength) {
+  delete[] _topicBuffer;
+  _topicBuffer = new char[maxTopicLength + 1];
+  _parser.setTopicBuffer(_topicBuffer, maxTopicLength);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setCredentials(const char* username, const char* password) {
+  _username = username;
+  _password = password;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setWill(const char* topic, uint8_t qos, bool retain, const char* payload, size_t length) {
+  _willTopic = topic;
+  _willQos = qos;
+  _willRetain = retain;
+  _willPayload = payload;
+  _willPayloadLength = length;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setServer(IPAddress ip, uint16_t port) {
+  _useIp = true;
+  _ip = ip;
+  _port = port;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setServer(const char* host, uint16_t port) {
+  _useIp = false;
+  _host = host;
+  _port = port;
+  return *this;
+}
+
+#if ASYNC_TCP_SSL_ENABLED
+AsyncMqttClient& AsyncMqttClient::setSecure(bool secure) {
+  _secure = secure;
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::addServerFingerprint(const uint8_t* fingerprint) {
+  std::array<uint8_t, SHA1_SIZE> newFingerprint;
+  memcpy(newFingerprint.data(), fingerprint, SHA1_SIZE);
+  _secureServerFingerprints.push_back(newFingerprint);
+  return *this;
+}
+#endif
+
+#if defined(ESP32)
+AsyncMqttClient& AsyncMqttClient::setTls(const char* caCert) {
+  _tls.setCaCert(caCert);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setTlsSessionRecord(AsyncMqttClientInternals::TlsSessionRecord* record) {
+  _tls.setSessionRecord(record);
+  return *this;
+}
+
+const AsyncMqttClientInternals::TlsHandshakeStats& AsyncMqttClient::tlsStats() const {
+  return _tls.stats();
+}
+#endif
+
+AsyncMqttClient& AsyncMqttClient::onConnect(AsyncMqttClientInternals::OnConnectUserCallback callback) {
+  _onConnectUserCallbacks.push_back(callback);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onDisconnect(AsyncMqttClientInternals::OnDisconnectUserCallback callback) {
+  _onDisconnectUserCallbacks.push_back(callback);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onSubscribe(AsyncMqttClientInternals::OnSubscribeUserCallback callback) {
+  _onSubscribeUserCallbacks.push_back(callback);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onUnsubscribe(AsyncMqttClientInternals::OnUnsubscribeUserCallback callback) {
+  _onUnsubscribeUserCallbacks.push_back(callback);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onMessage(AsyncMqttClientInternals::OnMessageUserCallback callback) {
+  _onMessageUserCallbacks.push_back(callback);
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onPublish(AsyncMqttClientInternals::OnPublishUserCallback callback) {
+  _onPublishUserCallbacks.push_back(callback);
+  return *this;
+}
+
+void AsyncMqttClient::_clear() {
+  _lastPingRequestTime = 0;
+  _parser.reset();
+  _clearQueue(true);  // keep session data for now
+
+  _client.setRxTimeout(0);
+}
+
+/* TCP */
+void AsyncMqttClient::_onConnect() {
+  log_i("TCP conn, MQTT CONNECT");
+#if ASYNC_TCP_SSL_ENABLED
+  if (_secure && _secureServerFingerprints.size() > 0) {
+    SSL* clientSsl = _client.getSSL();
+
+    bool sslFoundFingerprint = false;
+    for (std::array<uint8_t, SHA1_SIZE> fingerprint : _secureServerFingerprints) {
+      if (ssl_match_fingerprint(clientSsl, fingerprint.data()) == SSL_OK) {
+        sslFoundFingerprint = true;
+        break;
+      }
+    }
+
+    if (!sslFoundFingerprint) {
+      _disconnectReason = AsyncMqttClientDisconnectReason::TLS_BAD_FINGERPRINT;
+      _client.close(true);
+      return;
+    }
+  }
+#endif
+#if defined(ESP32)
+  if (_tls.enabled()) {
+    // CONNECT waits for the handshake.
+    SEMAPHORE_TAKE();
+    AsyncMqttClientInternals::TlsLayer::Progress progress = _tls.begin(&_client, _useIp ? nullptr : _host, _port);
+    SEMAPHORE_GIVE();
+    _onTlsProgress(progress);
+    return;
+  }
+#endif
+  _sendConnect();
+}
+
+void AsyncMqttClient::_sendConnect() {
+  // Aliases belong to a connection; none are used until the CONNACK says how many.
+  SEMAPHORE_TAKE();
+  _topicAliases.reset(0);
+  SEMAPHORE_GIVE();
+  void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::ConnectOutPacket), true);
+  if (!slot) {
+    _client.close(true);
+    return;
+  }
+  AsyncMqttClientInternals::OutPacket* msg =
+  new (slot) AsyncMqttClientInternals::ConnectOutPacket(_cleanSession,
+                                                 _username,
+                                                 _password,
+                                                 _willTopic,
+                                                 _willRetain,
+                                                 _willQos,
+                                                 _willPayload,
+                                                 _willPayloadLength,
+                                                 _keepAlive,
+                                                 _clientId,
+                                                 _protocolVersion,
+                                                 _sessionExpiry);
+  _addFront(msg);
+  _handleQueue();
+}
+
+void AsyncMqttClient::_onDisconnect() {
+  log_i("TCP disconn");
+  _state = DISCONNECTED;
+#if defined(ESP32)
+  SEMAPHORE_TAKE();
+  _tls.end();
+  SEMAPHORE_GIVE();
+#endif
+
+  _clear();
+
+  for (auto callback : _onDisconnectUserCallbacks) callback(_disconnectReason);
+}
+
+/*
+void AsyncMqttClient::_onError(int8_t error) {
+  (void)error;
+  // _onDisconnect called anyway
+}
+
+void AsyncMqttClient::_onTimeout() {
+  // disconnection will be handled by ping/pong management
+}
+*/
+
+void AsyncMqttClient::_onAck(size_t len) {
+  log_i("ack %u", len);
+#if defined(ESP32)
+  if (_tls.enabled()) {
+    SEMAPHORE_TAKE();
+    AsyncMqttClientInternals::TlsLayer::Progress progress = _tls.resume();
+    SEMAPHORE_GIVE();
+    _onTlsProgress(progress);
+  }
+#endif
+  _handleQueue();
+}
+
+void AsyncMqttClient::_onData(char* data, size_t len) {
+  log_i("data rcv (%u)", len);
+  _lastServerActivity = millis();
+#if defined(ESP32)
+  if (_tls.enabled()) {
+    _onTlsData(data, len);
+    return;
+  }
+#endif
+  _parser.parse(data, len);
+}
+
+#if defined(ESP32)
+void AsyncMqttClient::_onTlsData(char* data, size_t len) {
+  // mbedTLS is not thread safe and publish() encrypts from the caller's task, so every
+  // TLS call holds the semaphore; the parser runs without it since its callbacks queue packets.
+  SEMAPHORE_TAKE();
+  AsyncMqttClientInternals::TlsLayer::Progress progress = _tls.feed(data, len);
+  SEMAPHORE_GIVE();
+  _onTlsProgress(progress);
+  for (;;) {
+    SEMAPHORE_TAKE();
+    int read = _tls.read(_tlsReadBuffer, sizeof(_tlsReadBuffer));
+    SEMAPHORE_GIVE();
+    if (read == 0) return;
+    if (read < 0) {
+      log_w("TLS read failed, disconnecting");
+      _client.close(true);
+      return;
+    }
+    _parser.parse(_tlsReadBuffer, read);
+  }
+}
+
+void AsyncMqttClient::_onTlsProgress(AsyncMqttClientInternals::TlsLayer::Progress progress) {
+  if (progress == AsyncMqttClientInternals::TlsLayer::Progress::ESTABLISHED) {
+    log_i("TLS up, MQTT CONNECT");
+    _sendConnect();
+  } else if (progress == AsyncMqttClientInternals::TlsLayer::Progress::FAILED) {
+    log_w("TLS handshake failed (%d)", _tls.stats().lastError);
+    _disconnectReason = AsyncMqttClientDisconnectReason::TLS_HANDSHAKE_FAILED;
+    _client.close(true);
+  }
+}
+#endif
+
+void AsyncMqttClient::_onPoll() {
+  // if there is too much time the client has sent a ping request without a response, disconnect client to avoid half open connections
+  if (_lastPingRequestTime != 0 && (millis() - _lastPingRequestTime) >= (_connectionKeepAlive * 1000 * 2)) {
+    log_w("PING t/o, disconnecting");
+    disconnect(true);
+    return;
+  }
+  // send ping to ensure the server will receive at least one message inside keepalive window
+  if (_state == CONNECTED && _lastPingRequestTime == 0 && (millis() - _lastClientActivity) >= (_connectionKeepAlive * 1000 * 0.7)) {
+    _sendPing();
+  // send ping to verify if the server is still there (ensure this is not a half connection)
+  } else if (_state == CONNECTED && _lastPingRequestTime == 0 && (millis() - _lastServerActivity) >= (_connectionKeepAlive * 1000 * 0.7)) {
+    _sendPing();
+  }
+  _handleQueue();
+}
+
+/* QUEUE */
+
+void AsyncMqttClient::_addFront(AsyncMqttClientInternals::OutPacket* packet) {
+  // CONNECT goes ahead of the packets kept from the previous session; PUBREL and
+  // PUBCOMP answer the broker before anything else is sent.
+  SEMAPHORE_TAKE();
+  log_i("new front #%u", packet->packetType());
+  _queue.pushFront(packet);
+  SEMAPHORE_GIVE();
+  _handleQueue();
+}
+
+bool AsyncMqttClient::_addBack(AsyncMqttClientInternals::OutPacket* packet, AsyncMqttClientInternals::OutPriority priority) {
+  SEMAPHORE_TAKE();
+  log_i("new back #%u", packet->packetType());
+  packet->priority = priority;
+  bool queued = _queue.pushBack(packet);
+  SEMAPHORE_GIVE();
+  if (!queued) {
+    log_i("out queue full, #%u refused", packet->packetType());
+    _lastError = AsyncMqttClientError::QUEUE_FULL;
+    _destroyOutPacket(packet);
+    return false;
+  }
+  _handleQueue();
+  return true;
+}
+
+void AsyncMqttClient::_handleQueue() {
+  SEMAPHORE_TAKE();
+  // On ESP32, onDisconnect is called within the close()-call. So we need to make sure we don't lock
+  bool disconnect = _queue.write(*this);
+#if defined(ESP32)
+  disconnect = disconnect || _tls.failed();
+#endif
+  SEMAPHORE_GIVE();
+  if (disconnect) {
+    log_i("snd DISCONN, disconnecting");
+    _client.close();
+  }
+}
+
+bool AsyncMqttClient::_acknowledge(uint8_t packetType, uint16_t packetId) {
+  SEMAPHORE_TAKE();
+  bool acknowledged = _queue.acknowledge(packetType, packetId);
+  SEMAPHORE_GIVE();
+  if (acknowledged) log_i("#%u %u released", packetType, packetId);
+  return acknowledged;
+}
+
+void AsyncMqttClient::_clearQueue(bool keepSessionData) {
+  SEMAPHORE_TAKE();
+  _queue.clear(keepSessionData);
+  SEMAPHORE_GIVE();
+}
+
+void* AsyncMqttClient::_acquireOutPacket(size_t size, bool protocolPacket) {
+  AsyncMqttClientInternals::OutPacketPool::Result result;
+  void* slot = _outPackets.acquire(size, protocolPacket, &result);
+  if (!slot) {
+    switch (result) {
+      case AsyncMqttClientInternals::OutPacketPool::Result::EXHAUSTED:
+        _lastError = AsyncMqttClientError::POOL_EXHAUSTED;
+        break;
+      case AsyncMqttClientInternals::OutPacketPool::Result::TOO_LARGE:
+        _lastError = AsyncMqttClientError::PACKET_TOO_LARGE;
+        break;
+      default:
+        _lastError = AsyncMqttClientError::OUT_OF_MEMORY;
+        break;
+    }
+    log_i("out packet (%u bytes) refused: %u", size, static_cast<uint8_t>(_lastError));
+  }
+  return slot;
+}
+
+void AsyncMqttClient::_destroyOutPacket(AsyncMqttClientInternals::OutPacket* packet) {
+  packet->~OutPacket();
+  _outPackets.release(packet);
+}
+
+size_t AsyncMqttClient::space() {
+#if defined(ESP32)
+  if (_tls.enabled()) return _tls.space();
+#endif
+  return _client.space();
+}
+
+size_t AsyncMqttClient::add(const char* data, size_t size) {
+#if defined(ESP32)
+  size_t realSent = _tls.enabled() ? _tls.write(data, size) : _client.add(data, size, ASYNC_WRITE_FLAG_COPY);
+#else
+  size_t realSent = _client.add(data, size, ASYNC_WRITE_FLAG_COPY);  // flag is set by LWIP anyway, added for clarity
+#endif
+  _lastClientActivity = millis();
+  _lastPingRequestTime = 0;
+  log_i("snd %u (%u in flight)", realSent, _queue.inFlight());
+  return realSent;
+}
+
+bool AsyncMqttClient::send() {
+  return _client.send();
+}
+
+void AsyncMqttClient::prepare(AsyncMqttClientInternals::OutPacket& packet) {
+  // Runs inside _handleQueue() with the semaphore held, in the order packets hit the wire,
+  // so an alias is always set up before a packet that uses it alone.
+  if (_protocolVersion != AsyncMqttClientInternals::ProtocolVersion.V5 ||
+      packet.packetType() != AsyncMqttClientInternals::PacketType.PUBLISH) {
+    return;
+  }
+  AsyncMqttClientInternals::PublishOutPacket& publish = static_cast<AsyncMqttClientInternals::PublishOutPacket&>(packet);
+  uint16_t topicLength;
+  const char* topic = publish.topic(&topicLength);
+  bool assigned;
+  const uint16_t alias = _topicAliases.lookup(topic, topicLength, &assigned);
+  publish.setTopicAlias(alias, assigned);
+}
+
+/* MQTT */
+void AsyncMqttClient::_onPingResp() {
+  log_i("PINGRESP");
+  _lastPingRequestTime = 0;
+}
+
+// MQTT 5 reason codes mapped onto the MQTT 3.1.1 return codes the disconnect reason uses.
+static AsyncMqttClientDisconnectReason refusalReason(uint8_t protocolVersion, uint8_t returnCode) {
+  if (protocolVersion != AsyncMqttClientInternals::ProtocolVersion.V5 || returnCode < 0x80) {
+    return static_cast<AsyncMqttClientDisconnectReason>(returnCode);
+  }
+  switch (returnCode) {
+    case 0x84:
+      return AsyncMqttClientDisconnectReason::MQTT_UNACCEPTABLE_PROTOCOL_VERSION;
+    case 0x85:
+      return AsyncMqttClientDisconnectReason::MQTT_IDENTIFIER_REJECTED;
+    case 0x86:
+      return AsyncMqttClientDisconnectReason::MQTT_MALFORMED_CREDENTIALS;
+    case 0x87:
+      return AsyncMqttClientDisconnectReason::MQTT_NOT_AUTHORIZED;
+    default:
+      return AsyncMqttClientDisconnectReason::MQTT_SERVER_UNAVAILABLE;  // busy, banned, quota, ...
+  }
+}
+
+void AsyncMqttClient::_onConnAck(bool sessionPresent, uint8_t connectReturnCode, const AsyncMqttClientInternals::ConnAckProperties& properties) {
+  log_i("CONNACK");
+  _client.setRxTimeout(0);
+  SEMAPHORE_TAKE();
+  _topicAliases.reset(properties.topicAliasMaximum);
+  SEMAPHORE_GIVE();
+  if (properties.hasServerKeepAlive) _connectionKeepAlive = properties.serverKeepAlive;
+  if (!sessionPresent) {
+    _pendingPubRels.clear();
+    _pendingPubRels.shrink_to_fit();
+    _clearQueue(false);  // remove session data
+  }
+
+  if (connectReturnCode == 0) {
+    _state = CONNECTED;
+    for (auto callback : _onConnectUserCallbacks) callback(sessionPresent);
+  } else {
+    // Callbacks are handled by the onDisconnect function which is called from the AsyncTcp lib
+    _disconnectReason = refusalReason(_protocolVersion, connectReturnCode);
+    return;
+  }
+  _handleQueue();  // send any remaining data from continued session
+}
+
+void AsyncMqttClient::_onSubAck(uint16_t packetId, char status) {
+  log_i("SUBACK");
+  _acknowledge(AsyncMqttClientInternals::PacketType.SUBSCRIBE, packetId);
+
+  for (auto callback : _onSubscribeUserCallbacks) callback(packetId, status);
+
+  _handleQueue();  // subscribe confirmed, ready to send next queued item
+}
+
+void AsyncMqttClient::_onUnsubAck(uint16_t packetId) {
+  log_i("UNSUBACK");
+  _acknowledge(AsyncMqttClientInternals::PacketType.UNSUBSCRIBE, packetId);
+
+  for (auto callback : _onUnsubscribeUserCallbacks) callback(packetId);
+
+  _handleQueue();  // unsubscribe confirmed, ready to send next queued item
+}
+
+void AsyncMqttClient::_onMessage(char* topic, char* payload, uint8_t qos, bool dup, bool retain, size_t len, size_t index, size_t total, uint16_t packetId) {
+  bool notifyPublish = true;
+
+  if (qos == 2) {
+    for (AsyncMqttClientInternals::PendingPubRel pendingPubRel : _pendingPubRels) {
+      if (pendingPubRel.packetId == packetId) {
+        notifyPublish = false;
+        break;
+      }
+    }
+  }
+
+  if (notifyPublish) {
+    AsyncMqttClientMessageProperties properties;
+    properties.qos = qos;
+    properties.dup = dup;
+    properties.retain = retain;
+
+    for (auto callback : _onMessageUserCallbacks) callback(topic, payload, properties, len, index, total);
+  }
+}
+
+void AsyncMqttClient::_onPublish(uint16_t packetId, uint8_t qos) {
+  AsyncMqttClientInternals::PendingAck pendingAck;
+
+  if (qos == 1) {
+    pendingAck.packetType = AsyncMqttClientInternals::PacketType.PUBACK;
+    pendingAck.headerFlag = AsyncMqttClientInternals::HeaderFlag.PUBACK_RESERVED;
+    pendingAck.packetId = packetId;
+    void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::PubAckOutPacket), true);
+    if (slot) _addBack(new (slot) AsyncMqttClientInternals::PubAckOutPacket(pendingAck), AsyncMqttClientInternals::OutPriority::ACK);
+  } else if (qos == 2) {
+    pendingAck.packetType = AsyncMqttClientInternals::PacketType.PUBREC;
+    pendingAck.headerFlag = AsyncMqttClientInternals::HeaderFlag.PUBREC_RESERVED;
+    pendingAck.packetId = packetId;
+    void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::PubAckOutPacket), true);
+    if (slot) _addBack(new (slot) AsyncMqttClientInternals::PubAckOutPacket(pendingAck), AsyncMqttClientInternals::OutPriority::ACK);
+
+    bool pubRelAwaiting = false;
+    for (AsyncMqttClientInternals::PendingPubRel pendingPubRel : _pendingPubRels) {
+      if (pendingPubRel.packetId == packetId) {
+        pubRelAwaiting = true;
+        break;
+      }
+    }
+
+    if (!pubRelAwaiting) {
+      AsyncMqttClientInternals::PendingPubRel pendingPubRel;
+      pendingPubRel.packetId = packetId;
+      _pendingPubRels.push_back(pendingPubRel);
+    }
+  }
+}
+
+void AsyncMqttClient::_onPubRel(uint16_t packetId) {
+  AsyncMqttClientInternals::PendingAck pendingAck;
+  pendingAck.packetType = AsyncMqttClientInternals::PacketType.PUBCOMP;
+  pendingAck.headerFlag = AsyncMqttClientInternals::HeaderFlag.PUBCOMP_RESERVED;
+  pendingAck.packetId = packetId;
+  // Without a slot the PUBREC stays in flight and the broker retransmits PUBREL.
+  void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::PubAckOutPacket), true);
+  if (slot) {
+    if (_acknowledge(AsyncMqttClientInternals::PacketType.PUBREC, packetId)) {
+      _addFront(new (slot) AsyncMqttClientInternals::PubAckOutPacket(pendingAck));
+    } else {
+      _outPackets.release(slot);
+    }
+  }
+
+  for (size_t i = 0; i < _pendingPubRels.size(); i++) {
+    if (_pendingPubRels[i].packetId == packetId) {
+      _pendingPubRels.erase(_pendingPubRels.begin() + i);
+      _pendingPubRels.shrink_to_fit();
+    }
+  }
+}
+
+void AsyncMqttClient::_onPubAck(uint16_t packetId) {
+  _acknowledge(AsyncMqttClientInternals::PacketType.PUBLISH, packetId);
+
+  for (auto callback : _onPublishUserCallbacks) callback(packetId);
+
+  _handleQueue();  // the window has room again
+}
+
+void AsyncMqttClient::_onPubRec(uint16_t packetId) {
+  // A QoS 2 PUB is sent with nothing else in flight (to honor message ordering),
+  // so the PUBREL simply goes to the front of the queue and stays in flight
+  // until a PUBCOMP comes in.
+  AsyncMqttClientInternals::PendingAck pendingAck;
+  pendingAck.packetType = AsyncMqttClientInternals::PacketType.PUBREL;
+  pendingAck.headerFlag = AsyncMqttClientInternals::HeaderFlag.PUBREL_RESERVED;
+  pendingAck.packetId = packetId;
+  log_i("snd PUBREL");
+
+  void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::PubAckOutPacket), true);
+  if (!slot) return;
+  AsyncMqttClientInternals::OutPacket* msg = new (slot) AsyncMqttClientInternals::PubAckOutPacket(pendingAck);
+  _acknowledge(AsyncMqttClientInternals::PacketType.PUBLISH, packetId);
+  _addFront(msg);
+}
+
+void AsyncMqttClient::_onPubComp(uint16_t packetId) {
+  _acknowledge(AsyncMqttClientInternals::PacketType.PUBREL, packetId);
+
+  for (auto callback : _onPublishUserCallbacks) callback(packetId);
+
+  _handleQueue();
+}
+
+void AsyncMqttClient::_onServerDisconnect(uint8_t reasonCode) {
+  log_w("rcv DISCONNECT (0x%02x)", reasonCode);
+  _disconnectReason = AsyncMqttClientDisconnectReason::MQTT_SERVER_DISCONNECTED;
+  disconnect(true);
+}
+
+void AsyncMqttClient::_onProtocolViolation() {
+  log_i("rcv PROTOCOL VIOLATION");
+  disconnect(true);
+}
+
+void AsyncMqttClient::_sendPing() {
+  log_i("PING");
+  _lastPingRequestTime = millis();
+  void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::PingReqOutPacket), true);
+  if (slot) _addBack(new (slot) AsyncMqttClientInternals::PingReqOutPacket, AsyncMqttClientInternals::OutPriority::ACK);
+}
+
+bool AsyncMqttClient::connected() const {
+  return _state == CONNECTED;
+}
+
+void AsyncMqttClient::connect() {
+  if (_state != DISCONNECTED) return;
+  log_i("CONNECTING");
+  _state = CONNECTING;
+  _disconnectReason = AsyncMqttClientDisconnectReason::TCP_DISCONNECTED;  // reset any previous
+  _connectionKeepAlive = _keepAlive;
+
+  _client.setRxTimeout(_keepAlive);
+
+#if ASYNC_TCP_SSL_ENABLED
+  if (_useIp) {
+    _client.connect(_ip, _port, _secure);
+  } else {
+    _client.connect(_host, _port, _secure);
+  }
+#else
+  if (_useIp) {
+    _client.connect(_ip, _port);
+  } else {
+    _client.connect(_host, _port);
+  }
+#endif
+}
+
+void AsyncMqttClient::disconnect(bool force) {
+  if (_state == DISCONNECTED) return;
+  log_i("DISCONNECT (f:%d)", force);
+  if (force) {
+    _state = DISCONNECTED;
+    _client.close(true);
+  } else if (_state != DISCONNECTING) {
+    void* slot = _acquireOutPacket(sizeof(AsyncMqttClientInternals::DisconnOutPacket), true);
+    if (!slot) {
+      _state = DISCONNECTED;
+      _client.close(true);
+      return;
+    }
+    _state = DISCONNECTING;
+    // Lowest priority: everything already queued goes out first.
+    if (!_addBack(new (slot) AsyncMqttClientInternals::DisconnOutPacket, AsyncMqttClientInternals::OutPriority::DIAGNOSTIC)) {
+      _state = DISCONNECTED;
+      _client.close(true);
+    }
+  }
+}
+
+uint16_t AsyncMqttClient::subscribe(const char* topic, uint8_t qos) {
+  if (_state != CONNECTED) {
+    _lastError = AsyncMqttClientError::NOT_CONNECTED;
+    return 0;
+  }
+  log_i("SUBSCRIBE");
+
+  const size_t size = sizeof(AsyncMqttClientInternals::SubscribeOutPacket) + AsyncMqttClientInternals::SubscribeOutPacket::neededSpace(topic, _protocolVersion);
+  void* slot = _acquireOutPacket(size, false);
+  if (!slot) return 0;
+  uint8_t* buffer = static_cast<uint8_t*>(slot) + sizeof(AsyncMqttClientInternals::SubscribeOutPacket);
+  AsyncMqttClientInternals::OutPacket* msg = new (slot) AsyncMqttClientInternals::SubscribeOutPacket(topic, qos, buffer, _protocolVersion);
+  const uint16_t packetId = msg->packetId();
+  if (!_addBack(msg)) return 0;
+  return packetId;
+}
+
+uint16_t AsyncMqttClient::unsubscribe(const char* topic) {
+  if (_state != CONNECTED) {
+    _lastError = AsyncMqttClientError::NOT_CONNECTED;
+    return 0;
+  }
+  log_i("UNSUBSCRIBE");
+
+  const size_t size = sizeof(AsyncMqttClientInternals::UnsubscribeOutPacket) + AsyncMqttClientInternals::UnsubscribeOutPacket::neededSpace(topic, _protocolVersion);
+  void* slot = _acquireOutPacket(size, false);
+  if (!slot) return 0;
+  uint8_t* buffer = static_cast<uint8_t*>(slot) + sizeof(AsyncMqttClientInternals::UnsubscribeOutPacket);
+  AsyncMqttClientInternals::OutPacket* msg = new (slot) AsyncMqttClientInternals::UnsubscribeOutPacket(topic, buffer, _protocolVersion);
+  const uint16_t packetId = msg->packetId();
+  if (!_addBack(msg)) return 0;
+  return packetId;
+}
+
+uint16_t AsyncMqttClient::publish(const char* topic, uint8_t qos, bool retain, const char* payload, size_t length, bool dup, uint16_t message_id) {
+  if (_state != CONNECTED) {
+    _lastError = AsyncMqttClientError::NOT_CONNECTED;
+    return 0;
+  }
+  // With a pool the memory is already reserved; the heap check only applies to heap mode.
+  if (!_outPackets.pooled() && GET_FREE_MEMORY() < MQTT_MIN_FREE_MEMORY) {
+    _lastError = AsyncMqttClientError::OUT_OF_MEMORY;
+    return 0;
+  }
+  log_i("PUBLISH");
+
+  const size_t size = sizeof(AsyncMqttClientInternals::PublishOutPacket) + AsyncMqttClientInternals::PublishOutPacket::neededSpace(topic, qos, payload, length, _protocolVersion);
+  void* slot = _acquireOutPacket(size, false);
+  if (!slot) return 0;
+  uint8_t* buffer = static_cast<uint8_t*>(slot) + sizeof(AsyncMqttClientInternals::PublishOutPacket);
+  AsyncMqttClientInternals::OutPacket* msg = new (slot) AsyncMqttClientInternals::PublishOutPacket(topic, qos, retain, payload, length, buffer, _protocolVersion);
+  const uint16_t packetId = msg->packetId();
+  if (!_addBack(msg)) return 0;
+  return packetId;
+}
+
+char* AsyncMqttClient::beginPublish(const char* topic, uint8_t qos, bool retain, size_t maxLength, AsyncMqttClientInternals::OutPriority priority) {
+  abortPublish();
+  if (_state != CONNECTED) {
+    _lastError = AsyncMqttClientError::NOT_CONNECTED;
+    return nullptr;
+  }
+  if (!_outPackets.pooled() && GET_FREE_MEMORY() < MQTT_MIN_FREE_MEMORY) {
+    _lastError = AsyncMqttClientError::OUT_OF_MEMORY;
+    return nullptr;
+  }
+
+  const size_t size = sizeof(AsyncMqttClientInternals::PublishOutPacket) + AsyncMqttClientInternals::PublishOutPacket::reservedSpace(topic, qos, maxLength, _protocolVersion);
+  void* slot = _acquireOutPacket(size, false);
+  if (!slot) return nullptr;
+  uint8_t* buffer = static_cast<uint8_t*>(slot) + sizeof(AsyncMqttClientInternals::PublishOutPacket);
+  _reservedPublish = new (slot) AsyncMqttClientInternals::PublishOutPacket(topic, qos, retain, maxLength, buffer, _protocolVersion);
+  _reservedPublish->priority = priority;
+  return reinterpret_cast<char*>(_reservedPublish->payload());
+}
+
+uint16_t AsyncMqttClient::endPublish(size_t length) {
+  AsyncMqttClientInternals::PublishOutPacket* msg = _reservedPublish;
+  if (!msg) return 0;
+  _reservedPublish = nullptr;
+  if (_state != CONNECTED) {
+    _lastError = AsyncMqttClientError::NOT_CONNECTED;
+    _destroyOutPacket(msg);
+    return 0;
+  }
+  log_i("PUBLISH");
+
+  msg->commit(length);
+  const uint16_t packetId = msg->packetId();
+  if (!_addBack(msg, msg->priority)) return 0;
+  return packetId;
+}
+
+void AsyncMqttClient::abortPublish() {
+  if (!_reservedPublish) return;
+  _destroyOutPacket(_reservedPublish);
+  _reservedPublish = nullptr;
+}
+
+bool AsyncMqttClient::clearQueue() {
+  if (_state != DISCONNECTED) return false;
+  _clearQueue(false);
+  return true;
+}
+
+const char* AsyncMqttClient::getClientId() const {
+  return _clientId;
+}
+
+bool AsyncMqttClient::setOutPacketPool(size_t slots, size_t slotSize, size_t reservedSlots) {
+  if (!_queue.empty()) return false;
+  return _outPackets.begin(slots, slotSize, reservedSlots);
+}
+
+AsyncMqttClient& AsyncMqttClient::setInFlightWindow(uint8_t window) {
+  SEMAPHORE_TAKE();
+  _queue.setWindow(window);
+  SEMAPHORE_GIVE();
+  return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setOutQueueBudget(size_t bytes) {
+  SEMAPHORE_TAKE();
+  _queue.setByteBudget(bytes);
+  SEMAPHORE_GIVE();
+  return *this;
+}
+
+const AsyncMqttClientInternals::OutPacketPool& AsyncMqttClient::outPacketPool() const {
+  return _outPackets;
+}
+
+const AsyncMqttClientInternals::OutQueue& AsyncMqttClient::outQueue() const {
+  return _queue;
+}
+
+AsyncMqttClientError AsyncMqttClient::lastError() const {
+  return _lastError;
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <functional>
+#include <new>  // placement new for pooled out packets
+#include <vector>
+
+#include "Arduino.h"
+
+#ifndef MQTT_MIN_FREE_MEMORY
+#define MQTT_MIN_FREE_MEMORY 4096
+#endif
+
+#ifdef ESP32
+#include <AsyncTCP.h>
+#include <freertos/semphr.h>
+#elif defined(ESP8266)
+#include <ESPAsyncTCP.h>
+#else
+#error Platform not supported
+#endif
+
+#if ASYNC_TCP_SSL_ENABLED
+#include <tcp_axtls.h>
+#define SHA1_SIZE 20
+#endif
+
+#include "AsyncMqttClient/Flags.hpp"
+#include "AsyncMqttClient/MessageProperties.hpp"
+#include "AsyncMqttClient/Helpers.hpp"
+#include "AsyncMqttClient/Callbacks.hpp"
+#include "AsyncMqttClient/DisconnectReasons.hpp"
+#include "AsyncMqttClient/Storage.hpp"
+
+#include "AsyncMqttClient/Packets/PacketParser.hpp"
+
+#include "AsyncMqttClient/Packets/Out/Connect.hpp"
+#include "AsyncMqttClient/Packets/Out/PingReq.hpp"
+#include "AsyncMqttClient/Packets/Out/PubAck.hpp"
+#include "AsyncMqttClient/Packets/Out/Disconn.hpp"
+#include "AsyncMqttClient/Packets/Out/Subscribe.hpp"
+#include "AsyncMqttClient/Packets/Out/Unsubscribe.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+#include "AsyncMqttClient/Packets/Out/OutPacketPool.hpp"
+#include "AsyncMqttClient/Packets/Out/OutQueue.hpp"
+#include "AsyncMqttClient/Packets/Out/TopicAliases.hpp"
+
+#if defined(ESP32)
+#include "AsyncMqttClient/Tls/TlsLayer.hpp"
+#endif
+
+class AsyncMqttClient : private AsyncMqttClientInternals::PacketHandler, private AsyncMqttClientInternals::OutTransport {
+ public:
+  AsyncMqttClient();
+  ~AsyncMqttClient();
+
+  AsyncMqttClient& setKeepAlive(uint16_t keepAlive);
+  AsyncMqttClient& setClientId(const char* clientId);
+  AsyncMqttClient& setCleanSession(bool cleanSession);
+  // ProtocolVersion.V3_1_1 (the default) or V5; set it before connect(). With MQTT 5 the
+  // client uses the topic aliases the broker allows, so repeated topics cost two bytes.
+  AsyncMqttClient& setProtocolVersion(uint8_t protocolVersion);
+  // MQTT 5: how long the broker keeps the session after the connection is gone. 0, the
+  // default, ends it with the connection, so setCleanSession(false) needs a value here.
+  AsyncMqttClient& setSessionExpiry(uint32_t seconds);
+  AsyncMqttClient& setMaxTopicLength(uint16_t maxTopicLength);
+  AsyncMqttClient& setCredentials(const char* username, const char* password = nullptr);
+  AsyncMqttClient& setWill(const char* topic, uint8_t qos, bool retain, const char* payload = nullptr, size_t length = 0);
+  AsyncMqttClient& setServer(IPAddress ip, uint16_t port);
+  AsyncMqttClient& setServer(const char* host, uint16_t port);
+  // Preallocates `slots` out packets of up to `slotSize` bytes each; call once in setup().
+  // Afterwards publish/subscribe/unsubscribe return 0 instead of allocating when the pool is full.
+  bool setOutPacketPool(size_t slots, size_t slotSize, size_t reservedSlots = 2);
+  // Number of QoS 1 publishes sent before waiting for their PUBACK (default 1).
+  // In-flight packets keep their pool slot until acknowledged.
+  AsyncMqttClient& setInFlightWindow(uint8_t window);
+  // Caps the bytes of queued, unsent packets (0, the default, means unlimited). See OutQueue
+  // for the drop policy; a refused publish returns 0 with lastError() QUEUE_FULL.
+  AsyncMqttClient& setOutQueueBudget(size_t bytes);
+#if ASYNC_TCP_SSL_ENABLED
+  AsyncMqttClient& setSecure(bool secure);
+  AsyncMqttClient& addServerFingerprint(const uint8_t* fingerprint);
+#endif
+#if defined(ESP32)
+  // TLS 1.2 over mbedTLS. The broker certificate must chain to `caCert` (PEM, kept by the
+  // caller) and match the host given to setServer(host, port).
+  AsyncMqttClient& setTls(const char* caCert);
+  // Where the session is kept between connections, so a reconnect resumes it instead of
+  // doing a full handshake. A record in RTC memory also survives deep sleep.
+  AsyncMqttClient& setTlsSessionRecord(AsyncMqttClientInternals::TlsSessionRecord* record);
+  const AsyncMqttClientInternals::TlsHandshakeStats& tlsStats() const;
+#endif
+
+  AsyncMqttClient& onConnect(AsyncMqttClientInternals::OnConnectUserCallback callback);
+  AsyncMqttClient& onDisconnect(AsyncMqttClientInternals::OnDisconnectUserCallback callback);
+  AsyncMqttClient& onSubscribe(AsyncMqttClientInternals::OnSubscribeUserCallback callback);
+  AsyncMqttClient& onUnsubscribe(AsyncMqttClientInternals::OnUnsubscribeUserCallback callback);
+  AsyncMqttClient& onMessage(AsyncMqttClientInternals::OnMessageUserCallback callback);
+  AsyncMqttClient& onPublish(AsyncMqttClientInternals::OnPublishUserCallback callback);
+
+  bool connected() const;
+  void connect();
+  void disconnect(bool force = false);
+  uint16_t subscribe(const char* topic, uint8_t qos);
+  uint16_t unsubscribe(const char* topic);
+  uint16_t publish(const char* topic, uint8_t qos, bool retain, const char* payload = nullptr, size_t length = 0, bool dup = false, uint16_t message_id = 0);
+  // Zero-copy publish: beginPublish() reserves the packet and returns where to write up to
+  // maxLength payload bytes; endPublish() queues it with the length actually written.
+  // One reservation at a time. Returns nullptr / 0 where publish() would return 0.
+  // An unsent retained publish is replaced by a newer one on the same topic and never
+  // reported to onPublish.
+  char* beginPublish(const char* topic, uint8_t qos, bool retain, size_t maxLength,
+                     AsyncMqttClientInternals::OutPriority priority = AsyncMqttClientInternals::OutPriority::STATE);
+  uint16_t endPublish(size_t length);
+  void abortPublish();
+  bool clearQueue();  // Not MQTT compliant!
+
+  const char* getClientId() const;
+  const AsyncMqttClientInternals::OutPacketPool& outPacketPool() const;
+  const AsyncMqttClientInternals::OutQueue& outQueue() const;
+  // Why the last publish/subscribe/unsubscribe returned 0.
+  AsyncMqttClientError lastError() const;
+
+ private:
+  AsyncClient _client;
+  AsyncMqttClientInternals::OutPacketPool _outPackets;
+  AsyncMqttClientInternals::OutQueue _queue;
+  AsyncMqttClientInternals::PublishOutPacket* _reservedPublish;
+  AsyncMqttClientError _lastError;
+  enum {
+    CONNECTING,
+    CONNECTED,
+    DISCONNECTING,
+    DISCONNECTED
+  } _state;
+  AsyncMqttClientDisconnectReason _disconnectReason;
+  uint32_t _lastClientActivity;
+  uint32_t _lastServerActivity;
+  uint32_t _lastPingRequestTime;
+
+  char _generatedClientId[18 + 1];  // esp8266-abc123 and esp32-abcdef123456
+  IPAddress _ip;
+  const char* _host;
+  bool _useIp;
+#if ASYNC_TCP_SSL_ENABLED
+  bool _secure;
+#endif
+  uint16_t _port;
+  uint16_t _keepAlive;
+  uint16_t _connectionKeepAlive;  // _keepAlive, or the Server Keep Alive of an MQTT 5 CONNACK
+  bool _cleanSession;
+  uint8_t _protocolVersion;
+  uint32_t _sessionExpiry;
+  const char* _clientId;
+  const char* _username;
+  const char* _password;
+  const char* _willTopic;
+  const char* _willPayload;
+  uint16_t _willPayloadLength;
+  uint8_t _willQos;
+  bool _willRetain;
+
+#if ASYNC_TCP_SSL_ENABLED
+  std::vector<std::array<uint8_t, SHA1_SIZE>> _secureServerFingerprints;
+#endif
+
+  std::vector<AsyncMqttClientInternals::OnConnectUserCallback> _onConnectUserCallbacks;
+  std::vector<AsyncMqttClientInternals::OnDisconnectUserCallback> _onDisconnectUserCallbacks;
+  std::vector<AsyncMqttClientInternals::OnSubscribeUserCallback> _onSubscribeUserCallbacks;
+  std::vector<AsyncMqttClientInternals::OnUnsubscribeUserCallback> _onUnsubscribeUserCallbacks;
+  std::vector<AsyncMqttClientInternals::OnMessageUserCallback> _onMessageUserCallbacks;
+  std::vector<AsyncMqttClientInternals::OnPublishUserCallback> _onPublishUserCallbacks;
+
+  AsyncMqttClientInternals::PacketParser _parser;
+  char* _topicBuffer;
+  AsyncMqttClientInternals::TopicAliasTable _topicAliases;  // guarded by the semaphore
+#if defined(ESP32)
+  AsyncMqttClientInternals::TlsLayer _tls;  // guarded by the semaphore
+  char _tlsReadBuffer[512];
+#endif
+
+  std::vector<AsyncMqttClientInternals::PendingPubRel> _pendingPubRels;
+
+#if defined(ESP32)
+  SemaphoreHandle_t _xSemaphore = nullptr;
+#elif defined(ESP8266)
+  bool _xSemaphore = false;
+#endif
+
+  void _clear();
+
+  // TCP
+  void _onConnect();
+  void _onDisconnect();
+  // void _onError(int8_t error);
+  // void _onTimeout();
+  void _onAck(size_t len);
+  void _onData(char* data, size_t len);
+  void _onPoll();
+#if defined(ESP32)
+  void _onTlsData(char* data, size_t len);
+  void _onTlsProgress(AsyncMqttClientInternals::TlsLayer::Progress progress);
+#endif
+
+  // QUEUE
+  void _addFront(AsyncMqttClientInternals::OutPacket* packet);  // for CONNECT, PUBREL and PUBCOMP
+  bool _addBack(AsyncMqttClientInternals::OutPacket* packet,    // all the rest
+                AsyncMqttClientInternals::OutPriority priority = AsyncMqttClientInternals::OutPriority::STATE);
+  void _handleQueue();
+  bool _acknowledge(uint8_t packetType, uint16_t packetId);
+  void _clearQueue(bool keepSessionData);
+  void* _acquireOutPacket(size_t size, bool protocolPacket);
+  void _destroyOutPacket(AsyncMqttClientInternals::OutPacket* packet);
+  size_t space() override;
+  size_t add(const char* data, size_t size) override;
+  bool send() override;
+  void prepare(AsyncMqttClientInternals::OutPacket& packet) override;
+
+  // MQTT
+  void _sendConnect();
+  void _onPingResp() override;
+  void _onConnAck(bool sessionPresent, uint8_t connectReturnCode, const AsyncMqttClientInternals::ConnAckProperties& properties) override;
+  void _onSubAck(uint16_t packetId, char status) override;
+  void _onUnsubAck(uint16_t packetId) override;
+  void _onMessage(char* topic, char* payload, uint8_t qos, bool dup, bool retain, size_t len, size_t index, size_t total, uint16_t packetId) override;
+  void _onPublish(uint16_t packetId, uint8_t qos) override;
+  void _onPubRel(uint16_t packetId) override;
+  void _onPubAck(uint16_t packetId) override;
+  void _onPubRec(uint16_t packetId) override;
+  void _onPubComp(uint16_t packetId) override;
+  void _onServerDisconnect(uint8_t reasonCode) override;
+  void _onProtocolViolation() override;
+
+  void _sendPing();
+};
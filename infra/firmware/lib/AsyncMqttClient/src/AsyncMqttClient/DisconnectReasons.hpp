@@ -11,5 +11,9 @@ enum class AsyncMqttClientDisconnectReason : uint8_t {
 
   ESP8266_NOT_ENOUGH_SPACE = 6,
 
-  TLS_BAD_FINGERPRINT = 7
+  TLS_BAD_FINGERPRINT = 7,
+
+  MQTT_SERVER_DISCONNECTED = 8,  // MQTT 5 DISCONNECT from the broker
+
+  TLS_HANDSHAKE_FAILED = 9
 };
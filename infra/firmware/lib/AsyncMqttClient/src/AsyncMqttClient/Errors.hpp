@@ -0,0 +1,10 @@
+#pragma once
+
+enum class AsyncMqttClientError : uint8_t {
+  MAX_RETRIES = 0,
+  OUT_OF_MEMORY = 1,
+  POOL_EXHAUSTED = 2,
+  PACKET_TOO_LARGE = 3,
+  NOT_CONNECTED = 4,
+  QUEUE_FULL = 5
+};
@@ -11,7 +11,9 @@ ConnectOutPacket::ConnectOutPacket(bool cleanSession,
                                    const char* willPayload,
                                    uint16_t willPayloadLength,
                                    uint16_t keepAlive,
-                                   const char* clientId) {
+                                   const char* clientId,
+                                   uint8_t protocolVersion,
+                                   uint32_t sessionExpiryInterval) {
   char fixedHeader[5];
   fixedHeader[0] = AsyncMqttClientInternals::PacketType.CONNECT;
   fixedHeader[0] = fixedHeader[0] << 4;
@@ -23,7 +25,25 @@ ConnectOutPacket::ConnectOutPacket(bool cleanSession,
   protocolNameLengthBytes[1] = protocolNameLength & 0xFF;
 
   char protocolLevel[1];
-  protocolLevel[0] = 0x04;
+  protocolLevel[0] = protocolVersion;
+  const bool v5 = protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5;
+
+  // MQTT 5: the property length and Session Expiry Interval follow the keep alive; the will
+  // gets an empty property list.
+  char properties[1 + 5];
+  uint8_t propertiesLength = 0;
+  if (v5) {
+    properties[propertiesLength++] = 0;
+    if (sessionExpiryInterval != 0) {
+      properties[propertiesLength++] = AsyncMqttClientInternals::Property.SESSION_EXPIRY_INTERVAL;
+      properties[propertiesLength++] = sessionExpiryInterval >> 24;
+      properties[propertiesLength++] = (sessionExpiryInterval >> 16) & 0xFF;
+      properties[propertiesLength++] = (sessionExpiryInterval >> 8) & 0xFF;
+      properties[propertiesLength++] = sessionExpiryInterval & 0xFF;
+    }
+    properties[0] = propertiesLength - 1;
+  }
+  const uint8_t willPropertiesLength = v5 ? 1 : 0;
 
   char connectFlags[1];
   connectFlags[0] = 0;
@@ -86,8 +106,8 @@ ConnectOutPacket::ConnectOutPacket(bool cleanSession,
     passwordLengthBytes[1] = passwordLength & 0xFF;
   }
 
-  uint32_t remainingLength = 2 + protocolNameLength + 1 + 1 + 2 + 2 + clientIdLength;  // always present
-  if (willTopic != nullptr) remainingLength += 2 + willTopicLength + 2 + willPayloadLength;
+  uint32_t remainingLength = 2 + protocolNameLength + 1 + 1 + 2 + propertiesLength + 2 + clientIdLength;  // always present
+  if (willTopic != nullptr) remainingLength += willPropertiesLength + 2 + willTopicLength + 2 + willPayloadLength;
   if (username != nullptr) remainingLength += 2 + usernameLength;
   if (password != nullptr) remainingLength += 2 + passwordLength;
   uint8_t remainingLengthLength = AsyncMqttClientInternals::Helpers::encodeRemainingLength(remainingLength, fixedHeader + 1);
@@ -98,9 +118,11 @@ ConnectOutPacket::ConnectOutPacket(bool cleanSession,
   neededSpace += 1;
   neededSpace += 1;
   neededSpace += 2;
+  neededSpace += propertiesLength;
   neededSpace += 2;
   neededSpace += clientIdLength;
   if (willTopic != nullptr) {
+    neededSpace += willPropertiesLength;
     neededSpace += 2;
     neededSpace += willTopicLength;
 
@@ -117,6 +139,7 @@ ConnectOutPacket::ConnectOutPacket(bool cleanSession,
   }
 
   _data.reserve(neededSpace);
+  _trackBuffer(_data.capacity());
 
   _data.insert(_data.end(), fixedHeader, fixedHeader + 1 + remainingLengthLength);
 
@@ -132,11 +155,13 @@ ConnectOutPacket::ConnectOutPacket(bool cleanSession,
   _data.push_back(connectFlags[0]);
   _data.push_back(keepAliveBytes[0]);
   _data.push_back(keepAliveBytes[1]);
+  _data.insert(_data.end(), properties, properties + propertiesLength);
   _data.push_back(clientIdLengthBytes[0]);
   _data.push_back(clientIdLengthBytes[1]);
 
   _data.insert(_data.end(), clientId, clientId + clientIdLength);
   if (willTopic != nullptr) {
+    if (v5) _data.push_back(0);  // will properties
     _data.insert(_data.end(), willTopicLengthBytes, willTopicLengthBytes + 2);
     _data.insert(_data.end(), willTopic, willTopic + willTopicLength);
 
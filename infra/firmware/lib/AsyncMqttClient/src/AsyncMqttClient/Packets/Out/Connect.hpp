@@ -19,7 +19,9 @@ class ConnectOutPacket : public OutPacket {
                    const char* willPayload,
                    uint16_t willPayloadLength,
                    uint16_t keepAlive,
-                   const char* clientId);
+                   const char* clientId,
+                   uint8_t protocolVersion = ProtocolVersion.V3_1_1,
+                   uint32_t sessionExpiryInterval = 0);  // MQTT 5 only; 0 ends the session with the connection
   const uint8_t* data(size_t index = 0) const;
   size_t size() const;
 
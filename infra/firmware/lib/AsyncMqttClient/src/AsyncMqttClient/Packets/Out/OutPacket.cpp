@@ -4,12 +4,29 @@ using AsyncMqttClientInternals::OutPacket;
 
 OutPacket::OutPacket()
 : next(nullptr)
+, priority(OutPriority::STATE)
 , timeout(0)
 , noTries(0)
 , _released(true)
-, _packetId(0) {}
+, _packetId(0)
+, _bufferBytes(0) {}
 
-OutPacket::~OutPacket() {}
+OutPacket::~OutPacket() {
+  if (_bufferBytes != 0 && _allocationHook) _allocationHook(_bufferBytes, false);
+}
+
+void OutPacket::setAllocationHook(OutPacketAllocationHook hook) {
+  _allocationHook = hook;
+}
+
+AsyncMqttClientInternals::OutPacketAllocationHook OutPacket::allocationHook() {
+  return _allocationHook;
+}
+
+void OutPacket::_trackBuffer(size_t bytes) {
+  _bufferBytes = bytes;
+  if (_bufferBytes != 0 && _allocationHook) _allocationHook(_bufferBytes, true);
+}
 
 bool OutPacket::released() const {
   return _released;
@@ -25,7 +42,7 @@ uint16_t OutPacket::packetId() const {
 
 uint8_t OutPacket::qos() const {
   if (packetType() == AsyncMqttClientInternals::PacketType.PUBLISH) {
-    return (data()[1] & 0x06) >> 1;
+    return (data()[0] & 0x06) >> 1;
   }
   return 0;
 }
@@ -35,6 +52,7 @@ void OutPacket::release() {
 }
 
 uint16_t OutPacket::_nextPacketId = 0;
+AsyncMqttClientInternals::OutPacketAllocationHook OutPacket::_allocationHook = nullptr;
 
 uint16_t OutPacket::_getNextPacketId() {
   if (++_nextPacketId == 0) {
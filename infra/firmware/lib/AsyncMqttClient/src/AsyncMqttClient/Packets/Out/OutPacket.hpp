@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+#include <algorithm>  // std::min
+
+#include "../../Flags.hpp"
+
+namespace AsyncMqttClientInternals {
+// Send order between unsent packets; lower values go first.
+enum class OutPriority : uint8_t {
+  STATE = 0,       // CONNECT, SUBSCRIBE and current-state publishes
+  ACK = 1,         // PUBACK, PUBREC and PINGREQ
+  DIAGNOSTIC = 2,  // diagnostics, logs and DISCONNECT
+};
+constexpr size_t OUT_PRIORITY_COUNT = 3;
+
+// Called for every out packet allocation (allocated = true) and release, with its size in bytes.
+typedef void (*OutPacketAllocationHook)(size_t bytes, bool allocated);
+
+class OutPacket {
+ public:
+  OutPacket();
+  virtual ~OutPacket();
+  static void setAllocationHook(OutPacketAllocationHook hook);
+  static OutPacketAllocationHook allocationHook();
+  virtual const uint8_t* data(size_t index = 0) const = 0;
+  virtual size_t size() const = 0;
+  bool released() const;
+  uint8_t packetType() const;
+  uint16_t packetId() const;
+  uint8_t qos() const;
+  void release();
+
+ public:
+  OutPacket* next;
+  OutPriority priority;
+  uint32_t timeout;
+  uint8_t noTries;
+
+ protected:
+  static uint16_t _getNextPacketId();
+  // Reports a separately allocated buffer to the allocation hook; released in the destructor.
+  void _trackBuffer(size_t bytes);
+  bool _released;
+  uint16_t _packetId;
+
+ private:
+  static uint16_t _nextPacketId;
+  static OutPacketAllocationHook _allocationHook;
+  size_t _bufferBytes;
+};
+}  // namespace AsyncMqttClientInternals
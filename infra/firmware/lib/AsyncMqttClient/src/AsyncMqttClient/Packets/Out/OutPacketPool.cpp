@@ -0,0 +1,162 @@
+#include "OutPacketPool.hpp"
+
+#include <new>
+
+#include "OutPacket.hpp"
+
+using AsyncMqttClientInternals::OutPacketPool;
+
+// Heap-mode blocks carry their size in front so release() can report it.
+static const size_t HEAP_HEADER_SIZE = alignof(max_align_t);
+
+static size_t alignSlot(size_t size) {
+  const size_t alignment = alignof(max_align_t);
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static void notifyHook(size_t bytes, bool allocated) {
+  AsyncMqttClientInternals::OutPacketAllocationHook hook = AsyncMqttClientInternals::OutPacket::allocationHook();
+  if (hook) hook(bytes, allocated);
+}
+
+OutPacketPool::OutPacketPool()
+: _storage(nullptr)
+, _freeSlots(nullptr)
+, _slotCount(0)
+, _slotSize(0)
+, _reservedSlots(0)
+, _freeCount(0)
+, _highWaterMark(0)
+, _failedAcquires(0)
+#if defined(ARDUINO_ARCH_ESP32)
+, _mux(portMUX_INITIALIZER_UNLOCKED)
+#endif
+{}
+
+OutPacketPool::~OutPacketPool() {
+  if (_storage) {
+    notifyHook(_slotCount * _slotSize + _slotCount * sizeof(uint16_t), false);
+  }
+  ::operator delete(_storage);
+  ::operator delete(_freeSlots);
+}
+
+bool OutPacketPool::begin(size_t slotCount, size_t slotSize, size_t reservedSlots) {
+  if (_storage || slotCount == 0 || slotCount > UINT16_MAX || reservedSlots >= slotCount) return false;
+
+  const size_t alignedSlotSize = alignSlot(slotSize);
+  uint8_t* storage = static_cast<uint8_t*>(::operator new(slotCount * alignedSlotSize, std::nothrow));
+  uint16_t* freeSlots = static_cast<uint16_t*>(::operator new(slotCount * sizeof(uint16_t), std::nothrow));
+  if (!storage || !freeSlots) {
+    ::operator delete(storage);
+    ::operator delete(freeSlots);
+    return false;
+  }
+
+  for (size_t i = 0; i < slotCount; i++) {
+    // Hand out low slots first.
+    freeSlots[i] = static_cast<uint16_t>(slotCount - 1 - i);
+  }
+
+  _lock();
+  _storage = storage;
+  _freeSlots = freeSlots;
+  _slotCount = slotCount;
+  _slotSize = alignedSlotSize;
+  _reservedSlots = reservedSlots;
+  _freeCount = slotCount;
+  _unlock();
+  notifyHook(slotCount * alignedSlotSize + slotCount * sizeof(uint16_t), true);
+  return true;
+}
+
+bool OutPacketPool::pooled() const {
+  return _storage != nullptr;
+}
+
+void* OutPacketPool::acquire(size_t size, bool protocolPacket, Result* result) {
+  if (!_storage) {
+    uint8_t* block = static_cast<uint8_t*>(::operator new(HEAP_HEADER_SIZE + size, std::nothrow));
+    if (result) *result = block ? Result::OK : Result::OUT_OF_MEMORY;
+    if (!block) return nullptr;
+    *reinterpret_cast<size_t*>(block) = size;
+    notifyHook(size, true);
+    return block + HEAP_HEADER_SIZE;
+  }
+
+  Result outcome = Result::OK;
+  void* ptr = nullptr;
+  _lock();
+  if (size > _slotSize) {
+    outcome = Result::TOO_LARGE;
+  } else if (_freeCount == 0 || (!protocolPacket && _freeCount <= _reservedSlots)) {
+    outcome = Result::EXHAUSTED;
+  } else {
+    const uint16_t slot = _freeSlots[--_freeCount];
+    ptr = _storage + static_cast<size_t>(slot) * _slotSize;
+    const size_t used = _slotCount - _freeCount;
+    if (used > _highWaterMark) _highWaterMark = used;
+  }
+  if (!ptr) _failedAcquires++;
+  _unlock();
+
+  if (result) *result = outcome;
+  return ptr;
+}
+
+void OutPacketPool::release(void* ptr) {
+  if (!ptr) return;
+
+  if (!owns(ptr)) {
+    uint8_t* block = static_cast<uint8_t*>(ptr) - HEAP_HEADER_SIZE;
+    notifyHook(*reinterpret_cast<size_t*>(block), false);
+    ::operator delete(block);
+    return;
+  }
+
+  const size_t slot = (static_cast<uint8_t*>(ptr) - _storage) / _slotSize;
+  _lock();
+  _freeSlots[_freeCount++] = static_cast<uint16_t>(slot);
+  _unlock();
+}
+
+bool OutPacketPool::owns(const void* ptr) const {
+  const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+  return _storage && bytes >= _storage && bytes < _storage + _slotCount * _slotSize;
+}
+
+size_t OutPacketPool::slotCount() const {
+  return _slotCount;
+}
+
+size_t OutPacketPool::slotSize() const {
+  return _slotSize;
+}
+
+size_t OutPacketPool::inUse() const {
+  return _slotCount - _freeCount;
+}
+
+size_t OutPacketPool::highWaterMark() const {
+  return _highWaterMark;
+}
+
+uint32_t OutPacketPool::failedAcquires() const {
+  return _failedAcquires;
+}
+
+void OutPacketPool::_lock() {
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&_mux);
+#else
+  _mutex.lock();
+#endif
+}
+
+void OutPacketPool::_unlock() {
+#if defined(ARDUINO_ARCH_ESP32)
+  portEXIT_CRITICAL(&_mux);
+#else
+  _mutex.unlock();
+#endif
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#else
+#include <mutex>
+#endif
+
+namespace AsyncMqttClientInternals {
+/*
+ * Fixed-capacity slab for out packets. Every packet (object plus its wire bytes)
+ * takes one slot, so steady-state publishing never touches the heap.
+ * Until begin() is called, acquire/release fall back to the heap.
+ *
+ * The last `reservedSlots` slots are kept for protocol packets (PUBACK, PINGREQ,
+ * DISCONNECT, ...) so application publishes cannot starve the session.
+ */
+class OutPacketPool {
+ public:
+  enum class Result : uint8_t {
+    OK = 0,
+    EXHAUSTED = 1,
+    TOO_LARGE = 2,
+    OUT_OF_MEMORY = 3
+  };
+
+  OutPacketPool();
+  ~OutPacketPool();
+  OutPacketPool(const OutPacketPool&) = delete;
+  OutPacketPool& operator=(const OutPacketPool&) = delete;
+
+  // Preallocates the slab. Can only be called once, before any packet is queued.
+  bool begin(size_t slotCount, size_t slotSize, size_t reservedSlots);
+  bool pooled() const;
+
+  void* acquire(size_t size, bool protocolPacket, Result* result = nullptr);
+  void release(void* ptr);
+  bool owns(const void* ptr) const;
+
+  size_t slotCount() const;
+  size_t slotSize() const;
+  size_t inUse() const;
+  size_t highWaterMark() const;
+  uint32_t failedAcquires() const;
+
+ private:
+  void _lock();
+  void _unlock();
+
+  uint8_t* _storage;
+  uint16_t* _freeSlots;
+  size_t _slotCount;
+  size_t _slotSize;
+  size_t _reservedSlots;
+  size_t _freeCount;
+  size_t _highWaterMark;
+  uint32_t _failedAcquires;
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_TYPE _mux;
+#else
+  std::mutex _mutex;
+#endif
+};
+}  // namespace AsyncMqttClientInternals
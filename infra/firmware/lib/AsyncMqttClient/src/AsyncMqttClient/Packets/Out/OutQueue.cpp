@@ -0,0 +1,356 @@
+#include "OutQueue.hpp"
+
+#include <cstring>  // memcmp
+
+#include "Publish.hpp"
+
+using AsyncMqttClientInternals::OutQueue;
+
+static bool isWindowed(const AsyncMqttClientInternals::OutPacket* packet) {
+  return packet->packetType() == AsyncMqttClientInternals::PacketType.PUBLISH && packet->qos() == 1;
+}
+
+// MQTT 3.1.1 section 4.4: what has to be resent when the session continues.
+static bool isSessionState(const AsyncMqttClientInternals::OutPacket* packet) {
+  const uint8_t type = packet->packetType();
+  return (type == AsyncMqttClientInternals::PacketType.PUBLISH && packet->qos() > 0) ||
+         type == AsyncMqttClientInternals::PacketType.PUBREC ||
+         type == AsyncMqttClientInternals::PacketType.PUBREL ||
+         type == AsyncMqttClientInternals::PacketType.PUBCOMP;
+}
+
+static const AsyncMqttClientInternals::PublishOutPacket* asRetainedPublish(const AsyncMqttClientInternals::OutPacket* packet) {
+  if (packet->packetType() != AsyncMqttClientInternals::PacketType.PUBLISH) return nullptr;
+  const AsyncMqttClientInternals::PublishOutPacket* publish = static_cast<const AsyncMqttClientInternals::PublishOutPacket*>(packet);
+  return publish->retain() ? publish : nullptr;
+}
+
+static size_t priorityIndex(const AsyncMqttClientInternals::OutPacket* packet) {
+  return static_cast<size_t>(packet->priority);
+}
+
+OutQueue::OutQueue(OutPacketPool& pool)
+: _pool(pool)
+, _heads()
+, _tails()
+, _inFlightHead(nullptr)
+, _inFlightTail(nullptr)
+, _writing(nullptr)
+, _sent(0)
+, _queued(0)
+, _queuedBytes(0)
+, _byteBudget(0)
+, _inFlight(0)
+, _inFlightHighWaterMark(0)
+, _coalesced(0)
+, _dropped(0)
+, _blocked(false)
+, _window(1) {}
+
+OutQueue::~OutQueue() {
+  clear(false);
+}
+
+void OutQueue::setWindow(uint8_t window) {
+  _window = window == 0 ? 1 : window;
+}
+
+uint8_t OutQueue::window() const {
+  return _window;
+}
+
+void OutQueue::setByteBudget(size_t bytes) {
+  _byteBudget = bytes;
+}
+
+size_t OutQueue::byteBudget() const {
+  return _byteBudget;
+}
+
+bool OutQueue::pushBack(OutPacket* packet) {
+  if (!_makeRoom(packet, _findRetained(packet, nullptr))) {
+    _dropped++;
+    return false;
+  }
+
+  OutPacket* previous;
+  OutPacket* older = _findRetained(packet, &previous);
+  if (!older) {
+    _appendQueued(packet);
+    return true;
+  }
+
+  // Take the older message's place in line.
+  const size_t priority = priorityIndex(packet);
+  packet->next = older->next;
+  if (previous) {
+    previous->next = packet;
+  } else {
+    _heads[priority] = packet;
+  }
+  if (_tails[priority] == older) _tails[priority] = packet;
+  _queuedBytes = _queuedBytes - older->size() + packet->size();
+  _destroy(older);
+  _coalesced++;
+  return true;
+}
+
+void OutQueue::pushFront(OutPacket* packet) {
+  const size_t priority = priorityIndex(packet);
+  OutPacket* head = _heads[priority];
+  if (head && head == _writing) {
+    // Never split a packet that is partly on the wire.
+    packet->next = head->next;
+    head->next = packet;
+    if (_tails[priority] == head) _tails[priority] = packet;
+  } else {
+    packet->next = head;
+    _heads[priority] = packet;
+    if (!_tails[priority]) _tails[priority] = packet;
+  }
+  _queued++;
+  _queuedBytes += packet->size();
+}
+
+bool OutQueue::write(OutTransport& transport) {
+  bool disconnect = false;
+  while (transport.space() > 10) {  // safe but arbitrary value, send at least 10 bytes
+    OutPacket* packet = _writing;
+    if (!packet) {
+      packet = _next();
+      if (!packet) break;
+      _queuedBytes -= packet->size();
+      transport.prepare(*packet);
+      _queuedBytes += packet->size();
+      _writing = packet;
+    }
+
+    // On SSL the TCP library returns the total amount of bytes, not just the unencrypted payload length.
+    // So we count the amount written ourselves.
+    size_t willSend = std::min(packet->size() - _sent, transport.space());
+    transport.add(reinterpret_cast<const char*>(packet->data(_sent)), willSend);
+    _sent += willSend;
+    transport.send();
+    if (_sent < packet->size()) continue;
+
+    _unlink(priorityIndex(packet), nullptr, packet);
+    _writing = nullptr;
+    _sent = 0;
+    if (packet->packetType() == AsyncMqttClientInternals::PacketType.DISCONNECT) disconnect = true;
+    if (packet->released()) {
+      _destroy(packet);
+    } else {
+      _appendInFlight(packet);
+    }
+  }
+  return disconnect;
+}
+
+bool OutQueue::acknowledge(uint8_t packetType, uint16_t packetId) {
+  OutPacket* previous = nullptr;
+  for (OutPacket* packet = _inFlightHead; packet; previous = packet, packet = packet->next) {
+    if (packet->packetType() != packetType || packet->packetId() != packetId) continue;
+
+    if (previous) {
+      previous->next = packet->next;
+    } else {
+      _inFlightHead = packet->next;
+    }
+    if (_inFlightTail == packet) _inFlightTail = previous;
+    _inFlight--;
+    if (!isWindowed(packet)) _blocked = false;
+    _destroy(packet);
+    return true;
+  }
+  return false;
+}
+
+void OutQueue::clear(bool keepSessionData) {
+  OutPacket* inFlight = _inFlightHead;
+  OutPacket* queued[OUT_PRIORITY_COUNT];
+  for (size_t priority = 0; priority < OUT_PRIORITY_COUNT; priority++) {
+    queued[priority] = _heads[priority];
+    _heads[priority] = nullptr;
+    _tails[priority] = nullptr;
+  }
+  _inFlightHead = nullptr;
+  _inFlightTail = nullptr;
+  _writing = nullptr;
+  _sent = 0;
+  _queued = 0;
+  _queuedBytes = 0;
+  _inFlight = 0;
+  _blocked = false;
+
+  // Written packets go first so they are resent in their original order.
+  while (inFlight) {
+    OutPacket* next = inFlight->next;
+    if (keepSessionData && isSessionState(inFlight)) {
+      if (inFlight->packetType() == AsyncMqttClientInternals::PacketType.PUBLISH) {
+        static_cast<PublishOutPacket*>(inFlight)->setDup();
+      }
+      _appendQueued(inFlight);
+    } else {
+      _destroy(inFlight);
+    }
+    inFlight = next;
+  }
+  for (size_t priority = 0; priority < OUT_PRIORITY_COUNT; priority++) {
+    while (queued[priority]) {
+      OutPacket* next = queued[priority]->next;
+      if (keepSessionData && isSessionState(queued[priority])) {
+        _appendQueued(queued[priority]);
+      } else {
+        _destroy(queued[priority]);
+      }
+      queued[priority] = next;
+    }
+  }
+}
+
+bool OutQueue::empty() const {
+  return _queued == 0 && !_inFlightHead;
+}
+
+size_t OutQueue::inFlight() const {
+  return _inFlight;
+}
+
+size_t OutQueue::queued() const {
+  return _queued;
+}
+
+size_t OutQueue::queuedBytes() const {
+  return _queuedBytes;
+}
+
+size_t OutQueue::inFlightHighWaterMark() const {
+  return _inFlightHighWaterMark;
+}
+
+uint32_t OutQueue::coalesced() const {
+  return _coalesced;
+}
+
+uint32_t OutQueue::dropped() const {
+  return _dropped;
+}
+
+bool OutQueue::_canStart(const OutPacket* packet) const {
+  if (_blocked) return false;
+  if (packet->packetType() == AsyncMqttClientInternals::PacketType.DISCONNECT) return _inFlight == 0;
+  if (packet->released()) return true;
+  if (isWindowed(packet)) return _inFlight < _window;
+  return _inFlight == 0;
+}
+
+AsyncMqttClientInternals::OutPacket* OutQueue::_next() {
+  bool waiting = false;
+  for (size_t priority = 0; priority < OUT_PRIORITY_COUNT; priority++) {
+    OutPacket* packet = _heads[priority];
+    if (!packet) continue;
+    if (_canStart(packet) &&
+        (!waiting || (packet->released() && packet->packetType() != AsyncMqttClientInternals::PacketType.DISCONNECT))) {
+      return packet;
+    }
+    waiting = true;
+  }
+  return nullptr;
+}
+
+// The unsent retained PUBLISH on the same topic and priority as `packet`, if any.
+AsyncMqttClientInternals::OutPacket* OutQueue::_findRetained(const OutPacket* packet, OutPacket** previous) const {
+  const PublishOutPacket* publish = asRetainedPublish(packet);
+  if (!publish) return nullptr;
+  uint16_t topicLength;
+  const char* topic = publish->topic(&topicLength);
+
+  OutPacket* before = nullptr;
+  for (OutPacket* queued = _heads[priorityIndex(packet)]; queued; before = queued, queued = queued->next) {
+    const PublishOutPacket* older = queued == _writing ? nullptr : asRetainedPublish(queued);
+    if (!older) continue;
+    uint16_t olderLength;
+    const char* olderTopic = older->topic(&olderLength);
+    if (olderLength == topicLength && memcmp(olderTopic, topic, topicLength) == 0) {
+      if (previous) *previous = before;
+      return queued;
+    }
+  }
+  return nullptr;
+}
+
+bool OutQueue::_makeRoom(const OutPacket* packet, const OutPacket* replaced) {
+  const size_t kept = _queuedBytes - (replaced ? replaced->size() : 0);
+  if (_byteBudget == 0 || kept + packet->size() <= _byteBudget) return true;
+  if (packet->size() > _byteBudget) return false;
+
+  // Drop nothing unless enough can be dropped.
+  const size_t lowest = packet->priority == OutPriority::DIAGNOSTIC ? priorityIndex(packet) : priorityIndex(packet) + 1;
+  size_t droppable = 0;
+  for (size_t priority = lowest; priority < OUT_PRIORITY_COUNT; priority++) {
+    for (OutPacket* queued = _heads[priority]; queued; queued = queued->next) {
+      if (queued != _writing && queued != replaced) droppable += queued->size();
+    }
+  }
+  if (kept - droppable + packet->size() > _byteBudget) return false;
+
+  for (size_t priority = OUT_PRIORITY_COUNT; priority-- > lowest;) {
+    OutPacket* previous = nullptr;
+    OutPacket* queued = _heads[priority];
+    while (queued && _queuedBytes - (replaced ? replaced->size() : 0) + packet->size() > _byteBudget) {
+      OutPacket* next = queued->next;
+      if (queued == _writing || queued == replaced) {
+        previous = queued;
+      } else {
+        _unlink(priority, previous, queued);
+        _destroy(queued);
+        _dropped++;
+      }
+      queued = next;
+    }
+  }
+  return true;
+}
+
+void OutQueue::_unlink(size_t priority, OutPacket* previous, OutPacket* packet) {
+  if (previous) {
+    previous->next = packet->next;
+  } else {
+    _heads[priority] = packet->next;
+  }
+  if (_tails[priority] == packet) _tails[priority] = previous;
+  packet->next = nullptr;
+  _queued--;
+  _queuedBytes -= packet->size();
+}
+
+void OutQueue::_appendQueued(OutPacket* packet) {
+  const size_t priority = priorityIndex(packet);
+  packet->next = nullptr;
+  if (!_tails[priority]) {
+    _heads[priority] = packet;
+  } else {
+    _tails[priority]->next = packet;
+  }
+  _tails[priority] = packet;
+  _queued++;
+  _queuedBytes += packet->size();
+}
+
+void OutQueue::_appendInFlight(OutPacket* packet) {
+  packet->next = nullptr;
+  if (!_inFlightTail) {
+    _inFlightHead = packet;
+  } else {
+    _inFlightTail->next = packet;
+  }
+  _inFlightTail = packet;
+  _inFlight++;
+  if (_inFlight > _inFlightHighWaterMark) _inFlightHighWaterMark = _inFlight;
+  if (!isWindowed(packet)) _blocked = true;
+}
+
+void OutQueue::_destroy(OutPacket* packet) {
+  packet->~OutPacket();
+  _pool.release(packet);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+#include "OutPacket.hpp"
+#include "OutPacketPool.hpp"
+
+namespace AsyncMqttClientInternals {
+// The part of AsyncClient the queue writes to.
+class OutTransport {
+ public:
+  virtual size_t space() = 0;
+  // Copies `size` bytes into the send buffer; returns the bytes accepted.
+  virtual size_t add(const char* data, size_t size) = 0;
+  virtual bool send() = 0;
+  // Called before the first byte of a packet is written, in wire order. The transport may
+  // re-encode the packet for the connection it is about to go out on (MQTT 5 topic aliases).
+  virtual void prepare(OutPacket&) {}
+
+ protected:
+  ~OutTransport() = default;
+};
+
+/*
+ * Outgoing packets, one FIFO per OutPriority. The highest priority packet that may
+ * start is written next; a packet that was started is always finished first. Packets
+ * that need no acknowledgment are dropped once written; the others move to the
+ * in-flight list until acknowledge() is called.
+ *
+ * Up to `window` QoS 1 PUBLISH packets may be in flight at once. Everything else that
+ * waits for an answer (SUBSCRIBE, UNSUBSCRIBE, QoS 2, PUBREC, PUBREL) and DISCONNECT is
+ * only written with nothing in flight, and nothing is written behind it until it is
+ * answered. While the first packet of a priority has to wait, lower priorities only
+ * pass it with packets that need no answer. Within a priority packets keep their order.
+ *
+ * A retained PUBLISH replaces an unsent retained PUBLISH on the same topic in place:
+ * only the latest value of a state topic is worth sending.
+ *
+ * With a byte budget, the unsent packets never take more than that many bytes. A
+ * packet that does not fit drops unsent packets of lower priority, lowest priority and
+ * oldest first; a DIAGNOSTIC packet may also drop older DIAGNOSTIC packets. If that
+ * does not make room the new packet is refused. Written packets are never dropped.
+ */
+class OutQueue {
+ public:
+  explicit OutQueue(OutPacketPool& pool);
+  ~OutQueue();
+  OutQueue(const OutQueue&) = delete;
+  OutQueue& operator=(const OutQueue&) = delete;
+
+  void setWindow(uint8_t window);
+  uint8_t window() const;
+  // 0 (the default) means unlimited.
+  void setByteBudget(size_t bytes);
+  size_t byteBudget() const;
+
+  // Queues behind the unsent packets of its priority. Returns false, leaving the packet
+  // to the caller, when it does not fit the byte budget.
+  bool pushBack(OutPacket* packet);
+  // Ahead of everything not yet written (CONNECT, PUBREL, PUBCOMP); never refused.
+  void pushFront(OutPacket* packet);
+
+  // Writes while the transport has room. Returns true when a DISCONNECT was written completely.
+  bool write(OutTransport& transport);
+  // Drops the in-flight packet of `packetType` with `packetId`. Returns false if there is none.
+  bool acknowledge(uint8_t packetType, uint16_t packetId);
+  // After a lost connection: with keepSessionData, unacknowledged QoS > 0 PUBLISH (flagged DUP
+  // if they were written), PUBREC, PUBREL and PUBCOMP are requeued in their original order,
+  // ahead of the unsent packets; everything else is dropped.
+  void clear(bool keepSessionData);
+
+  bool empty() const;
+  size_t inFlight() const;
+  size_t queued() const;
+  size_t queuedBytes() const;
+  size_t inFlightHighWaterMark() const;
+  // Unsent retained publishes replaced by a newer one on the same topic.
+  uint32_t coalesced() const;
+  // Packets dropped or refused for the byte budget.
+  uint32_t dropped() const;
+
+ private:
+  bool _canStart(const OutPacket* packet) const;
+  OutPacket* _next();
+  OutPacket* _findRetained(const OutPacket* packet, OutPacket** previous) const;
+  bool _makeRoom(const OutPacket* packet, const OutPacket* replaced);
+  void _unlink(size_t priority, OutPacket* previous, OutPacket* packet);
+  void _appendQueued(OutPacket* packet);
+  void _appendInFlight(OutPacket* packet);
+  void _destroy(OutPacket* packet);
+
+  OutPacketPool& _pool;
+  OutPacket* _heads[OUT_PRIORITY_COUNT];
+  OutPacket* _tails[OUT_PRIORITY_COUNT];
+  OutPacket* _inFlightHead;
+  OutPacket* _inFlightTail;
+  OutPacket* _writing;  // partly written; the head of its priority
+  size_t _sent;  // bytes of _writing already written
+  size_t _queued;
+  size_t _queuedBytes;
+  size_t _byteBudget;
+  size_t _inFlight;
+  size_t _inFlightHighWaterMark;
+  uint32_t _coalesced;
+  uint32_t _dropped;
+  bool _blocked;  // a packet outside the window is in flight
+  uint8_t _window;
+};
+}  // namespace AsyncMqttClientInternals
@@ -0,0 +1,173 @@
+#include "Publish.hpp"
+
+using AsyncMqttClientInternals::PublishOutPacket;
+
+size_t PublishOutPacket::neededSpace(const char* topic, uint8_t qos, const char* payload, size_t length, uint8_t protocolVersion) {
+  size_t payloadLength = length;
+  if (payload != nullptr && payloadLength == 0) payloadLength = strlen(payload);
+  if (payload == nullptr) payloadLength = 0;
+  return reservedSpace(topic, qos, payloadLength, protocolVersion);
+}
+
+size_t PublishOutPacket::reservedSpace(const char* topic, uint8_t qos, size_t maxLength, uint8_t protocolVersion) {
+  return _headerSpace(strlen(topic), qos, maxLength, protocolVersion) + maxLength;
+}
+
+PublishOutPacket::PublishOutPacket(const char* topic, uint8_t qos, bool retain, const char* payload, size_t length, uint8_t* buffer, uint8_t protocolVersion)
+: _data(buffer)
+, _size(0)
+, _offset(0)
+, _topicAt(0)
+, _payloadStart(0)
+, _maxPayloadLength(0)
+, _topicLength(0)
+, _topicAlias(0)
+, _withTopic(true)
+, _protocolVersion(protocolVersion) {
+  uint32_t payloadLength = length;
+  if (payload != nullptr && payloadLength == 0) payloadLength = strlen(payload);
+  if (payload == nullptr) payloadLength = 0;
+
+  _place(topic, qos, payloadLength);
+  if (payload != nullptr) memcpy(_data + _payloadStart, payload, payloadLength);
+  _render(_fixedHeaderFlags(qos, retain), payloadLength);
+}
+
+PublishOutPacket::PublishOutPacket(const char* topic, uint8_t qos, bool retain, size_t maxLength, uint8_t* buffer, uint8_t protocolVersion)
+: _data(buffer)
+, _size(0)
+, _offset(0)
+, _topicAt(0)
+, _payloadStart(0)
+, _maxPayloadLength(0)
+, _topicLength(0)
+, _topicAlias(0)
+, _withTopic(true)
+, _protocolVersion(protocolVersion) {
+  _place(topic, qos, maxLength);
+  _render(_fixedHeaderFlags(qos, retain), 0);
+}
+
+uint8_t* PublishOutPacket::payload() {
+  return _data + _payloadStart;
+}
+
+size_t PublishOutPacket::maxPayloadLength() const {
+  return _maxPayloadLength;
+}
+
+void PublishOutPacket::commit(size_t length) {
+  if (length > _maxPayloadLength) length = _maxPayloadLength;
+  _render(_data[_offset], length);
+}
+
+void PublishOutPacket::setTopicAlias(uint16_t alias, bool withTopic) {
+  if (_protocolVersion != AsyncMqttClientInternals::ProtocolVersion.V5) return;
+  _topicAlias = alias;
+  _withTopic = withTopic;
+  _render(_data[_offset], _size - _payloadStart);
+}
+
+uint16_t PublishOutPacket::topicAlias() const {
+  return _topicAlias;
+}
+
+uint8_t PublishOutPacket::_fixedHeaderFlags(uint8_t qos, bool retain) {
+  uint8_t flags = AsyncMqttClientInternals::PacketType.PUBLISH << 4;
+  // if (dup) flags |= AsyncMqttClientInternals::HeaderFlag.PUBLISH_DUP;
+  if (retain) flags |= AsyncMqttClientInternals::HeaderFlag.PUBLISH_RETAIN;
+  switch (qos) {
+    case 0:
+      flags |= AsyncMqttClientInternals::HeaderFlag.PUBLISH_QOS0;
+      break;
+    case 1:
+      flags |= AsyncMqttClientInternals::HeaderFlag.PUBLISH_QOS1;
+      break;
+    case 2:
+      flags |= AsyncMqttClientInternals::HeaderFlag.PUBLISH_QOS2;
+      break;
+  }
+  return flags;
+}
+
+// Room for the largest header: with MQTT 5 that is the topic plus a Topic Alias property.
+size_t PublishOutPacket::_headerSpace(size_t topicLength, uint8_t qos, size_t maxLength, uint8_t protocolVersion) {
+  char remainingLengthBytes[4];
+  size_t variableLength = 2 + topicLength;
+  if (qos != 0) variableLength += 2;
+  if (protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5) variableLength += 1 + 3;
+  return 1 + AsyncMqttClientInternals::Helpers::encodeRemainingLength(variableLength + maxLength, remainingLengthBytes) + variableLength;
+}
+
+void PublishOutPacket::_place(const char* topic, uint8_t qos, size_t maxLength) {
+  _topicLength = strlen(topic);
+  _payloadStart = _headerSpace(_topicLength, qos, maxLength, _protocolVersion);
+  _maxPayloadLength = maxLength;
+  // Parked at the start of the buffer; _render() moves it into the header.
+  memcpy(_data, topic, _topicLength);
+  _topicAt = 0;
+
+  _packetId = (qos !=0) ? _getNextPacketId() : 1;
+  if (qos != 0) _released = false;
+}
+
+void PublishOutPacket::_render(uint8_t flags, size_t payloadLength) {
+  const bool v5 = _protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5;
+  const bool withTopic = _topicAlias == 0 || _withTopic;
+  const uint16_t topicLength = withTopic ? _topicLength : 0;
+  const size_t packetIdLength = (flags & AsyncMqttClientInternals::HeaderFlag.PUBLISH_QOSRESERVED) != 0 ? 2 : 0;
+  size_t propertiesLength = 0;
+  if (v5) propertiesLength = _topicAlias != 0 ? 1 + 3 : 1;
+  const size_t variableLength = 2 + topicLength + packetIdLength + propertiesLength;
+
+  char remainingLengthBytes[4];
+  const uint8_t remainingLengthLength = AsyncMqttClientInternals::Helpers::encodeRemainingLength(variableLength + payloadLength, remainingLengthBytes);
+  _offset = _payloadStart - 1 - remainingLengthLength - variableLength;
+  size_t at = _offset + 1 + remainingLengthLength + 2;
+
+  // The topic moves first, the rest of the header may overlap where it was. Without it in
+  // the header it goes to the start of the buffer, which the shorter header leaves free.
+  const size_t topicAt = withTopic ? at : 0;
+  memmove(_data + topicAt, _data + _topicAt, _topicLength);
+  _topicAt = topicAt;
+
+  _data[_offset] = flags;
+  memcpy(_data + _offset + 1, remainingLengthBytes, remainingLengthLength);
+  _data[at - 2] = topicLength >> 8;
+  _data[at - 1] = topicLength & 0xFF;
+  at += topicLength;
+  if (packetIdLength != 0) {
+    _data[at++] = _packetId >> 8;
+    _data[at++] = _packetId & 0xFF;
+  }
+  if (v5) {
+    _data[at++] = propertiesLength - 1;
+    if (_topicAlias != 0) {
+      _data[at++] = AsyncMqttClientInternals::Property.TOPIC_ALIAS;
+      _data[at++] = _topicAlias >> 8;
+      _data[at++] = _topicAlias & 0xFF;
+    }
+  }
+  _size = _payloadStart + payloadLength;
+}
+
+const uint8_t* PublishOutPacket::data(size_t index) const {
+  return &_data[_offset + index];
+}
+
+size_t PublishOutPacket::size() const {
+  return _size - _offset;
+}
+
+void PublishOutPacket::setDup() {
+  _data[_offset] |= AsyncMqttClientInternals::HeaderFlag.PUBLISH_DUP;
+}
+
+bool PublishOutPacket::retain() const {
+  return (_data[_offset] & AsyncMqttClientInternals::HeaderFlag.PUBLISH_RETAIN) != 0;
+}
+
+const char* PublishOutPacket::topic(uint16_t* length) const {
+  *length = _topicLength;
+  return reinterpret_cast<const char*>(&_data[_topicAt]);
+}
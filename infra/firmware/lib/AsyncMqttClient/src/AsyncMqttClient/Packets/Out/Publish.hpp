@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstring>  // strlen
+
+#include "OutPacket.hpp"
+#include "../../Flags.hpp"
+#include "../../Helpers.hpp"
+#include "../../Storage.hpp"
+
+namespace AsyncMqttClientInternals {
+/*
+ * The header is always written right in front of the payload, so it can be rewritten
+ * without moving the payload. With MQTT 5 the buffer also has room for a Topic Alias
+ * property and setTopicAlias() switches between the plain form, the form that sends the
+ * topic and sets up the alias, and the form with the alias alone. The topic bytes are
+ * kept in the buffer in every form.
+ */
+class PublishOutPacket : public OutPacket {
+ public:
+  // `buffer` must hold neededSpace() bytes and outlive the packet; it is placed right behind it.
+  PublishOutPacket(const char* topic, uint8_t qos, bool retain, const char* payload, size_t length, uint8_t* buffer,
+                   uint8_t protocolVersion = ProtocolVersion.V3_1_1);
+  static size_t neededSpace(const char* topic, uint8_t qos, const char* payload, size_t length,
+                            uint8_t protocolVersion = ProtocolVersion.V3_1_1);
+
+  // Reserving form: lays out topic and packet id and leaves room for up to `maxLength`
+  // payload bytes at payload(). commit() then writes the fixed header for the actual length
+  // in front of the topic, so the payload is never copied.
+  PublishOutPacket(const char* topic, uint8_t qos, bool retain, size_t maxLength, uint8_t* buffer,
+                   uint8_t protocolVersion = ProtocolVersion.V3_1_1);
+  static size_t reservedSpace(const char* topic, uint8_t qos, size_t maxLength,
+                              uint8_t protocolVersion = ProtocolVersion.V3_1_1);
+  uint8_t* payload();
+  size_t maxPayloadLength() const;
+  void commit(size_t length);
+
+  const uint8_t* data(size_t index = 0) const;
+  size_t size() const;
+
+  void setDup();  // you cannot unset dup
+  bool retain() const;
+  // Topic bytes inside the packet; not NUL-terminated.
+  const char* topic(uint16_t* length) const;
+
+  // MQTT 5 only. alias 0 sends the plain topic; otherwise the packet carries the alias,
+  // with the topic as well when `withTopic` (the first use of the alias on a connection).
+  void setTopicAlias(uint16_t alias, bool withTopic);
+  uint16_t topicAlias() const;
+
+ private:
+  static uint8_t _fixedHeaderFlags(uint8_t qos, bool retain);
+  static size_t _headerSpace(size_t topicLength, uint8_t qos, size_t maxLength, uint8_t protocolVersion);
+  void _place(const char* topic, uint8_t qos, size_t maxLength);
+  void _render(uint8_t flags, size_t payloadLength);
+
+  uint8_t* _data;
+  size_t _size;
+  // Start of the packet in _data.
+  size_t _offset;
+  size_t _topicAt;
+  size_t _payloadStart;
+  size_t _maxPayloadLength;
+  uint16_t _topicLength;
+  uint16_t _topicAlias;
+  bool _withTopic;
+  uint8_t _protocolVersion;
+};
+}  // namespace AsyncMqttClientInternals
@@ -0,0 +1,55 @@
+#include "Subscribe.hpp"
+
+using AsyncMqttClientInternals::SubscribeOutPacket;
+
+size_t SubscribeOutPacket::neededSpace(const char* topic, uint8_t protocolVersion) {
+  char remainingLengthBytes[4];
+  const size_t propertiesLength = protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5 ? 1 : 0;
+  const size_t remainingLength = 2 + propertiesLength + 2 + strlen(topic) + 1;
+  return 1 + AsyncMqttClientInternals::Helpers::encodeRemainingLength(remainingLength, remainingLengthBytes) + remainingLength;
+}
+
+SubscribeOutPacket::SubscribeOutPacket(const char* topic, uint8_t qos, uint8_t* buffer, uint8_t protocolVersion)
+: _data(buffer)
+, _size(0) {
+  char fixedHeader[5];
+  fixedHeader[0] = AsyncMqttClientInternals::PacketType.SUBSCRIBE;
+  fixedHeader[0] = fixedHeader[0] << 4;
+  fixedHeader[0] = fixedHeader[0] | AsyncMqttClientInternals::HeaderFlag.SUBSCRIBE_RESERVED;
+
+  uint16_t topicLength = strlen(topic);
+  char topicLengthBytes[2];
+  topicLengthBytes[0] = topicLength >> 8;
+  topicLengthBytes[1] = topicLength & 0xFF;
+
+  char qosByte[1];
+  qosByte[0] = qos;
+
+  const uint8_t propertiesLength = protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5 ? 1 : 0;
+  uint8_t remainingLengthLength = AsyncMqttClientInternals::Helpers::encodeRemainingLength(2 + propertiesLength + 2 + topicLength + 1, fixedHeader + 1);
+
+  _packetId = _getNextPacketId();
+  char packetIdBytes[2];
+  packetIdBytes[0] = _packetId >> 8;
+  packetIdBytes[1] = _packetId & 0xFF;
+
+  memcpy(_data + _size, fixedHeader, 1 + remainingLengthLength);
+  _size += 1 + remainingLengthLength;
+  memcpy(_data + _size, packetIdBytes, 2);
+  _size += 2;
+  if (propertiesLength != 0) _data[_size++] = 0;
+  memcpy(_data + _size, topicLengthBytes, 2);
+  _size += 2;
+  memcpy(_data + _size, topic, topicLength);
+  _size += topicLength;
+  _data[_size++] = qosByte[0];
+  _released = false;
+}
+
+const uint8_t* SubscribeOutPacket::data(size_t index) const {
+  return &_data[index];
+}
+
+size_t SubscribeOutPacket::size() const {
+  return _size;
+}
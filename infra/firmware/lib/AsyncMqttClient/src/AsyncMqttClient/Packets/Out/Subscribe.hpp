@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstring>  // strlen
+
+#include "OutPacket.hpp"
+#include "../../Flags.hpp"
+#include "../../Helpers.hpp"
+#include "../../Storage.hpp"
+
+namespace AsyncMqttClientInternals {
+class SubscribeOutPacket : public OutPacket {
+ public:
+  // `buffer` must hold neededSpace() bytes and outlive the packet; it is placed right behind it.
+  // MQTT 5 adds an empty property list after the packet id.
+  SubscribeOutPacket(const char* topic, uint8_t qos, uint8_t* buffer, uint8_t protocolVersion = ProtocolVersion.V3_1_1);
+  static size_t neededSpace(const char* topic, uint8_t protocolVersion = ProtocolVersion.V3_1_1);
+  const uint8_t* data(size_t index = 0) const;
+  size_t size() const;
+
+ private:
+  uint8_t* _data;
+  size_t _size;
+};
+}  // namespace AsyncMqttClientInternals
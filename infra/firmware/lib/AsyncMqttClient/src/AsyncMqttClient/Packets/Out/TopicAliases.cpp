@@ -0,0 +1,41 @@
+#include "TopicAliases.hpp"
+
+#include <cstring>  // memcmp, memcpy
+
+using AsyncMqttClientInternals::TopicAliasTable;
+
+TopicAliasTable::TopicAliasTable()
+: _entries()
+, _topics()
+, _used(0)
+, _size(0)
+, _capacity(0) {}
+
+void TopicAliasTable::reset(uint16_t brokerMaximum) {
+  _used = 0;
+  _size = 0;
+  _capacity = brokerMaximum < MAX_ALIASES ? brokerMaximum : MAX_ALIASES;
+}
+
+uint16_t TopicAliasTable::lookup(const char* topic, uint16_t length, bool* assigned) {
+  *assigned = false;
+  for (uint8_t i = 0; i < _size; i++) {
+    if (_entries[i].length == length && memcmp(_topics + _entries[i].offset, topic, length) == 0) return i + 1;
+  }
+
+  if (_size == _capacity || length == 0 || length > TOPIC_BYTES - _used) return 0;
+  memcpy(_topics + _used, topic, length);
+  _entries[_size].offset = _used;
+  _entries[_size].length = length;
+  _used += length;
+  *assigned = true;
+  return ++_size;
+}
+
+uint8_t TopicAliasTable::capacity() const {
+  return _capacity;
+}
+
+uint8_t TopicAliasTable::size() const {
+  return _size;
+}
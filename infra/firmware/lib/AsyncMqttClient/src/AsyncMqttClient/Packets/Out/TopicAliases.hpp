@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+namespace AsyncMqttClientInternals {
+/*
+ * MQTT 5 topic aliases of one connection, client to broker. Aliases are handed out
+ * first come, first served, up to the broker's Topic Alias Maximum and MAX_ALIASES;
+ * topics that arrive after that, or do not fit the name buffer, go out in full. An
+ * alias is never remapped: the topics a node publishes are a small fixed set.
+ * Topics are compared byte for byte. Nothing is allocated.
+ */
+class TopicAliasTable {
+ public:
+  static constexpr uint8_t MAX_ALIASES = 16;
+  static constexpr size_t TOPIC_BYTES = 512;
+
+  TopicAliasTable();
+
+  // Forgets every alias (they only live as long as the connection) and sets the limit.
+  void reset(uint16_t brokerMaximum);
+  // The alias for `topic`, assigning one if there is room; 0 if it has none. `assigned` is
+  // set when the alias is new, so the packet has to carry the topic as well.
+  uint16_t lookup(const char* topic, uint16_t length, bool* assigned);
+
+  uint8_t capacity() const;
+  uint8_t size() const;
+
+ private:
+  struct Entry {
+    uint16_t offset;
+    uint16_t length;
+  };
+
+  Entry _entries[MAX_ALIASES];
+  char _topics[TOPIC_BYTES];
+  uint16_t _used;
+  uint8_t _size;
+  uint8_t _capacity;
+};
+}  // namespace AsyncMqttClientInternals
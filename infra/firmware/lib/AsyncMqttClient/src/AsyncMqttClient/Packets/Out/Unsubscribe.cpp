@@ -0,0 +1,51 @@
+#include "Unsubscribe.hpp"
+
+using AsyncMqttClientInternals::UnsubscribeOutPacket;
+
+size_t UnsubscribeOutPacket::neededSpace(const char* topic, uint8_t protocolVersion) {
+  char remainingLengthBytes[4];
+  const size_t propertiesLength = protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5 ? 1 : 0;
+  const size_t remainingLength = 2 + propertiesLength + 2 + strlen(topic);
+  return 1 + AsyncMqttClientInternals::Helpers::encodeRemainingLength(remainingLength, remainingLengthBytes) + remainingLength;
+}
+
+UnsubscribeOutPacket::UnsubscribeOutPacket(const char* topic, uint8_t* buffer, uint8_t protocolVersion)
+: _data(buffer)
+, _size(0) {
+  char fixedHeader[5];
+  fixedHeader[0] = AsyncMqttClientInternals::PacketType.UNSUBSCRIBE;
+  fixedHeader[0] = fixedHeader[0] << 4;
+  fixedHeader[0] = fixedHeader[0] | AsyncMqttClientInternals::HeaderFlag.UNSUBSCRIBE_RESERVED;
+
+  uint16_t topicLength = strlen(topic);
+  char topicLengthBytes[2];
+  topicLengthBytes[0] = topicLength >> 8;
+  topicLengthBytes[1] = topicLength & 0xFF;
+
+  const uint8_t propertiesLength = protocolVersion == AsyncMqttClientInternals::ProtocolVersion.V5 ? 1 : 0;
+  uint8_t remainingLengthLength = AsyncMqttClientInternals::Helpers::encodeRemainingLength(2 + propertiesLength + 2 + topicLength, fixedHeader + 1);
+
+  _packetId = _getNextPacketId();
+  char packetIdBytes[2];
+  packetIdBytes[0] = _packetId >> 8;
+  packetIdBytes[1] = _packetId & 0xFF;
+
+  memcpy(_data + _size, fixedHeader, 1 + remainingLengthLength);
+  _size += 1 + remainingLengthLength;
+  memcpy(_data + _size, packetIdBytes, 2);
+  _size += 2;
+  if (propertiesLength != 0) _data[_size++] = 0;
+  memcpy(_data + _size, topicLengthBytes, 2);
+  _size += 2;
+  memcpy(_data + _size, topic, topicLength);
+  _size += topicLength;
+  _released = false;
+}
+
+const uint8_t* UnsubscribeOutPacket::data(size_t index) const {
+  return &_data[index];
+}
+
+size_t UnsubscribeOutPacket::size() const {
+  return _size;
+}
@@ -0,0 +1,479 @@
+#include "PacketParser.hpp"
+
+#include <string.h>  // memcpy
+
+#include "../Flags.hpp"
+
+using AsyncMqttClientInternals::PacketParser;
+
+// The remaining length field (and any other variable byte integer) is at most four bytes long.
+static const uint32_t MAX_REMAINING_LENGTH_MULTIPLIER = 128UL * 128UL * 128UL;
+
+PacketParser::PacketParser(PacketHandler* handler)
+: _handler(handler)
+, _topicBuffer(nullptr)
+, _maxTopicLength(0)
+, _resets(0)
+, _v5(false)
+, _state(State::FIXED_HEADER)
+, _packetType(0)
+, _packetFlags(0)
+, _remainingLength(0)
+, _remainingLengthMultiplier(1)
+, _left(0)
+, _field{0}
+, _fieldLength(0)
+, _packet()
+, _properties()
+, _connAck() {}
+
+void PacketParser::setTopicBuffer(char* topicBuffer, uint16_t maxTopicLength) {
+  _topicBuffer = topicBuffer;
+  _maxTopicLength = maxTopicLength;
+}
+
+void PacketParser::setProtocolVersion(uint8_t protocolVersion) {
+  _v5 = protocolVersion == ProtocolVersion.V5;
+}
+
+void PacketParser::reset() {
+  _state = State::FIXED_HEADER;
+  _fieldLength = 0;
+  // Stops a parse() that is still running further up the stack (a callback disconnected).
+  _resets++;
+}
+
+void PacketParser::parse(char* data, size_t len) {
+  const uint32_t resets = _resets;
+  size_t position = 0;
+
+  while (position < len && resets == _resets) {
+    switch (_state) {
+      case State::FIXED_HEADER: {
+        const uint8_t currentByte = data[position++];
+        _packetType = currentByte >> 4;
+        _packetFlags = currentByte & 0x0F;
+        _remainingLength = 0;
+        _remainingLengthMultiplier = 1;
+        _state = State::REMAINING_LENGTH;
+        break;
+      }
+      case State::REMAINING_LENGTH: {
+        const uint8_t currentByte = data[position++];
+        _remainingLength += (currentByte & 0x7F) * _remainingLengthMultiplier;
+        if ((currentByte & 0x80) == 0) {
+          _left = _remainingLength;
+          _beginVariableHeader();
+        } else if (_remainingLengthMultiplier == MAX_REMAINING_LENGTH_MULTIPLIER) {
+          _violation();
+        } else {
+          _remainingLengthMultiplier *= 128;
+        }
+        break;
+      }
+      case State::TOPIC_LENGTH:
+        position += _collect(data + position, len - position, 2);
+        if (_fieldLength == 2) {
+          PublishState& publish = _packet.publish;
+          publish.topicLength = static_cast<uint8_t>(_field[0]) << 8 | static_cast<uint8_t>(_field[1]);
+          if (publish.topicLength + (publish.qos != 0 ? 2u : 0u) + (_v5 ? 1u : 0u) > _left) {
+            _violation();
+            break;
+          }
+          publish.ignore = _topicBuffer == nullptr || publish.topicLength > _maxTopicLength;
+          if (!publish.ignore) _topicBuffer[publish.topicLength] = '\0';
+          _fieldLength = 0;
+          _state = State::TOPIC;
+        }
+        break;
+      case State::TOPIC: {
+        PublishState& publish = _packet.publish;
+        size_t span = publish.topicLength - publish.topicRead;
+        if (span > len - position) span = len - position;
+        if (!publish.ignore) memcpy(_topicBuffer + publish.topicRead, data + position, span);
+        publish.topicRead += span;
+        position += span;
+        _left -= span;
+        if (publish.topicRead == publish.topicLength) {
+          if (publish.qos != 0) {
+            _state = State::PACKET_ID;
+          } else if (_v5) {
+            _beginProperties();
+          } else {
+            _beginPayload();
+          }
+        }
+        break;
+      }
+      case State::PACKET_ID:
+        position += _collect(data + position, len - position, 2);
+        if (_fieldLength == 2) {
+          _packet.publish.packetId = static_cast<uint8_t>(_field[0]) << 8 | static_cast<uint8_t>(_field[1]);
+          _fieldLength = 0;
+          if (_v5) {
+            _beginProperties();
+          } else {
+            _beginPayload();
+          }
+        }
+        break;
+      case State::PAYLOAD: {
+        PublishState& publish = _packet.publish;
+        size_t span = publish.payloadLength - publish.payloadRead;
+        if (span > len - position) span = len - position;
+        const uint32_t index = publish.payloadRead;
+        publish.payloadRead += span;
+        _left -= span;
+        const bool complete = publish.payloadRead == publish.payloadLength;
+        if (complete) _state = State::FIXED_HEADER;
+        if (!publish.ignore) {
+          _handler->_onMessage(_topicBuffer, data + position, publish.qos, publish.dup, publish.retain, span, index, publish.payloadLength, publish.packetId);
+        }
+        position += span;
+        if (complete && resets == _resets) _completePublish();
+        break;
+      }
+      case State::ACK_FIELDS:
+        position += _collect(data + position, len - position, _packet.ack.needed);
+        if (_fieldLength == _packet.ack.needed) {
+          if (_v5 && !_packet.ack.propertiesRead && _left > 0 &&
+              (_packetType == PacketType.CONNACK || _packetType == PacketType.SUBACK)) {
+            _packet.ack.propertiesRead = true;
+            _beginProperties();
+            break;
+          }
+          // Anything after the fields we use (further SUBACK return codes) is skipped.
+          _state = _left > 0 ? State::SKIP : State::FIXED_HEADER;
+          _fieldLength = 0;
+          _completeAck();
+        }
+        break;
+      case State::PROPERTY_LENGTH: {
+        const uint8_t currentByte = data[position++];
+        _left--;
+        PropertyState& properties = _properties;
+        properties.left += (currentByte & 0x7F) * properties.multiplier;
+        if ((currentByte & 0x80) == 0) {
+          if (properties.left > _left) {
+            _violation();
+          } else if (properties.left == 0) {
+            _endProperties();
+          } else {
+            _state = State::PROPERTIES;
+          }
+        } else if (properties.multiplier == MAX_REMAINING_LENGTH_MULTIPLIER || _left == 0) {
+          _violation();
+        } else {
+          properties.multiplier *= 128;
+        }
+        break;
+      }
+      case State::PROPERTIES: {
+        PropertyState& properties = _properties;
+        if (properties.step == PropertyStep::DATA) {
+          size_t span = properties.valueLeft;
+          if (span > len - position) span = len - position;
+          position += span;
+          _left -= span;
+          properties.left -= span;
+          properties.valueLeft -= span;
+          if (properties.valueLeft == 0) _endPropertyValue();
+        } else {
+          _left--;
+          properties.left--;
+          _readProperty(data[position++]);
+        }
+        if (resets != _resets) break;
+        if (properties.left == 0) {
+          // A value running past the end of the property list is malformed.
+          if (properties.step != PropertyStep::ID) {
+            _violation();
+          } else {
+            _endProperties();
+          }
+        }
+        break;
+      }
+      case State::SKIP: {
+        size_t span = _left;
+        if (span > len - position) span = len - position;
+        position += span;
+        _left -= span;
+        if (_left == 0) _state = State::FIXED_HEADER;
+        break;
+      }
+    }
+  }
+}
+
+size_t PacketParser::_collect(const char* data, size_t len, uint8_t needed) {
+  size_t span = needed - _fieldLength;
+  if (span > len) span = len;
+  memcpy(_field + _fieldLength, data, span);
+  _fieldLength += span;
+  _left -= span;
+  return span;
+}
+
+void PacketParser::_beginVariableHeader() {
+  _fieldLength = 0;
+
+  if (_packetType == PacketType.PUBLISH) {
+    PublishState& publish = _packet.publish;
+    publish.topicLength = 0;
+    publish.topicRead = 0;
+    publish.packetId = 0;
+    publish.qos = (_packetFlags & HeaderFlag.PUBLISH_QOSRESERVED) >> 1;
+    publish.dup = _packetFlags & HeaderFlag.PUBLISH_DUP;
+    publish.retain = _packetFlags & HeaderFlag.PUBLISH_RETAIN;
+    publish.ignore = false;
+    publish.payloadLength = 0;
+    publish.payloadRead = 0;
+    if (publish.qos == 3 || _left < 2) {
+      _violation();
+      return;
+    }
+    _state = State::TOPIC_LENGTH;
+    return;
+  }
+
+  if (_packetType == PacketType.PINGRESP) {
+    if (_left != 0) {
+      _violation();
+      return;
+    }
+    _state = State::FIXED_HEADER;
+    _handler->_onPingResp();
+    return;
+  }
+
+  _packet.ack.propertiesRead = false;
+  if (_packetType == PacketType.CONNACK) _connAck = ConnAckProperties();
+
+  if (_packetType == PacketType.CONNACK ||
+      _packetType == PacketType.UNSUBACK ||
+      _packetType == PacketType.PUBACK ||
+      _packetType == PacketType.PUBREC ||
+      _packetType == PacketType.PUBREL ||
+      _packetType == PacketType.PUBCOMP) {
+    _packet.ack.needed = 2;
+  } else if (_packetType == PacketType.SUBACK) {
+    // Packet id and the first return code; with MQTT 5 the properties come in between.
+    _packet.ack.needed = _v5 ? 2 : 3;
+    if (_v5 && _left < 2 + 1 + 1) {
+      _violation();
+      return;
+    }
+  } else if (_v5 && _packetType == PacketType.DISCONNECT) {
+    // Reason code and properties; both are left out for a normal disconnection.
+    if (_left == 0) {
+      _state = State::FIXED_HEADER;
+      _handler->_onServerDisconnect(0);
+      return;
+    }
+    _packet.ack.needed = 1;
+  } else {
+    _violation();
+    return;
+  }
+
+  if (_left < _packet.ack.needed) {
+    _violation();
+    return;
+  }
+  _state = State::ACK_FIELDS;
+}
+
+void PacketParser::_beginPayload() {
+  PublishState& publish = _packet.publish;
+  publish.payloadLength = _left;
+  publish.payloadRead = 0;
+  if (publish.payloadLength > 0) {
+    _state = State::PAYLOAD;
+    return;
+  }
+
+  _state = State::FIXED_HEADER;
+  if (publish.ignore) return;
+  const uint32_t resets = _resets;
+  _handler->_onMessage(_topicBuffer, nullptr, publish.qos, publish.dup, publish.retain, 0, 0, 0, publish.packetId);
+  if (resets == _resets) _completePublish();
+}
+
+void PacketParser::_beginProperties() {
+  if (_left == 0) {
+    _violation();
+    return;
+  }
+  _properties.left = 0;
+  _properties.multiplier = 1;
+  _properties.step = PropertyStep::ID;
+  _state = State::PROPERTY_LENGTH;
+}
+
+void PacketParser::_readProperty(uint8_t currentByte) {
+  PropertyState& properties = _properties;
+  switch (properties.step) {
+    case PropertyStep::ID:
+      properties.id = currentByte;
+      properties.value = 0;
+      properties.multiplier = 1;
+      properties.strings = 0;
+      switch (currentByte) {
+        case Property.PAYLOAD_FORMAT_INDICATOR:
+        case Property.REQUEST_PROBLEM_INFORMATION:
+        case Property.REQUEST_RESPONSE_INFORMATION:
+        case Property.MAXIMUM_QOS:
+        case Property.RETAIN_AVAILABLE:
+        case Property.WILDCARD_SUBSCRIPTION_AVAILABLE:
+        case Property.SUBSCRIPTION_IDENTIFIER_AVAILABLE:
+        case Property.SHARED_SUBSCRIPTION_AVAILABLE:
+          properties.step = PropertyStep::INTEGER;
+          properties.valueLeft = 1;
+          break;
+        case Property.SERVER_KEEP_ALIVE:
+        case Property.RECEIVE_MAXIMUM:
+        case Property.TOPIC_ALIAS_MAXIMUM:
+        case Property.TOPIC_ALIAS:
+          properties.step = PropertyStep::INTEGER;
+          properties.valueLeft = 2;
+          break;
+        case Property.MESSAGE_EXPIRY_INTERVAL:
+        case Property.SESSION_EXPIRY_INTERVAL:
+        case Property.WILL_DELAY_INTERVAL:
+        case Property.MAXIMUM_PACKET_SIZE:
+          properties.step = PropertyStep::INTEGER;
+          properties.valueLeft = 4;
+          break;
+        case Property.SUBSCRIPTION_IDENTIFIER:
+          properties.step = PropertyStep::VARIABLE_INTEGER;
+          break;
+        case Property.CONTENT_TYPE:
+        case Property.RESPONSE_TOPIC:
+        case Property.CORRELATION_DATA:
+        case Property.ASSIGNED_CLIENT_IDENTIFIER:
+        case Property.AUTHENTICATION_METHOD:
+        case Property.AUTHENTICATION_DATA:
+        case Property.RESPONSE_INFORMATION:
+        case Property.SERVER_REFERENCE:
+        case Property.REASON_STRING:
+          properties.step = PropertyStep::LENGTH;
+          properties.valueLeft = 2;
+          properties.strings = 1;
+          break;
+        case Property.USER_PROPERTY:
+          properties.step = PropertyStep::LENGTH;
+          properties.valueLeft = 2;
+          properties.strings = 2;
+          break;
+        default:
+          _violation();
+          break;
+      }
+      break;
+    case PropertyStep::INTEGER:
+      properties.value = properties.value << 8 | currentByte;
+      if (--properties.valueLeft == 0) _endPropertyValue();
+      break;
+    case PropertyStep::VARIABLE_INTEGER:
+      properties.value += (currentByte & 0x7F) * properties.multiplier;
+      if ((currentByte & 0x80) == 0) {
+        _endPropertyValue();
+      } else if (properties.multiplier == MAX_REMAINING_LENGTH_MULTIPLIER) {
+        _violation();
+      } else {
+        properties.multiplier *= 128;
+      }
+      break;
+    case PropertyStep::LENGTH:
+      properties.value = properties.value << 8 | currentByte;
+      if (--properties.valueLeft == 0) {
+        if (properties.value > properties.left) {
+          _violation();
+        } else if (properties.value == 0) {
+          _endPropertyValue();
+        } else {
+          properties.valueLeft = properties.value;
+          properties.step = PropertyStep::DATA;
+        }
+      }
+      break;
+    case PropertyStep::DATA:
+      break;
+  }
+}
+
+void PacketParser::_endPropertyValue() {
+  PropertyState& properties = _properties;
+  if (properties.strings > 0) {
+    if (--properties.strings > 0) {
+      properties.step = PropertyStep::LENGTH;
+      properties.valueLeft = 2;
+      properties.value = 0;
+    } else {
+      properties.step = PropertyStep::ID;
+    }
+    return;
+  }
+
+  if (_packetType == PacketType.CONNACK) {
+    if (properties.id == Property.TOPIC_ALIAS_MAXIMUM) {
+      _connAck.topicAliasMaximum = properties.value;
+    } else if (properties.id == Property.SERVER_KEEP_ALIVE) {
+      _connAck.hasServerKeepAlive = true;
+      _connAck.serverKeepAlive = properties.value;
+    }
+  }
+  properties.step = PropertyStep::ID;
+}
+
+void PacketParser::_endProperties() {
+  if (_packetType == PacketType.PUBLISH) {
+    _beginPayload();
+    return;
+  }
+  if (_packetType == PacketType.SUBACK) {
+    _packet.ack.needed = 3;
+    if (_left == 0) {
+      _violation();
+      return;
+    }
+    _state = State::ACK_FIELDS;
+    return;
+  }
+
+  _state = _left > 0 ? State::SKIP : State::FIXED_HEADER;
+  _fieldLength = 0;
+  _completeAck();
+}
+
+void PacketParser::_completePublish() {
+  if (!_packet.publish.ignore) _handler->_onPublish(_packet.publish.packetId, _packet.publish.qos);
+}
+
+void PacketParser::_completeAck() {
+  const uint16_t packetId = static_cast<uint8_t>(_field[0]) << 8 | static_cast<uint8_t>(_field[1]);
+
+  if (_packetType == PacketType.CONNACK) {
+    _handler->_onConnAck(_field[0] & 0x01, _field[1], _connAck);
+  } else if (_packetType == PacketType.SUBACK) {
+    _handler->_onSubAck(packetId, _field[2]);
+  } else if (_packetType == PacketType.UNSUBACK) {
+    _handler->_onUnsubAck(packetId);
+  } else if (_packetType == PacketType.PUBACK) {
+    _handler->_onPubAck(packetId);
+  } else if (_packetType == PacketType.PUBREC) {
+    _handler->_onPubRec(packetId);
+  } else if (_packetType == PacketType.PUBREL) {
+    _handler->_onPubRel(packetId);
+  } else if (_packetType == PacketType.PUBCOMP) {
+    _handler->_onPubComp(packetId);
+  } else if (_packetType == PacketType.DISCONNECT) {
+    _handler->_onServerDisconnect(_field[0]);
+  }
+}
+
+void PacketParser::_violation() {
+  reset();
+  _handler->_onProtocolViolation();
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+namespace AsyncMqttClientInternals {
+// What the broker announced in an MQTT 5 CONNACK; all zero for MQTT 3.1.1.
+struct ConnAckProperties {
+  uint16_t topicAliasMaximum;  // aliases the client may use towards the broker
+  bool hasServerKeepAlive;
+  uint16_t serverKeepAlive;  // replaces the client's keep alive when present
+};
+
+// Receives the packets decoded by PacketParser. Payload pointers point into the buffer
+// passed to PacketParser::parse() and are only valid during the call.
+class PacketHandler {
+ public:
+  // The return code is the MQTT 5 reason code on MQTT 5 connections.
+  virtual void _onConnAck(bool sessionPresent, uint8_t connectReturnCode, const ConnAckProperties& properties) = 0;
+  virtual void _onPingResp() = 0;
+  virtual void _onSubAck(uint16_t packetId, char status) = 0;
+  virtual void _onUnsubAck(uint16_t packetId) = 0;
+  virtual void _onMessage(char* topic, char* payload, uint8_t qos, bool dup, bool retain, size_t len, size_t index, size_t total, uint16_t packetId) = 0;
+  virtual void _onPublish(uint16_t packetId, uint8_t qos) = 0;
+  virtual void _onPubRel(uint16_t packetId) = 0;
+  virtual void _onPubAck(uint16_t packetId) = 0;
+  virtual void _onPubRec(uint16_t packetId) = 0;
+  virtual void _onPubComp(uint16_t packetId) = 0;
+  // MQTT 5 only: the broker closes the connection and says why.
+  virtual void _onServerDisconnect(uint8_t reasonCode) = 0;
+  virtual void _onProtocolViolation() = 0;
+
+ protected:
+  ~PacketHandler() {}
+};
+
+/*
+ * Incremental parser for incoming MQTT 3.1.1 and MQTT 5 packets. Bytes may arrive in any
+ * fragmentation. Per-packet state lives inline in a tagged union; fixed fields and
+ * topic spans are copied with memcpy. Nothing is allocated while parsing.
+ *
+ * MQTT 5 properties are read one value at a time. The CONNACK properties the client acts
+ * on are passed to _onConnAck(); all other properties (and reason codes past the fields
+ * the handler takes) are checked for their framing and skipped.
+ */
+class PacketParser {
+ public:
+  explicit PacketParser(PacketHandler* handler);
+
+  // The topic buffer must hold maxTopicLength + 1 bytes. Longer topics are skipped.
+  void setTopicBuffer(char* topicBuffer, uint16_t maxTopicLength);
+  // ProtocolVersion.V3_1_1 (the default) or V5; set it before connecting.
+  void setProtocolVersion(uint8_t protocolVersion);
+  void reset();
+  void parse(char* data, size_t len);
+
+ private:
+  enum class State : uint8_t {
+    FIXED_HEADER,
+    REMAINING_LENGTH,
+    TOPIC_LENGTH,
+    TOPIC,
+    PACKET_ID,
+    PAYLOAD,
+    ACK_FIELDS,
+    PROPERTY_LENGTH,
+    PROPERTIES,
+    SKIP
+  };
+
+  enum class PropertyStep : uint8_t {
+    ID,
+    INTEGER,  // one, two or four byte integer
+    VARIABLE_INTEGER,
+    LENGTH,   // length prefix of a string or binary value
+    DATA
+  };
+
+  struct PropertyState {
+    uint32_t left;  // bytes of the property list still to read
+    uint32_t multiplier;
+    uint32_t value;
+    uint16_t valueLeft;
+    uint8_t id;
+    uint8_t strings;  // length-prefixed values left in this property (two for a user property)
+    PropertyStep step;
+  };
+
+  struct PublishState {
+    uint16_t topicLength;
+    uint16_t topicRead;
+    uint16_t packetId;
+    uint8_t qos;
+    bool dup;
+    bool retain;
+    bool ignore;
+    uint32_t payloadLength;
+    uint32_t payloadRead;
+  };
+
+  // CONNACK, SUBACK, UNSUBACK, PUBACK, PUBREC, PUBREL and PUBCOMP: up to three fixed bytes.
+  struct AckState {
+    uint8_t needed;
+    bool propertiesRead;  // MQTT 5 CONNACK and SUBACK: properties come after the first fields
+  };
+
+  size_t _collect(const char* data, size_t len, uint8_t needed);
+  void _beginVariableHeader();
+  void _beginPayload();
+  void _beginProperties();
+  void _readProperty(uint8_t currentByte);
+  void _endPropertyValue();
+  void _endProperties();
+  void _completeAck();
+  void _completePublish();
+  void _violation();
+
+  PacketHandler* _handler;
+  char* _topicBuffer;
+  uint16_t _maxTopicLength;
+  uint32_t _resets;
+  bool _v5;
+
+  State _state;
+  uint8_t _packetType;
+  uint8_t _packetFlags;
+  uint32_t _remainingLength;
+  uint32_t _remainingLengthMultiplier;
+  // Bytes of the packet after the fixed header that are still to be consumed.
+  uint32_t _left;
+  char _field[3];
+  uint8_t _fieldLength;
+  union {
+    PublishState publish;
+    AckState ack;
+  } _packet;
+  PropertyState _properties;
+  ConnAckProperties _connAck;
+};
+}  // namespace AsyncMqttClientInternals
@@ -0,0 +1,284 @@
+#include "TlsLayer.hpp"
+
+#if defined(ESP32)
+
+#include <cstring>  // memcpy, strlen
+
+#include <Arduino.h>  // millis
+#include <AsyncTCP.h>
+#include <esp_heap_caps.h>
+#include <mbedtls/version.h>
+
+// Only built against the mbedTLS 2.28 of arduino-esp32 2.x (platform espressif32 6.x);
+// 3.x renamed the version setters and made the handshake state private.
+#if MBEDTLS_VERSION_MAJOR != 2
+#error "TlsLayer needs mbedTLS 2.x; pin platform = espressif32@^6"
+#endif
+
+using AsyncMqttClientInternals::TlsHandshakeStats;
+using AsyncMqttClientInternals::TlsLayer;
+using AsyncMqttClientInternals::TlsSessionRecord;
+
+static uint32_t freeHeap() {
+  return heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
+
+TlsLayer::TlsLayer()
+: _caCert(nullptr)
+, _sessions()
+, _meter()
+, _ready(false)
+, _client(nullptr)
+, _host(nullptr)
+, _port(0)
+, _rxData(nullptr)
+, _rxLength(0)
+, _active(false)
+, _established(false)
+, _failed(false)
+, _certificateVerified(false) {
+  mbedtls_entropy_init(&_entropy);
+  mbedtls_ctr_drbg_init(&_drbg);
+  mbedtls_x509_crt_init(&_ca);
+  mbedtls_ssl_config_init(&_config);
+  mbedtls_ssl_init(&_ssl);
+}
+
+TlsLayer::~TlsLayer() {
+  mbedtls_ssl_free(&_ssl);
+  mbedtls_ssl_config_free(&_config);
+  mbedtls_x509_crt_free(&_ca);
+  mbedtls_ctr_drbg_free(&_drbg);
+  mbedtls_entropy_free(&_entropy);
+}
+
+void TlsLayer::setCaCert(const char* caCert) {
+  _caCert = caCert;
+}
+
+void TlsLayer::setSessionRecord(TlsSessionRecord* record) {
+  _sessions.attach(record);
+}
+
+bool TlsLayer::enabled() const {
+  return _caCert != nullptr;
+}
+
+TlsLayer::Progress TlsLayer::begin(AsyncClient* client, const char* host, uint16_t port) {
+  _client = client;
+  _host = host;
+  _port = port;
+  _rxData = nullptr;
+  _rxLength = 0;
+  _active = true;
+  _established = false;
+  _failed = false;
+  _certificateVerified = false;
+  if (!host) return _fail(MBEDTLS_ERR_SSL_BAD_INPUT_DATA);  // nothing to check the certificate against
+  if (!_setup()) return Progress::FAILED;
+
+  int result = mbedtls_ssl_session_reset(&_ssl);
+  if (result == 0) result = mbedtls_ssl_set_hostname(&_ssl, host);
+  if (result != 0) return _fail(result);
+  mbedtls_ssl_set_bio(&_ssl, this, _send, _receive, nullptr);
+
+  _meter.start(millis(), freeHeap());
+  _offerSession();
+  return _handshake();
+}
+
+TlsLayer::Progress TlsLayer::feed(const char* data, size_t length) {
+  if (!_active) return Progress::NONE;
+  _rxData = data;
+  _rxLength = length;
+  if (!handshaking()) return Progress::NONE;
+  return _handshake();
+}
+
+TlsLayer::Progress TlsLayer::resume() {
+  if (!handshaking()) return Progress::NONE;
+  return _handshake();
+}
+
+int TlsLayer::read(char* buffer, size_t size) {
+  while (_active && _established && !_failed) {
+    const int result = mbedtls_ssl_read(&_ssl, reinterpret_cast<unsigned char*>(buffer), size);
+    if (result > 0) return result;
+    // A record that carried no data (an ignored alert, say) can leave more input behind.
+    if (result == MBEDTLS_ERR_SSL_WANT_READ && _rxLength > 0) continue;
+    if (result == MBEDTLS_ERR_SSL_WANT_READ || result == MBEDTLS_ERR_SSL_WANT_WRITE) break;
+    _failed = true;  // close_notify, or a record that did not decrypt
+    _rxData = nullptr;
+    _rxLength = 0;
+    return -1;
+  }
+  _rxData = nullptr;
+  _rxLength = 0;
+  return 0;
+}
+
+size_t TlsLayer::space() {
+  if (!_active || !_established || _failed) return 0;
+  const int expansion = mbedtls_ssl_get_record_expansion(&_ssl);
+  const int maxPayload = mbedtls_ssl_get_max_out_record_payload(&_ssl);
+  const size_t room = _client->space();
+  if (expansion < 0 || maxPayload <= 0 || room <= static_cast<size_t>(expansion)) return 0;
+  const size_t payload = room - expansion;
+  return payload < static_cast<size_t>(maxPayload) ? payload : static_cast<size_t>(maxPayload);
+}
+
+size_t TlsLayer::write(const char* data, size_t size) {
+  if (!_active || !_established || _failed) return 0;
+  const int result = mbedtls_ssl_write(&_ssl, reinterpret_cast<const unsigned char*>(data), size);
+  // The out queue counts what it hands over as sent, so a short write would lose bytes
+  // from the middle of the stream.
+  if (result != static_cast<int>(size)) {
+    _failed = true;
+    return 0;
+  }
+  return size;
+}
+
+void TlsLayer::end() {
+  if (_meter.running()) _meter.fail(MBEDTLS_ERR_SSL_CONN_EOF);  // TCP went away mid-handshake
+  _active = false;
+  _established = false;
+  _rxData = nullptr;
+  _rxLength = 0;
+}
+
+bool TlsLayer::handshaking() const {
+  return _active && !_established && !_failed;
+}
+
+bool TlsLayer::established() const {
+  return _active && _established;
+}
+
+bool TlsLayer::failed() const {
+  return _active && _failed;
+}
+
+const TlsHandshakeStats& TlsLayer::stats() const {
+  return _meter.stats();
+}
+
+bool TlsLayer::_setup() {
+  if (_ready) return true;
+  const uint32_t heapBefore = freeHeap();
+  static const char PERSONALIZATION[] = "AsyncMqttClient";
+  int result = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                     reinterpret_cast<const unsigned char*>(PERSONALIZATION), sizeof(PERSONALIZATION) - 1);
+  if (result == 0) {
+    mbedtls_x509_crt_free(&_ca);  // a previous attempt may have parsed it already
+    mbedtls_x509_crt_init(&_ca);
+    result = mbedtls_x509_crt_parse(&_ca, reinterpret_cast<const unsigned char*>(_caCert), strlen(_caCert) + 1);
+  }
+  if (result == 0) {
+    result = mbedtls_ssl_config_defaults(&_config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+  }
+  if (result == 0) {
+    mbedtls_ssl_conf_authmode(&_config, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(&_config, &_ca, nullptr);
+    mbedtls_ssl_conf_rng(&_config, mbedtls_ctr_drbg_random, &_drbg);
+    mbedtls_ssl_conf_verify(&_config, _verify, this);
+    // TLS 1.3 delivers tickets after the handshake; with 1.2 the session is complete
+    // once the handshake is, which is when it gets saved.
+    mbedtls_ssl_conf_max_version(&_config, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&_config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+    result = mbedtls_ssl_setup(&_ssl, &_config);
+  }
+  if (result != 0) {
+    _fail(result);
+    return false;
+  }
+  const uint32_t heapAfter = freeHeap();
+  _meter.setContextHeap(heapBefore > heapAfter ? heapBefore - heapAfter : 0);
+  _ready = true;
+  return true;
+}
+
+TlsLayer::Progress TlsLayer::_handshake() {
+  while (!_handshakeOver()) {
+    const int result = mbedtls_ssl_handshake_step(&_ssl);
+    _meter.sample(freeHeap());
+    if (result == MBEDTLS_ERR_SSL_WANT_READ || result == MBEDTLS_ERR_SSL_WANT_WRITE) {
+      _client->send();
+      return Progress::NONE;
+    }
+    if (result != 0) return _fail(result);
+  }
+  _client->send();
+  _established = true;
+  _meter.succeed(millis(), !_certificateVerified);
+  _saveSession();  // also after a resumption: the broker may have issued a new ticket
+  return Progress::ESTABLISHED;
+}
+
+TlsLayer::Progress TlsLayer::_fail(int error) {
+  _meter.fail(error);
+  // Whatever was offered is not trusted again.
+  _sessions.invalidate();
+  _failed = true;
+  return Progress::FAILED;
+}
+
+bool TlsLayer::_handshakeOver() {
+  return _ssl.state == MBEDTLS_SSL_HANDSHAKE_OVER;
+}
+
+void TlsLayer::_offerSession() {
+  size_t length;
+  const uint8_t* data = _sessions.find(_host, _port, &length);
+  if (!data) return;
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  if (mbedtls_ssl_session_load(&session, data, length) != 0 || mbedtls_ssl_set_session(&_ssl, &session) != 0) {
+    _sessions.invalidate();  // saved by a different mbedTLS build or configuration
+  }
+  mbedtls_ssl_session_free(&session);
+}
+
+void TlsLayer::_saveSession() {
+  size_t capacity;
+  uint8_t* storage = _sessions.storage(&capacity);
+  if (!storage) return;
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  size_t length = 0;
+  if (mbedtls_ssl_get_session(&_ssl, &session) == 0 && mbedtls_ssl_session_save(&session, storage, capacity, &length) == 0) {
+    _sessions.commit(_host, _port, length);
+  }
+  mbedtls_ssl_session_free(&session);
+}
+
+int TlsLayer::_send(void* context, const unsigned char* data, size_t length) {
+  AsyncClient* client = static_cast<TlsLayer*>(context)->_client;
+  const size_t room = client->space();
+  if (room == 0) return MBEDTLS_ERR_SSL_WANT_WRITE;
+  const size_t added = client->add(reinterpret_cast<const char*>(data), length < room ? length : room, ASYNC_WRITE_FLAG_COPY);
+  return added == 0 ? MBEDTLS_ERR_SSL_WANT_WRITE : static_cast<int>(added);
+}
+
+int TlsLayer::_receive(void* context, unsigned char* buffer, size_t length) {
+  TlsLayer* tls = static_cast<TlsLayer*>(context);
+  if (tls->_rxLength == 0) return MBEDTLS_ERR_SSL_WANT_READ;
+  const size_t taken = length < tls->_rxLength ? length : tls->_rxLength;
+  memcpy(buffer, tls->_rxData, taken);
+  tls->_rxData += taken;
+  tls->_rxLength -= taken;
+  return static_cast<int>(taken);
+}
+
+int TlsLayer::_verify(void* context, mbedtls_x509_crt* certificate, int depth, uint32_t* flags) {
+  (void)certificate;
+  (void)depth;
+  (void)flags;  // left as they are: the chain and host checks still decide
+  // Only a full handshake has a certificate to verify.
+  static_cast<TlsLayer*>(context)->_certificateVerified = true;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#if defined(ESP32)
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+#include "TlsSession.hpp"
+#include "TlsStats.hpp"
+
+class AsyncClient;
+
+namespace AsyncMqttClientInternals {
+/*
+ * TLS 1.2 client (mbedTLS) on top of an AsyncClient. Everything runs in the TCP
+ * callbacks: received bytes are handed in with feed() and must be drained with read()
+ * before the callback returns; records go straight to the client's send buffer.
+ *
+ * The mbedTLS contexts and their record buffers are set up on the first connection and
+ * only reset for the next one. After every handshake the session is saved to the
+ * TlsSessionRecord, and the next handshake offers it, so a reconnect to a broker that
+ * still knows the session (ID cache or ticket) skips the certificate exchange and key
+ * agreement. A handshake is reported as resumed when no certificate had to be verified.
+ *
+ * Not thread safe: the caller serializes feed/read/write/end.
+ */
+class TlsLayer {
+ public:
+  // What a call changed about the connection.
+  enum class Progress : uint8_t {
+    NONE,
+    ESTABLISHED,  // the handshake completed during this call
+    FAILED
+  };
+
+  TlsLayer();
+  ~TlsLayer();
+
+  TlsLayer(const TlsLayer&) = delete;
+  TlsLayer& operator=(const TlsLayer&) = delete;
+
+  // PEM of the CA that signed the broker certificate; enables TLS. Kept by the caller.
+  void setCaCert(const char* caCert);
+  void setSessionRecord(TlsSessionRecord* record);
+  bool enabled() const;
+
+  // TCP is up: resets the connection state and sends the ClientHello. The certificate
+  // must match `host`, which also keys the saved session.
+  Progress begin(AsyncClient* client, const char* host, uint16_t port);
+  // Received bytes, valid for this call only. Runs the handshake while it is not done.
+  Progress feed(const char* data, size_t length);
+  // Continues a handshake that was waiting for send buffer space.
+  Progress resume();
+  // Decrypted application data from what feed() got; 0 when it is used up, -1 when the
+  // broker closed the session or the record was bad.
+  int read(char* buffer, size_t size);
+  // Plaintext bytes that fit into one record the TCP send buffer can take right now.
+  size_t space();
+  // Encrypts `size` bytes (at most space()) into one record; 0 if nothing was taken.
+  size_t write(const char* data, size_t size);
+  // TCP is gone.
+  void end();
+
+  bool handshaking() const;
+  bool established() const;
+  // A record could not be written or read; the connection has to be closed.
+  bool failed() const;
+  const TlsHandshakeStats& stats() const;
+
+ private:
+  bool _setup();
+  Progress _handshake();
+  Progress _fail(int error);
+  bool _handshakeOver();
+  void _offerSession();
+  void _saveSession();
+
+  static int _send(void* context, const unsigned char* data, size_t length);
+  static int _receive(void* context, unsigned char* buffer, size_t length);
+  static int _verify(void* context, mbedtls_x509_crt* certificate, int depth, uint32_t* flags);
+
+  const char* _caCert;
+  TlsSessionCache _sessions;
+  TlsHandshakeMeter _meter;
+
+  mbedtls_entropy_context _entropy;
+  mbedtls_ctr_drbg_context _drbg;
+  mbedtls_x509_crt _ca;
+  mbedtls_ssl_config _config;
+  mbedtls_ssl_context _ssl;
+  bool _ready;
+
+  AsyncClient* _client;
+  const char* _host;
+  uint16_t _port;
+  const char* _rxData;
+  size_t _rxLength;
+  bool _active;
+  bool _established;
+  bool _failed;
+  bool _certificateVerified;
+};
+}  // namespace AsyncMqttClientInternals
+
+#endif
@@ -0,0 +1,63 @@
+#include "TlsSession.hpp"
+
+#include <cstring>  // strlen
+
+using AsyncMqttClientInternals::TlsSessionCache;
+using AsyncMqttClientInternals::TlsSessionRecord;
+
+// Bump when the record layout changes; a firmware update then starts without a session.
+static constexpr uint32_t SESSION_MAGIC = 0x544C5331;  // "TLS1"
+static constexpr uint32_t FNV_OFFSET = 2166136261u;
+static constexpr uint32_t FNV_PRIME = 16777619u;
+
+TlsSessionCache::TlsSessionCache()
+: _record(nullptr) {}
+
+void TlsSessionCache::attach(TlsSessionRecord* record) {
+  _record = record;
+}
+
+bool TlsSessionCache::attached() const {
+  return _record != nullptr;
+}
+
+const uint8_t* TlsSessionCache::find(const char* host, uint16_t port, size_t* length) const {
+  if (!_record || _record->magic != SESSION_MAGIC) return nullptr;
+  if (_record->length == 0 || _record->length > TlsSessionRecord::MAX_BYTES) return nullptr;
+  if (_record->server != _server(host, port)) return nullptr;
+  if (_record->checksum != _hash(FNV_OFFSET, _record->data, _record->length)) return nullptr;
+  *length = _record->length;
+  return _record->data;
+}
+
+uint8_t* TlsSessionCache::storage(size_t* capacity) {
+  if (!_record) return nullptr;
+  invalidate();
+  *capacity = TlsSessionRecord::MAX_BYTES;
+  return _record->data;
+}
+
+void TlsSessionCache::commit(const char* host, uint16_t port, size_t length) {
+  if (!_record || length == 0 || length > TlsSessionRecord::MAX_BYTES) return;
+  _record->length = static_cast<uint16_t>(length);
+  _record->server = _server(host, port);
+  _record->checksum = _hash(FNV_OFFSET, _record->data, length);
+  _record->magic = SESSION_MAGIC;  // last: only a complete record is valid
+}
+
+void TlsSessionCache::invalidate() {
+  if (_record) _record->magic = 0;
+}
+
+uint32_t TlsSessionCache::_hash(uint32_t hash, const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ data[i]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+uint32_t TlsSessionCache::_server(const char* host, uint16_t port) {
+  const uint8_t portBytes[] = { static_cast<uint8_t>(port >> 8), static_cast<uint8_t>(port & 0xFF) };
+  const uint32_t hash = _hash(FNV_OFFSET, reinterpret_cast<const uint8_t*>(host), strlen(host));
+  return _hash(hash, portBytes, sizeof(portBytes));
+}
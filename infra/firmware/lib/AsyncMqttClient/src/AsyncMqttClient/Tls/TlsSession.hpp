@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+namespace AsyncMqttClientInternals {
+/*
+ * A serialized TLS session, owned by the application so it can live in RTC memory and
+ * survive deep sleep and soft resets. It is stamped with the server it belongs to and a
+ * checksum; a record that was never written, is torn or belongs to another broker is
+ * not offered. The peer certificate is part of the session, hence the size.
+ */
+struct TlsSessionRecord {
+  static constexpr size_t MAX_BYTES = 2048;
+
+  uint32_t magic;
+  uint32_t server;
+  uint32_t checksum;
+  uint16_t length;
+  uint8_t data[MAX_BYTES];
+};
+
+/*
+ * Reads and writes a TlsSessionRecord. Nothing is cached without a record.
+ */
+class TlsSessionCache {
+ public:
+  TlsSessionCache();
+
+  void attach(TlsSessionRecord* record);
+  bool attached() const;
+
+  // The session saved for host:port, or nullptr.
+  const uint8_t* find(const char* host, uint16_t port, size_t* length) const;
+  // Where to serialize a new session. The current one is invalidated first, so a reset
+  // halfway through never leaves a mixed record behind; commit() makes it valid again.
+  uint8_t* storage(size_t* capacity);
+  void commit(const char* host, uint16_t port, size_t length);
+  void invalidate();
+
+ private:
+  static uint32_t _hash(uint32_t hash, const uint8_t* data, size_t length);
+  static uint32_t _server(const char* host, uint16_t port);
+
+  TlsSessionRecord* _record;
+};
+}  // namespace AsyncMqttClientInternals
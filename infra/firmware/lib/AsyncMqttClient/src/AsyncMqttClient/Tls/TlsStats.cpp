@@ -0,0 +1,63 @@
+#include "TlsStats.hpp"
+
+using AsyncMqttClientInternals::TlsHandshakeMeter;
+using AsyncMqttClientInternals::TlsHandshakeStats;
+
+TlsHandshakeMeter::TlsHandshakeMeter()
+: _stats()
+, _running(false)
+, _startedMs(0)
+, _startHeap(0)
+, _lowestHeap(0) {}
+
+void TlsHandshakeMeter::setContextHeap(uint32_t bytes) {
+  _stats.contextHeapBytes = bytes;
+}
+
+void TlsHandshakeMeter::start(uint32_t nowMs, uint32_t freeHeap) {
+  _running = true;
+  _startedMs = nowMs;
+  _startHeap = freeHeap;
+  _lowestHeap = freeHeap;
+}
+
+void TlsHandshakeMeter::sample(uint32_t freeHeap) {
+  if (_running && freeHeap < _lowestHeap) _lowestHeap = freeHeap;
+}
+
+void TlsHandshakeMeter::succeed(uint32_t nowMs, bool resumed) {
+  if (!_running) return;
+  _running = false;
+  const uint32_t elapsedMs = nowMs - _startedMs;
+  _stats.lastMs = elapsedMs;
+  _stats.lastResumed = resumed;
+  _stats.lastHeapBytes = _heapTaken();
+  if (_stats.lastHeapBytes > _stats.maxHeapBytes) _stats.maxHeapBytes = _stats.lastHeapBytes;
+  if (resumed) {
+    _stats.resumed++;
+    _stats.totalResumedMs += elapsedMs;
+    if (elapsedMs > _stats.maxResumedMs) _stats.maxResumedMs = elapsedMs;
+  } else {
+    _stats.full++;
+    _stats.totalFullMs += elapsedMs;
+    if (elapsedMs > _stats.maxFullMs) _stats.maxFullMs = elapsedMs;
+  }
+}
+
+void TlsHandshakeMeter::fail(int32_t error) {
+  _running = false;
+  _stats.failed++;
+  _stats.lastError = error;
+}
+
+bool TlsHandshakeMeter::running() const {
+  return _running;
+}
+
+const TlsHandshakeStats& TlsHandshakeMeter::stats() const {
+  return _stats;
+}
+
+uint32_t TlsHandshakeMeter::_heapTaken() const {
+  return _startHeap - _lowestHeap;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+namespace AsyncMqttClientInternals {
+struct TlsHandshakeStats {
+  uint32_t full;             // completed handshakes with a certificate exchange
+  uint32_t resumed;          // completed handshakes that resumed a saved session
+  uint32_t failed;
+  uint32_t lastMs;
+  bool lastResumed;
+  uint32_t lastHeapBytes;    // heap the last handshake took at its low point
+  uint32_t maxHeapBytes;
+  uint32_t maxFullMs;
+  uint32_t maxResumedMs;
+  uint64_t totalFullMs;
+  uint64_t totalResumedMs;
+  int32_t lastError;         // mbedTLS error of the last failure, 0 if none
+  uint32_t contextHeapBytes;  // buffers of the TLS context, allocated once and kept
+};
+
+/*
+ * Times handshakes and tracks the lowest free heap seen while one runs. The heap is
+ * sampled between handshake steps, so it includes what a step keeps (key material,
+ * the peer certificate) but not scratch memory a step frees before it returns.
+ */
+class TlsHandshakeMeter {
+ public:
+  TlsHandshakeMeter();
+
+  void setContextHeap(uint32_t bytes);
+  void start(uint32_t nowMs, uint32_t freeHeap);
+  void sample(uint32_t freeHeap);
+  void succeed(uint32_t nowMs, bool resumed);
+  void fail(int32_t error);
+  bool running() const;
+
+  const TlsHandshakeStats& stats() const;
+
+ private:
+  uint32_t _heapTaken() const;
+
+  TlsHandshakeStats _stats;
+  bool _running;
+  uint32_t _startedMs;
+  uint32_t _startHeap;
+  uint32_t _lowestHeap;
+};
+}  // namespace AsyncMqttClientInternals
@@ -0,0 +1,114 @@
+#include "boot_timeline.h"
+
+static_assert(BootTimeline::PHASE_COUNT <= 8, "reachedMask_ holds one bit per phase");
+
+static uint8_t phaseBit(BootPhase phase)
+{
+  return static_cast<uint8_t>(1u << static_cast<uint8_t>(phase));
+}
+
+BootTimeline::BootTimeline()
+  : atMs_{},
+    reachedMask_(0),
+    mqttAttempts_(0),
+    reported_(false)
+{
+}
+
+void BootTimeline::Mark(BootPhase phase, uint32_t nowMs)
+{
+  if (phase == BootPhase::Count || Has(phase))
+  {
+    return;
+  }
+
+  atMs_[static_cast<size_t>(phase)] = nowMs;
+  reachedMask_ |= phaseBit(phase);
+}
+
+void BootTimeline::CountMqttAttempt()
+{
+  if (!Has(BootPhase::MqttConnected) && mqttAttempts_ < UINT16_MAX)
+  {
+    mqttAttempts_++;
+  }
+}
+
+bool BootTimeline::Has(BootPhase phase) const
+{
+  return phase != BootPhase::Count && (reachedMask_ & phaseBit(phase)) != 0;
+}
+
+uint32_t BootTimeline::At(BootPhase phase) const
+{
+  return Has(phase) ? atMs_[static_cast<size_t>(phase)] : 0;
+}
+
+uint32_t BootTimeline::SincePrevious(BootPhase phase) const
+{
+  if (!Has(phase))
+  {
+    return 0;
+  }
+
+  for (size_t i = static_cast<size_t>(phase); i > 0; i--)
+  {
+    const BootPhase previous = static_cast<BootPhase>(i - 1);
+    if (Has(previous))
+    {
+      return At(phase) - At(previous);
+    }
+  }
+  return At(phase);
+}
+
+uint16_t BootTimeline::MqttAttempts() const
+{
+  return mqttAttempts_;
+}
+
+bool BootTimeline::ReportDue() const
+{
+  return !reported_ && Has(BootPhase::FirstPublish);
+}
+
+void BootTimeline::MarkReported()
+{
+  reported_ = true;
+}
+
+const char* BootTimeline::PhaseName(BootPhase phase)
+{
+  switch (phase)
+  {
+    case BootPhase::Setup: return "setup";
+    case BootPhase::WifiBegin: return "wifiBegin";
+    case BootPhase::WifiConnected: return "wifiConnected";
+    case BootPhase::MqttConnecting: return "mqttConnecting";
+    case BootPhase::MqttConnected: return "mqttConnected";
+    case BootPhase::Subscribed: return "subscribed";
+    case BootPhase::FirstPublish: return "firstPublish";
+    case BootPhase::Count: break;
+  }
+  return "unknown";
+}
+
+#if defined(ESP32)
+const char* ResetReasonName(esp_reset_reason_t reason)
+{
+  switch (reason)
+  {
+    case ESP_RST_POWERON: return "power_on";
+    case ESP_RST_EXT: return "external";
+    case ESP_RST_SW: return "software";
+    case ESP_RST_PANIC: return "panic";
+    case ESP_RST_INT_WDT: return "interrupt_watchdog";
+    case ESP_RST_TASK_WDT: return "task_watchdog";
+    case ESP_RST_WDT: return "watchdog";
+    case ESP_RST_DEEPSLEEP: return "deep_sleep";
+    case ESP_RST_BROWNOUT: return "brownout";
+    case ESP_RST_SDIO: return "sdio";
+    default: return "unknown";
+  }
+}
+#endif
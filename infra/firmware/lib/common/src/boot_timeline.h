@@ -0,0 +1,64 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#if defined(ESP32)
+#include <esp_system.h>
+#endif
+
+/// <summary>
+/// Cold-start milestones, in the order they normally happen.
+/// </summary>
+enum class BootPhase : uint8_t
+{
+  Setup,
+  WifiBegin,
+  WifiConnected,
+  MqttConnecting,
+  MqttConnected,
+  Subscribed,
+  FirstPublish,
+  Count
+};
+
+/// <summary>
+/// Records the first time each boot phase is reached, in millis() since boot.
+/// Later reconnects do not overwrite a phase, so the record describes the cold start only.
+/// Owned by loop().
+/// </summary>
+class BootTimeline
+{
+public:
+  static constexpr size_t PHASE_COUNT = static_cast<size_t>(BootPhase::Count);
+
+  BootTimeline();
+
+  void Mark(BootPhase phase, uint32_t nowMs);
+  void CountMqttAttempt();
+  bool Has(BootPhase phase) const;
+  uint32_t At(BootPhase phase) const;
+  // Milliseconds from the previous reached phase (or boot) to this one.
+  uint32_t SincePrevious(BootPhase phase) const;
+  uint16_t MqttAttempts() const;
+  // True once the first publish is recorded and the report has not been taken yet.
+  bool ReportDue() const;
+  void MarkReported();
+
+  static const char* PhaseName(BootPhase phase);
+
+private:
+  uint32_t atMs_[PHASE_COUNT];
+  uint8_t reachedMask_;
+  uint16_t mqttAttempts_;
+  bool reported_;
+};
+
+#if defined(ESP32)
+/// <summary>
+/// Name of a reset reason as reported in diag/boot.
+/// </summary>
+const char* ResetReasonName(esp_reset_reason_t reason);
+#endif
+
+#endif
@@ -0,0 +1,263 @@
+#include "connectivity_manager.h"
+
+static bool reached(uint32_t nowMs, uint32_t atMs)
+{
+  return static_cast<int32_t>(nowMs - atMs) >= 0;
+}
+
+static uint32_t untilMs(uint32_t nowMs, uint32_t atMs)
+{
+  const int32_t left = static_cast<int32_t>(atMs - nowMs);
+  return left > 0 ? static_cast<uint32_t>(left) : 0;
+}
+
+ReconnectBackoff::ReconnectBackoff(uint32_t firstRetryMs, uint32_t baseMs, uint32_t maxMs)
+  : firstRetryMs_(firstRetryMs),
+    baseMs_(baseMs),
+    maxMs_(maxMs),
+    failures_(0)
+{
+}
+
+uint32_t ReconnectBackoff::NextDelayMs(uint32_t random)
+{
+  uint32_t delayMs = firstRetryMs_;
+  if (failures_ > 0)
+  {
+    uint32_t ceilingMs = baseMs_ < maxMs_ ? baseMs_ : maxMs_;
+    for (uint32_t i = 1; i < failures_ && ceilingMs < maxMs_; i++)
+    {
+      ceilingMs = ceilingMs > maxMs_ / 2 ? maxMs_ : ceilingMs * 2;
+    }
+    const uint32_t floorMs = ceilingMs / 2;
+    delayMs = floorMs + random % (ceilingMs - floorMs + 1);
+  }
+
+  if (failures_ < UINT32_MAX)
+  {
+    failures_++;
+  }
+  return delayMs;
+}
+
+void ReconnectBackoff::Reset()
+{
+  failures_ = 0;
+}
+
+uint32_t ReconnectBackoff::Failures() const
+{
+  return failures_;
+}
+
+ConnectivityManager::ConnectivityManager(ConnectivityHal& hal, const ConnectivityConfig& config)
+  : hal_(hal),
+    config_(config),
+    wifiBackoff_(config.firstRetryMs, config.backoffBaseMs, config.backoffMaxMs),
+    mqttBackoff_(config.firstRetryMs, config.backoffBaseMs, config.backoffMaxMs),
+    wifi_(LinkState::Down),
+    mqtt_(LinkState::Down),
+    hasCredentials_(false),
+    portalActive_(false),
+    wifiAttemptStartMs_(0),
+    wifiRetryAtMs_(0),
+    wifiDownSinceMs_(0),
+    mqttRetryAtMs_(0),
+    offline_(false),
+    offlineSinceMs_(0),
+    stats_{ 0, 0, 0, 0, 0, 0, 0 }
+{
+}
+
+void ConnectivityManager::Begin(bool hasCredentials, uint32_t nowMs)
+{
+  hasCredentials_ = hasCredentials;
+  wifiDownSinceMs_ = nowMs;
+  if (!hasCredentials_)
+  {
+    portalActive_ = true;
+    stats_.portalOpens++;
+    hal_.StartPortal();
+    return;
+  }
+
+  StartWifiAttempt(nowMs);
+}
+
+void ConnectivityManager::Step(uint32_t nowMs)
+{
+  if (wifi_ == LinkState::Connecting && nowMs - wifiAttemptStartMs_ >= config_.wifiAttemptTimeoutMs)
+  {
+    WifiDown(nowMs);
+  }
+
+  if (wifi_ == LinkState::Down && hasCredentials_ && reached(nowMs, wifiRetryAtMs_))
+  {
+    StartWifiAttempt(nowMs);
+  }
+
+  if (!portalActive_ && wifi_ != LinkState::Up && nowMs - wifiDownSinceMs_ >= config_.portalAfterMs)
+  {
+    portalActive_ = true;
+    stats_.portalOpens++;
+    hal_.StartPortal();
+  }
+
+  if (wifi_ == LinkState::Up && mqtt_ == LinkState::Down && reached(nowMs, mqttRetryAtMs_))
+  {
+    mqtt_ = LinkState::Connecting;
+    stats_.mqttAttempts++;
+    hal_.BeginMqtt();
+  }
+}
+
+void ConnectivityManager::OnWifiConnected(uint32_t nowMs)
+{
+  if (wifi_ == LinkState::Up)
+  {
+    return;
+  }
+
+  wifi_ = LinkState::Up;
+  wifiBackoff_.Reset();
+  if (portalActive_)
+  {
+    portalActive_ = false;
+    hal_.StopPortal();
+  }
+  if (mqtt_ == LinkState::Down)
+  {
+    // A fresh station gets its MQTT attempt right away, whatever the broker backoff was.
+    mqttRetryAtMs_ = nowMs;
+  }
+}
+
+void ConnectivityManager::OnWifiDisconnected(uint32_t nowMs)
+{
+  if (wifi_ == LinkState::Down)
+  {
+    // Repeated event, or the tail of an attempt that already timed out.
+    return;
+  }
+
+  if (wifi_ == LinkState::Up)
+  {
+    wifiDownSinceMs_ = nowMs;
+    if (mqtt_ == LinkState::Up)
+    {
+      MarkOffline(nowMs);
+    }
+    // The session dies with the station; its own disconnect event is ignored.
+    mqtt_ = LinkState::Down;
+  }
+  WifiDown(nowMs);
+}
+
+void ConnectivityManager::OnMqttConnected(uint32_t nowMs)
+{
+  mqtt_ = LinkState::Up;
+  mqttBackoff_.Reset();
+  if (offline_)
+  {
+    const uint32_t reconnectMs = nowMs - offlineSinceMs_;
+    offline_ = false;
+    stats_.reconnects++;
+    stats_.lastReconnectMs = reconnectMs;
+    stats_.totalReconnectMs += reconnectMs;
+    if (reconnectMs > stats_.maxReconnectMs)
+    {
+      stats_.maxReconnectMs = reconnectMs;
+    }
+  }
+}
+
+void ConnectivityManager::OnMqttDisconnected(uint32_t nowMs)
+{
+  if (mqtt_ == LinkState::Down)
+  {
+    return;
+  }
+
+  if (mqtt_ == LinkState::Up)
+  {
+    MarkOffline(nowMs);
+  }
+  MqttDown(nowMs);
+}
+
+LinkState ConnectivityManager::Wifi() const
+{
+  return wifi_;
+}
+
+LinkState ConnectivityManager::Mqtt() const
+{
+  return mqtt_;
+}
+
+bool ConnectivityManager::PortalActive() const
+{
+  return portalActive_;
+}
+
+uint32_t ConnectivityManager::MsUntilNextStep(uint32_t nowMs, uint32_t idleMs) const
+{
+  uint32_t waitMs = idleMs;
+  uint32_t candidateMs = idleMs;
+  if (wifi_ == LinkState::Connecting)
+  {
+    candidateMs = untilMs(nowMs, wifiAttemptStartMs_ + config_.wifiAttemptTimeoutMs);
+  }
+  else if (wifi_ == LinkState::Down && hasCredentials_)
+  {
+    candidateMs = untilMs(nowMs, wifiRetryAtMs_);
+  }
+  waitMs = candidateMs < waitMs ? candidateMs : waitMs;
+
+  if (!portalActive_ && wifi_ != LinkState::Up)
+  {
+    candidateMs = untilMs(nowMs, wifiDownSinceMs_ + config_.portalAfterMs);
+    waitMs = candidateMs < waitMs ? candidateMs : waitMs;
+  }
+
+  if (wifi_ == LinkState::Up && mqtt_ == LinkState::Down)
+  {
+    candidateMs = untilMs(nowMs, mqttRetryAtMs_);
+    waitMs = candidateMs < waitMs ? candidateMs : waitMs;
+  }
+  return waitMs;
+}
+
+const ConnectivityStats& ConnectivityManager::Stats() const
+{
+  return stats_;
+}
+
+void ConnectivityManager::StartWifiAttempt(uint32_t nowMs)
+{
+  wifi_ = LinkState::Connecting;
+  wifiAttemptStartMs_ = nowMs;
+  stats_.wifiAttempts++;
+  hal_.BeginWifi();
+}
+
+void ConnectivityManager::WifiDown(uint32_t nowMs)
+{
+  wifi_ = LinkState::Down;
+  wifiRetryAtMs_ = nowMs + wifiBackoff_.NextDelayMs(hal_.Random());
+}
+
+void ConnectivityManager::MqttDown(uint32_t nowMs)
+{
+  mqtt_ = LinkState::Down;
+  mqttRetryAtMs_ = nowMs + mqttBackoff_.NextDelayMs(hal_.Random());
+}
+
+void ConnectivityManager::MarkOffline(uint32_t nowMs)
+{
+  if (!offline_)
+  {
+    offline_ = true;
+    offlineSinceMs_ = nowMs;
+  }
+}
@@ -0,0 +1,133 @@
+#ifndef CONNECTIVITY_MANAGER_H
+#define CONNECTIVITY_MANAGER_H
+
+#include <stdint.h>
+
+/// <summary>
+/// Radio and client seams of the connectivity manager.
+/// </summary>
+class ConnectivityHal
+{
+public:
+  // Starts a station connect attempt with the stored credentials.
+  virtual void BeginWifi() = 0;
+  // Opens the config portal access point next to the station (AP+STA).
+  virtual void StartPortal() = 0;
+  virtual void StopPortal() = 0;
+  virtual void BeginMqtt() = 0;
+  // Jitter source: any uniformly distributed 32-bit value.
+  virtual uint32_t Random() = 0;
+
+protected:
+  ~ConnectivityHal() = default;
+};
+
+struct ConnectivityConfig
+{
+  // A station attempt without an IP after this long counts as failed.
+  uint32_t wifiAttemptTimeoutMs;
+  // Delay before the first retry after a drop or failure.
+  uint32_t firstRetryMs;
+  // Later retries wait base, 2 x base, ... up to max, jittered down to half of that.
+  uint32_t backoffBaseMs;
+  uint32_t backoffMaxMs;
+  // The station down for this long opens the config portal.
+  uint32_t portalAfterMs;
+};
+
+/// <summary>
+/// Retry delays: a fast first retry, then exponential backoff with equal jitter
+/// (a delay d is drawn from [d/2, d]) so nodes that lost the same AP do not retry in step.
+/// </summary>
+class ReconnectBackoff
+{
+public:
+  ReconnectBackoff(uint32_t firstRetryMs, uint32_t baseMs, uint32_t maxMs);
+
+  uint32_t NextDelayMs(uint32_t random);
+  void Reset();
+  // Delays handed out since the last Reset().
+  uint32_t Failures() const;
+
+private:
+  uint32_t firstRetryMs_;
+  uint32_t baseMs_;
+  uint32_t maxMs_;
+  uint32_t failures_;
+};
+
+enum class LinkState : uint8_t
+{
+  // Waiting for the next retry; for MQTT also waiting for Wi-Fi.
+  Down,
+  Connecting,
+  Up
+};
+
+/// <summary>
+/// Attempts and time-to-reconnect. A reconnect runs from the loss of an established
+/// MQTT session (or of the Wi-Fi under it) until MQTT is connected again.
+/// </summary>
+struct ConnectivityStats
+{
+  uint32_t wifiAttempts;
+  uint32_t mqttAttempts;
+  uint32_t portalOpens;
+  uint32_t reconnects;
+  uint32_t lastReconnectMs;
+  uint32_t maxReconnectMs;
+  uint64_t totalReconnectMs;
+};
+
+/// <summary>
+/// Keeps the station and the MQTT session up. It is driven by link events plus Step()
+/// for retry and timeout deadlines, and only ever has one attempt per link in flight.
+/// Failed attempts back off with ReconnectBackoff. A station that stays down opens the
+/// config portal in AP+STA mode; the station keeps retrying and the portal closes as
+/// soon as it connects. Owned by loop().
+/// </summary>
+class ConnectivityManager
+{
+public:
+  ConnectivityManager(ConnectivityHal& hal, const ConnectivityConfig& config);
+
+  // Without credentials the portal opens straight away and the station is never started.
+  void Begin(bool hasCredentials, uint32_t nowMs);
+  void Step(uint32_t nowMs);
+
+  void OnWifiConnected(uint32_t nowMs);
+  void OnWifiDisconnected(uint32_t nowMs);
+  void OnMqttConnected(uint32_t nowMs);
+  void OnMqttDisconnected(uint32_t nowMs);
+
+  LinkState Wifi() const;
+  LinkState Mqtt() const;
+  bool PortalActive() const;
+  // Time until Step() has a deadline to act on, at most idleMs.
+  uint32_t MsUntilNextStep(uint32_t nowMs, uint32_t idleMs) const;
+  const ConnectivityStats& Stats() const;
+
+private:
+  void StartWifiAttempt(uint32_t nowMs);
+  void WifiDown(uint32_t nowMs);
+  void MqttDown(uint32_t nowMs);
+  void MarkOffline(uint32_t nowMs);
+
+  ConnectivityHal& hal_;
+  ConnectivityConfig config_;
+  ReconnectBackoff wifiBackoff_;
+  ReconnectBackoff mqttBackoff_;
+  LinkState wifi_;
+  LinkState mqtt_;
+  bool hasCredentials_;
+  bool portalActive_;
+  uint32_t wifiAttemptStartMs_;
+  uint32_t wifiRetryAtMs_;
+  uint32_t wifiDownSinceMs_;
+  uint32_t mqttRetryAtMs_;
+  bool offline_;
+  uint32_t offlineSinceMs_;
+  ConnectivityStats stats_;
+};
+
+#endif
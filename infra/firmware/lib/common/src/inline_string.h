@@ -0,0 +1,73 @@
+#ifndef INLINE_STRING_H
+#define INLINE_STRING_H
+
+#include <stddef.h>
+#include <string.h>
+#include <string_view>
+
+/// <summary>
+/// Fixed-capacity, null-terminated string stored inline (never touches the heap).
+/// Values longer than Capacity are truncated.
+/// </summary>
+template <size_t Capacity>
+class InlineString
+{
+public:
+  InlineString()
+    : length_(0)
+  {
+    data_[0] = '\0';
+  }
+
+  explicit InlineString(std::string_view value)
+  {
+    Assign(value);
+  }
+
+  void Assign(std::string_view value)
+  {
+    length_ = value.size() < Capacity ? value.size() : Capacity;
+    if (length_ > 0)
+    {
+      memcpy(data_, value.data(), length_);
+    }
+    data_[length_] = '\0';
+  }
+
+  void Clear()
+  {
+    length_ = 0;
+    data_[0] = '\0';
+  }
+
+  std::string_view View() const
+  {
+    return std::string_view(data_, length_);
+  }
+
+  const char* CStr() const
+  {
+    return data_;
+  }
+
+  size_t Length() const
+  {
+    return length_;
+  }
+
+  bool Empty() const
+  {
+    return length_ == 0;
+  }
+
+  static constexpr size_t MaxLength()
+  {
+    return Capacity;
+  }
+
+private:
+  char data_[Capacity + 1];
+  size_t length_;
+};
+
+#endif
@@ -0,0 +1,10 @@
+#include "iso_timestamp.h"
+
+IsoTimestamp FormatIsoUtc(time_t at)
+{
+  struct tm tmUtc;
+  gmtime_r(&at, &tmUtc);
+  char buf[ISO_TIMESTAMP_MAX_LENGTH + 1];
+  const size_t len = strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tmUtc);
+  return IsoTimestamp(std::string_view(buf, len));
+}
@@ -0,0 +1,20 @@
+#ifndef ISO_TIMESTAMP_H
+#define ISO_TIMESTAMP_H
+
+#include <stddef.h>
+#include <time.h>
+#include "inline_string.h"
+
+/// <summary>
+/// Room for an ISO-8601 UTC timestamp such as 2026-01-15T07:00:00Z.
+/// </summary>
+static constexpr size_t ISO_TIMESTAMP_MAX_LENGTH = 24;
+
+using IsoTimestamp = InlineString<ISO_TIMESTAMP_MAX_LENGTH>;
+
+/// <summary>
+/// Formats a Unix time as an ISO-8601 UTC timestamp without touching the heap.
+/// </summary>
+IsoTimestamp FormatIsoUtc(time_t at);
+
+#endif
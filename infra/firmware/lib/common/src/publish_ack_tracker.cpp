@@ -0,0 +1,62 @@
+#include "publish_ack_tracker.h"
+
+PublishAckTracker::PublishAckTracker(uint32_t timeoutMs)
+  : timeoutMs_(timeoutMs),
+    packetId_(0),
+    value_(0),
+    sentMs_(0),
+    ackCount_(0),
+    lastLatencyMs_(0)
+{
+}
+
+void PublishAckTracker::Sent(uint16_t packetId, uint32_t value, uint32_t nowMs)
+{
+  packetId_ = packetId;
+  value_ = value;
+  sentMs_ = nowMs;
+}
+
+bool PublishAckTracker::Acked(uint16_t packetId, uint32_t nowMs, PublishAck& ack)
+{
+  if (packetId_ == 0 || packetId != packetId_)
+  {
+    return false;
+  }
+
+  packetId_ = 0;
+  lastLatencyMs_ = nowMs - sentMs_;
+  ackCount_++;
+  ack = { value_, sentMs_, lastLatencyMs_ };
+  return true;
+}
+
+void PublishAckTracker::Reset()
+{
+  packetId_ = 0;
+}
+
+bool PublishAckTracker::Pending() const
+{
+  return packetId_ != 0;
+}
+
+uint32_t PublishAckTracker::PendingValue() const
+{
+  return value_;
+}
+
+bool PublishAckTracker::Overdue(uint32_t nowMs) const
+{
+  return Pending() && nowMs - sentMs_ >= timeoutMs_;
+}
+
+uint32_t PublishAckTracker::AckCount() const
+{
+  return ackCount_;
+}
+
+uint32_t PublishAckTracker::LastLatencyMs() const
+{
+  return lastLatencyMs_;
+}
@@ -0,0 +1,50 @@
+#ifndef PUBLISH_ACK_TRACKER_H
+#define PUBLISH_ACK_TRACKER_H
+
+#include <stdint.h>
+
+/// <summary>
+/// A state publish confirmed by its PUBACK: what was sent, when, and how long the ack took.
+/// </summary>
+struct PublishAck
+{
+  uint32_t value;
+  uint32_t sentMs;
+  uint32_t latencyMs;
+};
+
+/// <summary>
+/// Follows the latest QoS 1 state publish until the broker acknowledges it, so the
+/// caller only commits a state as delivered on its PUBACK. A newer publish replaces
+/// the awaited one; acks for older packets are ignored. Owned by loop().
+/// </summary>
+class PublishAckTracker
+{
+public:
+  explicit PublishAckTracker(uint32_t timeoutMs);
+
+  // packetId 0 (the publish was refused) leaves nothing to await.
+  void Sent(uint16_t packetId, uint32_t value, uint32_t nowMs);
+  // True when packetId is the awaited publish; it is no longer pending afterwards.
+  bool Acked(uint16_t packetId, uint32_t nowMs, PublishAck& ack);
+  // Forgets the awaited publish, e.g. after a disconnect; it has to be sent again.
+  void Reset();
+
+  bool Pending() const;
+  uint32_t PendingValue() const;
+  // Pending for longer than the timeout: the ack is not coming, send again.
+  bool Overdue(uint32_t nowMs) const;
+
+  uint32_t AckCount() const;
+  uint32_t LastLatencyMs() const;
+
+private:
+  uint32_t timeoutMs_;
+  uint16_t packetId_;
+  uint32_t value_;
+  uint32_t sentMs_;
+  uint32_t ackCount_;
+  uint32_t lastLatencyMs_;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/// <summary>
+/// Fixed-size lock-free ring for exactly one producer task and one consumer task.
+/// Pushing into a full ring fails and is counted instead of blocking the producer.
+/// </summary>
+template <typename T, size_t Capacity>
+class SpscRing
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+  SpscRing()
+    : head_(0),
+      tail_(0),
+      highWaterMark_(0),
+      droppedCount_(0)
+  {
+  }
+
+  /// <summary>
+  /// Producer side only.
+  /// </summary>
+  bool TryPush(const T& item)
+  {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    const size_t used = head - tail;
+    if (used >= Capacity)
+    {
+      droppedCount_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    items_[head & (Capacity - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+
+    if (used + 1 > highWaterMark_.load(std::memory_order_relaxed))
+    {
+      highWaterMark_.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  /// <summary>
+  /// Consumer side only.
+  /// </summary>
+  bool TryPop(T& item)
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    item = items_[tail & (Capacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t Size() const
+  {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  size_t HighWaterMark() const
+  {
+    return highWaterMark_.load(std::memory_order_relaxed);
+  }
+
+  uint32_t DroppedCount() const
+  {
+    return droppedCount_.load(std::memory_order_relaxed);
+  }
+
+  static constexpr size_t CapacityValue()
+  {
+    return Capacity;
+  }
+
+private:
+  T items_[Capacity];
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+  std::atomic<size_t> highWaterMark_;
+  std::atomic<uint32_t> droppedCount_;
+};
+
+#endif
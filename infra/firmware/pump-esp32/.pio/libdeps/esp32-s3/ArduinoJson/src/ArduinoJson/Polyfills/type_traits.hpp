@@ -1,27 +0,0 @@
-// ArduinoJson - https://arduinojson.org
-// Copyright © 2014-2025, Benoit BLANCHON
-// MIT License
-
-#pragma once
-
-#include "type_traits/conditional.hpp"
-#include "type_traits/decay.hpp"
-#include "type_traits/enable_if.hpp"
-#include "type_traits/function_traits.hpp"
-#include "type_traits/integral_constant.hpp"
-#include "type_traits/is_array.hpp"
-#include "type_traits/is_base_of.hpp"
-#include "type_traits/is_class.hpp"
-#include "type_traits/is_const.hpp"
-#include "type_traits/is_convertible.hpp"
-#include "type_traits/is_enum.hpp"
-#include "type_traits/is_floating_point.hpp"
-#include "type_traits/is_integral.hpp"
-#include "type_traits/is_pointer.hpp"
-#include "type_traits/is_same.hpp"
-#include "type_traits/is_signed.hpp"
-#include "type_traits/is_unsigned.hpp"
-#include "type_traits/make_unsigned.hpp"
-#include "type_traits/remove_const.hpp"
-#include "type_traits/remove_reference.hpp"
-#include "type_traits/void_t.hpp"
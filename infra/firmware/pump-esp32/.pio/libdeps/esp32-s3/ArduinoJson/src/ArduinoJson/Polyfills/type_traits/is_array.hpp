@@ -1,22 +0,0 @@
-// ArduinoJson - https://arduinojson.org
-// Copyright © 2014-2025, Benoit BLANCHON
-// MIT License
-
-#pragma once
-
-#include <ArduinoJson/Namespace.hpp>
-
-#include <stddef.h>  // size_t
-
-ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
-
-template <typename T>
-struct is_array : false_type {};
-
-template <typename T>
-struct is_array<T[]> : true_type {};
-
-template <typename T, size_t N>
-struct is_array<T[N]> : true_type {};
-
-ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,144 @@
+#include "alloc_accounting.h"
+
+#include <stdlib.h>
+#include <atomic>
+
+namespace
+{
+struct AtomicTagStats
+{
+  std::atomic<uint32_t> allocations;
+  std::atomic<uint32_t> frees;
+  std::atomic<uint32_t> liveBytes;
+  std::atomic<uint32_t> peakLiveBytes;
+  std::atomic<uint64_t> totalBytes;
+};
+
+AtomicTagStats tagStats[AllocAccounting::TAG_COUNT];
+
+// Keeps the payload maximally aligned behind the size header.
+constexpr size_t JSON_HEADER_SIZE = alignof(max_align_t);
+static_assert(JSON_HEADER_SIZE >= sizeof(size_t), "header must hold the block size");
+
+AtomicTagStats* statsFor(AllocTag tag)
+{
+  const size_t index = static_cast<size_t>(tag);
+  return index < AllocAccounting::TAG_COUNT ? &tagStats[index] : nullptr;
+}
+}
+
+void AllocAccounting::OnAllocate(AllocTag tag, size_t bytes)
+{
+  AtomicTagStats* stats = statsFor(tag);
+  if (!stats)
+  {
+    return;
+  }
+
+  stats->allocations.fetch_add(1, std::memory_order_relaxed);
+  stats->totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+  const uint32_t live = stats->liveBytes.fetch_add(static_cast<uint32_t>(bytes), std::memory_order_relaxed) + static_cast<uint32_t>(bytes);
+  uint32_t peak = stats->peakLiveBytes.load(std::memory_order_relaxed);
+  while (live > peak && !stats->peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+  {
+  }
+}
+
+void AllocAccounting::OnFree(AllocTag tag, size_t bytes)
+{
+  AtomicTagStats* stats = statsFor(tag);
+  if (!stats)
+  {
+    return;
+  }
+
+  stats->frees.fetch_add(1, std::memory_order_relaxed);
+  stats->liveBytes.fetch_sub(static_cast<uint32_t>(bytes), std::memory_order_relaxed);
+}
+
+AllocTagStats AllocAccounting::Stats(AllocTag tag)
+{
+  const AtomicTagStats* stats = statsFor(tag);
+  if (!stats)
+  {
+    return AllocTagStats{};
+  }
+
+  return AllocTagStats{
+    stats->allocations.load(std::memory_order_relaxed),
+    stats->frees.load(std::memory_order_relaxed),
+    stats->liveBytes.load(std::memory_order_relaxed),
+    stats->peakLiveBytes.load(std::memory_order_relaxed),
+    stats->totalBytes.load(std::memory_order_relaxed)
+  };
+}
+
+void AllocAccounting::Reset()
+{
+  for (AtomicTagStats& stats : tagStats)
+  {
+    stats.allocations = 0;
+    stats.frees = 0;
+    stats.liveBytes = 0;
+    stats.peakLiveBytes = 0;
+    stats.totalBytes = 0;
+  }
+}
+
+const char* AllocAccounting::TagName(AllocTag tag)
+{
+  switch (tag)
+  {
+    case AllocTag::MqttOut: return "mqttOut";
+    case AllocTag::Json: return "json";
+    case AllocTag::Count: break;
+  }
+  return "unknown";
+}
+
+void* AccountedJsonAllocator::allocate(size_t size)
+{
+  uint8_t* block = static_cast<uint8_t*>(malloc(JSON_HEADER_SIZE + size));
+  if (!block)
+  {
+    return nullptr;
+  }
+
+  *reinterpret_cast<size_t*>(block) = size;
+  AllocAccounting::OnAllocate(AllocTag::Json, size);
+  return block + JSON_HEADER_SIZE;
+}
+
+void AccountedJsonAllocator::deallocate(void* ptr)
+{
+  if (!ptr)
+  {
+    return;
+  }
+
+  uint8_t* block = static_cast<uint8_t*>(ptr) - JSON_HEADER_SIZE;
+  AllocAccounting::OnFree(AllocTag::Json, *reinterpret_cast<size_t*>(block));
+  free(block);
+}
+
+void* AccountedJsonAllocator::reallocate(void* ptr, size_t newSize)
+{
+  if (!ptr)
+  {
+    return allocate(newSize);
+  }
+
+  uint8_t* block = static_cast<uint8_t*>(ptr) - JSON_HEADER_SIZE;
+  const size_t oldSize = *reinterpret_cast<size_t*>(block);
+  uint8_t* resized = static_cast<uint8_t*>(realloc(block, JSON_HEADER_SIZE + newSize));
+  if (!resized)
+  {
+    return nullptr;
+  }
+
+  // Booked as a free of the old block and an allocation of the new one.
+  *reinterpret_cast<size_t*>(resized) = newSize;
+  AllocAccounting::OnFree(AllocTag::Json, oldSize);
+  AllocAccounting::OnAllocate(AllocTag::Json, newSize);
+  return resized + JSON_HEADER_SIZE;
+}
@@ -0,0 +1,54 @@
+#ifndef ALLOC_ACCOUNTING_H
+#define ALLOC_ACCOUNTING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+
+/// <summary>
+/// Subsystems whose heap use is tracked separately.
+/// </summary>
+enum class AllocTag : uint8_t
+{
+  MqttOut,
+  Json,
+  Count
+};
+
+struct AllocTagStats
+{
+  uint32_t allocations;
+  uint32_t frees;
+  uint32_t liveBytes;
+  uint32_t peakLiveBytes;
+  uint64_t totalBytes;
+};
+
+/// <summary>
+/// Process-wide allocation counters per tag. Safe to call from any task.
+/// </summary>
+class AllocAccounting
+{
+public:
+  static constexpr size_t TAG_COUNT = static_cast<size_t>(AllocTag::Count);
+
+  static void OnAllocate(AllocTag tag, size_t bytes);
+  static void OnFree(AllocTag tag, size_t bytes);
+  static AllocTagStats Stats(AllocTag tag);
+  static void Reset();
+  static const char* TagName(AllocTag tag);
+};
+
+/// <summary>
+/// ArduinoJson allocator that books every pool and string buffer under AllocTag::Json.
+/// Each block carries its size in a small header so frees are exact.
+/// </summary>
+class AccountedJsonAllocator : public ArduinoJson::Allocator
+{
+public:
+  void* allocate(size_t size) override;
+  void deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t newSize) override;
+};
+
+#endif
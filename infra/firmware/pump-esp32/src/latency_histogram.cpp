@@ -0,0 +1,112 @@
+#include "latency_histogram.h"
+
+static uint8_t highestBit(uint32_t value)
+{
+  return static_cast<uint8_t>(31 - __builtin_clz(value));
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+  Reset();
+}
+
+void LatencyHistogram::Record(uint32_t valueUs)
+{
+  uint32_t& bucket = buckets_[BucketIndex(valueUs)];
+  if (bucket < UINT32_MAX)
+  {
+    bucket++;
+  }
+  if (count_ < UINT32_MAX)
+  {
+    count_++;
+  }
+  minUs_ = valueUs < minUs_ ? valueUs : minUs_;
+  maxUs_ = valueUs > maxUs_ ? valueUs : maxUs_;
+}
+
+void LatencyHistogram::Reset()
+{
+  for (size_t i = 0; i < BUCKET_COUNT; i++)
+  {
+    buckets_[i] = 0;
+  }
+  count_ = 0;
+  minUs_ = UINT32_MAX;
+  maxUs_ = 0;
+}
+
+uint32_t LatencyHistogram::Count() const
+{
+  return count_;
+}
+
+uint32_t LatencyHistogram::MinUs() const
+{
+  return count_ == 0 ? 0 : minUs_;
+}
+
+uint32_t LatencyHistogram::MaxUs() const
+{
+  return maxUs_;
+}
+
+uint32_t LatencyHistogram::PercentileUs(uint8_t percent) const
+{
+  if (count_ == 0)
+  {
+    return 0;
+  }
+
+  percent = percent > 100 ? 100 : percent;
+  // Nearest-rank: the smallest value with at least percent % of samples at or below it.
+  uint64_t rank = (static_cast<uint64_t>(count_) * percent + 99) / 100;
+  rank = rank == 0 ? 1 : rank;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; i++)
+  {
+    seen += buckets_[i];
+    if (seen >= rank)
+    {
+      const uint32_t upperUs = BucketUpperUs(i);
+      return upperUs < maxUs_ ? upperUs : maxUs_;
+    }
+  }
+  return maxUs_;
+}
+
+size_t LatencyHistogram::BucketIndex(uint32_t valueUs)
+{
+  if (valueUs < SUB_BUCKETS)
+  {
+    return valueUs;
+  }
+
+  const uint8_t exponent = highestBit(valueUs);
+  const uint8_t shift = exponent - SUB_BUCKET_BITS;
+  const size_t subBucket = (valueUs >> shift) & (SUB_BUCKETS - 1);
+  return (static_cast<size_t>(shift) + 1) * SUB_BUCKETS + subBucket;
+}
+
+uint32_t LatencyHistogram::BucketLowerUs(size_t index)
+{
+  if (index < SUB_BUCKETS)
+  {
+    return static_cast<uint32_t>(index);
+  }
+
+  const uint8_t shift = static_cast<uint8_t>(index / SUB_BUCKETS - 1);
+  const uint32_t subBucket = static_cast<uint32_t>(index % SUB_BUCKETS);
+  return (static_cast<uint32_t>(SUB_BUCKETS) + subBucket) << shift;
+}
+
+uint32_t LatencyHistogram::BucketUpperUs(size_t index)
+{
+  if (index < SUB_BUCKETS)
+  {
+    return static_cast<uint32_t>(index);
+  }
+
+  const uint8_t shift = static_cast<uint8_t>(index / SUB_BUCKETS - 1);
+  return static_cast<uint32_t>(BucketLowerUs(index) + ((1ull << shift) - 1));
+}
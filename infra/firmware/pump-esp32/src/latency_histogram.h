@@ -0,0 +1,41 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// <summary>
+/// Fixed-bucket latency histogram in microseconds. Buckets are log-scaled with four
+/// linear steps per power of two, so any reported value is within 25 % of the
+/// recorded one. Recording is O(1) and never allocates.
+/// </summary>
+class LatencyHistogram
+{
+public:
+  static constexpr uint8_t SUB_BUCKET_BITS = 2;
+  static constexpr size_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKET_COUNT = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  LatencyHistogram();
+
+  void Record(uint32_t valueUs);
+  void Reset();
+
+  uint32_t Count() const;
+  uint32_t MinUs() const;
+  uint32_t MaxUs() const;
+  // Upper bound of the bucket holding the given percentile, capped at MaxUs(); 0 when empty.
+  uint32_t PercentileUs(uint8_t percent) const;
+
+  static size_t BucketIndex(uint32_t valueUs);
+  static uint32_t BucketLowerUs(size_t index);
+  static uint32_t BucketUpperUs(size_t index);
+
+private:
+  uint32_t buckets_[BUCKET_COUNT];
+  uint32_t count_;
+  uint32_t minUs_;
+  uint32_t maxUs_;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "loop_monitor.h"
+
+LoopMonitor::LoopMonitor(uint32_t stallThresholdUs)
+  : stallThresholdUs_(stallThresholdUs),
+    inIteration_(false),
+    iterationStartUs_(0),
+    currentStage_(0),
+    stageStartUs_(0),
+    trace_{},
+    traceNext_(0),
+    traceCount_(0),
+    stallCount_(0),
+    stallPending_(false),
+    lastStall_{}
+{
+}
+
+void LoopMonitor::BeginIteration(uint8_t stage, uint32_t nowUs)
+{
+  inIteration_ = true;
+  iterationStartUs_ = nowUs;
+  currentStage_ = stage;
+  stageStartUs_ = nowUs;
+}
+
+void LoopMonitor::EnterStage(uint8_t stage, uint32_t nowUs)
+{
+  if (!inIteration_)
+  {
+    BeginIteration(stage, nowUs);
+    return;
+  }
+
+  CloseStage(nowUs);
+  currentStage_ = stage;
+  stageStartUs_ = nowUs;
+}
+
+bool LoopMonitor::EndIteration(uint32_t nowUs)
+{
+  if (!inIteration_)
+  {
+    return false;
+  }
+
+  CloseStage(nowUs);
+  inIteration_ = false;
+  const uint32_t iterationUs = nowUs - iterationStartUs_;
+  iterations_.Record(iterationUs);
+  if (iterationUs <= stallThresholdUs_)
+  {
+    return false;
+  }
+
+  // The ring holds the stages of this and the previous iterations; keep them oldest first.
+  lastStall_.iterationUs = iterationUs;
+  lastStall_.endedUs = nowUs;
+  lastStall_.sampleCount = static_cast<uint8_t>(traceCount_);
+  const size_t first = (traceNext_ + LoopStallSnapshot::MAX_SAMPLES - traceCount_) % LoopStallSnapshot::MAX_SAMPLES;
+  for (size_t i = 0; i < traceCount_; i++)
+  {
+    lastStall_.samples[i] = trace_[(first + i) % LoopStallSnapshot::MAX_SAMPLES];
+  }
+  stallCount_++;
+  stallPending_ = true;
+  return true;
+}
+
+void LoopMonitor::RecordDecision(uint32_t durationUs)
+{
+  decisions_.Record(durationUs);
+}
+
+const LatencyHistogram& LoopMonitor::Iterations() const
+{
+  return iterations_;
+}
+
+const LatencyHistogram& LoopMonitor::Decisions() const
+{
+  return decisions_;
+}
+
+void LoopMonitor::ResetWindow()
+{
+  iterations_.Reset();
+  decisions_.Reset();
+}
+
+uint32_t LoopMonitor::StallThresholdUs() const
+{
+  return stallThresholdUs_;
+}
+
+uint32_t LoopMonitor::StallCount() const
+{
+  return stallCount_;
+}
+
+bool LoopMonitor::StallPending() const
+{
+  return stallPending_;
+}
+
+const LoopStallSnapshot& LoopMonitor::LastStall() const
+{
+  return lastStall_;
+}
+
+void LoopMonitor::ClearStallPending()
+{
+  stallPending_ = false;
+}
+
+void LoopMonitor::CloseStage(uint32_t nowUs)
+{
+  trace_[traceNext_] = LoopStageSample{ currentStage_, stageStartUs_, nowUs - stageStartUs_ };
+  traceNext_ = (traceNext_ + 1) % LoopStallSnapshot::MAX_SAMPLES;
+  if (traceCount_ < LoopStallSnapshot::MAX_SAMPLES)
+  {
+    traceCount_++;
+  }
+}
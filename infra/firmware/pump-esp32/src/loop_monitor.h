@@ -0,0 +1,77 @@
+#ifndef LOOP_MONITOR_H
+#define LOOP_MONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "latency_histogram.h"
+
+/// <summary>
+/// One stage of a loop() iteration. Stage ids are defined by the firmware.
+/// </summary>
+struct LoopStageSample
+{
+  uint8_t stage;
+  uint32_t startUs;
+  uint32_t durationUs;
+};
+
+/// <summary>
+/// Last stages before an iteration that exceeded the stall threshold, oldest first.
+/// </summary>
+struct LoopStallSnapshot
+{
+  static constexpr size_t MAX_SAMPLES = 16;
+
+  uint32_t iterationUs;
+  uint32_t endedUs;
+  uint8_t sampleCount;
+  LoopStageSample samples[MAX_SAMPLES];
+};
+
+/// <summary>
+/// Times every loop() iteration and the stages inside it. Iterations longer than the
+/// stall threshold freeze the most recent stages into a snapshot for reporting.
+/// Owned by loop(); fixed storage only.
+/// </summary>
+class LoopMonitor
+{
+public:
+  explicit LoopMonitor(uint32_t stallThresholdUs);
+
+  void BeginIteration(uint8_t stage, uint32_t nowUs);
+  // Closes the current stage and opens the next one.
+  void EnterStage(uint8_t stage, uint32_t nowUs);
+  // Closes the iteration; returns true when it was a stall.
+  bool EndIteration(uint32_t nowUs);
+  void RecordDecision(uint32_t durationUs);
+
+  const LatencyHistogram& Iterations() const;
+  const LatencyHistogram& Decisions() const;
+  // Clears both histograms for the next reporting window; stall state is kept.
+  void ResetWindow();
+
+  uint32_t StallThresholdUs() const;
+  uint32_t StallCount() const;
+  bool StallPending() const;
+  const LoopStallSnapshot& LastStall() const;
+  void ClearStallPending();
+
+private:
+  void CloseStage(uint32_t nowUs);
+
+  LatencyHistogram iterations_;
+  LatencyHistogram decisions_;
+  uint32_t stallThresholdUs_;
+  bool inIteration_;
+  uint32_t iterationStartUs_;
+  uint8_t currentStage_;
+  uint32_t stageStartUs_;
+  LoopStageSample trace_[LoopStallSnapshot::MAX_SAMPLES];
+  size_t traceNext_;
+  size_t traceCount_;
+  uint32_t stallCount_;
+  bool stallPending_;
+  LoopStallSnapshot lastStall_;
+};
+
+#endif
@@ -5,42 +5,254 @@
 #include <ArduinoOTA.h>
 #include <WebServer.h>
 #include <Preferences.h>
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+#include <esp_timer.h>
 #include <time.h>
+#include <atomic>
 #include "config.h"
+#include "alloc_accounting.h"
+#include "boot_timeline.h"
+#include "connectivity_manager.h"
+#include "inline_string.h"
+#include "iso_timestamp.h"
+#include "loop_monitor.h"
 #include "pump_logic.h"
+#include "mqtt_payload_parser.h"
+#include "pump_event.h"
+#include "publish_ack_tracker.h"
+#include "spsc_ring.h"
+#include "pump_stop_scheduler.h"
 
 static AsyncMqttClient mqttClient;
 static bool mqttConnected = false;
-static uint32_t lastMqttAttemptMs = 0;
-static uint32_t wifiConnectStartMs = 0;
 
-static PumpLogic pumpLogic(WATERLEVEL_STALE_MS);
+// Owned by loop(). AsyncTCP callbacks only push events into pumpEvents.
+static const size_t PUMP_EVENT_QUEUE_CAPACITY = 16;
+static PumpLogic pumpLogic(WATERLEVEL_STALE_MS, MQTT_RIDE_THROUGH_MS, PUMP_CMD_MAX_AGE_SECONDS);
+static SpscRing<PumpEvent, PUMP_EVENT_QUEUE_CAPACITY> pumpEvents;
+static size_t reportedEventHighWaterMark = 0;
+static uint32_t reportedEventDrops = 0;
+// Commands that did not fit into pumpEvents; each one is rejected with queue_full.
+static const size_t DROPPED_COMMAND_CAPACITY = 4;
+static SpscRing<DroppedCommand, DROPPED_COMMAND_CAPACITY> droppedCommands;
+static uint32_t reportedCommandDrops = 0;
+
+// loop() blocks for at most this long when no event or stop deadline is due.
+static const uint32_t LOOP_IDLE_WAIT_MS = 50;
+static const uint32_t LOOP_DISCONNECTED_WAIT_MS = 200;
+// Short enough for the config portal's web server to stay responsive.
+static const uint32_t LOOP_PORTAL_WAIT_MS = 10;
+static TaskHandle_t loopTask = nullptr;
+
+// An iteration longer than this delays OnTick enough to be reported as a stall.
+static const uint32_t LOOP_STALL_THRESHOLD_US = 50UL * 1000UL;
+static const uint32_t LOOP_DIAG_INTERVAL_MS = 60UL * 1000UL;
+static LoopMonitor loopMonitor(LOOP_STALL_THRESHOLD_US);
+static uint32_t lastLoopDiagMs = 0;
+
+// pump/state counts as published on its PUBACK; without one after this long it is sent again.
+static const uint32_t STATE_ACK_TIMEOUT_MS = 30000;
+static PublishAckTracker stateAck(STATE_ACK_TIMEOUT_MS);
+static LatencyHistogram stateAckLatency;
+
+static const uint32_t HEAP_DIAG_INTERVAL_MS = 5UL * 60UL * 1000UL;
+static AccountedJsonAllocator jsonAllocator;
+static uint32_t lastHeapDiagMs = 0;
+
+// Out packets come from a slab reserved at boot. A slot holds one packet object plus its
+// wire bytes, so it must fit the largest diag payload; two slots are kept for acks/pings.
+static const size_t MQTT_OUT_PACKET_SLOTS = 8;
+static const size_t MQTT_OUT_PACKET_SLOT_SIZE = 1280;
+static const size_t MQTT_OUT_PACKET_RESERVED_SLOTS = 2;
+// QoS 1 publishes sent ahead of their PUBACK. In-flight packets hold their slot, so this
+// leaves two of the six application slots free for new publishes.
+static const uint8_t MQTT_IN_FLIGHT_WINDOW = 4;
+// Unsent packets beyond this many bytes drop queued diagnostics first; pump state is only
+// refused when nothing of lower priority is left to drop.
+static const size_t MQTT_OUT_QUEUE_BUDGET = 4096;
+// The broker declares the pump offline (via the will) 1.5 keep-alives after its last packet.
+static const uint16_t MQTT_KEEP_ALIVE_SECONDS = 15;
+// MQTT 5: how long the broker keeps the session (and queued commands) after a disconnect.
+static const uint32_t MQTT_SESSION_EXPIRY_SECONDS = 24UL * 60UL * 60UL;
+static const char* MQTT_AVAILABILITY_ONLINE = "online";
+static const char* MQTT_AVAILABILITY_OFFLINE = "offline";
+// Last TLS session with the broker. RTC memory outlives soft resets and crashes, so the
+// reconnect after one resumes the session instead of doing a full handshake.
+RTC_NOINIT_ATTR static AsyncMqttClientInternals::TlsSessionRecord tlsSession;
+
+enum class LoopStage : uint8_t
+{
+  Events,
+  Connectivity,
+  Time,
+  Portal,
+  Subscribe,
+  OtaHandle,
+  Tick,
+  StatePublish,
+  Diagnostics
+};
+
+static const char* loopStageName(uint8_t stage)
+{
+  switch (static_cast<LoopStage>(stage))
+  {
+    case LoopStage::Events: return "events";
+    case LoopStage::Connectivity: return "connectivity";
+    case LoopStage::Time: return "time";
+    case LoopStage::Portal: return "portal";
+    case LoopStage::Subscribe: return "subscribe";
+    case LoopStage::OtaHandle: return "otaHandle";
+    case LoopStage::Tick: return "tick";
+    case LoopStage::StatePublish: return "statePublish";
+    case LoopStage::Diagnostics: return "diagnostics";
+  }
+  return "unknown";
+}
+
+static void enterStage(LoopStage stage)
+{
+  loopMonitor.EnterStage(static_cast<uint8_t>(stage), micros());
+}
+
+/// <summary>
+/// esp_timer-backed one-shot with microsecond resolution.
+/// </summary>
+class EspOneShotTimer : public OneShotTimer
+{
+public:
+  void Begin(esp_timer_cb_t callback)
+  {
+    esp_timer_create_args_t args = {};
+    args.callback = callback;
+    args.name = "pump-stop";
+    esp_timer_create(&args, &handle_);
+  }
+
+  void Arm(uint32_t delayMs) override
+  {
+    esp_timer_stop(handle_);
+    esp_timer_start_once(handle_, static_cast<uint64_t>(delayMs) * 1000ULL);
+  }
+
+  void Cancel() override
+  {
+    esp_timer_stop(handle_);
+  }
+
+private:
+  esp_timer_handle_t handle_ = nullptr;
+};
+
+static EspOneShotTimer stopTimer;
+static PumpStopScheduler stopScheduler(stopTimer);
+
+static void wakeLoop()
+{
+  if (loopTask != nullptr)
+  {
+    xTaskNotifyGive(loopTask);
+  }
+}
 
 static uint32_t lastStatePublishMs = 0;
+// The last pump/state was refused (queue full or over budget); loop() sends it again.
+static bool statePublishRefused = false;
 static bool subscribed = false;
+// The broker resumed a session whose subscriptions this boot already sent.
+static bool sessionResumed = false;
+static bool subscribedThisBoot = false;
 static bool otaReady = false;
-static String incomingTopic;
-static String incomingPayload;
-static size_t incomingTotal = 0;
-static bool configPortalActive = false;
+enum class IncomingTopic
+{
+  None,
+  PumpCmd,
+  WaterLevel
+};
+
+static IncomingTopic incomingTopic = IncomingTopic::None;
+static PumpCommandParser pumpCommandParser;
+static LevelReadingParser levelReadingParser;
+static bool configServerRoutesAdded = false;
 static WebServer configServer(80);
 static Preferences preferences;
 static String wifiSsid;
 static String wifiPassword;
 
-static String topicPumpCmd()
+static const char* TOPIC_SUFFIX_PUMP_CMD = "/WateringController/pump/cmd";
+static const char* TOPIC_SUFFIX_PUMP_STATE = "/WateringController/pump/state";
+static const char* TOPIC_SUFFIX_PUMP_CMD_RESULT = "/WateringController/pump/cmd/result";
+static const char* TOPIC_SUFFIX_PUMP_AVAILABILITY = "/WateringController/pump/availability";
+static const char* TOPIC_SUFFIX_WATER_LEVEL = "/WateringController/waterlevel/state";
+static const char* TOPIC_SUFFIX_PUMP_DIAG_BOOT = "/WateringController/pump/diag/boot";
+static const char* TOPIC_SUFFIX_PUMP_DIAG_LOOP = "/WateringController/pump/diag/loop";
+static const char* TOPIC_SUFFIX_PUMP_DIAG_STALL = "/WateringController/pump/diag/stall";
+static const char* TOPIC_SUFFIX_PUMP_DIAG_HEAP = "/WateringController/pump/diag/heap";
+static BootTimeline bootTimeline;
+
+// Topics fit AsyncMqttClient's default maximum topic length.
+static const size_t MQTT_TOPIC_MAX_LENGTH = 128;
+typedef InlineString<MQTT_TOPIC_MAX_LENGTH> MqttTopic;
+// setWill keeps the pointer, so the will topic needs static storage.
+static MqttTopic willTopic;
+
+static MqttTopic buildTopic(const char* suffix)
+{
+  char topic[MQTT_TOPIC_MAX_LENGTH + 1];
+  snprintf(topic, sizeof(topic), "%s%s", MQTT_PREFIX, suffix);
+  return MqttTopic(topic);
+}
+
+static MqttTopic topicPumpCmd()
+{
+  return buildTopic(TOPIC_SUFFIX_PUMP_CMD);
+}
+
+static MqttTopic topicPumpState()
+{
+  return buildTopic(TOPIC_SUFFIX_PUMP_STATE);
+}
+
+static MqttTopic topicPumpCmdResult()
+{
+  return buildTopic(TOPIC_SUFFIX_PUMP_CMD_RESULT);
+}
+
+static MqttTopic topicPumpAvailability()
 {
-  return String(MQTT_PREFIX) + "/WateringController/pump/cmd";
+  return buildTopic(TOPIC_SUFFIX_PUMP_AVAILABILITY);
 }
 
-static String topicPumpState()
+static MqttTopic topicWaterLevel()
 {
-  return String(MQTT_PREFIX) + "/WateringController/pump/state";
+  return buildTopic(TOPIC_SUFFIX_WATER_LEVEL);
 }
 
-static String topicWaterLevel()
+static MqttTopic topicPumpDiagBoot()
 {
-  return String(MQTT_PREFIX) + "/WateringController/waterlevel/state";
+  return buildTopic(TOPIC_SUFFIX_PUMP_DIAG_BOOT);
+}
+
+static MqttTopic topicPumpDiagLoop()
+{
+  return buildTopic(TOPIC_SUFFIX_PUMP_DIAG_LOOP);
+}
+
+static MqttTopic topicPumpDiagStall()
+{
+  return buildTopic(TOPIC_SUFFIX_PUMP_DIAG_STALL);
+}
+
+static MqttTopic topicPumpDiagHeap()
+{
+  return buildTopic(TOPIC_SUFFIX_PUMP_DIAG_HEAP);
+}
+
+static bool topicEquals(const char* topic, const char* suffix)
+{
+  const size_t prefixLength = strlen(MQTT_PREFIX);
+  return strncmp(topic, MQTT_PREFIX, prefixLength) == 0 && strcmp(topic + prefixLength, suffix) == 0;
 }
 
 static void setRelay(bool on)
@@ -48,19 +260,13 @@ static void setRelay(bool on)
   digitalWrite(RELAY_PIN, RELAY_ACTIVE_HIGH ? (on ? HIGH : LOW) : (on ? LOW : HIGH));
 }
 
-static std::string isoUtcNow()
-{
-  time_t now = time(nullptr);
-  if (now < 1700000000)
-  {
-    return std::string("1970-01-01T00:00:00Z");
-  }
+// Before NTP sets the clock, time() counts from 1970.
+static const time_t CLOCK_SET_AFTER = 1700000000;
 
-  struct tm tmUtc;
-  gmtime_r(&now, &tmUtc);
-  char buf[25];
-  strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tmUtc);
-  return std::string(buf);
+static IsoTimestamp isoUtcNow()
+{
+  const time_t now = time(nullptr);
+  return FormatIsoUtc(now < CLOCK_SET_AFTER ? 0 : now);
 }
 
 static void loadWifiCredentials()
@@ -87,13 +293,8 @@ static void saveWifiCredentials(const String& ssid, const String& password)
 
 static void startConfigPortal()
 {
-  if (configPortalActive)
-  {
-    return;
-  }
-
-  configPortalActive = true;
-  WiFi.mode(WIFI_AP);
+  // AP+STA: the station keeps retrying while the portal is up.
+  WiFi.mode(WIFI_AP_STA);
   if (WIFI_AP_PASSWORD && strlen(WIFI_AP_PASSWORD) >= 8)
   {
     WiFi.softAP(WIFI_AP_SSID, WIFI_AP_PASSWORD);
@@ -103,6 +304,13 @@ static void startConfigPortal()
     WiFi.softAP(WIFI_AP_SSID);
   }
 
+  if (configServerRoutesAdded)
+  {
+    configServer.begin();
+    return;
+  }
+
+  configServerRoutesAdded = true;
   configServer.on("/", HTTP_GET, []()
   {
     const char page[] =
@@ -136,45 +344,331 @@ static void startConfigPortal()
   configServer.begin();
 }
 
+static void stopConfigPortal()
+{
+  configServer.stop();
+  WiFi.softAPdisconnect(true);
+  WiFi.mode(WIFI_STA);
+}
+
+// Station attempts time out after WIFI_CONNECT_TIMEOUT_MS. Retries start fast and back off
+// to the maximum; the config portal opens once the station has been down this long.
+static const uint32_t WIFI_PORTAL_AFTER_MS = 3UL * 60UL * 1000UL;
+static const uint32_t RECONNECT_FIRST_RETRY_MS = 250;
+static const uint32_t RECONNECT_BACKOFF_BASE_MS = 1000;
+static const uint32_t RECONNECT_BACKOFF_MAX_MS = 60UL * 1000UL;
+
+/// <summary>
+/// Arduino WiFi and AsyncMqttClient side of the connectivity manager.
+/// </summary>
+class EspConnectivityHal : public ConnectivityHal
+{
+public:
+  void BeginWifi() override
+  {
+    bootTimeline.Mark(BootPhase::WifiBegin, millis());
+    WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str());
+  }
+
+  void StartPortal() override
+  {
+    startConfigPortal();
+  }
+
+  void StopPortal() override
+  {
+    stopConfigPortal();
+  }
+
+  void BeginMqtt() override
+  {
+    bootTimeline.Mark(BootPhase::MqttConnecting, millis());
+    bootTimeline.CountMqttAttempt();
+    mqttClient.connect();
+  }
+
+  uint32_t Random() override
+  {
+    return esp_random();
+  }
+};
+
+static EspConnectivityHal connectivityHal;
+static ConnectivityManager connectivity(connectivityHal, {
+  WIFI_CONNECT_TIMEOUT_MS,
+  RECONNECT_FIRST_RETRY_MS,
+  RECONNECT_BACKOFF_BASE_MS,
+  RECONNECT_BACKOFF_MAX_MS,
+  WIFI_PORTAL_AFTER_MS
+});
+
+// Set by the WiFi event task, read by loop(). Drops are counted so a drop and
+// reconnect between two loop passes is still seen.
+static std::atomic<bool> wifiLinkUp{ false };
+static std::atomic<uint32_t> wifiLinkDrops{ 0 };
+static uint32_t handledWifiLinkDrops = 0;
+
+/// <summary>
+/// Serializes a JSON document straight into a reserved MQTT packet, without an
+/// intermediate payload String.
+/// </summary>
+static uint16_t publishJson(const MqttTopic& topic, const JsonDocument& doc, uint8_t qos, bool retain,
+                            AsyncMqttClientInternals::OutPriority priority)
+{
+  const size_t length = measureJson(doc);
+  uint16_t packetId = 0;
+  char* payload = mqttClient.beginPublish(topic.CStr(), qos, retain, length, priority);
+  if (payload != nullptr)
+  {
+    serializeJson(doc, payload, length);
+    packetId = mqttClient.endPublish(length);
+  }
+  if (packetId == 0 && mqttClient.connected())
+  {
+    Serial.printf("MQTT publish to %s refused (error %u).\n", topic.CStr(), static_cast<unsigned>(mqttClient.lastError()));
+  }
+  return packetId;
+}
+
+static void subscribeTopic(const MqttTopic& topic)
+{
+  mqttClient.subscribe(topic.CStr(), 1);
+}
+
+/// <summary>
+/// Marks the pump online; the broker replaces it with the will ("offline") when the
+/// connection is lost without a DISCONNECT.
+/// </summary>
+static void publishOnline()
+{
+  mqttClient.publish(topicPumpAvailability().CStr(), 1, true, MQTT_AVAILABILITY_ONLINE);
+}
+
 static void publishPumpState()
 {
-  JsonDocument doc;
+  JsonDocument doc(&jsonAllocator);
   const PumpLogicState& state = pumpLogic.State();
   doc["running"] = state.pumpRunning;
   if (state.pumpRunning)
   {
-    doc["since"] = state.pumpStartIso.c_str();
+    doc["since"] = state.pumpStartIso.CStr();
   }
   else
   {
     doc["since"] = nullptr;
   }
-  doc["lastRunSeconds"] = state.pumpRunSeconds;
-  doc["lastRequestId"] = state.lastRequestId.c_str();
-  doc["reportedAt"] = isoUtcNow().c_str();
+  doc["lastRunSeconds"] = (state.pumpRunMs + 999) / 1000;
+  doc["lastRunMs"] = state.pumpRunMs;
+  doc["lastRequestId"] = state.lastRequestId.CStr();
+  doc["stopReason"] = PumpDecisionReasonName(state.lastStopReason);
+  const uint32_t deliveredMs = pumpLogic.DeliveredMs(millis());
+  doc["deliveredSeconds"] = deliveredMs / 1000;
+  doc["deliveredMs"] = deliveredMs;
+  doc["offlineMs"] = state.lastRunOfflineMs;
+  const IsoTimestamp reportedAt = isoUtcNow();
+  doc["reportedAt"] = reportedAt.CStr();
+
+  const uint16_t packetId = publishJson(topicPumpState(), doc, 1, true, AsyncMqttClientInternals::OutPriority::STATE);
+  statePublishRefused = packetId == 0;
+  if (statePublishRefused)
+  {
+    // An earlier publish still in flight stays awaited.
+    return;
+  }
+  // lastStatePublishMs only moves on the PUBACK.
+  stateAck.Sent(packetId, 0, millis());
+  bootTimeline.Mark(BootPhase::FirstPublish, millis());
+}
+
+/// <summary>
+/// Publishes how long this boot took to reach each phase, once per boot.
+/// </summary>
+static void publishBootDiag()
+{
+  JsonDocument doc(&jsonAllocator);
+  doc["resetReason"] = ResetReasonName(esp_reset_reason());
+  JsonArray phases = doc["phases"].to<JsonArray>();
+  for (size_t i = 0; i < BootTimeline::PHASE_COUNT; i++)
+  {
+    const BootPhase phase = static_cast<BootPhase>(i);
+    if (!bootTimeline.Has(phase))
+    {
+      continue;
+    }
+    JsonObject entry = phases.add<JsonObject>();
+    entry["name"] = BootTimeline::PhaseName(phase);
+    entry["atMs"] = bootTimeline.At(phase);
+    entry["stepMs"] = bootTimeline.SincePrevious(phase);
+  }
+  doc["mqttAttempts"] = bootTimeline.MqttAttempts();
+  const IsoTimestamp reportedAt = isoUtcNow();
+  doc["reportedAt"] = reportedAt.CStr();
+
+  publishJson(topicPumpDiagBoot(), doc, 1, true, AsyncMqttClientInternals::OutPriority::DIAGNOSTIC);
+  bootTimeline.MarkReported();
+  Serial.print("boot diag: ");
+  serializeJson(doc, Serial);
+  Serial.println();
+}
+
+static void addLatency(JsonObject target, const LatencyHistogram& histogram)
+{
+  target["count"] = histogram.Count();
+  target["p50Us"] = histogram.PercentileUs(50);
+  target["p99Us"] = histogram.PercentileUs(99);
+  target["maxUs"] = histogram.MaxUs();
+}
+
+/// <summary>
+/// Adds handshake counts, durations and heap use of the TLS connections since boot.
+/// </summary>
+static void addTlsStats(JsonObject target)
+{
+  const AsyncMqttClientInternals::TlsHandshakeStats& tls = mqttClient.tlsStats();
+  target["full"] = tls.full;
+  target["resumed"] = tls.resumed;
+  target["failed"] = tls.failed;
+  target["lastMs"] = tls.lastMs;
+  target["lastResumed"] = tls.lastResumed;
+  target["lastHeapBytes"] = tls.lastHeapBytes;
+  target["maxHeapBytes"] = tls.maxHeapBytes;
+  target["meanFullMs"] = tls.full == 0 ? 0 : static_cast<uint32_t>(tls.totalFullMs / tls.full);
+  target["maxFullMs"] = tls.maxFullMs;
+  target["meanResumedMs"] = tls.resumed == 0 ? 0 : static_cast<uint32_t>(tls.totalResumedMs / tls.resumed);
+  target["maxResumedMs"] = tls.maxResumedMs;
+  target["contextHeapBytes"] = tls.contextHeapBytes;
+  target["lastError"] = tls.lastError;
+}
+
+/// <summary>
+/// Publishes loop and decision latency for the window since the last report, then starts a new window.
+/// </summary>
+static void publishLoopDiag(uint32_t windowMs)
+{
+  JsonDocument doc(&jsonAllocator);
+  doc["windowMs"] = windowMs;
+  addLatency(doc["loop"].to<JsonObject>(), loopMonitor.Iterations());
+  addLatency(doc["decision"].to<JsonObject>(), loopMonitor.Decisions());
+  addLatency(doc["stateAck"].to<JsonObject>(), stateAckLatency);
+  doc["stalls"] = loopMonitor.StallCount();
+  const ConnectivityStats& link = connectivity.Stats();
+  JsonObject linkDoc = doc["connectivity"].to<JsonObject>();
+  linkDoc["wifiAttempts"] = link.wifiAttempts;
+  linkDoc["mqttAttempts"] = link.mqttAttempts;
+  linkDoc["portalOpens"] = link.portalOpens;
+  linkDoc["reconnects"] = link.reconnects;
+  linkDoc["lastReconnectMs"] = link.lastReconnectMs;
+  linkDoc["maxReconnectMs"] = link.maxReconnectMs;
+  linkDoc["meanReconnectMs"] = link.reconnects == 0 ? 0 : static_cast<uint32_t>(link.totalReconnectMs / link.reconnects);
+  if (MQTT_TLS_CA_CERT != nullptr)
+  {
+    addTlsStats(linkDoc["tls"].to<JsonObject>());
+  }
+  const IsoTimestamp reportedAt = isoUtcNow();
+  doc["reportedAt"] = reportedAt.CStr();
+
+  publishJson(topicPumpDiagLoop(), doc, 0, false, AsyncMqttClientInternals::OutPriority::DIAGNOSTIC);
+  loopMonitor.ResetWindow();
+  stateAckLatency.Reset();
+}
+
+/// <summary>
+/// Publishes the stages leading up to the last stalled iteration.
+/// </summary>
+static void publishStallDiag()
+{
+  const LoopStallSnapshot& stall = loopMonitor.LastStall();
+  JsonDocument doc(&jsonAllocator);
+  doc["iterationUs"] = stall.iterationUs;
+  doc["thresholdUs"] = loopMonitor.StallThresholdUs();
+  doc["stalls"] = loopMonitor.StallCount();
+  doc["agoMs"] = (micros() - stall.endedUs) / 1000;
+  JsonArray stages = doc["stages"].to<JsonArray>();
+  for (uint8_t i = 0; i < stall.sampleCount; i++)
+  {
+    JsonObject entry = stages.add<JsonObject>();
+    entry["stage"] = loopStageName(stall.samples[i].stage);
+    entry["offsetUs"] = static_cast<int32_t>(stall.samples[i].startUs - (stall.endedUs - stall.iterationUs));
+    entry["durationUs"] = stall.samples[i].durationUs;
+  }
+  const IsoTimestamp reportedAt = isoUtcNow();
+  doc["reportedAt"] = reportedAt.CStr();
+
+  publishJson(topicPumpDiagStall(), doc, 1, false, AsyncMqttClientInternals::OutPriority::DIAGNOSTIC);
+  loopMonitor.ClearStallPending();
+}
+
+/// <summary>
+/// Publishes heap health and per-subsystem allocation counters since boot.
+/// </summary>
+static void publishHeapDiag()
+{
+  const uint32_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  const uint32_t largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  JsonDocument doc(&jsonAllocator);
+  doc["uptimeMs"] = millis();
+  doc["freeBytes"] = freeBytes;
+  doc["largestFreeBlock"] = largestBlock;
+  doc["minFreeBytes"] = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  // Share of free memory that is not usable as one block.
+  doc["fragmentationPercent"] = freeBytes == 0 ? 0 : 100 - static_cast<uint32_t>((static_cast<uint64_t>(largestBlock) * 100) / freeBytes);
+  JsonObject tags = doc["tags"].to<JsonObject>();
+  for (size_t i = 0; i < AllocAccounting::TAG_COUNT; i++)
+  {
+    const AllocTag tag = static_cast<AllocTag>(i);
+    const AllocTagStats stats = AllocAccounting::Stats(tag);
+    JsonObject entry = tags[AllocAccounting::TagName(tag)].to<JsonObject>();
+    entry["allocations"] = stats.allocations;
+    entry["frees"] = stats.frees;
+    entry["liveBytes"] = stats.liveBytes;
+    entry["peakLiveBytes"] = stats.peakLiveBytes;
+    entry["totalBytes"] = stats.totalBytes;
+  }
+  const AsyncMqttClientInternals::OutPacketPool& outPackets = mqttClient.outPacketPool();
+  JsonObject pool = doc["mqttOutPool"].to<JsonObject>();
+  pool["slots"] = outPackets.slotCount();
+  pool["slotSize"] = outPackets.slotSize();
+  pool["inUse"] = outPackets.inUse();
+  pool["highWaterMark"] = outPackets.highWaterMark();
+  pool["refused"] = outPackets.failedAcquires();
+  const AsyncMqttClientInternals::OutQueue& outQueue = mqttClient.outQueue();
+  pool["inFlightHighWaterMark"] = outQueue.inFlightHighWaterMark();
+  pool["queued"] = outQueue.queued();
+  pool["queuedBytes"] = outQueue.queuedBytes();
+  pool["coalesced"] = outQueue.coalesced();
+  pool["dropped"] = outQueue.dropped();
+  const IsoTimestamp reportedAt = isoUtcNow();
+  doc["reportedAt"] = reportedAt.CStr();
+
+  publishJson(topicPumpDiagHeap(), doc, 0, false, AsyncMqttClientInternals::OutPriority::DIAGNOSTIC);
+}
 
-  String payload;
-  serializeJson(doc, payload);
-  mqttClient.publish(
-    topicPumpState().c_str(),
-    1,
-    true,
-    payload.c_str(),
-    payload.length());
-  lastStatePublishMs = millis();
+static void endIteration()
+{
+  if (loopMonitor.EndIteration(micros()))
+  {
+    const LoopStallSnapshot& stall = loopMonitor.LastStall();
+    Serial.printf(
+      "loop stall %ums (last stage %s %ums)\n",
+      static_cast<unsigned>(stall.iterationUs / 1000),
+      loopStageName(stall.samples[stall.sampleCount - 1].stage),
+      static_cast<unsigned>(stall.samples[stall.sampleCount - 1].durationUs / 1000));
+  }
 }
 
-static void applyDecision(const PumpDecision& decision)
+// Returns the millis() at which the relay was switched, or 0 when nothing was applied.
+static uint32_t applyDecision(const PumpDecision& decision)
 {
   if (decision.action == PumpDecision::Action::None)
   {
-    return;
+    return 0;
   }
 
+  const uint32_t startUs = micros();
   const uint32_t nowMs = millis();
   if (decision.action == PumpDecision::Action::Start)
   {
-    pumpLogic.ApplyDecision(decision, nowMs, isoUtcNow());
+    pumpLogic.ApplyDecision(decision, nowMs, isoUtcNow().View());
     setRelay(true);
   }
   else
@@ -182,22 +676,100 @@ static void applyDecision(const PumpDecision& decision)
     pumpLogic.ApplyDecision(decision, nowMs, "");
     setRelay(false);
   }
+  stopScheduler.Sync(pumpLogic, nowMs);
 
   publishPumpState();
+  loopMonitor.RecordDecision(micros() - startUs);
+  return nowMs;
 }
 
-static void handlePumpCmd(const JsonDocument& doc)
+/// <summary>
+/// Confirms or rejects a pump/cmd on pump/cmd/result, so the backend does not have
+/// to infer a dropped command from a state update that never comes.
+/// </summary>
+static void publishCommandResult(const PumpDecision& decision, uint32_t receivedMs, uint32_t appliedMs)
 {
-  const char* action = doc["action"] | "start";
-  const char* requestId = doc["requestId"] | "";
-  const int runSeconds = doc["runSeconds"] | 0;
+  JsonDocument doc(&jsonAllocator);
+  const bool accepted = decision.action != PumpDecision::Action::None;
+  if (decision.requestId.Empty())
+  {
+    doc["requestId"] = nullptr;
+  }
+  else
+  {
+    doc["requestId"] = decision.requestId.CStr();
+  }
+  doc["accepted"] = accepted;
+  doc["reason"] = PumpDecisionReasonName(decision.reason);
+  if (decision.action == PumpDecision::Action::Start)
+  {
+    doc["runMs"] = decision.runMs;
+  }
+  doc["receivedMs"] = receivedMs;
+  if (accepted)
+  {
+    doc["appliedMs"] = appliedMs;
+  }
+  else
+  {
+    doc["appliedMs"] = nullptr;
+  }
+  const IsoTimestamp reportedAt = isoUtcNow();
+  doc["reportedAt"] = reportedAt.CStr();
+
+  publishJson(topicPumpCmdResult(), doc, 1, false, AsyncMqttClientInternals::OutPriority::STATE);
+}
 
+/// <summary>
+/// Seconds since the command was issued, or -1 when it carried no usable issuedAt or
+/// the clock is not set yet. Backend clock skew ahead of ours counts as zero.
+/// </summary>
+static int64_t commandAgeSeconds(const PumpCommand& command)
+{
+  const time_t now = time(nullptr);
+  if (command.issuedAtSeconds < 0 || now < CLOCK_SET_AFTER)
+  {
+    return -1;
+  }
+  const int64_t age = static_cast<int64_t>(now) - command.issuedAtSeconds;
+  return age > 0 ? age : 0;
+}
+
+static void handlePumpCmd(const PumpCommand& command, uint32_t receivedMs)
+{
+  // With a persistent session the broker holds commands for us while we are offline.
   const PumpDecision decision = pumpLogic.EvaluateCommand(
-    std::string(action),
-    runSeconds,
-    std::string(requestId),
-    millis());
-  applyDecision(decision);
+    command.action,
+    command.runSeconds,
+    command.requestId.View(),
+    millis(),
+    command.runMs,
+    commandAgeSeconds(command));
+  const uint32_t appliedMs = applyDecision(decision);
+  publishCommandResult(decision, receivedMs, appliedMs);
+}
+
+static void onMqttLinkDown(uint32_t nowMs)
+{
+  applyDecision(pumpLogic.OnMqttDisconnected(nowMs));
+  // A run riding through the drop now also stops at the end of the ride-through.
+  stopScheduler.Sync(pumpLogic, millis());
+}
+
+static void onMqttLinkUp(uint32_t nowMs)
+{
+  pumpLogic.OnMqttConnected(nowMs);
+  stopScheduler.Sync(pumpLogic, millis());
+}
+
+static void pushEvent(PumpEvent::Type type)
+{
+  PumpEvent event{};
+  event.type = type;
+  event.receivedMs = millis();
+  // A dropped connection event is recovered in processEvents() from mqttClient.connected().
+  pumpEvents.TryPush(event);
+  wakeLoop();
 }
 
 static void mqttCallback(
@@ -208,73 +780,153 @@ static void mqttCallback(
   size_t index,
   size_t total)
 {
+  // Chunks are parsed as they arrive; the payload is never reassembled.
   if (index == 0)
   {
-    incomingTopic = topic;
-    incomingPayload = "";
-    incomingPayload.reserve(total);
-    incomingTotal = total;
+    if (topicEquals(topic, TOPIC_SUFFIX_PUMP_CMD))
+    {
+      incomingTopic = IncomingTopic::PumpCmd;
+      pumpCommandParser.Reset();
+    }
+    else if (topicEquals(topic, TOPIC_SUFFIX_WATER_LEVEL))
+    {
+      incomingTopic = IncomingTopic::WaterLevel;
+      levelReadingParser.Reset();
+    }
+    else
+    {
+      incomingTopic = IncomingTopic::None;
+    }
   }
 
-  incomingPayload.concat(payload, len);
-
-  if (index + len < total)
+  if (incomingTopic == IncomingTopic::PumpCmd)
   {
-    return;
+    pumpCommandParser.Feed(payload, len);
+  }
+  else if (incomingTopic == IncomingTopic::WaterLevel)
+  {
+    levelReadingParser.Feed(payload, len);
   }
 
-  JsonDocument doc;
-  DeserializationError err = deserializeJson(doc, incomingPayload);
-  if (err)
+  if (index + len < total)
   {
     return;
   }
 
-  if (incomingTopic == topicPumpCmd())
+  PumpEvent event{};
+  event.receivedMs = millis();
+  if (incomingTopic == IncomingTopic::PumpCmd && pumpCommandParser.Finish(event.command))
   {
-    handlePumpCmd(doc);
+    event.type = PumpEvent::Type::Command;
+    if (!pumpEvents.TryPush(event))
+    {
+      // The broker has the PUBACK already, so the command must not vanish silently.
+      droppedCommands.TryPush({ event.command.requestId, event.receivedMs });
+    }
+    wakeLoop();
   }
-  else if (incomingTopic == topicWaterLevel())
+  else if (incomingTopic == IncomingTopic::WaterLevel && levelReadingParser.Finish(event.level))
   {
-    int level = doc["levelPercent"] | -1;
-    pumpLogic.UpdateWaterLevel(level, millis());
+    event.type = PumpEvent::Type::WaterLevel;
+    // A dropped reading is superseded by the next one; the stale check covers a long gap.
+    pumpEvents.TryPush(event);
+    wakeLoop();
   }
+  incomingTopic = IncomingTopic::None;
 }
 
-static void ensureWifi()
+static void processEvents()
 {
-  if (configPortalActive)
+  PumpEvent event;
+  while (pumpEvents.TryPop(event))
   {
-    return;
+    switch (event.type)
+    {
+      case PumpEvent::Type::MqttConnected:
+        mqttConnected = true;
+        subscribed = false;
+        sessionResumed = event.sessionPresent && subscribedThisBoot;
+        connectivity.OnMqttConnected(event.receivedMs);
+        onMqttLinkUp(event.receivedMs);
+        bootTimeline.Mark(BootPhase::MqttConnected, event.receivedMs);
+        break;
+      case PumpEvent::Type::MqttDisconnected:
+        mqttConnected = false;
+        subscribed = false;
+        sessionResumed = false;
+        stateAck.Reset();
+        connectivity.OnMqttDisconnected(event.receivedMs);
+        onMqttLinkDown(event.receivedMs);
+        break;
+      case PumpEvent::Type::Command:
+        handlePumpCmd(event.command, event.receivedMs);
+        break;
+      case PumpEvent::Type::WaterLevel:
+        // Dry-run interlock: an empty reading stops the pump before the next event is handled.
+        applyDecision(pumpLogic.UpdateWaterLevel(event.level.levelPercent, event.receivedMs));
+        stopScheduler.Sync(pumpLogic, millis());
+        break;
+      case PumpEvent::Type::Published:
+      {
+        PublishAck ack;
+        if (stateAck.Acked(event.packetId, event.receivedMs, ack))
+        {
+          lastStatePublishMs = ack.sentMs;
+          stateAckLatency.Record(ack.latencyMs * 1000);
+        }
+        break;
+      }
+    }
   }
 
-  if (WiFi.status() == WL_CONNECTED)
+  DroppedCommand dropped;
+  while (droppedCommands.TryPop(dropped))
   {
-    wifiConnectStartMs = 0;
-    return;
+    const PumpDecision rejected{ PumpDecision::Action::None, 0, dropped.requestId, PumpDecision::Reason::QueueFull };
+    publishCommandResult(rejected, dropped.receivedMs, 0);
   }
-
-  if (wifiSsid.length() == 0)
+  if (droppedCommands.DroppedCount() != reportedCommandDrops)
   {
-    startConfigPortal();
-    return;
+    // Not even the rejection fitted; only the log records these.
+    reportedCommandDrops = droppedCommands.DroppedCount();
+    Serial.printf("dropped %u pump commands without a result\n", static_cast<unsigned>(reportedCommandDrops));
   }
 
-  WiFi.mode(WIFI_STA);
-  if (wifiConnectStartMs == 0)
+  if (pumpEvents.DroppedCount() != reportedEventDrops && mqttClient.connected() != mqttConnected)
   {
-    wifiConnectStartMs = millis();
-    WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str());
+    // A dropped connection event must not leave loop() with a stale view of the link.
+    mqttConnected = !mqttConnected;
+    subscribed = false;
+    // Whether the broker kept the session is lost with the event; subscribe again.
+    sessionResumed = false;
+    stateAck.Reset();
+    if (mqttConnected)
+    {
+      connectivity.OnMqttConnected(millis());
+      onMqttLinkUp(millis());
+    }
+    else
+    {
+      connectivity.OnMqttDisconnected(millis());
+      onMqttLinkDown(millis());
+    }
   }
-  else if (millis() - wifiConnectStartMs > WIFI_CONNECT_TIMEOUT_MS)
+
+  if (pumpEvents.HighWaterMark() != reportedEventHighWaterMark || pumpEvents.DroppedCount() != reportedEventDrops)
   {
-    startConfigPortal();
+    reportedEventHighWaterMark = pumpEvents.HighWaterMark();
+    reportedEventDrops = pumpEvents.DroppedCount();
+    Serial.printf(
+      "event queue high-water mark %u/%u, dropped %u\n",
+      static_cast<unsigned>(reportedEventHighWaterMark),
+      static_cast<unsigned>(PUMP_EVENT_QUEUE_CAPACITY),
+      static_cast<unsigned>(reportedEventDrops));
   }
 }
 
-static void ensureOta()
+static void beginOta()
 {
-  if (!OTA_ENABLED || otaReady || WiFi.status() != WL_CONNECTED)
+  if (!OTA_ENABLED || otaReady)
   {
     return;
   }
@@ -289,21 +941,25 @@ static void ensureOta()
   otaReady = true;
 }
 
-static void ensureMqtt()
+/// <summary>
+/// Feeds WiFi events to the connectivity manager and runs its retry deadlines.
+/// </summary>
+static void syncConnectivity()
 {
-  if (mqttConnected || WiFi.status() != WL_CONNECTED)
+  const uint32_t now = millis();
+  const uint32_t drops = wifiLinkDrops;
+  if (drops != handledWifiLinkDrops)
   {
-    return;
+    handledWifiLinkDrops = drops;
+    connectivity.OnWifiDisconnected(now);
   }
-
-  const uint32_t now = millis();
-  if (now - lastMqttAttemptMs < 5000)
+  if (wifiLinkUp && connectivity.Wifi() != LinkState::Up)
   {
-    return;
+    connectivity.OnWifiConnected(now);
+    bootTimeline.Mark(BootPhase::WifiConnected, now);
+    beginOta();
   }
-
-  lastMqttAttemptMs = now;
-  mqttClient.connect();
+  connectivity.Step(now);
 }
 
 static void ensureTime()
@@ -318,63 +974,186 @@ static void ensureTime()
 
 void setup()
 {
+  bootTimeline.Mark(BootPhase::Setup, millis());
   Serial.begin(115200);
   pinMode(RELAY_PIN, OUTPUT);
   setRelay(false);
+  loopTask = xTaskGetCurrentTaskHandle();
+  AsyncMqttClientInternals::OutPacket::setAllocationHook([](size_t bytes, bool allocated)
+  {
+    if (allocated)
+    {
+      AllocAccounting::OnAllocate(AllocTag::MqttOut, bytes);
+    }
+    else
+    {
+      AllocAccounting::OnFree(AllocTag::MqttOut, bytes);
+    }
+  });
+  if (!mqttClient.setOutPacketPool(MQTT_OUT_PACKET_SLOTS, MQTT_OUT_PACKET_SLOT_SIZE, MQTT_OUT_PACKET_RESERVED_SLOTS))
+  {
+    Serial.println("MQTT out packet pool allocation failed; using the heap.");
+  }
+  mqttClient.setInFlightWindow(MQTT_IN_FLIGHT_WINDOW);
+  mqttClient.setOutQueueBudget(MQTT_OUT_QUEUE_BUDGET);
+  stopTimer.Begin([](void*) { wakeLoop(); });
 
   loadWifiCredentials();
+  // The connectivity manager owns every retry; the driver must not reconnect behind its back.
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t)
+  {
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+    {
+      wifiLinkUp = true;
+      wakeLoop();
+    }
+    else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+    {
+      wifiLinkUp = false;
+      wifiLinkDrops++;
+      wakeLoop();
+    }
+  });
 
-  ensureWifi();
-  ensureOta();
   ensureTime();
   mqttClient.setServer(MQTT_HOST, MQTT_PORT);
   mqttClient.setCredentials(MQTT_USER, MQTT_PASS);
   mqttClient.setClientId(MQTT_CLIENT_ID);
+  mqttClient.setProtocolVersion(MQTT_PROTOCOL_VERSION);
+  if (MQTT_TLS_CA_CERT != nullptr)
+  {
+    mqttClient.setTls(MQTT_TLS_CA_CERT);
+    mqttClient.setTlsSessionRecord(&tlsSession);
+  }
+  mqttClient.setSessionExpiry(MQTT_SESSION_EXPIRY_SECONDS);
+  // The broker keeps subscriptions and queued QoS 1 commands across reconnects.
+  mqttClient.setCleanSession(false);
+  mqttClient.setKeepAlive(MQTT_KEEP_ALIVE_SECONDS);
+  willTopic = topicPumpAvailability();
+  mqttClient.setWill(willTopic.CStr(), 1, true, MQTT_AVAILABILITY_OFFLINE);
   mqttClient.onMessage(mqttCallback);
-  mqttClient.onConnect([](bool) { mqttConnected = true; subscribed = false; });
-  mqttClient.onDisconnect([](AsyncMqttClientDisconnectReason) {
-    mqttConnected = false;
-    subscribed = false;
-    applyDecision(pumpLogic.OnMqttDisconnected());
+  mqttClient.onConnect([](bool sessionPresent)
+  {
+    PumpEvent event{};
+    event.type = PumpEvent::Type::MqttConnected;
+    event.receivedMs = millis();
+    event.sessionPresent = sessionPresent;
+    pumpEvents.TryPush(event);
+    wakeLoop();
   });
+  mqttClient.onDisconnect([](AsyncMqttClientDisconnectReason) { pushEvent(PumpEvent::Type::MqttDisconnected); });
+  mqttClient.onPublish([](uint16_t packetId)
+  {
+    // Not urgent enough to wake loop(); receivedMs keeps the ack latency exact.
+    PumpEvent event{};
+    event.type = PumpEvent::Type::Published;
+    event.receivedMs = millis();
+    event.packetId = packetId;
+    pumpEvents.TryPush(event);
+  });
+  connectivity.Begin(wifiSsid.length() > 0, millis());
 }
 
 void loop()
 {
-  ensureWifi();
-  ensureOta();
+  loopMonitor.BeginIteration(static_cast<uint8_t>(LoopStage::Events), micros());
+  processEvents();
+  enterStage(LoopStage::Connectivity);
+  syncConnectivity();
+  enterStage(LoopStage::Time);
   ensureTime();
-  ensureMqtt();
 
-  if (configPortalActive)
+  if (!mqttConnected)
+  {
+    // Re-evaluated every pass so a run riding through the drop stops on time, portal or not.
+    enterStage(LoopStage::Tick);
+    onMqttLinkDown(millis());
+  }
+
+  if (connectivity.PortalActive())
   {
+    enterStage(LoopStage::Portal);
     configServer.handleClient();
-    delay(10);
-    return;
   }
 
   if (mqttConnected)
   {
     if (!subscribed)
     {
-      mqttClient.subscribe(topicPumpCmd().c_str(), 1);
-      mqttClient.subscribe(topicWaterLevel().c_str(), 1);
+      enterStage(LoopStage::Subscribe);
+      if (!sessionResumed)
+      {
+        subscribeTopic(topicPumpCmd());
+        subscribeTopic(topicWaterLevel());
+        subscribedThisBoot = true;
+      }
       subscribed = true;
+      bootTimeline.Mark(BootPhase::Subscribed, millis());
+      publishOnline();
       publishPumpState();
+      if (bootTimeline.ReportDue())
+      {
+        publishBootDiag();
+      }
     }
+    enterStage(LoopStage::OtaHandle);
     ArduinoOTA.handle();
   }
   else
   {
-    applyDecision(pumpLogic.OnMqttDisconnected());
-    delay(200);
+    // Deliberate idle waits are not part of the iteration.
+    endIteration();
+    const uint32_t idleMs = connectivity.PortalActive() ? LOOP_PORTAL_WAIT_MS : LOOP_DISCONNECTED_WAIT_MS;
+    const uint32_t waitMs = connectivity.MsUntilNextStep(millis(), stopScheduler.WaitMs(pumpLogic, millis(), idleMs));
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
     return;
   }
 
-  applyDecision(pumpLogic.OnTick(millis()));
+  enterStage(LoopStage::Tick);
+  const PumpDecision tick = pumpLogic.OnTick(millis());
+  if (tick.action == PumpDecision::Action::Stop)
+  {
+    const uint32_t deadlineMs = pumpLogic.StopDeadlineMs();
+    applyDecision(tick);
+    stopScheduler.RecordDeadlineStop(deadlineMs, millis());
+    const StopJitterStats& jitter = stopScheduler.Jitter();
+    Serial.printf(
+      "pump stop (%s) %ums after deadline (max %ums over %u runs)\n",
+      PumpDecisionReasonName(tick.reason),
+      static_cast<unsigned>(jitter.lastMs),
+      static_cast<unsigned>(jitter.maxMs),
+      static_cast<unsigned>(jitter.count));
+  }
 
-  if (millis() - lastStatePublishMs >= STATE_PUBLISH_INTERVAL_MS)
+  enterStage(LoopStage::StatePublish);
+  // The heartbeat counts from the last acknowledged state; an unanswered or refused one is
+  // sent again.
+  if (stateAck.Overdue(millis()) ||
+      (statePublishRefused && mqttConnected) ||
+      (!stateAck.Pending() && millis() - lastStatePublishMs >= STATE_PUBLISH_INTERVAL_MS))
   {
     publishPumpState();
   }
+
+  enterStage(LoopStage::Diagnostics);
+  if (loopMonitor.StallPending())
+  {
+    publishStallDiag();
+  }
+  const uint32_t loopDiagWindowMs = millis() - lastLoopDiagMs;
+  if (loopDiagWindowMs >= LOOP_DIAG_INTERVAL_MS)
+  {
+    publishLoopDiag(loopDiagWindowMs);
+    lastLoopDiagMs = millis();
+  }
+  if (millis() - lastHeapDiagMs >= HEAP_DIAG_INTERVAL_MS)
+  {
+    publishHeapDiag();
+    lastHeapDiagMs = millis();
+  }
+  endIteration();
+
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(stopScheduler.WaitMs(pumpLogic, millis(), LOOP_IDLE_WAIT_MS)));
 }
@@ -0,0 +1,518 @@
+#include "mqtt_payload_parser.h"
+
+#include <limits.h>
+
+static bool isJsonWhitespace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+static bool isHexDigit(char c)
+{
+  return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool readDigits(std::string_view text, size_t& pos, size_t count, int& value)
+{
+  value = 0;
+  for (size_t end = pos + count; pos < end; pos++)
+  {
+    if (pos >= text.size() || !isDigit(text[pos]))
+    {
+      return false;
+    }
+    value = value * 10 + (text[pos] - '0');
+  }
+  return true;
+}
+
+static bool expectChar(std::string_view text, size_t& pos, char c)
+{
+  if (pos >= text.size() || text[pos] != c)
+  {
+    return false;
+  }
+  pos++;
+  return true;
+}
+
+// Days from 1970-01-01 to a proleptic Gregorian date.
+static int64_t daysFromCivil(int year, int month, int day)
+{
+  year -= month <= 2 ? 1 : 0;
+  const int era = (year >= 0 ? year : year - 399) / 400;
+  const int yearOfEra = year - era * 400;
+  const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return static_cast<int64_t>(era) * 146097 + dayOfEra - 719468;
+}
+
+bool ParseIsoUtcSeconds(std::string_view iso, int64_t& seconds)
+{
+  size_t pos = 0;
+  int year, month, day, hour, minute, second;
+  if (!readDigits(iso, pos, 4, year) || !expectChar(iso, pos, '-') ||
+      !readDigits(iso, pos, 2, month) || !expectChar(iso, pos, '-') ||
+      !readDigits(iso, pos, 2, day) || !expectChar(iso, pos, 'T') ||
+      !readDigits(iso, pos, 2, hour) || !expectChar(iso, pos, ':') ||
+      !readDigits(iso, pos, 2, minute) || !expectChar(iso, pos, ':') ||
+      !readDigits(iso, pos, 2, second))
+  {
+    return false;
+  }
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+  {
+    return false;
+  }
+
+  if (pos < iso.size() && iso[pos] == '.')
+  {
+    pos++;
+    const size_t digitsStart = pos;
+    while (pos < iso.size() && isDigit(iso[pos]))
+    {
+      pos++;
+    }
+    if (pos == digitsStart)
+    {
+      return false;
+    }
+  }
+
+  int offsetMinutes = 0;
+  if (pos < iso.size() && iso[pos] == 'Z')
+  {
+    pos++;
+  }
+  else if (pos < iso.size() && (iso[pos] == '+' || iso[pos] == '-'))
+  {
+    const int sign = iso[pos] == '-' ? -1 : 1;
+    pos++;
+    int offsetHours, offsetMins;
+    if (!readDigits(iso, pos, 2, offsetHours) || !expectChar(iso, pos, ':') || !readDigits(iso, pos, 2, offsetMins))
+    {
+      return false;
+    }
+    offsetMinutes = sign * (offsetHours * 60 + offsetMins);
+  }
+  else
+  {
+    // Without a zone designator the time is local, which the device cannot place.
+    return false;
+  }
+  if (pos != iso.size())
+  {
+    return false;
+  }
+
+  seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offsetMinutes * 60;
+  return true;
+}
+
+JsonObjectScanner::JsonObjectScanner(Sink& sink)
+  : sink_(sink)
+{
+  Reset();
+}
+
+void JsonObjectScanner::Reset()
+{
+  state_ = State::ExpectObject;
+  escape_ = false;
+  unicodeDigits_ = 0;
+  keyTruncated_ = false;
+  negative_ = false;
+  fraction_ = false;
+  containerInString_ = false;
+  containerDepth_ = 0;
+  number_ = 0;
+  key_.Clear();
+  value_[0] = '\0';
+  valueLength_ = 0;
+}
+
+void JsonObjectScanner::Feed(const char* data, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    // A delimiter that ends a number or literal is consumed by the next state.
+    while (!Step(data[i]))
+    {
+    }
+  }
+}
+
+bool JsonObjectScanner::IsComplete() const
+{
+  return state_ == State::Done;
+}
+
+bool JsonObjectScanner::HasError() const
+{
+  return state_ == State::Error;
+}
+
+void JsonObjectScanner::AppendStringChar(char c)
+{
+  if (valueLength_ < MAX_STRING_LENGTH)
+  {
+    value_[valueLength_++] = c;
+  }
+}
+
+void JsonObjectScanner::EndNumber()
+{
+  // Like ArduinoJson's `doc[key] | fallback`, only exact in-range integers are reported.
+  const int64_t value = negative_ ? -number_ : number_;
+  if (!keyTruncated_ && !fraction_ && value >= INT_MIN && value <= INT_MAX)
+  {
+    sink_.OnInteger(key_.View(), static_cast<int>(value));
+  }
+  state_ = State::AfterValue;
+}
+
+/// <summary>
+/// Consumes one character. Returns false when the character must be re-read in the new state.
+/// </summary>
+bool JsonObjectScanner::Step(char c)
+{
+  switch (state_)
+  {
+    case State::ExpectObject:
+      if (c == '{')
+      {
+        state_ = State::ExpectKeyOrEnd;
+      }
+      else if (!isJsonWhitespace(c))
+      {
+        state_ = State::Error;
+      }
+      return true;
+
+    case State::ExpectKeyOrEnd:
+    case State::ExpectKey:
+      if (c == '"')
+      {
+        key_.Clear();
+        keyTruncated_ = false;
+        valueLength_ = 0;
+        escape_ = false;
+        state_ = State::InKey;
+      }
+      else if (c == '}' && state_ == State::ExpectKeyOrEnd)
+      {
+        state_ = State::Done;
+      }
+      else if (!isJsonWhitespace(c))
+      {
+        state_ = State::Error;
+      }
+      return true;
+
+    case State::InKey:
+      if (escape_)
+      {
+        // Keys of interest are plain ASCII; an escaped key can never match.
+        escape_ = false;
+        keyTruncated_ = true;
+      }
+      else if (c == '\\')
+      {
+        escape_ = true;
+      }
+      else if (c == '"')
+      {
+        if (!keyTruncated_)
+        {
+          key_.Assign(std::string_view(value_, valueLength_));
+        }
+        state_ = State::ExpectColon;
+      }
+      else if (valueLength_ < MAX_KEY_LENGTH)
+      {
+        value_[valueLength_++] = c;
+      }
+      else
+      {
+        keyTruncated_ = true;
+      }
+      return true;
+
+    case State::ExpectColon:
+      if (c == ':')
+      {
+        state_ = State::ExpectValue;
+      }
+      else if (!isJsonWhitespace(c))
+      {
+        state_ = State::Error;
+      }
+      return true;
+
+    case State::ExpectValue:
+      if (c == '"')
+      {
+        valueLength_ = 0;
+        escape_ = false;
+        unicodeDigits_ = 0;
+        state_ = State::InString;
+      }
+      else if (c == '-' || isDigit(c))
+      {
+        negative_ = c == '-';
+        fraction_ = false;
+        number_ = negative_ ? 0 : c - '0';
+        state_ = State::InNumber;
+      }
+      else if (c == '{' || c == '[')
+      {
+        containerDepth_ = 1;
+        containerInString_ = false;
+        escape_ = false;
+        state_ = State::SkipContainer;
+      }
+      else if (c >= 'a' && c <= 'z')
+      {
+        state_ = State::InLiteral;
+      }
+      else if (!isJsonWhitespace(c))
+      {
+        state_ = State::Error;
+      }
+      return true;
+
+    case State::InString:
+      if (unicodeDigits_ > 0)
+      {
+        if (!isHexDigit(c))
+        {
+          state_ = State::Error;
+          return true;
+        }
+        if (--unicodeDigits_ == 0)
+        {
+          AppendStringChar('?');
+        }
+      }
+      else if (escape_)
+      {
+        escape_ = false;
+        switch (c)
+        {
+          case '"': AppendStringChar('"'); break;
+          case '\\': AppendStringChar('\\'); break;
+          case '/': AppendStringChar('/'); break;
+          case 'b': AppendStringChar('\b'); break;
+          case 'f': AppendStringChar('\f'); break;
+          case 'n': AppendStringChar('\n'); break;
+          case 'r': AppendStringChar('\r'); break;
+          case 't': AppendStringChar('\t'); break;
+          case 'u': unicodeDigits_ = 4; break;
+          default: state_ = State::Error; break;
+        }
+      }
+      else if (c == '\\')
+      {
+        escape_ = true;
+      }
+      else if (c == '"')
+      {
+        if (!keyTruncated_)
+        {
+          sink_.OnString(key_.View(), std::string_view(value_, valueLength_));
+        }
+        state_ = State::AfterValue;
+      }
+      else
+      {
+        AppendStringChar(c);
+      }
+      return true;
+
+    case State::InNumber:
+      if (isDigit(c))
+      {
+        if (number_ <= INT_MAX)
+        {
+          number_ = number_ * 10 + (c - '0');
+        }
+        return true;
+      }
+      if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+      {
+        fraction_ = true;
+        return true;
+      }
+      EndNumber();
+      return false;
+
+    case State::InLiteral:
+      if (c >= 'a' && c <= 'z')
+      {
+        return true;
+      }
+      state_ = State::AfterValue;
+      return false;
+
+    case State::SkipContainer:
+      if (containerInString_)
+      {
+        if (escape_)
+        {
+          escape_ = false;
+        }
+        else if (c == '\\')
+        {
+          escape_ = true;
+        }
+        else if (c == '"')
+        {
+          containerInString_ = false;
+        }
+      }
+      else if (c == '"')
+      {
+        containerInString_ = true;
+      }
+      else if (c == '{' || c == '[')
+      {
+        containerDepth_++;
+      }
+      else if ((c == '}' || c == ']') && --containerDepth_ == 0)
+      {
+        state_ = State::AfterValue;
+      }
+      return true;
+
+    case State::AfterValue:
+      if (c == ',')
+      {
+        state_ = State::ExpectKey;
+      }
+      else if (c == '}')
+      {
+        state_ = State::Done;
+      }
+      else if (!isJsonWhitespace(c))
+      {
+        state_ = State::Error;
+      }
+      return true;
+
+    case State::Done:
+      if (!isJsonWhitespace(c))
+      {
+        state_ = State::Error;
+      }
+      return true;
+
+    case State::Error:
+      return true;
+  }
+
+  return true;
+}
+
+PumpCommandParser::PumpCommandParser()
+  : scanner_(*this),
+    command_{ PumpCommandAction::Start, 0, 0, {}, -1 }
+{
+}
+
+void PumpCommandParser::Reset()
+{
+  scanner_.Reset();
+  command_ = { PumpCommandAction::Start, 0, 0, {}, -1 };
+}
+
+void PumpCommandParser::Feed(const char* data, size_t len)
+{
+  scanner_.Feed(data, len);
+}
+
+bool PumpCommandParser::Finish(PumpCommand& command) const
+{
+  if (!scanner_.IsComplete())
+  {
+    return false;
+  }
+
+  command = command_;
+  return true;
+}
+
+void PumpCommandParser::OnString(std::string_view key, std::string_view value)
+{
+  if (key == "action")
+  {
+    command_.action = ParsePumpCommandAction(value);
+  }
+  else if (key == "requestId")
+  {
+    command_.requestId.Assign(value);
+  }
+  else if (key == "issuedAt")
+  {
+    if (!ParseIsoUtcSeconds(value, command_.issuedAtSeconds))
+    {
+      command_.issuedAtSeconds = -1;
+    }
+  }
+}
+
+void PumpCommandParser::OnInteger(std::string_view key, int value)
+{
+  if (key == "runSeconds")
+  {
+    command_.runSeconds = value;
+  }
+  else if (key == "runMs")
+  {
+    command_.runMs = value;
+  }
+}
+
+LevelReadingParser::LevelReadingParser()
+  : scanner_(*this),
+    reading_{ -1 }
+{
+}
+
+void LevelReadingParser::Reset()
+{
+  scanner_.Reset();
+  reading_ = { -1 };
+}
+
+void LevelReadingParser::Feed(const char* data, size_t len)
+{
+  scanner_.Feed(data, len);
+}
+
+bool LevelReadingParser::Finish(LevelReading& reading) const
+{
+  if (!scanner_.IsComplete())
+  {
+    return false;
+  }
+
+  reading = reading_;
+  return true;
+}
+
+void LevelReadingParser::OnString(std::string_view, std::string_view)
+{
+}
+
+void LevelReadingParser::OnInteger(std::string_view key, int value)
+{
+  if (key == "levelPercent")
+  {
+    reading_.levelPercent = value;
+  }
+}
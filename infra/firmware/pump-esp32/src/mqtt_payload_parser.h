@@ -0,0 +1,142 @@
+#ifndef MQTT_PAYLOAD_PARSER_H
+#define MQTT_PAYLOAD_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include "inline_string.h"
+#include "pump_logic.h"
+
+/// <summary>
+/// Typed view of a pump/cmd payload. Defaults mirror the MQTT contract.
+/// </summary>
+struct PumpCommand
+{
+  PumpCommandAction action;
+  int runSeconds;
+  int runMs;
+  PumpRequestId requestId;
+  // Unix seconds of "issuedAt", or -1 when it is absent or not a timestamp.
+  int64_t issuedAtSeconds;
+};
+
+/// <summary>
+/// Parses an ISO-8601 timestamp such as 2026-01-15T07:00:00Z or
+/// 2026-01-15T07:00:00.1234567+00:00 into Unix seconds; fractions are dropped.
+/// </summary>
+bool ParseIsoUtcSeconds(std::string_view iso, int64_t& seconds);
+
+/// <summary>
+/// Typed view of a waterlevel/state payload. levelPercent is -1 when absent.
+/// </summary>
+struct LevelReading
+{
+  int levelPercent;
+};
+
+/// <summary>
+/// Incremental scanner for a flat JSON object. Bytes can arrive in arbitrary chunks;
+/// top-level scalar fields are reported to a sink as soon as they complete and
+/// nested objects/arrays are skipped. Uses fixed buffers only.
+/// </summary>
+class JsonObjectScanner
+{
+public:
+  static constexpr size_t MAX_KEY_LENGTH = 24;
+  static constexpr size_t MAX_STRING_LENGTH = PUMP_REQUEST_ID_MAX_LENGTH;
+
+  class Sink
+  {
+  public:
+    virtual void OnString(std::string_view key, std::string_view value) = 0;
+    virtual void OnInteger(std::string_view key, int value) = 0;
+
+  protected:
+    ~Sink() = default;
+  };
+
+  explicit JsonObjectScanner(Sink& sink);
+
+  void Reset();
+  void Feed(const char* data, size_t len);
+  bool IsComplete() const;
+  bool HasError() const;
+
+private:
+  enum class State : uint8_t
+  {
+    ExpectObject,
+    ExpectKeyOrEnd,
+    ExpectKey,
+    InKey,
+    ExpectColon,
+    ExpectValue,
+    InString,
+    InNumber,
+    InLiteral,
+    SkipContainer,
+    AfterValue,
+    Done,
+    Error
+  };
+
+  bool Step(char c);
+  void EndNumber();
+  void AppendStringChar(char c);
+
+  Sink& sink_;
+  State state_;
+  bool escape_;
+  uint8_t unicodeDigits_;
+  bool keyTruncated_;
+  bool negative_;
+  bool fraction_;
+  bool containerInString_;
+  uint16_t containerDepth_;
+  int64_t number_;
+  InlineString<MAX_KEY_LENGTH> key_;
+  char value_[MAX_STRING_LENGTH + 1];
+  size_t valueLength_;
+};
+
+/// <summary>
+/// Parses a pump/cmd payload chunk by chunk straight into a PumpCommand.
+/// </summary>
+class PumpCommandParser : private JsonObjectScanner::Sink
+{
+public:
+  PumpCommandParser();
+
+  void Reset();
+  void Feed(const char* data, size_t len);
+  bool Finish(PumpCommand& command) const;
+
+private:
+  void OnString(std::string_view key, std::string_view value) override;
+  void OnInteger(std::string_view key, int value) override;
+
+  JsonObjectScanner scanner_;
+  PumpCommand command_;
+};
+
+/// <summary>
+/// Parses a waterlevel/state payload chunk by chunk straight into a LevelReading.
+/// </summary>
+class LevelReadingParser : private JsonObjectScanner::Sink
+{
+public:
+  LevelReadingParser();
+
+  void Reset();
+  void Feed(const char* data, size_t len);
+  bool Finish(LevelReading& reading) const;
+
+private:
+  void OnString(std::string_view key, std::string_view value) override;
+  void OnInteger(std::string_view key, int value) override;
+
+  JsonObjectScanner scanner_;
+  LevelReading reading_;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef PUMP_EVENT_H
+#define PUMP_EVENT_H
+
+#include <stdint.h>
+#include "mqtt_payload_parser.h"
+
+/// <summary>
+/// Network-side event handed from the AsyncTCP task to the loop() task.
+/// </summary>
+struct PumpEvent
+{
+  enum class Type : uint8_t
+  {
+    MqttConnected,
+    MqttDisconnected,
+    Command,
+    WaterLevel,
+    Published
+  };
+
+  Type type;
+  uint32_t receivedMs;
+  PumpCommand command;
+  LevelReading level;
+  // Published: the packet id the broker acknowledged.
+  uint16_t packetId;
+  // MqttConnected: the broker resumed the previous session.
+  bool sessionPresent;
+};
+
+/// <summary>
+/// A pump/cmd that arrived while the event queue was full; loop() rejects it on
+/// pump/cmd/result so the backend does not wait for a state update that never comes.
+/// </summary>
+struct DroppedCommand
+{
+  PumpRequestId requestId;
+  uint32_t receivedMs;
+};
+
+#endif
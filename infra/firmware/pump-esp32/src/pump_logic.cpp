@@ -1,15 +1,53 @@
 #include "pump_logic.h"
 
-PumpLogic::PumpLogic(uint32_t waterLevelStaleMs)
-  : state_{false, 0, 0, "", "", -1, 0},
-    waterLevelStaleMs_(waterLevelStaleMs)
+PumpCommandAction ParsePumpCommandAction(std::string_view action)
 {
+  return action == "stop" ? PumpCommandAction::Stop : PumpCommandAction::Start;
 }
 
-void PumpLogic::UpdateWaterLevel(int levelPercent, uint32_t nowMs)
+const char* PumpDecisionReasonName(PumpDecision::Reason reason)
+{
+  switch (reason)
+  {
+    case PumpDecision::Reason::None: return "none";
+    case PumpDecision::Reason::Command: return "command";
+    case PumpDecision::Reason::RunCompleted: return "run_completed";
+    case PumpDecision::Reason::MqttDisconnected: return "mqtt_disconnected";
+    case PumpDecision::Reason::WaterLevelEmpty: return "water_level_empty";
+    case PumpDecision::Reason::WaterLevelStale: return "water_level_stale";
+    case PumpDecision::Reason::WaterLevelUnknown: return "water_level_unknown";
+    case PumpDecision::Reason::InvalidDuration: return "invalid_duration";
+    case PumpDecision::Reason::CommandExpired: return "command_expired";
+    case PumpDecision::Reason::QueueFull: return "queue_full";
+  }
+  return "none";
+}
+
+static uint32_t remainingMs(uint32_t elapsedMs, uint32_t limitMs)
+{
+  return elapsedMs >= limitMs ? 0 : limitMs - elapsedMs;
+}
+
+PumpLogic::PumpLogic(uint32_t waterLevelStaleMs, uint32_t rideThroughMs, uint32_t maxCommandAgeSeconds)
+  : state_{false, 0, 0, {}, {}, -1, 0, PumpDecision::Reason::None, false, 0, 0, 0},
+    waterLevelStaleMs_(waterLevelStaleMs),
+    rideThroughMs_(rideThroughMs),
+    maxCommandAgeSeconds_(maxCommandAgeSeconds)
+{
+}
+
+PumpDecision PumpLogic::UpdateWaterLevel(int levelPercent, uint32_t nowMs)
 {
   state_.lastWaterLevelPercent = levelPercent;
   state_.lastWaterLevelSeenMs = nowMs;
+
+  const PumpDecision::Reason unsafe = LevelUnsafeReason(nowMs);
+  if (state_.pumpRunning && unsafe != PumpDecision::Reason::None)
+  {
+    return { PumpDecision::Action::Stop, 0, state_.lastRequestId, unsafe };
+  }
+
+  return { PumpDecision::Action::None, 0, state_.lastRequestId, PumpDecision::Reason::None };
 }
 
 bool PumpLogic::IsWaterLevelKnown() const
@@ -28,80 +66,191 @@ bool PumpLogic::IsWaterLevelStale(uint32_t nowMs) const
 
 bool PumpLogic::IsWaterLevelSafe(uint32_t nowMs) const
 {
-  return IsWaterLevelKnown() && !IsWaterLevelStale(nowMs) && state_.lastWaterLevelPercent > 0;
+  return LevelUnsafeReason(nowMs) == PumpDecision::Reason::None;
+}
+
+PumpDecision::Reason PumpLogic::LevelUnsafeReason(uint32_t nowMs) const
+{
+  if (!IsWaterLevelKnown())
+  {
+    return PumpDecision::Reason::WaterLevelUnknown;
+  }
+
+  if (IsWaterLevelStale(nowMs))
+  {
+    return PumpDecision::Reason::WaterLevelStale;
+  }
+
+  if (state_.lastWaterLevelPercent <= 0)
+  {
+    return PumpDecision::Reason::WaterLevelEmpty;
+  }
+
+  return PumpDecision::Reason::None;
 }
 
 PumpDecision PumpLogic::EvaluateCommand(
-  const std::string& action,
+  PumpCommandAction action,
   int runSeconds,
-  const std::string& requestId,
-  uint32_t nowMs) const
+  std::string_view requestId,
+  uint32_t nowMs,
+  int runMs,
+  int64_t commandAgeSeconds) const
 {
-  if (action == "stop")
+  const PumpRequestId id(requestId);
+  if (action == PumpCommandAction::Stop)
+  {
+    return { PumpDecision::Action::Stop, 0, id, PumpDecision::Reason::Command };
+  }
+
+  if (maxCommandAgeSeconds_ > 0 && commandAgeSeconds > static_cast<int64_t>(maxCommandAgeSeconds_))
   {
-    return { PumpDecision::Action::Stop, 0, requestId };
+    return { PumpDecision::Action::None, 0, id, PumpDecision::Reason::CommandExpired };
   }
 
-  if (!IsWaterLevelSafe(nowMs))
+  const PumpDecision::Reason unsafe = LevelUnsafeReason(nowMs);
+  if (unsafe != PumpDecision::Reason::None)
   {
-    return { PumpDecision::Action::None, 0, requestId };
+    return { PumpDecision::Action::None, 0, id, unsafe };
+  }
+
+  if (runMs > 0)
+  {
+    return { PumpDecision::Action::Start, static_cast<uint32_t>(runMs), id, PumpDecision::Reason::None };
   }
 
   if (runSeconds <= 0)
   {
-    return { PumpDecision::Action::None, 0, requestId };
+    return { PumpDecision::Action::None, 0, id, PumpDecision::Reason::InvalidDuration };
   }
 
-  return { PumpDecision::Action::Start, static_cast<uint32_t>(runSeconds), requestId };
+  const uint32_t maxSeconds = UINT32_MAX / 1000;
+  const uint32_t seconds = static_cast<uint32_t>(runSeconds) < maxSeconds ? static_cast<uint32_t>(runSeconds) : maxSeconds;
+  return { PumpDecision::Action::Start, seconds * 1000, id, PumpDecision::Reason::None };
 }
 
-PumpDecision PumpLogic::OnMqttDisconnected() const
+PumpDecision PumpLogic::OnMqttDisconnected(uint32_t nowMs)
 {
-  if (state_.pumpRunning)
+  if (!state_.mqttLinkDown)
+  {
+    state_.mqttLinkDown = true;
+    state_.mqttLinkDownSinceMs = nowMs;
+  }
+
+  if (!state_.pumpRunning)
   {
-    return { PumpDecision::Action::Stop, 0, state_.lastRequestId };
+    return { PumpDecision::Action::None, 0, state_.lastRequestId, PumpDecision::Reason::None };
   }
 
-  return { PumpDecision::Action::None, 0, state_.lastRequestId };
+  return OnTick(nowMs);
+}
+
+void PumpLogic::OnMqttConnected(uint32_t nowMs)
+{
+  if (state_.mqttLinkDown && state_.pumpRunning)
+  {
+    state_.lastRunOfflineMs += nowMs - RunOfflineStartMs();
+  }
+  state_.mqttLinkDown = false;
 }
 
 PumpDecision PumpLogic::OnTick(uint32_t nowMs) const
 {
   if (!state_.pumpRunning)
   {
-    return { PumpDecision::Action::None, 0, state_.lastRequestId };
+    return { PumpDecision::Action::None, 0, state_.lastRequestId, PumpDecision::Reason::None };
+  }
+
+  if ((nowMs - state_.pumpStartMs) >= state_.pumpRunMs)
+  {
+    return { PumpDecision::Action::Stop, 0, state_.lastRequestId, PumpDecision::Reason::RunCompleted };
   }
 
-  if (state_.pumpRunSeconds == 0)
+  const PumpDecision::Reason unsafe = LevelUnsafeReason(nowMs);
+  if (unsafe != PumpDecision::Reason::None)
   {
-    return { PumpDecision::Action::None, 0, state_.lastRequestId };
+    return { PumpDecision::Action::Stop, 0, state_.lastRequestId, unsafe };
   }
 
-  const uint32_t elapsedSeconds = (nowMs - state_.pumpStartMs) / 1000;
-  if (elapsedSeconds >= state_.pumpRunSeconds)
+  if (state_.mqttLinkDown && (nowMs - state_.mqttLinkDownSinceMs) >= rideThroughMs_)
   {
-    return { PumpDecision::Action::Stop, 0, state_.lastRequestId };
+    return { PumpDecision::Action::Stop, 0, state_.lastRequestId, PumpDecision::Reason::MqttDisconnected };
   }
 
-  return { PumpDecision::Action::None, 0, state_.lastRequestId };
+  return { PumpDecision::Action::None, 0, state_.lastRequestId, PumpDecision::Reason::None };
 }
 
-void PumpLogic::ApplyDecision(const PumpDecision& decision, uint32_t nowMs, const std::string& startIso)
+void PumpLogic::ApplyDecision(const PumpDecision& decision, uint32_t nowMs, std::string_view startIso)
 {
   if (decision.action == PumpDecision::Action::Start)
   {
     state_.pumpRunning = true;
     state_.pumpStartMs = nowMs;
-    state_.pumpRunSeconds = decision.runSeconds;
+    state_.pumpRunMs = decision.runMs;
     state_.lastRequestId = decision.requestId;
-    state_.pumpStartIso = startIso;
+    state_.pumpStartIso.Assign(startIso);
+    state_.lastStopReason = PumpDecision::Reason::None;
+    state_.lastDeliveredMs = 0;
+    state_.lastRunOfflineMs = 0;
     return;
   }
 
   if (decision.action == PumpDecision::Action::Stop)
   {
+    if (state_.pumpRunning)
+    {
+      state_.lastDeliveredMs = nowMs - state_.pumpStartMs;
+      if (state_.mqttLinkDown)
+      {
+        state_.lastRunOfflineMs += nowMs - RunOfflineStartMs();
+      }
+    }
     state_.pumpRunning = false;
+    state_.lastStopReason = decision.reason;
+  }
+}
+
+bool PumpLogic::HasStopDeadline() const
+{
+  return state_.pumpRunning;
+}
+
+uint32_t PumpLogic::StopDeadlineMs() const
+{
+  const uint32_t runEndMs = state_.pumpStartMs + state_.pumpRunMs;
+  const uint32_t staleAtMs = state_.lastWaterLevelSeenMs + waterLevelStaleMs_ + 1;
+  uint32_t deadlineMs = static_cast<int32_t>(staleAtMs - runEndMs) < 0 ? staleAtMs : runEndMs;
+  if (state_.mqttLinkDown)
+  {
+    const uint32_t rideThroughEndMs = state_.mqttLinkDownSinceMs + rideThroughMs_;
+    deadlineMs = static_cast<int32_t>(rideThroughEndMs - deadlineMs) < 0 ? rideThroughEndMs : deadlineMs;
+  }
+  return deadlineMs;
+}
+
+uint32_t PumpLogic::MsUntilStop(uint32_t nowMs) const
+{
+  const uint32_t untilRunEndMs = remainingMs(nowMs - state_.pumpStartMs, state_.pumpRunMs);
+  const uint32_t untilStaleMs = remainingMs(nowMs - state_.lastWaterLevelSeenMs, waterLevelStaleMs_ + 1);
+  uint32_t untilStopMs = untilStaleMs < untilRunEndMs ? untilStaleMs : untilRunEndMs;
+  if (state_.mqttLinkDown)
+  {
+    const uint32_t untilRideThroughEndMs = remainingMs(nowMs - state_.mqttLinkDownSinceMs, rideThroughMs_);
+    untilStopMs = untilRideThroughEndMs < untilStopMs ? untilRideThroughEndMs : untilStopMs;
   }
+  return untilStopMs;
+}
+
+uint32_t PumpLogic::DeliveredMs(uint32_t nowMs) const
+{
+  return state_.pumpRunning ? nowMs - state_.pumpStartMs : state_.lastDeliveredMs;
+}
+
+uint32_t PumpLogic::RunOfflineStartMs() const
+{
+  // A run only starts on a command, so it normally predates the drop; never count time before it.
+  const bool droppedBeforeStart = static_cast<int32_t>(state_.pumpStartMs - state_.mqttLinkDownSinceMs) > 0;
+  return droppedBeforeStart ? state_.pumpStartMs : state_.mqttLinkDownSinceMs;
 }
 
 const PumpLogicState& PumpLogic::State() const
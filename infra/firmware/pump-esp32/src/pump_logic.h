@@ -2,7 +2,30 @@
 #define PUMP_LOGIC_H
 
 #include <stdint.h>
-#include <string>
+#include <string_view>
+#include "inline_string.h"
+#include "iso_timestamp.h"
+
+/// <summary>
+/// A canonical UUID is 36 characters (37 bytes with the terminator).
+/// </summary>
+static constexpr size_t PUMP_REQUEST_ID_MAX_LENGTH = 36;
+
+using PumpRequestId = InlineString<PUMP_REQUEST_ID_MAX_LENGTH>;
+
+/// <summary>
+/// Action requested by a pump command.
+/// </summary>
+enum class PumpCommandAction
+{
+  Start,
+  Stop
+};
+
+/// <summary>
+/// Maps the cmd payload "action" field; anything but "stop" is a start for backward compatibility.
+/// </summary>
+PumpCommandAction ParsePumpCommandAction(std::string_view action);
 
 /// <summary>
 /// Describes a pump action derived from commands or safety logic.
@@ -16,11 +39,34 @@ struct PumpDecision
     Stop
   };
 
+  /// <summary>
+  /// Why a stop was issued or a command was not acted on.
+  /// </summary>
+  enum class Reason
+  {
+    None,
+    Command,
+    RunCompleted,
+    MqttDisconnected,
+    WaterLevelEmpty,
+    WaterLevelStale,
+    WaterLevelUnknown,
+    InvalidDuration,
+    CommandExpired,
+    QueueFull
+  };
+
   Action action;
-  uint32_t runSeconds;
-  std::string requestId;
+  uint32_t runMs;
+  PumpRequestId requestId;
+  Reason reason;
 };
 
+/// <summary>
+/// Stable snake_case name of a decision reason for MQTT payloads and logs.
+/// </summary>
+const char* PumpDecisionReasonName(PumpDecision::Reason reason);
+
 /// <summary>
 /// Holds the current pump and water level state for decision making.
 /// </summary>
@@ -28,41 +74,94 @@ struct PumpLogicState
 {
   bool pumpRunning;
   uint32_t pumpStartMs;
-  uint32_t pumpRunSeconds;
-  std::string lastRequestId;
-  std::string pumpStartIso;
+  uint32_t pumpRunMs;
+  PumpRequestId lastRequestId;
+  IsoTimestamp pumpStartIso;
   int lastWaterLevelPercent;
   uint32_t lastWaterLevelSeenMs;
+  PumpDecision::Reason lastStopReason;
+  bool mqttLinkDown;
+  uint32_t mqttLinkDownSinceMs;
+  // Relay-on time of the last finished run, and how much of the run went without a broker.
+  uint32_t lastDeliveredMs;
+  uint32_t lastRunOfflineMs;
 };
 
 /// <summary>
 /// Encapsulates pump command decisions without direct hardware dependencies.
+/// Decision paths never allocate; strings are held in fixed inline buffers.
 /// </summary>
 class PumpLogic
 {
 public:
-  explicit PumpLogic(uint32_t waterLevelStaleMs);
+  /// <summary>
+  /// rideThroughMs is how long a timed run may keep going after the MQTT link drops;
+  /// 0 stops the pump on every disconnect. A start issued more than maxCommandAgeSeconds
+  /// ago is refused; 0 accepts starts of any age.
+  /// </summary>
+  explicit PumpLogic(uint32_t waterLevelStaleMs, uint32_t rideThroughMs = 0, uint32_t maxCommandAgeSeconds = 0);
 
-  void UpdateWaterLevel(int levelPercent, uint32_t nowMs);
+  /// <summary>
+  /// Records a level reading. Returns a Stop when the pump is running and the reading is not safe.
+  /// </summary>
+  PumpDecision UpdateWaterLevel(int levelPercent, uint32_t nowMs);
   bool IsWaterLevelKnown() const;
   bool IsWaterLevelStale(uint32_t nowMs) const;
   bool IsWaterLevelSafe(uint32_t nowMs) const;
 
+  /// <summary>
+  /// runMs, when positive, takes precedence over runSeconds for millisecond precision.
+  /// commandAgeSeconds is how long ago the command was issued, -1 when unknown; a
+  /// start held back by the broker past the age limit is refused, a stop never is.
+  /// </summary>
   PumpDecision EvaluateCommand(
-    const std::string& action,
+    PumpCommandAction action,
     int runSeconds,
-    const std::string& requestId,
-    uint32_t nowMs) const;
+    std::string_view requestId,
+    uint32_t nowMs,
+    int runMs = 0,
+    int64_t commandAgeSeconds = -1) const;
+
+  /// <summary>
+  /// Called on the disconnect and again while the link stays down. A timed run rides
+  /// through until its own deadline, the ride-through limit or the last level reading
+  /// turning stale, whichever comes first; anything else stops at once.
+  /// </summary>
+  PumpDecision OnMqttDisconnected(uint32_t nowMs);
+  void OnMqttConnected(uint32_t nowMs);
 
-  PumpDecision OnMqttDisconnected() const;
+  /// <summary>
+  /// Stops a running pump when its run time is over, the level reading went stale or
+  /// the ride-through limit of a link drop is used up.
+  /// </summary>
   PumpDecision OnTick(uint32_t nowMs) const;
 
-  void ApplyDecision(const PumpDecision& decision, uint32_t nowMs, const std::string& startIso);
+  /// <summary>
+  /// While running, the next instant OnTick must be evaluated: the earliest of the
+  /// run end, the moment the last level reading turns stale and, while the link is
+  /// down, the end of the ride-through.
+  /// </summary>
+  bool HasStopDeadline() const;
+  uint32_t StopDeadlineMs() const;
+  uint32_t MsUntilStop(uint32_t nowMs) const;
+
+  /// <summary>
+  /// Relay-on time of the current run so far, or of the last run once it stopped.
+  /// </summary>
+  uint32_t DeliveredMs(uint32_t nowMs) const;
+
+  void ApplyDecision(const PumpDecision& decision, uint32_t nowMs, std::string_view startIso);
   const PumpLogicState& State() const;
 
 private:
+  PumpDecision::Reason LevelUnsafeReason(uint32_t nowMs) const;
+
+  uint32_t RunOfflineStartMs() const;
+
   PumpLogicState state_;
   uint32_t waterLevelStaleMs_;
+  uint32_t rideThroughMs_;
+  uint32_t maxCommandAgeSeconds_;
 };
 
 #endif
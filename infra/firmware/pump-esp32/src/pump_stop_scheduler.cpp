@@ -0,0 +1,61 @@
+#include "pump_stop_scheduler.h"
+
+PumpStopScheduler::PumpStopScheduler(OneShotTimer& timer)
+  : timer_(timer),
+    armed_(false),
+    armedDeadlineMs_(0),
+    jitter_{ 0, 0, 0, 0 }
+{
+}
+
+void PumpStopScheduler::Sync(const PumpLogic& logic, uint32_t nowMs)
+{
+  if (!logic.HasStopDeadline())
+  {
+    if (armed_)
+    {
+      timer_.Cancel();
+      armed_ = false;
+    }
+    return;
+  }
+
+  const uint32_t deadlineMs = logic.StopDeadlineMs();
+  if (armed_ && deadlineMs == armedDeadlineMs_)
+  {
+    return;
+  }
+
+  timer_.Arm(logic.MsUntilStop(nowMs));
+  armed_ = true;
+  armedDeadlineMs_ = deadlineMs;
+}
+
+uint32_t PumpStopScheduler::WaitMs(const PumpLogic& logic, uint32_t nowMs, uint32_t idleWaitMs) const
+{
+  if (!logic.HasStopDeadline())
+  {
+    return idleWaitMs;
+  }
+
+  const uint32_t untilStopMs = logic.MsUntilStop(nowMs);
+  return untilStopMs < idleWaitMs ? untilStopMs : idleWaitMs;
+}
+
+void PumpStopScheduler::RecordDeadlineStop(uint32_t deadlineMs, uint32_t stoppedMs)
+{
+  const int32_t lateness = static_cast<int32_t>(stoppedMs - deadlineMs);
+  const uint32_t latenessMs = lateness > 0 ? static_cast<uint32_t>(lateness) : 0;
+  jitter_.count++;
+  jitter_.lastMs = latenessMs;
+  jitter_.totalMs += latenessMs;
+  if (latenessMs > jitter_.maxMs)
+  {
+    jitter_.maxMs = latenessMs;
+  }
+}
+
+const StopJitterStats& PumpStopScheduler::Jitter() const
+{
+  return jitter_;
+}
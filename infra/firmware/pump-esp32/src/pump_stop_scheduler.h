@@ -0,0 +1,54 @@
+#ifndef PUMP_STOP_SCHEDULER_H
+#define PUMP_STOP_SCHEDULER_H
+
+#include <stdint.h>
+#include "pump_logic.h"
+
+/// <summary>
+/// One-shot timer abstraction so deadline handling can run without hardware.
+/// Arming again replaces any pending deadline.
+/// </summary>
+class OneShotTimer
+{
+public:
+  virtual void Arm(uint32_t delayMs) = 0;
+  virtual void Cancel() = 0;
+
+protected:
+  ~OneShotTimer() = default;
+};
+
+/// <summary>
+/// Lateness of deadline stops relative to the requested run end.
+/// </summary>
+struct StopJitterStats
+{
+  uint32_t count;
+  uint32_t lastMs;
+  uint32_t maxMs;
+  uint64_t totalMs;
+};
+
+/// <summary>
+/// Keeps a one-shot timer armed for the running pump's stop deadline so loop() can
+/// sleep instead of polling, and records how late each deadline stop was applied.
+/// Owned by loop(); the timer callback itself only needs to wake loop().
+/// </summary>
+class PumpStopScheduler
+{
+public:
+  explicit PumpStopScheduler(OneShotTimer& timer);
+
+  void Sync(const PumpLogic& logic, uint32_t nowMs);
+  uint32_t WaitMs(const PumpLogic& logic, uint32_t nowMs, uint32_t idleWaitMs) const;
+  void RecordDeadlineStop(uint32_t deadlineMs, uint32_t stoppedMs);
+  const StopJitterStats& Jitter() const;
+
+private:
+  OneShotTimer& timer_;
+  bool armed_;
+  uint32_t armedDeadlineMs_;
+  StopJitterStats jitter_;
+};
+
+#endif
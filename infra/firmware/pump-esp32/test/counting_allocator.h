@@ -0,0 +1,42 @@
+#ifndef COUNTING_ALLOCATOR_H
+#define COUNTING_ALLOCATOR_H
+
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new for the test program that includes this header, so
+// tests can assert that a code path does not allocate. Include it from one file only.
+
+/// <summary>
+/// Number of operator new calls since the program started; compare before and after.
+/// </summary>
+static size_t allocationCount = 0;
+
+void* operator new(size_t size)
+{
+  allocationCount++;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  allocationCount++;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <string>
+#include <thread>
+#include "alloc_accounting.h"
+
+void setUp()
+{
+  AllocAccounting::Reset();
+}
+
+void tearDown()
+{
+}
+
+void test_allocations_balance()
+{
+  AllocAccounting::OnAllocate(AllocTag::MqttOut, 48);
+  AllocAccounting::OnAllocate(AllocTag::MqttOut, 200);
+  const AllocTagStats inside = AllocAccounting::Stats(AllocTag::MqttOut);
+  TEST_ASSERT_EQUAL_UINT32(2, inside.allocations);
+  TEST_ASSERT_EQUAL_UINT32(248, inside.liveBytes);
+  AllocAccounting::OnFree(AllocTag::MqttOut, 200);
+  AllocAccounting::OnFree(AllocTag::MqttOut, 48);
+
+  const AllocTagStats after = AllocAccounting::Stats(AllocTag::MqttOut);
+  TEST_ASSERT_EQUAL_UINT32(2, after.frees);
+  TEST_ASSERT_EQUAL_UINT32(0, after.liveBytes);
+  TEST_ASSERT_EQUAL_UINT32(248, after.peakLiveBytes);
+  TEST_ASSERT_EQUAL_UINT32(248, static_cast<uint32_t>(after.totalBytes));
+  TEST_ASSERT_EQUAL_UINT32(0, AllocAccounting::Stats(AllocTag::Json).allocations);
+}
+
+void test_json_document_is_accounted_and_released()
+{
+  AccountedJsonAllocator allocator;
+  {
+    JsonDocument doc(&allocator);
+    doc["running"] = true;
+    doc["lastRequestId"] = std::string("a-request-id-that-is-not-a-literal");
+    JsonArray arr = doc["sensors"].to<JsonArray>();
+    for (int i = 0; i < 32; i++)
+    {
+      arr.add(i);
+    }
+    std::string payload;
+    serializeJson(doc, payload);
+
+    const AllocTagStats inside = AllocAccounting::Stats(AllocTag::Json);
+    TEST_ASSERT_TRUE(inside.allocations > 0);
+    TEST_ASSERT_TRUE(inside.liveBytes > 0);
+  }
+
+  const AllocTagStats after = AllocAccounting::Stats(AllocTag::Json);
+  TEST_ASSERT_EQUAL_UINT32(after.allocations, after.frees);
+  TEST_ASSERT_EQUAL_UINT32(0, after.liveBytes);
+  TEST_ASSERT_TRUE(after.peakLiveBytes > 0);
+}
+
+void test_json_reallocate_keeps_live_bytes_exact()
+{
+  AccountedJsonAllocator allocator;
+  void* block = allocator.allocate(64);
+  TEST_ASSERT_EQUAL_UINT32(64, AllocAccounting::Stats(AllocTag::Json).liveBytes);
+
+  block = allocator.reallocate(block, 256);
+  TEST_ASSERT_EQUAL_UINT32(256, AllocAccounting::Stats(AllocTag::Json).liveBytes);
+  block = allocator.reallocate(block, 16);
+  TEST_ASSERT_EQUAL_UINT32(16, AllocAccounting::Stats(AllocTag::Json).liveBytes);
+  TEST_ASSERT_EQUAL_UINT32(256, AllocAccounting::Stats(AllocTag::Json).peakLiveBytes);
+
+  allocator.deallocate(block);
+  allocator.deallocate(nullptr);
+  TEST_ASSERT_EQUAL_UINT32(0, AllocAccounting::Stats(AllocTag::Json).liveBytes);
+}
+
+static void buildLevelPayload(AccountedJsonAllocator& allocator, int levelPercent)
+{
+  JsonDocument doc(&allocator);
+  doc["levelPercent"] = levelPercent;
+  doc["reportedAt"] = std::string("2026-01-15T06:55:01Z");
+  std::string payload;
+  serializeJson(doc, payload);
+}
+
+void test_repeated_documents_do_not_leak()
+{
+  AccountedJsonAllocator allocator;
+  buildLevelPayload(allocator, 0);
+  const uint32_t firstPeak = AllocAccounting::Stats(AllocTag::Json).peakLiveBytes;
+  for (int i = 1; i < 1000; i++)
+  {
+    buildLevelPayload(allocator, i % 100);
+  }
+
+  const AllocTagStats stats = AllocAccounting::Stats(AllocTag::Json);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.liveBytes);
+  TEST_ASSERT_EQUAL_UINT32(stats.allocations, stats.frees);
+  // One document's worth at a time, no growth across iterations.
+  TEST_ASSERT_EQUAL_UINT32(firstPeak, stats.peakLiveBytes);
+}
+
+void test_counters_are_safe_across_tasks()
+{
+  const int perThread = 20000;
+  auto worker = []()
+  {
+    for (int i = 0; i < perThread; i++)
+    {
+      AllocAccounting::OnAllocate(AllocTag::MqttOut, 100);
+      AllocAccounting::OnFree(AllocTag::MqttOut, 100);
+    }
+  };
+  std::thread a(worker);
+  std::thread b(worker);
+  a.join();
+  b.join();
+
+  const AllocTagStats stats = AllocAccounting::Stats(AllocTag::MqttOut);
+  TEST_ASSERT_EQUAL_UINT32(2 * perThread, stats.allocations);
+  TEST_ASSERT_EQUAL_UINT32(2 * perThread, stats.frees);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.liveBytes);
+  TEST_ASSERT_LESS_OR_EQUAL(200, stats.peakLiveBytes);
+}
+
+void test_tag_names()
+{
+  TEST_ASSERT_EQUAL_STRING("mqttOut", AllocAccounting::TagName(AllocTag::MqttOut));
+  TEST_ASSERT_EQUAL_STRING("json", AllocAccounting::TagName(AllocTag::Json));
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_allocations_balance);
+  RUN_TEST(test_json_document_is_accounted_and_released);
+  RUN_TEST(test_json_reallocate_keeps_live_bytes_exact);
+  RUN_TEST(test_repeated_documents_do_not_leak);
+  RUN_TEST(test_counters_are_safe_across_tasks);
+  RUN_TEST(test_tag_names);
+  return UNITY_END();
+}
@@ -0,0 +1,70 @@
+#include <unity.h>
+#include "boot_timeline.h"
+
+void test_first_mark_wins()
+{
+  BootTimeline timeline;
+  timeline.Mark(BootPhase::WifiConnected, 2100);
+  timeline.Mark(BootPhase::WifiConnected, 90000);
+
+  TEST_ASSERT_TRUE(timeline.Has(BootPhase::WifiConnected));
+  TEST_ASSERT_EQUAL_UINT32(2100, timeline.At(BootPhase::WifiConnected));
+  TEST_ASSERT_FALSE(timeline.Has(BootPhase::MqttConnected));
+  TEST_ASSERT_EQUAL_UINT32(0, timeline.At(BootPhase::MqttConnected));
+}
+
+void test_since_previous_skips_missing_phases()
+{
+  BootTimeline timeline;
+  timeline.Mark(BootPhase::Setup, 300);
+  timeline.Mark(BootPhase::WifiBegin, 310);
+  timeline.Mark(BootPhase::WifiConnected, 2110);
+  timeline.Mark(BootPhase::MqttConnected, 2400);
+
+  TEST_ASSERT_EQUAL_UINT32(300, timeline.SincePrevious(BootPhase::Setup));
+  TEST_ASSERT_EQUAL_UINT32(1800, timeline.SincePrevious(BootPhase::WifiConnected));
+  TEST_ASSERT_EQUAL_UINT32(290, timeline.SincePrevious(BootPhase::MqttConnected));
+  TEST_ASSERT_EQUAL_UINT32(0, timeline.SincePrevious(BootPhase::Subscribed));
+}
+
+void test_mqtt_attempts_stop_counting_once_connected()
+{
+  BootTimeline timeline;
+  timeline.CountMqttAttempt();
+  timeline.CountMqttAttempt();
+  timeline.Mark(BootPhase::MqttConnected, 12000);
+  timeline.CountMqttAttempt();
+
+  TEST_ASSERT_EQUAL_UINT16(2, timeline.MqttAttempts());
+}
+
+void test_report_due_once_after_first_publish()
+{
+  BootTimeline timeline;
+  timeline.Mark(BootPhase::MqttConnected, 2400);
+  TEST_ASSERT_FALSE(timeline.ReportDue());
+
+  timeline.Mark(BootPhase::FirstPublish, 2420);
+  TEST_ASSERT_TRUE(timeline.ReportDue());
+
+  timeline.MarkReported();
+  TEST_ASSERT_FALSE(timeline.ReportDue());
+}
+
+void test_phase_names()
+{
+  TEST_ASSERT_EQUAL_STRING("setup", BootTimeline::PhaseName(BootPhase::Setup));
+  TEST_ASSERT_EQUAL_STRING("firstPublish", BootTimeline::PhaseName(BootPhase::FirstPublish));
+  TEST_ASSERT_EQUAL_STRING("unknown", BootTimeline::PhaseName(BootPhase::Count));
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_first_mark_wins);
+  RUN_TEST(test_since_previous_skips_missing_phases);
+  RUN_TEST(test_mqtt_attempts_stop_counting_once_connected);
+  RUN_TEST(test_report_due_once_after_first_publish);
+  RUN_TEST(test_phase_names);
+  return UNITY_END();
+}
@@ -0,0 +1,256 @@
+#include <unity.h>
+#include "connectivity_manager.h"
+
+/// <summary>
+/// Records what the manager asked for; link events are fed by the test.
+/// </summary>
+class FakeHal : public ConnectivityHal
+{
+public:
+  void BeginWifi() override { wifiBegins++; }
+  void StartPortal() override { portalStarts++; }
+  void StopPortal() override { portalStops++; }
+  void BeginMqtt() override { mqttBegins++; }
+  uint32_t Random() override { return random; }
+
+  int wifiBegins = 0;
+  int portalStarts = 0;
+  int portalStops = 0;
+  int mqttBegins = 0;
+  uint32_t random = 0;
+};
+
+static const ConnectivityConfig CONFIG{ 10000, 250, 1000, 8000, 60000 };
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void assert_link(LinkState expected, LinkState actual)
+{
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(expected), static_cast<int>(actual));
+}
+
+static void connect(ConnectivityManager& manager, uint32_t nowMs)
+{
+  manager.Begin(true, nowMs);
+  manager.OnWifiConnected(nowMs);
+  manager.Step(nowMs);
+  manager.OnMqttConnected(nowMs);
+}
+
+void test_backoff_starts_fast_then_doubles_with_jitter()
+{
+  ReconnectBackoff low(250, 1000, 8000);
+  const uint32_t floors[] = { 250, 500, 1000, 2000, 4000, 4000, 4000 };
+  for (uint32_t expected : floors)
+  {
+    TEST_ASSERT_EQUAL_UINT32(expected, low.NextDelayMs(0));
+  }
+
+  ReconnectBackoff high(250, 1000, 8000);
+  const uint32_t ceilings[] = { 250, 1000, 2000, 4000, 8000, 8000 };
+  for (uint32_t expected : ceilings)
+  {
+    // random % (ceiling - floor + 1) == ceiling / 2 picks the top of the range.
+    TEST_ASSERT_EQUAL_UINT32(expected, high.NextDelayMs(expected / 2));
+  }
+
+  uint32_t seed = 12345;
+  ReconnectBackoff jittered(250, 1000, 8000);
+  for (int i = 0; i < 8; i++)
+  {
+    jittered.NextDelayMs(0);
+  }
+  for (int i = 0; i < 1000; i++)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    const uint32_t delayMs = jittered.NextDelayMs(seed);
+    TEST_ASSERT_TRUE(delayMs >= 4000 && delayMs <= 8000);
+  }
+
+  jittered.Reset();
+  TEST_ASSERT_EQUAL_UINT32(0, jittered.Failures());
+  TEST_ASSERT_EQUAL_UINT32(250, jittered.NextDelayMs(seed));
+}
+
+void test_cold_start_connects_wifi_then_mqtt()
+{
+  FakeHal hal;
+  ConnectivityManager manager(hal, CONFIG);
+  manager.Begin(true, 0);
+  TEST_ASSERT_EQUAL_INT(1, hal.wifiBegins);
+  assert_link(LinkState::Connecting, manager.Wifi());
+
+  manager.Step(500);
+  TEST_ASSERT_EQUAL_INT(0, hal.mqttBegins);
+  manager.OnWifiConnected(800);
+  manager.Step(800);
+  TEST_ASSERT_EQUAL_INT(1, hal.mqttBegins);
+  assert_link(LinkState::Connecting, manager.Mqtt());
+
+  manager.Step(900);
+  TEST_ASSERT_EQUAL_INT(1, hal.mqttBegins);
+  manager.OnMqttConnected(950);
+  assert_link(LinkState::Up, manager.Mqtt());
+  // The cold start is the boot timeline's business, not a reconnect.
+  TEST_ASSERT_EQUAL_UINT32(0, manager.Stats().reconnects);
+}
+
+void test_wifi_attempts_time_out_and_back_off()
+{
+  FakeHal hal;
+  ConnectivityManager manager(hal, CONFIG);
+  manager.Begin(true, 0);
+
+  manager.Step(9999);
+  TEST_ASSERT_EQUAL_INT(1, hal.wifiBegins);
+  manager.Step(10000);
+  assert_link(LinkState::Down, manager.Wifi());
+  TEST_ASSERT_EQUAL_UINT32(250, manager.MsUntilNextStep(10000, 60000));
+  manager.Step(10250);
+  TEST_ASSERT_EQUAL_INT(2, hal.wifiBegins);
+
+  // A failed attempt (disconnect event) retries after the next backoff step.
+  manager.OnWifiDisconnected(11000);
+  manager.OnWifiDisconnected(11001);
+  manager.Step(11499);
+  TEST_ASSERT_EQUAL_INT(2, hal.wifiBegins);
+  manager.Step(11500);
+  TEST_ASSERT_EQUAL_INT(3, hal.wifiBegins);
+  TEST_ASSERT_EQUAL_UINT32(3, manager.Stats().wifiAttempts);
+
+  manager.OnWifiConnected(12000);
+  manager.OnWifiDisconnected(20000);
+  // A link that was up starts over with the fast first retry.
+  TEST_ASSERT_EQUAL_UINT32(250, manager.MsUntilNextStep(20000, 60000));
+}
+
+void test_drop_and_reconnect_is_measured()
+{
+  FakeHal hal;
+  ConnectivityManager manager(hal, CONFIG);
+  connect(manager, 0);
+
+  manager.OnWifiDisconnected(10000);
+  assert_link(LinkState::Down, manager.Mqtt());
+  manager.Step(10250);
+  TEST_ASSERT_EQUAL_INT(2, hal.wifiBegins);
+  manager.OnWifiConnected(10400);
+  // The session's own disconnect arrives late and must not delay the new attempt.
+  manager.OnMqttDisconnected(10410);
+  manager.Step(10410);
+  TEST_ASSERT_EQUAL_INT(2, hal.mqttBegins);
+  manager.OnMqttConnected(10500);
+
+  const ConnectivityStats& stats = manager.Stats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.reconnects);
+  TEST_ASSERT_EQUAL_UINT32(500, stats.lastReconnectMs);
+  TEST_ASSERT_EQUAL_UINT32(500, stats.maxReconnectMs);
+
+  manager.OnMqttDisconnected(20000);
+  manager.Step(20250);
+  manager.OnMqttConnected(20300);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.reconnects);
+  TEST_ASSERT_EQUAL_UINT32(300, stats.lastReconnectMs);
+  TEST_ASSERT_EQUAL_UINT32(500, stats.maxReconnectMs);
+  TEST_ASSERT_EQUAL_UINT64(800, stats.totalReconnectMs);
+}
+
+void test_broker_down_backs_off_without_overlapping_attempts()
+{
+  FakeHal hal;
+  ConnectivityManager manager(hal, CONFIG);
+  connect(manager, 0);
+
+  manager.OnMqttDisconnected(1000);
+  uint32_t nowMs = 1000;
+  const uint32_t delays[] = { 250, 500, 1000, 2000, 4000, 4000 };
+  for (uint32_t delayMs : delays)
+  {
+    TEST_ASSERT_EQUAL_UINT32(delayMs, manager.MsUntilNextStep(nowMs, 60000));
+    const int begins = hal.mqttBegins;
+    manager.Step(nowMs + delayMs - 1);
+    TEST_ASSERT_EQUAL_INT(begins, hal.mqttBegins);
+    nowMs += delayMs;
+    manager.Step(nowMs);
+    manager.Step(nowMs + 100);
+    TEST_ASSERT_EQUAL_INT(begins + 1, hal.mqttBegins);
+    nowMs += 100;
+    manager.OnMqttDisconnected(nowMs);
+  }
+  TEST_ASSERT_EQUAL_INT(1, hal.wifiBegins);
+}
+
+void test_portal_opens_keeps_retrying_and_closes_on_connect()
+{
+  FakeHal hal;
+  ConnectivityManager manager(hal, CONFIG);
+  manager.Begin(true, 0);
+
+  uint32_t nowMs = 0;
+  for (; nowMs < 60000; nowMs += 50)
+  {
+    manager.Step(nowMs);
+  }
+  TEST_ASSERT_FALSE(manager.PortalActive());
+  manager.Step(60000);
+  TEST_ASSERT_TRUE(manager.PortalActive());
+  TEST_ASSERT_EQUAL_INT(1, hal.portalStarts);
+
+  const int beginsAtPortal = hal.wifiBegins;
+  for (nowMs = 60000; nowMs < 180000; nowMs += 50)
+  {
+    manager.Step(nowMs);
+  }
+  TEST_ASSERT_TRUE(hal.wifiBegins > beginsAtPortal);
+  TEST_ASSERT_TRUE(manager.PortalActive());
+
+  manager.OnWifiConnected(nowMs);
+  TEST_ASSERT_FALSE(manager.PortalActive());
+  TEST_ASSERT_EQUAL_INT(1, hal.portalStops);
+  manager.Step(nowMs);
+  TEST_ASSERT_EQUAL_INT(1, hal.mqttBegins);
+
+  // A later outage opens it again after the same delay.
+  manager.OnWifiDisconnected(nowMs + 1000);
+  for (uint32_t t = nowMs + 1000; t <= nowMs + 61000; t += 50)
+  {
+    manager.Step(t);
+  }
+  TEST_ASSERT_EQUAL_INT(2, hal.portalStarts);
+  TEST_ASSERT_EQUAL_UINT32(2, manager.Stats().portalOpens);
+}
+
+void test_without_credentials_only_the_portal_runs()
+{
+  FakeHal hal;
+  ConnectivityManager manager(hal, CONFIG);
+  manager.Begin(false, 0);
+  for (uint32_t nowMs = 0; nowMs < 300000; nowMs += 1000)
+  {
+    manager.Step(nowMs);
+  }
+
+  TEST_ASSERT_TRUE(manager.PortalActive());
+  TEST_ASSERT_EQUAL_INT(1, hal.portalStarts);
+  TEST_ASSERT_EQUAL_INT(0, hal.wifiBegins);
+  TEST_ASSERT_EQUAL_UINT32(1000, manager.MsUntilNextStep(0, 1000));
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_backoff_starts_fast_then_doubles_with_jitter);
+  RUN_TEST(test_cold_start_connects_wifi_then_mqtt);
+  RUN_TEST(test_wifi_attempts_time_out_and_back_off);
+  RUN_TEST(test_drop_and_reconnect_is_measured);
+  RUN_TEST(test_broker_down_backs_off_without_overlapping_attempts);
+  RUN_TEST(test_portal_opens_keeps_retrying_and_closes_on_connect);
+  RUN_TEST(test_without_credentials_only_the_portal_runs);
+  return UNITY_END();
+}
@@ -0,0 +1,28 @@
+#include <unity.h>
+#include "iso_timestamp.h"
+#include "../counting_allocator.h"
+
+void test_formats_utc()
+{
+  TEST_ASSERT_EQUAL_STRING("2026-01-15T07:00:00Z", FormatIsoUtc(1768460400).CStr());
+  TEST_ASSERT_EQUAL_STRING("1970-01-01T00:00:00Z", FormatIsoUtc(0).CStr());
+  TEST_ASSERT_EQUAL_UINT32(20, FormatIsoUtc(1768460400).Length());
+}
+
+void test_does_not_allocate()
+{
+  const size_t before = allocationCount;
+  for (time_t at = 1768460400; at < 1768460400 + 1000; at += 7)
+  {
+    TEST_ASSERT_EQUAL_UINT32(20, FormatIsoUtc(at).Length());
+  }
+  TEST_ASSERT_EQUAL_UINT32(before, allocationCount);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_formats_utc);
+  RUN_TEST(test_does_not_allocate);
+  return UNITY_END();
+}
@@ -0,0 +1,93 @@
+#include <unity.h>
+#include "latency_histogram.h"
+#include "../counting_allocator.h"
+
+void test_buckets_cover_the_range_without_gaps()
+{
+  TEST_ASSERT_EQUAL_UINT32(0, LatencyHistogram::BucketLowerUs(0));
+  for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++)
+  {
+    TEST_ASSERT_EQUAL_UINT32(i, LatencyHistogram::BucketIndex(LatencyHistogram::BucketLowerUs(i)));
+    TEST_ASSERT_EQUAL_UINT32(i, LatencyHistogram::BucketIndex(LatencyHistogram::BucketUpperUs(i)));
+    if (i + 1 < LatencyHistogram::BUCKET_COUNT)
+    {
+      TEST_ASSERT_EQUAL_UINT32(LatencyHistogram::BucketUpperUs(i) + 1, LatencyHistogram::BucketLowerUs(i + 1));
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, LatencyHistogram::BucketUpperUs(LatencyHistogram::BUCKET_COUNT - 1));
+}
+
+void test_bucket_width_is_within_a_quarter()
+{
+  for (size_t i = LatencyHistogram::SUB_BUCKETS; i < LatencyHistogram::BUCKET_COUNT; i++)
+  {
+    const uint64_t lower = LatencyHistogram::BucketLowerUs(i);
+    const uint64_t upper = LatencyHistogram::BucketUpperUs(i);
+    TEST_ASSERT_TRUE((upper - lower) * 4 <= lower);
+  }
+}
+
+void test_percentiles_and_max()
+{
+  LatencyHistogram histogram;
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.PercentileUs(50));
+
+  for (int i = 0; i < 98; i++)
+  {
+    histogram.Record(100);
+  }
+  histogram.Record(2000);
+  histogram.Record(250000);
+
+  TEST_ASSERT_EQUAL_UINT32(100, histogram.Count());
+  TEST_ASSERT_EQUAL_UINT32(100, histogram.MinUs());
+  TEST_ASSERT_EQUAL_UINT32(250000, histogram.MaxUs());
+  TEST_ASSERT_EQUAL_UINT32(111, histogram.PercentileUs(50));
+  TEST_ASSERT_EQUAL_UINT32(2047, histogram.PercentileUs(99));
+  TEST_ASSERT_EQUAL_UINT32(250000, histogram.PercentileUs(100));
+}
+
+void test_single_sample_percentile_is_exact()
+{
+  LatencyHistogram histogram;
+  histogram.Record(1234);
+  TEST_ASSERT_EQUAL_UINT32(1234, histogram.PercentileUs(50));
+  TEST_ASSERT_EQUAL_UINT32(1234, histogram.PercentileUs(99));
+}
+
+void test_reset_clears_samples()
+{
+  LatencyHistogram histogram;
+  histogram.Record(10);
+  histogram.Record(UINT32_MAX);
+  histogram.Reset();
+
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.Count());
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.MinUs());
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.MaxUs());
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.PercentileUs(99));
+}
+
+void test_record_does_not_allocate()
+{
+  static LatencyHistogram histogram;
+  const size_t before = allocationCount;
+  for (uint32_t i = 0; i < 100000; i++)
+  {
+    histogram.Record(i * 37);
+  }
+  histogram.PercentileUs(99);
+  TEST_ASSERT_EQUAL_UINT32(before, allocationCount);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_buckets_cover_the_range_without_gaps);
+  RUN_TEST(test_bucket_width_is_within_a_quarter);
+  RUN_TEST(test_percentiles_and_max);
+  RUN_TEST(test_single_sample_percentile_is_exact);
+  RUN_TEST(test_reset_clears_samples);
+  RUN_TEST(test_record_does_not_allocate);
+  return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include "loop_monitor.h"
+
+enum Stage : uint8_t
+{
+  Events,
+  Network,
+  Tick,
+  Publish
+};
+
+static void runIteration(LoopMonitor& monitor, uint32_t& nowUs, uint32_t eventsUs, uint32_t networkUs, uint32_t tickUs)
+{
+  monitor.BeginIteration(Events, nowUs);
+  nowUs += eventsUs;
+  monitor.EnterStage(Network, nowUs);
+  nowUs += networkUs;
+  monitor.EnterStage(Tick, nowUs);
+  nowUs += tickUs;
+  monitor.EndIteration(nowUs);
+  // Idle wait between iterations is not part of the iteration.
+  nowUs += 50000;
+}
+
+void test_iterations_are_recorded()
+{
+  LoopMonitor monitor(100000);
+  uint32_t nowUs = 1000;
+  for (int i = 0; i < 10; i++)
+  {
+    runIteration(monitor, nowUs, 100, 200, 50);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(10, monitor.Iterations().Count());
+  TEST_ASSERT_EQUAL_UINT32(350, monitor.Iterations().MaxUs());
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.StallCount());
+  TEST_ASSERT_FALSE(monitor.StallPending());
+}
+
+void test_stall_snapshots_recent_stages_oldest_first()
+{
+  LoopMonitor monitor(100000);
+  uint32_t nowUs = 0;
+  runIteration(monitor, nowUs, 100, 200, 50);
+  const uint32_t stallStartUs = nowUs;
+  runIteration(monitor, nowUs, 100, 200000, 50);
+
+  TEST_ASSERT_EQUAL_UINT32(1, monitor.StallCount());
+  TEST_ASSERT_TRUE(monitor.StallPending());
+  const LoopStallSnapshot& stall = monitor.LastStall();
+  TEST_ASSERT_EQUAL_UINT32(200150, stall.iterationUs);
+  TEST_ASSERT_EQUAL_UINT32(6, stall.sampleCount);
+  TEST_ASSERT_EQUAL_UINT8(Events, stall.samples[0].stage);
+  TEST_ASSERT_EQUAL_UINT8(Network, stall.samples[4].stage);
+  TEST_ASSERT_EQUAL_UINT32(stallStartUs + 100, stall.samples[4].startUs);
+  TEST_ASSERT_EQUAL_UINT32(200000, stall.samples[4].durationUs);
+  TEST_ASSERT_EQUAL_UINT8(Tick, stall.samples[5].stage);
+
+  monitor.ClearStallPending();
+  TEST_ASSERT_FALSE(monitor.StallPending());
+  TEST_ASSERT_EQUAL_UINT32(1, monitor.StallCount());
+}
+
+void test_trace_keeps_only_the_latest_stages()
+{
+  LoopMonitor monitor(1000);
+  uint32_t nowUs = 0;
+  for (int i = 0; i < 20; i++)
+  {
+    runIteration(monitor, nowUs, 10, 10, 10);
+  }
+  monitor.BeginIteration(Events, nowUs);
+  monitor.EnterStage(Publish, nowUs + 10);
+  monitor.EndIteration(nowUs + 5000);
+
+  const LoopStallSnapshot& stall = monitor.LastStall();
+  TEST_ASSERT_EQUAL_UINT32(LoopStallSnapshot::MAX_SAMPLES, stall.sampleCount);
+  TEST_ASSERT_EQUAL_UINT8(Events, stall.samples[LoopStallSnapshot::MAX_SAMPLES - 2].stage);
+  TEST_ASSERT_EQUAL_UINT8(Publish, stall.samples[LoopStallSnapshot::MAX_SAMPLES - 1].stage);
+  TEST_ASSERT_EQUAL_UINT32(4990, stall.samples[LoopStallSnapshot::MAX_SAMPLES - 1].durationUs);
+  for (size_t i = 1; i < stall.sampleCount; i++)
+  {
+    TEST_ASSERT_TRUE(stall.samples[i].startUs >= stall.samples[i - 1].startUs);
+  }
+}
+
+void test_micros_wraparound()
+{
+  LoopMonitor monitor(100000);
+  uint32_t nowUs = UINT32_MAX - 150;
+  runIteration(monitor, nowUs, 100, 100, 100);
+
+  TEST_ASSERT_EQUAL_UINT32(300, monitor.Iterations().MaxUs());
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.StallCount());
+}
+
+void test_decisions_and_window_reset()
+{
+  LoopMonitor monitor(100000);
+  uint32_t nowUs = 0;
+  runIteration(monitor, nowUs, 10, 10, 10);
+  monitor.RecordDecision(40);
+  monitor.RecordDecision(900);
+  TEST_ASSERT_EQUAL_UINT32(2, monitor.Decisions().Count());
+  TEST_ASSERT_EQUAL_UINT32(900, monitor.Decisions().MaxUs());
+
+  monitor.ResetWindow();
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.Decisions().Count());
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.Iterations().Count());
+}
+
+void test_end_without_begin_is_ignored()
+{
+  LoopMonitor monitor(10);
+  TEST_ASSERT_FALSE(monitor.EndIteration(1000));
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.Iterations().Count());
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_iterations_are_recorded);
+  RUN_TEST(test_stall_snapshots_recent_stages_oldest_first);
+  RUN_TEST(test_trace_keeps_only_the_latest_stages);
+  RUN_TEST(test_micros_wraparound);
+  RUN_TEST(test_decisions_and_window_reset);
+  RUN_TEST(test_end_without_begin_is_ignored);
+  return UNITY_END();
+}
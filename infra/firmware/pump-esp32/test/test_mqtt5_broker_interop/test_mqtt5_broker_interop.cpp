@@ -0,0 +1,406 @@
+#include <unity.h>
+
+// Talks MQTT 5 to a real broker with the client's own encoders and parser. Skipped unless
+// MQTT_INTEROP_HOST is set, e.g. against infra/docker-compose.yml:
+//   docker compose -f infra/docker-compose.yml up -d mqtt
+//   MQTT_INTEROP_HOST=localhost pio test -e native -f test_mqtt5_broker_interop -v
+// POSIX sockets only; on Windows hosts the suite is empty.
+
+#if defined(_WIN32)
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  return UNITY_END();
+}
+#else
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncMqttClient/Flags.hpp"
+#include "AsyncMqttClient/Packets/PacketParser.hpp"
+#include "AsyncMqttClient/Packets/Out/Connect.hpp"
+#include "AsyncMqttClient/Packets/Out/Disconn.hpp"
+#include "AsyncMqttClient/Packets/Out/PubAck.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+#include "AsyncMqttClient/Packets/Out/Subscribe.hpp"
+#include "AsyncMqttClient/Packets/Out/TopicAliases.hpp"
+
+using AsyncMqttClientInternals::ConnAckProperties;
+using AsyncMqttClientInternals::ConnectOutPacket;
+using AsyncMqttClientInternals::DisconnOutPacket;
+using AsyncMqttClientInternals::PacketHandler;
+using AsyncMqttClientInternals::PacketParser;
+using AsyncMqttClientInternals::PendingAck;
+using AsyncMqttClientInternals::PubAckOutPacket;
+using AsyncMqttClientInternals::PublishOutPacket;
+using AsyncMqttClientInternals::SubscribeOutPacket;
+using AsyncMqttClientInternals::TopicAliasTable;
+
+static const uint8_t V5 = AsyncMqttClientInternals::ProtocolVersion.V5;
+static const uint16_t KEEP_ALIVE_SECONDS = 30;
+static const int WAIT_MS = 3000;
+
+struct Message
+{
+  std::string topic;
+  std::string payload;
+  uint16_t packetId;
+};
+
+/// <summary>
+/// One broker connection: writes raw packets and collects what the parser decodes.
+/// </summary>
+class BrokerConnection : public PacketHandler
+{
+public:
+  BrokerConnection()
+    : parser_(this)
+  {
+    parser_.setTopicBuffer(topic_, sizeof(topic_) - 1);
+    parser_.setProtocolVersion(V5);
+  }
+
+  ~BrokerConnection()
+  {
+    Close();
+  }
+
+  bool Open(const char* host, const char* port)
+  {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host, port, &hints, &found) != 0)
+    {
+      return false;
+    }
+    for (addrinfo* candidate = found; candidate != nullptr && fd_ < 0; candidate = candidate->ai_next)
+    {
+      fd_ = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+      if (fd_ >= 0 && connect(fd_, candidate->ai_addr, candidate->ai_addrlen) != 0)
+      {
+        close(fd_);
+        fd_ = -1;
+      }
+    }
+    freeaddrinfo(found);
+    return fd_ >= 0;
+  }
+
+  void Close()
+  {
+    if (fd_ >= 0)
+    {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  void Send(const uint8_t* data, size_t length)
+  {
+    while (length > 0)
+    {
+      const ssize_t written = send(fd_, data, length, 0);
+      TEST_ASSERT_TRUE(written > 0);
+      data += written;
+      length -= static_cast<size_t>(written);
+    }
+  }
+
+  template <typename Packet>
+  void Send(const Packet& packet)
+  {
+    Send(packet.data(), packet.size());
+  }
+
+  // Reads until the condition holds; false on timeout or when the broker closes the connection.
+  template <typename Condition>
+  bool WaitFor(Condition condition, int timeoutMs = WAIT_MS)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition())
+    {
+      const int leftMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count());
+      pollfd readable = { fd_, POLLIN, 0 };
+      if (leftMs <= 0 || poll(&readable, 1, leftMs) <= 0)
+      {
+        return false;
+      }
+      char buffer[512];
+      const ssize_t received = recv(fd_, buffer, sizeof(buffer), 0);
+      if (received <= 0)
+      {
+        closedByBroker = true;
+        return false;
+      }
+      parser_.parse(buffer, static_cast<size_t>(received));
+    }
+    return true;
+  }
+
+  bool Connect(const char* clientId, bool cleanSession, uint32_t sessionExpirySeconds)
+  {
+    connAcked = false;
+    Send(ConnectOutPacket(cleanSession, nullptr, nullptr, nullptr, false, 0, nullptr, 0, KEEP_ALIVE_SECONDS,
+                          clientId, V5, sessionExpirySeconds));
+    return WaitFor([this] { return connAcked; }) && connAckCode == 0;
+  }
+
+  bool Subscribe(const char* topic)
+  {
+    std::vector<uint8_t> buffer(SubscribeOutPacket::neededSpace(topic, V5));
+    const SubscribeOutPacket subscribe(topic, 1, buffer.data(), V5);
+    const uint32_t subAcksBefore = subAcks;
+    Send(subscribe);
+    return WaitFor([this, subAcksBefore] { return subAcks > subAcksBefore; }) && subAckStatus == 1;
+  }
+
+  void Acknowledge(uint16_t packetId)
+  {
+    const PendingAck pendingAck = { AsyncMqttClientInternals::PacketType.PUBACK,
+                                    AsyncMqttClientInternals::HeaderFlag.PUBACK_RESERVED, packetId };
+    Send(PubAckOutPacket(pendingAck));
+  }
+
+  void _onConnAck(bool sessionPresent, uint8_t connectReturnCode, const ConnAckProperties& properties) override
+  {
+    connAcked = true;
+    this->sessionPresent = sessionPresent;
+    connAckCode = connectReturnCode;
+    connAck = properties;
+  }
+
+  void _onPingResp() override {}
+
+  void _onSubAck(uint16_t, char status) override
+  {
+    subAcks++;
+    subAckStatus = static_cast<uint8_t>(status);
+  }
+
+  void _onUnsubAck(uint16_t) override {}
+
+  void _onMessage(char* topic, char* payload, uint8_t, bool, bool, size_t len, size_t index, size_t total,
+                  uint16_t packetId) override
+  {
+    if (index == 0)
+    {
+      partial_.assign(payload, len);
+    }
+    else
+    {
+      partial_.append(payload, len);
+    }
+    if (index + len == total)
+    {
+      messages.push_back({ topic, partial_, packetId });
+    }
+  }
+
+  void _onPublish(uint16_t, uint8_t) override {}
+  void _onPubRel(uint16_t) override {}
+
+  void _onPubAck(uint16_t packetId) override
+  {
+    pubAcks.push_back(packetId);
+  }
+
+  void _onPubRec(uint16_t) override {}
+  void _onPubComp(uint16_t) override {}
+
+  void _onServerDisconnect(uint8_t reasonCode) override
+  {
+    serverDisconnectReason = reasonCode;
+    closedByBroker = true;
+  }
+
+  void _onProtocolViolation() override
+  {
+    protocolViolation = true;
+  }
+
+  bool connAcked = false;
+  bool sessionPresent = false;
+  uint8_t connAckCode = 0xFF;
+  ConnAckProperties connAck = {};
+  uint32_t subAcks = 0;
+  uint8_t subAckStatus = 0xFF;
+  std::vector<Message> messages;
+  std::vector<uint16_t> pubAcks;
+  bool closedByBroker = false;
+  uint8_t serverDisconnectReason = 0;
+  bool protocolViolation = false;
+
+private:
+  int fd_ = -1;
+  PacketParser parser_;
+  char topic_[256];
+  std::string partial_;
+};
+
+static const char* brokerHost()
+{
+  const char* host = std::getenv("MQTT_INTEROP_HOST");
+  return host != nullptr && host[0] != '\0' ? host : nullptr;
+}
+
+static const char* brokerPort()
+{
+  const char* port = std::getenv("MQTT_INTEROP_PORT");
+  return port != nullptr ? port : "1883";
+}
+
+// Topics and client ids unique to this run, so reruns against one broker do not mix.
+static std::string scoped(const char* suffix)
+{
+  return "interop-" + std::to_string(getpid()) + "/" + suffix;
+}
+
+static void openOrSkip(BrokerConnection& connection)
+{
+  if (brokerHost() == nullptr)
+  {
+    TEST_IGNORE_MESSAGE("MQTT_INTEROP_HOST not set");
+  }
+  TEST_ASSERT_TRUE(connection.Open(brokerHost(), brokerPort()));
+}
+
+/// <summary>
+/// A QoS 1 PUBLISH as the backend sends pump/cmd: MQTT 5 with a Message Expiry Interval.
+/// </summary>
+static std::vector<uint8_t> commandWithExpiry(const std::string& topic, uint16_t packetId, uint32_t expirySeconds,
+                                              const std::string& payload)
+{
+  std::vector<uint8_t> wire = { 0x32, 0 };
+  wire.push_back(static_cast<uint8_t>(topic.size() >> 8));
+  wire.push_back(static_cast<uint8_t>(topic.size() & 0xFF));
+  wire.insert(wire.end(), topic.begin(), topic.end());
+  wire.push_back(static_cast<uint8_t>(packetId >> 8));
+  wire.push_back(static_cast<uint8_t>(packetId & 0xFF));
+  wire.push_back(5);
+  wire.push_back(AsyncMqttClientInternals::Property.MESSAGE_EXPIRY_INTERVAL);
+  for (int shift = 24; shift >= 0; shift -= 8)
+  {
+    wire.push_back(static_cast<uint8_t>(expirySeconds >> shift));
+  }
+  wire.insert(wire.end(), payload.begin(), payload.end());
+  TEST_ASSERT_TRUE(wire.size() - 2 < 128);
+  wire[1] = static_cast<uint8_t>(wire.size() - 2);
+  return wire;
+}
+
+void test_topic_aliases_are_resolved_by_the_broker()
+{
+  BrokerConnection subscriber;
+  openOrSkip(subscriber);
+  TEST_ASSERT_TRUE(subscriber.Connect(scoped("sub").c_str(), true, 0));
+  TEST_ASSERT_TRUE(subscriber.Subscribe(scoped("pump/#").c_str()));
+
+  BrokerConnection publisher;
+  openOrSkip(publisher);
+  TEST_ASSERT_TRUE(publisher.Connect(scoped("pump").c_str(), true, 0));
+  TEST_ASSERT_TRUE(publisher.connAck.topicAliasMaximum > 0);
+  TopicAliasTable aliases;
+  aliases.reset(publisher.connAck.topicAliasMaximum);
+
+  const std::string state = scoped("pump/state");
+  const std::string diag = scoped("pump/diag");
+  const std::string topics[] = { state, state, diag, state };
+  for (size_t i = 0; i < 4; i++)
+  {
+    const std::string payload = "{\"n\":" + std::to_string(i) + "}";
+    std::vector<uint8_t> buffer(PublishOutPacket::neededSpace(topics[i].c_str(), 1, payload.c_str(), payload.size(), V5));
+    PublishOutPacket packet(topics[i].c_str(), 1, false, payload.c_str(), payload.size(), buffer.data(), V5);
+    bool assigned;
+    const uint16_t alias = aliases.lookup(topics[i].c_str(), topics[i].size(), &assigned);
+    packet.setTopicAlias(alias, assigned);
+    // The second and fourth go out as alias only, with an empty topic.
+    TEST_ASSERT_EQUAL_INT(i == 1 || i == 3 ? 0 : 1, assigned ? 1 : 0);
+    publisher.Send(packet);
+    const uint16_t packetId = packet.packetId();
+    TEST_ASSERT_TRUE(publisher.WaitFor([&publisher, packetId]
+    {
+      return !publisher.pubAcks.empty() && publisher.pubAcks.back() == packetId;
+    }));
+  }
+  TEST_ASSERT_FALSE(publisher.closedByBroker);
+
+  TEST_ASSERT_TRUE(subscriber.WaitFor([&subscriber] { return subscriber.messages.size() == 4; }));
+  for (size_t i = 0; i < 4; i++)
+  {
+    TEST_ASSERT_EQUAL_STRING(topics[i].c_str(), subscriber.messages[i].topic.c_str());
+    TEST_ASSERT_EQUAL_STRING(("{\"n\":" + std::to_string(i) + "}").c_str(), subscriber.messages[i].payload.c_str());
+    subscriber.Acknowledge(subscriber.messages[i].packetId);
+  }
+  TEST_ASSERT_FALSE(subscriber.protocolViolation);
+  publisher.Send(DisconnOutPacket());
+  subscriber.Send(DisconnOutPacket());
+}
+
+void test_expired_pump_cmd_is_dropped_from_the_offline_session()
+{
+  const std::string clientId = scoped("pump-session");
+  const std::string topic = scoped("pump/cmd");
+  {
+    BrokerConnection pump;
+    openOrSkip(pump);
+    TEST_ASSERT_TRUE(pump.Connect(clientId.c_str(), true, 300));
+    TEST_ASSERT_TRUE(pump.Subscribe(topic.c_str()));
+    pump.Send(DisconnOutPacket());
+  }
+
+  {
+    BrokerConnection backend;
+    openOrSkip(backend);
+    TEST_ASSERT_TRUE(backend.Connect(scoped("backend").c_str(), true, 0));
+    const std::vector<uint8_t> expiring = commandWithExpiry(topic, 1, 1, "{\"action\":\"start\"}");
+    const std::vector<uint8_t> lasting = commandWithExpiry(topic, 2, 120, "{\"action\":\"stop\"}");
+    backend.Send(expiring.data(), expiring.size());
+    backend.Send(lasting.data(), lasting.size());
+    TEST_ASSERT_TRUE(backend.WaitFor([&backend] { return backend.pubAcks.size() == 2; }));
+    backend.Send(DisconnOutPacket());
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+
+  BrokerConnection pump;
+  openOrSkip(pump);
+  TEST_ASSERT_TRUE(pump.Connect(clientId.c_str(), false, 300));
+  TEST_ASSERT_TRUE(pump.sessionPresent);
+  TEST_ASSERT_TRUE(pump.WaitFor([&pump] { return !pump.messages.empty(); }));
+  // Anything else queued would arrive right behind the first message.
+  pump.WaitFor([] { return false; }, 500);
+  TEST_ASSERT_EQUAL_UINT32(1, pump.messages.size());
+  TEST_ASSERT_EQUAL_STRING(topic.c_str(), pump.messages[0].topic.c_str());
+  TEST_ASSERT_EQUAL_STRING("{\"action\":\"stop\"}", pump.messages[0].payload.c_str());
+  TEST_ASSERT_FALSE(pump.protocolViolation);
+  pump.Acknowledge(pump.messages[0].packetId);
+
+  // End the stored session.
+  BrokerConnection cleanup;
+  openOrSkip(cleanup);
+  TEST_ASSERT_TRUE(cleanup.Connect(clientId.c_str(), true, 0));
+  cleanup.Send(DisconnOutPacket());
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_topic_aliases_are_resolved_by_the_broker);
+  RUN_TEST(test_expired_pump_cmd_is_dropped_from_the_offline_session);
+  return UNITY_END();
+}
+
+#endif
@@ -0,0 +1,398 @@
+#include <unity.h>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "AsyncMqttClient/Packets/Out/Connect.hpp"
+#include "AsyncMqttClient/Packets/Out/OutPacketPool.hpp"
+#include "AsyncMqttClient/Packets/Out/OutQueue.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+#include "AsyncMqttClient/Packets/Out/Subscribe.hpp"
+#include "AsyncMqttClient/Packets/Out/TopicAliases.hpp"
+#include "AsyncMqttClient/Packets/Out/Unsubscribe.hpp"
+
+using AsyncMqttClientInternals::ConnectOutPacket;
+using AsyncMqttClientInternals::OutPacket;
+using AsyncMqttClientInternals::OutPacketPool;
+using AsyncMqttClientInternals::OutQueue;
+using AsyncMqttClientInternals::OutTransport;
+using AsyncMqttClientInternals::PublishOutPacket;
+using AsyncMqttClientInternals::SubscribeOutPacket;
+using AsyncMqttClientInternals::TopicAliasTable;
+using AsyncMqttClientInternals::UnsubscribeOutPacket;
+
+static const uint8_t V5 = AsyncMqttClientInternals::ProtocolVersion.V5;
+static const uint8_t PUBLISH = AsyncMqttClientInternals::PacketType.PUBLISH;
+
+/// <summary>
+/// One MQTT 5 PUBLISH as a broker would read it.
+/// </summary>
+struct Publish5
+{
+  uint8_t flags;
+  std::string topic;
+  uint16_t packetId;
+  uint16_t alias;
+  std::string payload;
+};
+
+static std::vector<uint8_t> bytesOf(const OutPacket& packet)
+{
+  return std::vector<uint8_t>(packet.data(), packet.data() + packet.size());
+}
+
+static std::vector<uint8_t> bytes(std::initializer_list<uint8_t> values)
+{
+  return std::vector<uint8_t>(values);
+}
+
+static std::vector<uint8_t> operator+(std::vector<uint8_t> left, const std::string& right)
+{
+  left.insert(left.end(), right.begin(), right.end());
+  return left;
+}
+
+static std::vector<uint8_t> operator+(std::vector<uint8_t> left, const std::vector<uint8_t>& right)
+{
+  left.insert(left.end(), right.begin(), right.end());
+  return left;
+}
+
+/// <summary>
+/// Decodes the PUBLISH at `at` and advances past it; the remaining length must match the bytes.
+/// </summary>
+static Publish5 decodePublish(const std::vector<uint8_t>& wire, size_t& at)
+{
+  Publish5 publish = { wire[at], "", 0, 0, "" };
+  TEST_ASSERT_EQUAL_UINT8(PUBLISH, publish.flags >> 4);
+  size_t remaining = 0;
+  size_t multiplier = 1;
+  size_t index = at + 1;
+  uint8_t digit;
+  do
+  {
+    digit = wire[index++];
+    remaining += (digit & 0x7F) * multiplier;
+    multiplier *= 128;
+  } while (digit & 0x80);
+  const size_t end = index + remaining;
+  TEST_ASSERT_TRUE(end <= wire.size());
+
+  const size_t topicLength = (wire[index] << 8) | wire[index + 1];
+  publish.topic.assign(reinterpret_cast<const char*>(&wire[index + 2]), topicLength);
+  index += 2 + topicLength;
+  if ((publish.flags & 0x06) != 0)
+  {
+    publish.packetId = (wire[index] << 8) | wire[index + 1];
+    index += 2;
+  }
+  const size_t propertiesEnd = index + 1 + wire[index];
+  for (index++; index < propertiesEnd;)
+  {
+    TEST_ASSERT_EQUAL_HEX8(AsyncMqttClientInternals::Property.TOPIC_ALIAS, wire[index]);
+    publish.alias = (wire[index + 1] << 8) | wire[index + 2];
+    index += 3;
+  }
+  publish.payload.assign(reinterpret_cast<const char*>(&wire[index]), end - index);
+  at = end;
+  return publish;
+}
+
+static Publish5 decodePublish(const OutPacket& packet)
+{
+  const std::vector<uint8_t> wire = bytesOf(packet);
+  size_t at = 0;
+  const Publish5 publish = decodePublish(wire, at);
+  TEST_ASSERT_EQUAL_UINT32(wire.size(), at);
+  return publish;
+}
+
+/// <summary>
+/// Records the wire bytes and, like AsyncMqttClient, sets topic aliases as packets start.
+/// </summary>
+class AliasingTransport : public OutTransport
+{
+public:
+  size_t space() override
+  {
+    return 5744;
+  }
+
+  size_t add(const char* data, size_t size) override
+  {
+    bytes_.insert(bytes_.end(), data, data + size);
+    return size;
+  }
+
+  bool send() override
+  {
+    return true;
+  }
+
+  void prepare(OutPacket& packet) override
+  {
+    PublishOutPacket& publish = static_cast<PublishOutPacket&>(packet);
+    uint16_t topicLength;
+    const char* topic = publish.topic(&topicLength);
+    bool assigned;
+    const uint16_t alias = aliases.lookup(topic, topicLength, &assigned);
+    publish.setTopicAlias(alias, assigned);
+    prepared++;
+  }
+
+  std::vector<Publish5> Publishes() const
+  {
+    std::vector<Publish5> publishes;
+    size_t at = 0;
+    while (at < bytes_.size())
+    {
+      publishes.push_back(decodePublish(bytes_, at));
+    }
+    return publishes;
+  }
+
+  TopicAliasTable aliases;
+  int prepared = 0;
+
+private:
+  std::vector<uint8_t> bytes_;
+};
+
+static OutPacket* makePublish5(OutPacketPool& pool, const char* topic, const char* payload)
+{
+  const size_t length = strlen(payload);
+  void* slot = pool.acquire(sizeof(PublishOutPacket) + PublishOutPacket::neededSpace(topic, 1, payload, length, V5), false);
+  return new (slot) PublishOutPacket(topic, 1, false, payload, length, static_cast<uint8_t*>(slot) + sizeof(PublishOutPacket), V5);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_connect_v5_carries_session_expiry_and_will_properties()
+{
+  ConnectOutPacket v5(false, "u", "p", "t/a", true, 1, "offline", 0, 15, "pump", V5, 86400);
+  const std::vector<uint8_t> expected5 =
+    bytes({ 0x10, 43, 0x00, 0x04 }) + "MQTT" + bytes({ 0x05, 0xEC, 0x00, 0x0F }) +
+    bytes({ 0x05, 0x11, 0x00, 0x01, 0x51, 0x80 }) +  // Session Expiry Interval 86400 s
+    bytes({ 0x00, 0x04 }) + "pump" +
+    bytes({ 0x00, 0x00, 0x03 }) + "t/a" + bytes({ 0x00, 0x07 }) + "offline" +  // empty will properties
+    bytes({ 0x00, 0x01 }) + "u" + bytes({ 0x00, 0x01 }) + "p";
+  TEST_ASSERT_EQUAL_UINT32(expected5.size(), v5.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected5.data(), v5.data(), expected5.size());
+
+  ConnectOutPacket noExpiry(true, nullptr, nullptr, nullptr, false, 0, nullptr, 0, 15, "pump", V5, 0);
+  const std::vector<uint8_t> expectedNoExpiry =
+    bytes({ 0x10, 17, 0x00, 0x04 }) + "MQTT" + bytes({ 0x05, 0x02, 0x00, 0x0F, 0x00, 0x00, 0x04 }) + "pump";
+  TEST_ASSERT_EQUAL_UINT32(expectedNoExpiry.size(), noExpiry.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedNoExpiry.data(), noExpiry.data(), expectedNoExpiry.size());
+
+  // MQTT 3.1.1 stays as it was; the session expiry has no field there.
+  ConnectOutPacket v311(false, "u", "p", "t/a", true, 1, "offline", 0, 15, "pump");
+  const std::vector<uint8_t> expected311 =
+    bytes({ 0x10, 36, 0x00, 0x04 }) + "MQTT" + bytes({ 0x04, 0xEC, 0x00, 0x0F }) +
+    bytes({ 0x00, 0x04 }) + "pump" + bytes({ 0x00, 0x03 }) + "t/a" + bytes({ 0x00, 0x07 }) + "offline" +
+    bytes({ 0x00, 0x01 }) + "u" + bytes({ 0x00, 0x01 }) + "p";
+  TEST_ASSERT_EQUAL_UINT32(expected311.size(), v311.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected311.data(), v311.data(), expected311.size());
+}
+
+void test_subscribe_and_unsubscribe_v5_have_empty_properties()
+{
+  std::vector<uint8_t> subscribeBuffer(SubscribeOutPacket::neededSpace("a/b", V5));
+  SubscribeOutPacket subscribe("a/b", 1, subscribeBuffer.data(), V5);
+  const uint8_t subscribeId[] = { static_cast<uint8_t>(subscribe.packetId() >> 8), static_cast<uint8_t>(subscribe.packetId() & 0xFF) };
+  const std::vector<uint8_t> expectedSubscribe =
+    bytes({ 0x82, 9, subscribeId[0], subscribeId[1], 0x00, 0x00, 0x03 }) + "a/b" + bytes({ 0x01 });
+  TEST_ASSERT_EQUAL_UINT32(subscribeBuffer.size(), subscribe.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedSubscribe.data(), subscribe.data(), expectedSubscribe.size());
+
+  std::vector<uint8_t> unsubscribeBuffer(UnsubscribeOutPacket::neededSpace("a/b", V5));
+  UnsubscribeOutPacket unsubscribe("a/b", unsubscribeBuffer.data(), V5);
+  const uint8_t unsubscribeId[] = { static_cast<uint8_t>(unsubscribe.packetId() >> 8), static_cast<uint8_t>(unsubscribe.packetId() & 0xFF) };
+  const std::vector<uint8_t> expectedUnsubscribe =
+    bytes({ 0xA2, 8, unsubscribeId[0], unsubscribeId[1], 0x00, 0x00, 0x03 }) + "a/b";
+  TEST_ASSERT_EQUAL_UINT32(unsubscribeBuffer.size(), unsubscribe.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedUnsubscribe.data(), unsubscribe.data(), expectedUnsubscribe.size());
+}
+
+void test_publish_v5_switches_between_topic_and_alias_forms()
+{
+  std::vector<uint8_t> buffer(PublishOutPacket::neededSpace("a/b", 1, "hi", 2, V5));
+  PublishOutPacket packet("a/b", 1, false, "hi", 2, buffer.data(), V5);
+  const uint8_t id[] = { static_cast<uint8_t>(packet.packetId() >> 8), static_cast<uint8_t>(packet.packetId() & 0xFF) };
+
+  const std::vector<uint8_t> plain = bytes({ 0x32, 10, 0x00, 0x03 }) + "a/b" + bytes({ id[0], id[1], 0x00 }) + "hi";
+  TEST_ASSERT_EQUAL_UINT32(plain.size(), packet.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(plain.data(), packet.data(), plain.size());
+
+  packet.setTopicAlias(1, true);
+  const std::vector<uint8_t> establish = bytes({ 0x32, 13, 0x00, 0x03 }) + "a/b" + bytes({ id[0], id[1], 0x03, 0x23, 0x00, 0x01 }) + "hi";
+  TEST_ASSERT_EQUAL_UINT32(buffer.size(), packet.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(establish.data(), packet.data(), establish.size());
+
+  packet.setDup();
+  packet.setTopicAlias(1, false);
+  const std::vector<uint8_t> aliasOnly = bytes({ 0x3A, 10, 0x00, 0x00, id[0], id[1], 0x03, 0x23, 0x00, 0x01 }) + "hi";
+  TEST_ASSERT_EQUAL_UINT32(aliasOnly.size(), packet.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(aliasOnly.data(), packet.data(), aliasOnly.size());
+  uint16_t topicLength;
+  const char* topic = packet.topic(&topicLength);
+  TEST_ASSERT_EQUAL_UINT16(3, topicLength);
+  TEST_ASSERT_EQUAL_MEMORY("a/b", topic, 3);
+
+  // Back to the full topic on a connection without aliases; DUP is kept.
+  packet.setTopicAlias(0, false);
+  std::vector<uint8_t> plainDup = plain;
+  plainDup[0] = 0x3A;
+  TEST_ASSERT_EQUAL_UINT32(plainDup.size(), packet.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(plainDup.data(), packet.data(), plainDup.size());
+}
+
+void test_publish_v5_forms_agree_across_length_boundaries()
+{
+  const std::string topic = "home/veranda/WateringController/pump/state";
+  // Remaining length of the form with the topic = 2 + topic + 2 + 4 + payload; probe each side of 127/128 and 16383/16384.
+  const size_t overhead = 2 + topic.size() + 2 + 4;
+  const size_t boundaries[] = { 127, 128, 16383, 16384 };
+  for (size_t boundary : boundaries)
+  {
+    for (size_t length = boundary - overhead - 1; length <= boundary - overhead + topic.size() + 1; length++)
+    {
+      const std::string payload(length, 'p');
+      std::vector<uint8_t> buffer(PublishOutPacket::reservedSpace(topic.c_str(), 1, length + 300, V5));
+      PublishOutPacket packet(topic.c_str(), 1, true, length + 300, buffer.data(), V5);
+      memcpy(packet.payload(), payload.data(), length);
+      packet.commit(length);
+
+      packet.setTopicAlias(7, true);
+      Publish5 decoded = decodePublish(packet);
+      TEST_ASSERT_EQUAL_STRING(topic.c_str(), decoded.topic.c_str());
+      TEST_ASSERT_EQUAL_UINT16(7, decoded.alias);
+      TEST_ASSERT_TRUE(decoded.payload == payload);
+
+      packet.setTopicAlias(7, false);
+      decoded = decodePublish(packet);
+      TEST_ASSERT_EQUAL_UINT32(0, decoded.topic.size());
+      TEST_ASSERT_EQUAL_UINT16(7, decoded.alias);
+      TEST_ASSERT_EQUAL_UINT16(packet.packetId(), decoded.packetId);
+      TEST_ASSERT_EQUAL_HEX8(0x33, decoded.flags);
+      TEST_ASSERT_TRUE(decoded.payload == payload);
+
+      packet.setTopicAlias(0, false);
+      decoded = decodePublish(packet);
+      TEST_ASSERT_EQUAL_STRING(topic.c_str(), decoded.topic.c_str());
+      TEST_ASSERT_EQUAL_UINT16(0, decoded.alias);
+      TEST_ASSERT_TRUE(decoded.payload == payload);
+    }
+  }
+}
+
+void test_publish_v311_ignores_topic_aliases()
+{
+  std::vector<uint8_t> buffer(PublishOutPacket::neededSpace("a/b", 0, "hi", 2));
+  PublishOutPacket packet("a/b", 0, false, "hi", 2, buffer.data());
+  const std::vector<uint8_t> before = bytesOf(packet);
+  packet.setTopicAlias(1, false);
+  TEST_ASSERT_TRUE(bytesOf(packet) == before);
+  TEST_ASSERT_EQUAL_UINT16(0, packet.topicAlias());
+}
+
+void test_alias_table_assigns_up_to_the_broker_maximum()
+{
+  TopicAliasTable table;
+  bool assigned;
+  TEST_ASSERT_EQUAL_UINT16(0, table.lookup("a", 1, &assigned));
+
+  table.reset(2);
+  TEST_ASSERT_EQUAL_UINT16(1, table.lookup("a", 1, &assigned));
+  TEST_ASSERT_TRUE(assigned);
+  TEST_ASSERT_EQUAL_UINT16(1, table.lookup("a", 1, &assigned));
+  TEST_ASSERT_FALSE(assigned);
+  // Same bytes up to a shorter length are a different topic.
+  TEST_ASSERT_EQUAL_UINT16(2, table.lookup("ab", 2, &assigned));
+  TEST_ASSERT_TRUE(assigned);
+  TEST_ASSERT_EQUAL_UINT16(0, table.lookup("c", 1, &assigned));
+  TEST_ASSERT_FALSE(assigned);
+
+  table.reset(1000);
+  TEST_ASSERT_EQUAL_UINT8(TopicAliasTable::MAX_ALIASES, table.capacity());
+  TEST_ASSERT_EQUAL_UINT8(0, table.size());
+  const std::string longTopic(TopicAliasTable::TOPIC_BYTES - 10, 't');
+  TEST_ASSERT_EQUAL_UINT16(1, table.lookup(longTopic.data(), longTopic.size(), &assigned));
+  TEST_ASSERT_EQUAL_UINT16(0, table.lookup(longTopic.data(), 11, &assigned));
+  TEST_ASSERT_EQUAL_UINT16(2, table.lookup(longTopic.data(), 10, &assigned));
+}
+
+void test_queue_sets_up_aliases_in_wire_order_and_again_after_reconnect()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(16, 256, 2));
+  OutQueue queue(pool);
+  queue.setWindow(4);
+  AliasingTransport transport;
+  transport.aliases.reset(10);
+
+  std::vector<uint16_t> ids;
+  const char* topics[] = { "pump/state", "pump/state", "pump/diag", "pump/state" };
+  for (const char* topic : topics)
+  {
+    OutPacket* packet = makePublish5(pool, topic, "{}");
+    ids.push_back(packet->packetId());
+    queue.pushBack(packet);
+  }
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_INT(4, transport.prepared);
+  TEST_ASSERT_EQUAL_UINT32(0, queue.queuedBytes());
+
+  std::vector<Publish5> sent = transport.Publishes();
+  TEST_ASSERT_EQUAL_UINT32(4, sent.size());
+  TEST_ASSERT_EQUAL_STRING("pump/state", sent[0].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT16(1, sent[0].alias);
+  TEST_ASSERT_EQUAL_STRING("", sent[1].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT16(1, sent[1].alias);
+  TEST_ASSERT_EQUAL_STRING("pump/diag", sent[2].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT16(2, sent[2].alias);
+  TEST_ASSERT_EQUAL_STRING("", sent[3].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT16(1, sent[3].alias);
+
+  // The connection drops before any PUBACK. The new connection starts without aliases,
+  // so the resent packets set them up again; the byte count follows the re-rendered sizes.
+  queue.clear(true);
+  TEST_ASSERT_TRUE(queue.queuedBytes() > 0);
+  AliasingTransport reconnected;
+  reconnected.aliases.reset(10);
+  queue.write(reconnected);
+  TEST_ASSERT_EQUAL_UINT32(0, queue.queuedBytes());
+  sent = reconnected.Publishes();
+  TEST_ASSERT_EQUAL_UINT32(4, sent.size());
+  TEST_ASSERT_EQUAL_STRING("pump/state", sent[0].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT16(1, sent[0].alias);
+  TEST_ASSERT_EQUAL_HEX8(0x3A, sent[0].flags);
+  TEST_ASSERT_EQUAL_STRING("", sent[1].topic.c_str());
+  TEST_ASSERT_EQUAL_STRING("pump/diag", sent[2].topic.c_str());
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    TEST_ASSERT_EQUAL_UINT16(ids[i], sent[i].packetId);
+    TEST_ASSERT_TRUE(queue.acknowledge(PUBLISH, ids[i]));
+  }
+  TEST_ASSERT_TRUE(queue.empty());
+  TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_connect_v5_carries_session_expiry_and_will_properties);
+  RUN_TEST(test_subscribe_and_unsubscribe_v5_have_empty_properties);
+  RUN_TEST(test_publish_v5_switches_between_topic_and_alias_forms);
+  RUN_TEST(test_publish_v5_forms_agree_across_length_boundaries);
+  RUN_TEST(test_publish_v311_ignores_topic_aliases);
+  RUN_TEST(test_alias_table_assigns_up_to_the_broker_maximum);
+  RUN_TEST(test_queue_sets_up_aliases_in_wire_order_and_again_after_reconnect);
+  return UNITY_END();
+}
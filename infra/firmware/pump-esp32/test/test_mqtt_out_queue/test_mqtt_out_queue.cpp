@@ -0,0 +1,536 @@
+#include <unity.h>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "AsyncMqttClient/Packets/Out/Connect.hpp"
+#include "AsyncMqttClient/Packets/Out/Disconn.hpp"
+#include "AsyncMqttClient/Packets/Out/OutPacketPool.hpp"
+#include "AsyncMqttClient/Packets/Out/OutQueue.hpp"
+#include "AsyncMqttClient/Packets/Out/PubAck.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+#include "AsyncMqttClient/Packets/Out/Subscribe.hpp"
+
+using AsyncMqttClientInternals::DisconnOutPacket;
+using AsyncMqttClientInternals::OutPacket;
+using AsyncMqttClientInternals::OutPacketPool;
+using AsyncMqttClientInternals::OutPriority;
+using AsyncMqttClientInternals::OutQueue;
+using AsyncMqttClientInternals::OutTransport;
+using AsyncMqttClientInternals::PubAckOutPacket;
+using AsyncMqttClientInternals::PublishOutPacket;
+using AsyncMqttClientInternals::SubscribeOutPacket;
+
+static const uint8_t PUBLISH = AsyncMqttClientInternals::PacketType.PUBLISH;
+static const uint8_t SUBSCRIBE = AsyncMqttClientInternals::PacketType.SUBSCRIBE;
+
+struct WirePacket
+{
+  uint8_t type;
+  bool dup;
+  uint8_t qos;
+  uint16_t packetId;
+  std::string topic;
+};
+
+/// <summary>
+/// Stands in for AsyncClient: accepts up to `space` bytes per write() and splits
+/// what was written back into packets.
+/// </summary>
+class FakeTransport : public OutTransport
+{
+public:
+  explicit FakeTransport(size_t space = 5744)
+    : space_(space)
+  {
+  }
+
+  size_t space() override
+  {
+    return space_ - pending_;
+  }
+
+  size_t add(const char* data, size_t size) override
+  {
+    bytes_.insert(bytes_.end(), data, data + size);
+    pending_ += size;
+    return size;
+  }
+
+  bool send() override
+  {
+    return true;
+  }
+
+  // The peer acknowledged everything on the wire.
+  void Drain()
+  {
+    pending_ = 0;
+  }
+
+  std::vector<WirePacket> Packets() const
+  {
+    std::vector<WirePacket> packets;
+    size_t at = 0;
+    while (at < bytes_.size())
+    {
+      const uint8_t header = bytes_[at];
+      size_t remaining = 0;
+      size_t multiplier = 1;
+      size_t index = at + 1;
+      uint8_t digit;
+      do
+      {
+        digit = bytes_[index++];
+        remaining += (digit & 0x7F) * multiplier;
+        multiplier *= 128;
+      } while (digit & 0x80);
+
+      WirePacket packet = { static_cast<uint8_t>(header >> 4), (header & 0x08) != 0, static_cast<uint8_t>((header & 0x06) >> 1), 0, "" };
+      if (packet.type == PUBLISH)
+      {
+        const size_t topicLength = (bytes_[index] << 8) | bytes_[index + 1];
+        packet.topic.assign(reinterpret_cast<const char*>(&bytes_[index + 2]), topicLength);
+        if (packet.qos > 0)
+        {
+          packet.packetId = (bytes_[index + 2 + topicLength] << 8) | bytes_[index + 3 + topicLength];
+        }
+      }
+      else if (remaining >= 2)
+      {
+        packet.packetId = (bytes_[index] << 8) | bytes_[index + 1];
+      }
+      packets.push_back(packet);
+      at = index + remaining;
+    }
+    return packets;
+  }
+
+  size_t Count() const
+  {
+    return Packets().size();
+  }
+
+private:
+  size_t space_;
+  size_t pending_ = 0;
+  std::vector<uint8_t> bytes_;
+};
+
+static OutPacket* makePublish(OutPacketPool& pool, uint8_t qos, const char* payload = "{}")
+{
+  const char* topic = "home/WateringController/pump/state";
+  const size_t length = strlen(payload);
+  void* slot = pool.acquire(sizeof(PublishOutPacket) + PublishOutPacket::neededSpace(topic, qos, payload, length), false);
+  return new (slot) PublishOutPacket(topic, qos, false, payload, length, static_cast<uint8_t*>(slot) + sizeof(PublishOutPacket));
+}
+
+static OutPacket* makeRetained(OutPacketPool& pool, const char* topic, const char* payload, OutPriority priority = OutPriority::STATE)
+{
+  const size_t length = strlen(payload);
+  void* slot = pool.acquire(sizeof(PublishOutPacket) + PublishOutPacket::neededSpace(topic, 1, payload, length), false);
+  OutPacket* packet = new (slot) PublishOutPacket(topic, 1, true, payload, length, static_cast<uint8_t*>(slot) + sizeof(PublishOutPacket));
+  packet->priority = priority;
+  return packet;
+}
+
+static OutPacket* makeSubscribe(OutPacketPool& pool)
+{
+  const char* topic = "home/WateringController/pump/cmd";
+  void* slot = pool.acquire(sizeof(SubscribeOutPacket) + SubscribeOutPacket::neededSpace(topic), false);
+  return new (slot) SubscribeOutPacket(topic, 1, static_cast<uint8_t*>(slot) + sizeof(SubscribeOutPacket));
+}
+
+static OutPacket* makeAck(OutPacketPool& pool, uint8_t type, uint8_t flag, uint16_t packetId)
+{
+  AsyncMqttClientInternals::PendingAck pendingAck;
+  pendingAck.packetType = type;
+  pendingAck.headerFlag = flag;
+  pendingAck.packetId = packetId;
+  OutPacket* packet = new (pool.acquire(sizeof(PubAckOutPacket), true)) PubAckOutPacket(pendingAck);
+  packet->priority = OutPriority::ACK;
+  return packet;
+}
+
+static void destroy(OutPacketPool& pool, OutPacket* packet)
+{
+  packet->~OutPacket();
+  pool.release(packet);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_window_of_one_waits_for_each_puback()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport;
+
+  OutPacket* first = makePublish(pool, 1);
+  OutPacket* second = makePublish(pool, 1);
+  const uint16_t firstId = first->packetId();
+  const uint16_t secondId = second->packetId();
+  queue.pushBack(first);
+  queue.pushBack(second);
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(1, transport.Count());
+  TEST_ASSERT_EQUAL_UINT32(1, queue.inFlight());
+
+  TEST_ASSERT_FALSE(queue.acknowledge(PUBLISH, secondId));
+  TEST_ASSERT_TRUE(queue.acknowledge(PUBLISH, firstId));
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(2, transport.Count());
+  TEST_ASSERT_TRUE(queue.acknowledge(PUBLISH, secondId));
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_window_limits_unacknowledged_publishes()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport;
+  queue.setWindow(4);
+
+  std::vector<uint16_t> ids;
+  for (int i = 0; i < 6; i++)
+  {
+    OutPacket* packet = makePublish(pool, 1);
+    ids.push_back(packet->packetId());
+    queue.pushBack(packet);
+  }
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(4, transport.Count());
+  TEST_ASSERT_EQUAL_UINT32(4, queue.inFlight());
+  TEST_ASSERT_EQUAL_UINT32(2, queue.queued());
+
+  // Acknowledgments may arrive out of order; each frees one place in the window.
+  TEST_ASSERT_TRUE(queue.acknowledge(PUBLISH, ids[1]));
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(5, transport.Count());
+  TEST_ASSERT_TRUE(queue.acknowledge(PUBLISH, ids[0]));
+  queue.write(transport);
+
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(6, packets.size());
+  for (size_t i = 0; i < packets.size(); i++)
+  {
+    TEST_ASSERT_EQUAL_UINT16(ids[i], packets[i].packetId);
+    TEST_ASSERT_FALSE(packets[i].dup);
+  }
+  TEST_ASSERT_EQUAL_UINT32(4, queue.inFlightHighWaterMark());
+}
+
+void test_packets_without_ack_follow_in_order_while_publishes_are_in_flight()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(8, 256, 2));
+  OutQueue queue(pool);
+  FakeTransport transport;
+  queue.setWindow(2);
+
+  queue.pushBack(makePublish(pool, 1));
+  queue.pushBack(makePublish(pool, 0));
+  queue.pushBack(makeAck(pool, AsyncMqttClientInternals::PacketType.PUBACK, 0, 7));
+  queue.write(transport);
+
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(3, packets.size());
+  TEST_ASSERT_EQUAL_UINT8(1, packets[0].qos);
+  TEST_ASSERT_EQUAL_UINT8(0, packets[1].qos);
+  TEST_ASSERT_EQUAL_UINT8(AsyncMqttClientInternals::PacketType.PUBACK, packets[2].type);
+  TEST_ASSERT_EQUAL_UINT32(1, queue.inFlight());
+  TEST_ASSERT_EQUAL_UINT32(1, pool.inUse());
+}
+
+void test_subscribe_waits_for_an_empty_window_and_blocks_until_suback()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport;
+  queue.setWindow(4);
+
+  OutPacket* first = makePublish(pool, 1);
+  OutPacket* second = makePublish(pool, 1);
+  OutPacket* subscribe = makeSubscribe(pool);
+  queue.pushBack(first);
+  queue.pushBack(second);
+  queue.pushBack(subscribe);
+  queue.pushBack(makePublish(pool, 1));
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(2, transport.Count());
+
+  queue.acknowledge(PUBLISH, first->packetId());
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(2, transport.Count());
+
+  queue.acknowledge(PUBLISH, second->packetId());
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(3, transport.Count());
+  TEST_ASSERT_EQUAL_UINT8(SUBSCRIBE, transport.Packets()[2].type);
+
+  const uint16_t subscribeId = subscribe->packetId();
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(3, transport.Count());
+  TEST_ASSERT_TRUE(queue.acknowledge(SUBSCRIBE, subscribeId));
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(4, transport.Count());
+}
+
+void test_disconnect_waits_for_in_flight_publishes()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport;
+  queue.setWindow(4);
+
+  OutPacket* publish = makePublish(pool, 1);
+  queue.pushBack(publish);
+  queue.pushBack(new (pool.acquire(sizeof(DisconnOutPacket), true)) DisconnOutPacket);
+  TEST_ASSERT_FALSE(queue.write(transport));
+  TEST_ASSERT_EQUAL_UINT32(1, transport.Count());
+
+  queue.acknowledge(PUBLISH, publish->packetId());
+  TEST_ASSERT_TRUE(queue.write(transport));
+  TEST_ASSERT_EQUAL_UINT8(AsyncMqttClientInternals::PacketType.DISCONNECT, transport.Packets()[1].type);
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_reconnect_resends_in_flight_publishes_with_dup_in_order()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(16, 512, 2));
+  OutQueue queue(pool);
+  FakeTransport transport;
+  queue.setWindow(3);
+
+  std::vector<uint16_t> ids;
+  for (int i = 0; i < 5; i++)
+  {
+    OutPacket* packet = makePublish(pool, 1);
+    ids.push_back(packet->packetId());
+    queue.pushBack(packet);
+  }
+  queue.pushBack(makePublish(pool, 0));
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(3, queue.inFlight());
+
+  // Connection lost: QoS 0 is dropped, the rest is resent behind the new CONNECT.
+  queue.clear(true);
+  TEST_ASSERT_EQUAL_UINT32(0, queue.inFlight());
+  TEST_ASSERT_EQUAL_UINT32(5, queue.queued());
+  TEST_ASSERT_EQUAL_UINT32(5, pool.inUse());
+
+  FakeTransport reconnected;
+  void* slot = pool.acquire(sizeof(AsyncMqttClientInternals::ConnectOutPacket), true);
+  queue.pushFront(new (slot) AsyncMqttClientInternals::ConnectOutPacket(false, nullptr, nullptr, nullptr, false, 0, nullptr, 0, 15, "pump"));
+  queue.write(reconnected);
+  for (size_t i = 0; i < 3; i++)
+  {
+    queue.acknowledge(PUBLISH, ids[i]);
+  }
+  queue.write(reconnected);
+
+  const std::vector<WirePacket> packets = reconnected.Packets();
+  TEST_ASSERT_EQUAL_UINT32(6, packets.size());
+  TEST_ASSERT_EQUAL_UINT8(AsyncMqttClientInternals::PacketType.CONNECT, packets[0].type);
+  for (size_t i = 0; i < 5; i++)
+  {
+    TEST_ASSERT_EQUAL_UINT16(ids[i], packets[i + 1].packetId);
+    TEST_ASSERT_EQUAL(i < 3, packets[i + 1].dup);
+  }
+}
+
+void test_clean_clear_releases_every_slot()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(8, 256, 2));
+  {
+    OutQueue queue(pool);
+    FakeTransport transport;
+    queue.setWindow(2);
+    for (int i = 0; i < 4; i++)
+    {
+      queue.pushBack(makePublish(pool, 1));
+    }
+    queue.pushBack(makeSubscribe(pool));
+    queue.write(transport);
+    TEST_ASSERT_EQUAL_UINT32(5, pool.inUse());
+
+    queue.clear(false);
+    TEST_ASSERT_TRUE(queue.empty());
+    TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+
+    queue.pushBack(makePublish(pool, 1));
+  }
+  // The destructor drops what is left.
+  TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+}
+
+void test_push_front_never_splits_a_partly_written_packet()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport(40);
+
+  std::string payload(60, 'x');
+  OutPacket* publish = makePublish(pool, 0, payload.c_str());
+  queue.pushBack(publish);
+  queue.write(transport);
+  TEST_ASSERT_EQUAL_UINT32(1, queue.queued());
+
+  queue.pushFront(makeAck(pool, AsyncMqttClientInternals::PacketType.PUBREL, AsyncMqttClientInternals::HeaderFlag.PUBREL_RESERVED, 5));
+  while (queue.queued() > 0)
+  {
+    transport.Drain();
+    queue.write(transport);
+  }
+
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(2, packets.size());
+  TEST_ASSERT_EQUAL_UINT8(PUBLISH, packets[0].type);
+  TEST_ASSERT_EQUAL_UINT8(AsyncMqttClientInternals::PacketType.PUBREL, packets[1].type);
+  TEST_ASSERT_EQUAL_UINT32(1, queue.inFlight());
+}
+
+void test_retained_publish_replaces_unsent_one_on_same_topic()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(8, 256, 2));
+  OutQueue queue(pool);
+  FakeTransport transport;
+
+  OutPacket* written = makeRetained(pool, "level", "{\"levelPercent\":10}");
+  const uint16_t writtenId = written->packetId();
+  queue.pushBack(written);
+  queue.write(transport);
+
+  // The written message stays in flight; only unsent ones are replaced.
+  queue.pushBack(makeRetained(pool, "level", "{\"levelPercent\":20}"));
+  queue.pushBack(makeRetained(pool, "pump", "{\"running\":true}"));
+  OutPacket* latest = makeRetained(pool, "level", "{\"levelPercent\":30}");
+  const uint16_t latestId = latest->packetId();
+  TEST_ASSERT_TRUE(queue.pushBack(latest));
+  queue.pushBack(makePublish(pool, 1));
+  queue.pushBack(makePublish(pool, 1));
+  TEST_ASSERT_EQUAL_UINT32(1, queue.coalesced());
+  TEST_ASSERT_EQUAL_UINT32(4, queue.queued());
+  TEST_ASSERT_EQUAL_UINT32(5, pool.inUse());
+
+  queue.setWindow(8);
+  queue.acknowledge(PUBLISH, writtenId);
+  queue.write(transport);
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(5, packets.size());
+  TEST_ASSERT_EQUAL_STRING("level", packets[1].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT16(latestId, packets[1].packetId);
+  TEST_ASSERT_EQUAL_STRING("pump", packets[2].topic.c_str());
+}
+
+void test_priorities_send_state_before_acks_before_diagnostics()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport;
+  queue.setWindow(4);
+
+  queue.pushBack(makeRetained(pool, "diag/loop", "{}", OutPriority::DIAGNOSTIC));
+  queue.pushBack(makeAck(pool, AsyncMqttClientInternals::PacketType.PUBACK, 0, 3));
+  queue.pushBack(makeRetained(pool, "pump/state", "{}"));
+  queue.write(transport);
+
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(3, packets.size());
+  TEST_ASSERT_EQUAL_STRING("pump/state", packets[0].topic.c_str());
+  TEST_ASSERT_EQUAL_UINT8(AsyncMqttClientInternals::PacketType.PUBACK, packets[1].type);
+  TEST_ASSERT_EQUAL_STRING("diag/loop", packets[2].topic.c_str());
+}
+
+void test_only_packets_without_answer_pass_a_waiting_priority()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  FakeTransport transport;
+
+  queue.pushBack(makeRetained(pool, "pump/state", "{}"));
+  queue.pushBack(makeRetained(pool, "level", "{}"));
+  queue.pushBack(makeRetained(pool, "diag/boot", "{}", OutPriority::DIAGNOSTIC));
+  queue.pushBack(makeAck(pool, AsyncMqttClientInternals::PacketType.PUBACK, 0, 3));
+  queue.write(transport);
+
+  // The window is full: the PUBACK goes, the QoS 1 diagnostic waits its turn.
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(2, packets.size());
+  TEST_ASSERT_EQUAL_UINT8(AsyncMqttClientInternals::PacketType.PUBACK, packets[1].type);
+  TEST_ASSERT_EQUAL_UINT32(2, queue.queued());
+}
+
+void test_byte_budget_drops_lower_priority_oldest_first()
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  OutPacket* sample = makeRetained(pool, "diag/a", "0123456789");
+  const size_t size = sample->size();
+  destroy(pool, sample);
+  queue.setByteBudget(3 * size);
+
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "diag/a", "0123456789", OutPriority::DIAGNOSTIC)));
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "diag/b", "0123456789", OutPriority::DIAGNOSTIC)));
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "diag/c", "0123456789", OutPriority::DIAGNOSTIC)));
+  TEST_ASSERT_EQUAL_UINT32(3 * size, queue.queuedBytes());
+
+  // State evicts the oldest diagnostic; a new diagnostic evicts the next oldest.
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "pump/a", "0123456789")));
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "diag/d", "0123456789", OutPriority::DIAGNOSTIC)));
+  TEST_ASSERT_EQUAL_UINT32(2, queue.dropped());
+  TEST_ASSERT_EQUAL_UINT32(3, queue.queued());
+
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "pump/b", "0123456789")));
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "pump/c", "0123456789")));
+  // Only state is left, so a further state packet is refused rather than dropping older state.
+  OutPacket* refused = makeRetained(pool, "pump/d", "0123456789");
+  TEST_ASSERT_FALSE(queue.pushBack(refused));
+  destroy(pool, refused);
+  OutPacket* diagnostic = makeRetained(pool, "diag/e", "0123456789", OutPriority::DIAGNOSTIC);
+  TEST_ASSERT_FALSE(queue.pushBack(diagnostic));
+  destroy(pool, diagnostic);
+  TEST_ASSERT_EQUAL_UINT32(6, queue.dropped());
+  TEST_ASSERT_EQUAL_UINT32(3 * size, queue.queuedBytes());
+
+  // A replacement only needs room for the size difference.
+  TEST_ASSERT_TRUE(queue.pushBack(makeRetained(pool, "pump/b", "9876543210")));
+  TEST_ASSERT_EQUAL_UINT32(1, queue.coalesced());
+  TEST_ASSERT_EQUAL_UINT32(6, queue.dropped());
+
+  FakeTransport transport;
+  queue.setWindow(3);
+  queue.write(transport);
+  const std::vector<WirePacket> packets = transport.Packets();
+  TEST_ASSERT_EQUAL_UINT32(3, packets.size());
+  TEST_ASSERT_EQUAL_STRING("pump/a", packets[0].topic.c_str());
+  TEST_ASSERT_EQUAL_STRING("pump/b", packets[1].topic.c_str());
+  TEST_ASSERT_EQUAL_STRING("pump/c", packets[2].topic.c_str());
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_window_of_one_waits_for_each_puback);
+  RUN_TEST(test_window_limits_unacknowledged_publishes);
+  RUN_TEST(test_packets_without_ack_follow_in_order_while_publishes_are_in_flight);
+  RUN_TEST(test_subscribe_waits_for_an_empty_window_and_blocks_until_suback);
+  RUN_TEST(test_disconnect_waits_for_in_flight_publishes);
+  RUN_TEST(test_reconnect_resends_in_flight_publishes_with_dup_in_order);
+  RUN_TEST(test_clean_clear_releases_every_slot);
+  RUN_TEST(test_push_front_never_splits_a_partly_written_packet);
+  RUN_TEST(test_retained_publish_replaces_unsent_one_on_same_topic);
+  RUN_TEST(test_priorities_send_state_before_acks_before_diagnostics);
+  RUN_TEST(test_only_packets_without_answer_pass_a_waiting_priority);
+  RUN_TEST(test_byte_budget_drops_lower_priority_oldest_first);
+  return UNITY_END();
+}
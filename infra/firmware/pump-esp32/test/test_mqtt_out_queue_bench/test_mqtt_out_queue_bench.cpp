@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+#include "AsyncMqttClient/Packets/Out/OutPacketPool.hpp"
+#include "AsyncMqttClient/Packets/Out/OutQueue.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+
+// Drains a burst of QoS 1 publishes (the pump after a reconnect: state, diagnostics,
+// replayed readings) through the out queue over a simulated link with latency, for
+// several in-flight windows. Run with: pio test -e native -f test_mqtt_out_queue_bench -v
+
+using AsyncMqttClientInternals::OutPacket;
+using AsyncMqttClientInternals::OutPacketPool;
+using AsyncMqttClientInternals::OutQueue;
+using AsyncMqttClientInternals::OutTransport;
+using AsyncMqttClientInternals::PublishOutPacket;
+
+static const char* TOPIC = "a1b2c3d4-0000-0000-0000-000000000000/WateringController/pump/diag/loop";
+static const size_t PAYLOAD_LENGTH = 180;
+static const int BURST = 200;
+// lwIP's default TCP send buffer on the ESP32 Arduino core.
+static const size_t SEND_BUFFER = 5744;
+
+struct Segment
+{
+  uint32_t arrivesAtMs;
+  uint32_t ackedAtMs;
+  size_t size;
+  std::vector<uint8_t> bytes;
+};
+
+struct PubAck
+{
+  uint32_t arrivesAtMs;
+  uint16_t packetId;
+};
+
+/// <summary>
+/// AsyncClient over a link with a fixed round trip: written bytes reach the broker after
+/// half of it and free send buffer space once TCP acknowledges them a full round trip later.
+/// The broker answers every QoS 1 PUBLISH with a PUBACK that takes another half round trip.
+/// </summary>
+class FakeAsyncClient : public OutTransport
+{
+public:
+  explicit FakeAsyncClient(uint32_t rttMs)
+    : rttMs_(rttMs)
+  {
+  }
+
+  size_t space() override
+  {
+    return SEND_BUFFER - buffered_;
+  }
+
+  size_t add(const char* data, size_t size) override
+  {
+    segments_.push_back({ nowMs_ + rttMs_ / 2, nowMs_ + rttMs_, size, std::vector<uint8_t>(data, data + size) });
+    buffered_ += size;
+    return size;
+  }
+
+  bool send() override
+  {
+    return true;
+  }
+
+  /// <summary>
+  /// Advances the clock and returns the PUBACKs that reach the client at this time.
+  /// </summary>
+  std::vector<uint16_t> Advance(uint32_t nowMs)
+  {
+    nowMs_ = nowMs;
+    for (Segment& segment : segments_)
+    {
+      if (!segment.bytes.empty() && segment.arrivesAtMs <= nowMs_)
+      {
+        Receive(segment.bytes);
+        segment.bytes.clear();
+      }
+    }
+    while (!segments_.empty() && segments_.front().bytes.empty() && segments_.front().ackedAtMs <= nowMs_)
+    {
+      buffered_ -= segments_.front().size;
+      segments_.pop_front();
+    }
+
+    std::vector<uint16_t> acks;
+    while (!pubAcks_.empty() && pubAcks_.front().arrivesAtMs <= nowMs_)
+    {
+      acks.push_back(pubAcks_.front().packetId);
+      pubAcks_.pop_front();
+    }
+    return acks;
+  }
+
+  const std::vector<uint16_t>& Received() const
+  {
+    return received_;
+  }
+
+private:
+  void Receive(const std::vector<uint8_t>& bytes)
+  {
+    stream_.insert(stream_.end(), bytes.begin(), bytes.end());
+    for (;;)
+    {
+      if (stream_.size() < 2)
+      {
+        return;
+      }
+      size_t remaining = 0;
+      size_t multiplier = 1;
+      size_t index = 1;
+      uint8_t digit;
+      do
+      {
+        if (index >= stream_.size())
+        {
+          return;
+        }
+        digit = stream_[index++];
+        remaining += (digit & 0x7F) * multiplier;
+        multiplier *= 128;
+      } while (digit & 0x80);
+      if (stream_.size() < index + remaining)
+      {
+        return;
+      }
+
+      const uint8_t header = stream_[0];
+      if ((header >> 4) == AsyncMqttClientInternals::PacketType.PUBLISH && (header & 0x06) == 0x02)
+      {
+        const size_t topicLength = (stream_[index] << 8) | stream_[index + 1];
+        const uint16_t packetId = (stream_[index + 2 + topicLength] << 8) | stream_[index + 3 + topicLength];
+        received_.push_back(packetId);
+        pubAcks_.push_back({ nowMs_ + rttMs_ / 2, packetId });
+      }
+      stream_.erase(stream_.begin(), stream_.begin() + index + remaining);
+    }
+  }
+
+  uint32_t rttMs_;
+  uint32_t nowMs_ = 0;
+  size_t buffered_ = 0;
+  std::deque<Segment> segments_;
+  std::deque<PubAck> pubAcks_;
+  std::vector<uint8_t> stream_;
+  std::vector<uint16_t> received_;
+};
+
+struct BurstResult
+{
+  uint32_t elapsedMs;
+  bool inOrder;
+  size_t maxInFlight;
+};
+
+static BurstResult runBurst(uint8_t window, uint32_t rttMs)
+{
+  OutPacketPool pool;
+  OutQueue queue(pool);
+  queue.setWindow(window);
+  FakeAsyncClient client(rttMs);
+
+  const std::string payload(PAYLOAD_LENGTH, 'x');
+  std::vector<uint16_t> sent;
+  for (int i = 0; i < BURST; i++)
+  {
+    void* slot = pool.acquire(sizeof(PublishOutPacket) + PublishOutPacket::neededSpace(TOPIC, 1, payload.c_str(), payload.size()), false);
+    OutPacket* packet = new (slot) PublishOutPacket(TOPIC, 1, false, payload.c_str(), payload.size(), static_cast<uint8_t*>(slot) + sizeof(PublishOutPacket));
+    sent.push_back(packet->packetId());
+    queue.pushBack(packet);
+  }
+
+  // The client runs _handleQueue on every PUBACK and TCP ack; stepping each millisecond covers both.
+  uint32_t nowMs = 0;
+  queue.write(client);
+  while (!queue.empty())
+  {
+    nowMs++;
+    for (uint16_t packetId : client.Advance(nowMs))
+    {
+      queue.acknowledge(AsyncMqttClientInternals::PacketType.PUBLISH, packetId);
+    }
+    queue.write(client);
+  }
+
+  return { nowMs, client.Received() == sent, queue.inFlightHighWaterMark() };
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_window_throughput_with_latency()
+{
+  const uint32_t rtts[] = { 20, 80 };
+  const uint8_t windows[] = { 1, 2, 4, 8, 16 };
+  for (uint32_t rttMs : rtts)
+  {
+    uint32_t stopAndWaitMs = 0;
+    for (uint8_t window : windows)
+    {
+      const BurstResult result = runBurst(window, rttMs);
+      TEST_ASSERT_TRUE(result.inOrder);
+      TEST_ASSERT_TRUE(result.maxInFlight <= window);
+      if (window == 1)
+      {
+        stopAndWaitMs = result.elapsedMs;
+        // Stop-and-wait: one publish per round trip.
+        TEST_ASSERT_UINT32_WITHIN(rttMs, BURST * rttMs, result.elapsedMs);
+      }
+
+      char line[128];
+      snprintf(line, sizeof(line), "rtt %3u ms  window %2u  %5u ms for %d publishes  %7.1f msg/s  speedup %4.1fx",
+        static_cast<unsigned>(rttMs), static_cast<unsigned>(window), static_cast<unsigned>(result.elapsedMs), BURST,
+        BURST * 1000.0 / result.elapsedMs, static_cast<double>(stopAndWaitMs) / result.elapsedMs);
+      TEST_MESSAGE(line);
+    }
+
+    TEST_ASSERT_TRUE(runBurst(8, rttMs).elapsedMs * 6 <= stopAndWaitMs);
+  }
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_window_throughput_with_latency);
+  return UNITY_END();
+}
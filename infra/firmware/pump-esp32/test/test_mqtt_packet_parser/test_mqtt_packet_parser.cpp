@@ -0,0 +1,389 @@
+#include <unity.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "AsyncMqttClient/Flags.hpp"
+#include "AsyncMqttClient/Packets/PacketParser.hpp"
+
+using AsyncMqttClientInternals::ConnAckProperties;
+using AsyncMqttClientInternals::PacketParser;
+
+static const uint8_t V3_1_1 = AsyncMqttClientInternals::ProtocolVersion.V3_1_1;
+static const uint8_t V5 = AsyncMqttClientInternals::ProtocolVersion.V5;
+
+/// <summary>
+/// Records every callback as one line so streams can be compared across fragmentations.
+/// Payload chunks of one message are joined into a single line.
+/// </summary>
+class RecordingHandler : public AsyncMqttClientInternals::PacketHandler
+{
+public:
+  std::vector<std::string> events;
+  std::string payload;
+  PacketParser* resetOnMessage = nullptr;
+
+  void _onConnAck(bool sessionPresent, uint8_t connectReturnCode, const ConnAckProperties& properties) override
+  {
+    std::string event = "connack " + std::to_string(sessionPresent) + " " + std::to_string(connectReturnCode);
+    if (properties.topicAliasMaximum != 0)
+    {
+      event += " aliases " + std::to_string(properties.topicAliasMaximum);
+    }
+    if (properties.hasServerKeepAlive)
+    {
+      event += " keepalive " + std::to_string(properties.serverKeepAlive);
+    }
+    Add(event);
+  }
+
+  void _onPingResp() override
+  {
+    Add("pingresp");
+  }
+
+  void _onSubAck(uint16_t packetId, char status) override
+  {
+    Add("suback " + std::to_string(packetId) + " " + std::to_string(static_cast<uint8_t>(status)));
+  }
+
+  void _onUnsubAck(uint16_t packetId) override
+  {
+    Add("unsuback " + std::to_string(packetId));
+  }
+
+  void _onMessage(char* topic, char* data, uint8_t qos, bool dup, bool retain, size_t len, size_t index, size_t total, uint16_t packetId) override
+  {
+    if (index == 0)
+    {
+      payload.clear();
+    }
+    if (data != nullptr)
+    {
+      payload.append(data, len);
+    }
+    if (resetOnMessage != nullptr)
+    {
+      Add("message reset");
+      resetOnMessage->reset();
+      return;
+    }
+    if (index + len == total)
+    {
+      Add("message " + std::string(topic) + " q" + std::to_string(qos) + " d" + std::to_string(dup) + " r" + std::to_string(retain) +
+          " id" + std::to_string(packetId) + " " + payload);
+    }
+  }
+
+  void _onPublish(uint16_t packetId, uint8_t qos) override
+  {
+    Add("publish " + std::to_string(packetId) + " q" + std::to_string(qos));
+  }
+
+  void _onPubRel(uint16_t packetId) override
+  {
+    Add("pubrel " + std::to_string(packetId));
+  }
+
+  void _onPubAck(uint16_t packetId) override
+  {
+    Add("puback " + std::to_string(packetId));
+  }
+
+  void _onPubRec(uint16_t packetId) override
+  {
+    Add("pubrec " + std::to_string(packetId));
+  }
+
+  void _onPubComp(uint16_t packetId) override
+  {
+    Add("pubcomp " + std::to_string(packetId));
+  }
+
+  void _onServerDisconnect(uint8_t reasonCode) override
+  {
+    Add("disconnect " + std::to_string(reasonCode));
+  }
+
+  void _onProtocolViolation() override
+  {
+    Add("violation");
+  }
+
+private:
+  void Add(const std::string& event)
+  {
+    events.push_back(event);
+  }
+};
+
+static std::string framed(uint8_t header, const std::string& body)
+{
+  std::string packet;
+  packet += static_cast<char>(header);
+  size_t remaining = body.size();
+  do
+  {
+    uint8_t encoded = remaining % 128;
+    remaining /= 128;
+    packet += static_cast<char>(remaining > 0 ? encoded | 0x80 : encoded);
+  } while (remaining > 0);
+  return packet + body;
+}
+
+// `properties` is the MQTT 5 property list including its length; empty for MQTT 3.1.1.
+static std::string publishPacket(const std::string& topic, uint8_t qos, uint16_t packetId, const std::string& payload, uint8_t flags = 0,
+                                 const std::string& properties = "")
+{
+  std::string body;
+  body += static_cast<char>(topic.size() >> 8);
+  body += static_cast<char>(topic.size() & 0xFF);
+  body += topic;
+  if (qos > 0)
+  {
+    body += static_cast<char>(packetId >> 8);
+    body += static_cast<char>(packetId & 0xFF);
+  }
+  body += properties;
+  body += payload;
+  return framed(static_cast<uint8_t>(0x30 | (qos << 1) | flags), body);
+}
+
+static std::string bytes(std::initializer_list<uint8_t> values)
+{
+  return std::string(values.begin(), values.end());
+}
+
+static std::string sessionStream()
+{
+  return bytes({ 0x20, 0x02, 0x01, 0x00 }) +
+         bytes({ 0x90, 0x03, 0x00, 0x07, 0x01 }) +
+         publishPacket("prefix/WateringController/pump/cmd", 1, 0x1234, "{\"action\":\"start\",\"runSeconds\":30}") +
+         bytes({ 0x40, 0x02, 0x00, 0x08 }) +
+         publishPacket("prefix/WateringController/waterlevel/state", 0, 0, std::string(300, 'x'), 0x01) +
+         bytes({ 0xD0, 0x00 }) +
+         bytes({ 0x50, 0x02, 0x00, 0x09 }) +
+         bytes({ 0x62, 0x02, 0x00, 0x0A }) +
+         bytes({ 0x70, 0x02, 0x00, 0x09 }) +
+         bytes({ 0xB0, 0x02, 0x00, 0x0B });
+}
+
+// The same session over MQTT 5, with properties on every packet that can carry them.
+static std::string sessionStream5()
+{
+  const std::string connAckProperties =
+    bytes({ 0x22, 0x00, 0x0A }) +                          // Topic Alias Maximum
+    bytes({ 0x13, 0x00, 0x3C }) +                          // Server Keep Alive
+    bytes({ 0x21, 0x00, 0x14 }) +                          // Receive Maximum
+    bytes({ 0x27, 0x00, 0x00, 0x10, 0x00 }) +              // Maximum Packet Size
+    bytes({ 0x24, 0x01 }) +                                // Maximum QoS
+    bytes({ 0x12, 0x00, 0x04 }) + "pump" +                 // Assigned Client Identifier
+    bytes({ 0x26, 0x00, 0x01 }) + "k" + bytes({ 0x00, 0x01 }) + "v" +  // User Property
+    bytes({ 0x1F, 0x00, 0x00 });                           // empty Reason String
+  const std::string publishProperties =
+    bytes({ 0x02, 0x00, 0x00, 0x00, 0x78 }) +              // Message Expiry Interval
+    bytes({ 0x0B, 0x81, 0x01 }) +                          // Subscription Identifier
+    bytes({ 0x03, 0x00, 0x10 }) + "application/json";      // Content Type
+
+  return framed(0x20, bytes({ 0x01, 0x00, static_cast<uint8_t>(connAckProperties.size()) }) + connAckProperties) +
+         framed(0x90, bytes({ 0x00, 0x07, 0x03, 0x1F, 0x00, 0x00, 0x01, 0x80 })) +
+         publishPacket("prefix/WateringController/pump/cmd", 1, 0x1234, "{\"action\":\"start\",\"runSeconds\":30}", 0,
+                       static_cast<char>(publishProperties.size()) + publishProperties) +
+         bytes({ 0x40, 0x04, 0x00, 0x08, 0x10, 0x00 }) +
+         publishPacket("prefix/WateringController/waterlevel/state", 0, 0, std::string(300, 'x'), 0x01, bytes({ 0x00 })) +
+         bytes({ 0xD0, 0x00 }) +
+         bytes({ 0x50, 0x02, 0x00, 0x09 }) +
+         bytes({ 0xB0, 0x03, 0x00, 0x0B, 0x00 }) +
+         bytes({ 0xE0, 0x02, 0x8E, 0x00 });
+}
+
+static char topicBuffer[128 + 1];
+
+static std::vector<std::string> parseInChunks(const std::string& stream, const std::vector<size_t>& cuts, uint8_t protocolVersion = V3_1_1)
+{
+  RecordingHandler handler;
+  PacketParser parser(&handler);
+  parser.setTopicBuffer(topicBuffer, 128);
+  parser.setProtocolVersion(protocolVersion);
+  std::string copy = stream;
+  size_t start = 0;
+  for (size_t cut : cuts)
+  {
+    parser.parse(&copy[start], cut - start);
+    start = cut;
+  }
+  parser.parse(&copy[start], copy.size() - start);
+  return handler.events;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_decodes_each_packet_type()
+{
+  const std::vector<std::string> events = parseInChunks(sessionStream(), {});
+  const std::vector<std::string> expected = {
+    "connack 1 0",
+    "suback 7 1",
+    "message prefix/WateringController/pump/cmd q1 d0 r0 id4660 {\"action\":\"start\",\"runSeconds\":30}",
+    "publish 4660 q1",
+    "puback 8",
+    "message prefix/WateringController/waterlevel/state q0 d0 r1 id0 " + std::string(300, 'x'),
+    "publish 0 q0",
+    "pingresp",
+    "pubrec 9",
+    "pubrel 10",
+    "pubcomp 9",
+    "unsuback 11"
+  };
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), events.size());
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), events[i].c_str());
+  }
+}
+
+void test_every_two_way_split_matches()
+{
+  const std::string stream = sessionStream();
+  const std::vector<std::string> whole = parseInChunks(stream, {});
+  for (size_t cut = 1; cut < stream.size(); cut++)
+  {
+    TEST_ASSERT_TRUE(parseInChunks(stream, { cut }) == whole);
+  }
+}
+
+void test_byte_by_byte_matches()
+{
+  const std::string stream = sessionStream();
+  std::vector<size_t> cuts;
+  for (size_t cut = 1; cut < stream.size(); cut++)
+  {
+    cuts.push_back(cut);
+  }
+  TEST_ASSERT_TRUE(parseInChunks(stream, cuts) == parseInChunks(stream, {}));
+}
+
+void test_long_topic_is_skipped_without_ack()
+{
+  const std::string stream = publishPacket(std::string(200, 't'), 1, 5, "payload") + bytes({ 0x40, 0x02, 0x00, 0x06 });
+  const std::vector<std::string> events = parseInChunks(stream, { 10, 150 });
+  TEST_ASSERT_EQUAL_UINT32(1, events.size());
+  TEST_ASSERT_EQUAL_STRING("puback 6", events[0].c_str());
+}
+
+void test_empty_payload_is_delivered()
+{
+  const std::vector<std::string> events = parseInChunks(publishPacket("a/b", 1, 3, ""), {});
+  TEST_ASSERT_EQUAL_UINT32(2, events.size());
+  TEST_ASSERT_EQUAL_STRING("message a/b q1 d0 r0 id3 ", events[0].c_str());
+  TEST_ASSERT_EQUAL_STRING("publish 3 q1", events[1].c_str());
+}
+
+void test_protocol_violations_are_reported()
+{
+  // CONNECT is never sent by a broker.
+  std::vector<std::string> events = parseInChunks(bytes({ 0x10, 0x00, 0x20, 0x02, 0x00, 0x00 }), {});
+  TEST_ASSERT_EQUAL_UINT32(1, events.size());
+  TEST_ASSERT_EQUAL_STRING("violation", events[0].c_str());
+
+  // Remaining length longer than four bytes.
+  events = parseInChunks(bytes({ 0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 }), {});
+  TEST_ASSERT_EQUAL_UINT32(1, events.size());
+  TEST_ASSERT_EQUAL_STRING("violation", events[0].c_str());
+
+  // Topic length past the end of the packet.
+  events = parseInChunks(bytes({ 0x30, 0x03, 0x00, 0x09, 'a' }), {});
+  TEST_ASSERT_EQUAL_UINT32(1, events.size());
+  TEST_ASSERT_EQUAL_STRING("violation", events[0].c_str());
+}
+
+void test_v5_properties_are_read_in_any_fragmentation()
+{
+  const std::string stream = sessionStream5();
+  const std::vector<std::string> events = parseInChunks(stream, {}, V5);
+  const std::vector<std::string> expected = {
+    "connack 1 0 aliases 10 keepalive 60",
+    "suback 7 1",
+    "message prefix/WateringController/pump/cmd q1 d0 r0 id4660 {\"action\":\"start\",\"runSeconds\":30}",
+    "publish 4660 q1",
+    "puback 8",
+    "message prefix/WateringController/waterlevel/state q0 d0 r1 id0 " + std::string(300, 'x'),
+    "publish 0 q0",
+    "pingresp",
+    "pubrec 9",
+    "unsuback 11",
+    "disconnect 142"
+  };
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), events.size());
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), events[i].c_str());
+  }
+
+  std::vector<size_t> everyByte;
+  for (size_t cut = 1; cut < stream.size(); cut++)
+  {
+    TEST_ASSERT_TRUE(parseInChunks(stream, { cut }, V5) == events);
+    everyByte.push_back(cut);
+  }
+  TEST_ASSERT_TRUE(parseInChunks(stream, everyByte, V5) == events);
+}
+
+void test_v5_malformed_properties_are_reported()
+{
+  const std::string malformed[] = {
+    bytes({ 0x20, 0x05, 0x00, 0x00, 0x02, 0x7F, 0x00 }),        // unknown property
+    bytes({ 0x20, 0x03, 0x00, 0x00, 0x05 }),                    // property list past the packet
+    bytes({ 0x20, 0x06, 0x00, 0x00, 0x03, 0x1F, 0x00, 0x05 }),  // string past the property list
+    bytes({ 0x20, 0x05, 0x00, 0x00, 0x02, 0x22, 0x00 }),        // integer past the property list
+    bytes({ 0x90, 0x03, 0x00, 0x07, 0x00 })                     // SUBACK without a reason code
+  };
+  for (const std::string& stream : malformed)
+  {
+    const std::vector<std::string> events = parseInChunks(stream, {}, V5);
+    TEST_ASSERT_EQUAL_UINT32(1, events.size());
+    TEST_ASSERT_EQUAL_STRING("violation", events[0].c_str());
+  }
+
+  // A normal disconnection leaves out the reason code; MQTT 3.1.1 brokers never send DISCONNECT.
+  TEST_ASSERT_EQUAL_STRING("disconnect 0", parseInChunks(bytes({ 0xE0, 0x00 }), {}, V5)[0].c_str());
+  TEST_ASSERT_EQUAL_STRING("violation", parseInChunks(bytes({ 0xE0, 0x00 }), {})[0].c_str());
+}
+
+void test_reset_from_callback_stops_parsing()
+{
+  RecordingHandler handler;
+  PacketParser parser(&handler);
+  parser.setTopicBuffer(topicBuffer, 128);
+  handler.resetOnMessage = &parser;
+
+  std::string stream = publishPacket("a/b", 1, 3, "hello") + bytes({ 0x40, 0x02, 0x00, 0x08 });
+  parser.parse(&stream[0], stream.size());
+  TEST_ASSERT_EQUAL_UINT32(1, handler.events.size());
+  TEST_ASSERT_EQUAL_STRING("message reset", handler.events[0].c_str());
+
+  handler.resetOnMessage = nullptr;
+  std::string next = bytes({ 0x40, 0x02, 0x00, 0x0C });
+  parser.parse(&next[0], next.size());
+  TEST_ASSERT_EQUAL_STRING("puback 12", handler.events.back().c_str());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_decodes_each_packet_type);
+  RUN_TEST(test_every_two_way_split_matches);
+  RUN_TEST(test_byte_by_byte_matches);
+  RUN_TEST(test_long_topic_is_skipped_without_ack);
+  RUN_TEST(test_empty_payload_is_delivered);
+  RUN_TEST(test_protocol_violations_are_reported);
+  RUN_TEST(test_v5_properties_are_read_in_any_fragmentation);
+  RUN_TEST(test_v5_malformed_properties_are_reported);
+  RUN_TEST(test_reset_from_callback_stops_parsing);
+  return UNITY_END();
+}
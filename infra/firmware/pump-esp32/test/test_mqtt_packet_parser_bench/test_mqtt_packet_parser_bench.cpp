@@ -0,0 +1,188 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "AsyncMqttClient/Packets/PacketParser.hpp"
+#include "../counting_allocator.h"
+
+// Feeds a captured broker-to-pump byte stream through the incoming packet parser at
+// different TCP fragmentations. Run with: pio test -e native -f test_mqtt_packet_parser_bench -v
+
+using AsyncMqttClientInternals::PacketParser;
+
+/// <summary>
+/// Counts decoded packets; consumes payload bytes so the work cannot be optimized away.
+/// </summary>
+class CountingHandler : public AsyncMqttClientInternals::PacketHandler
+{
+public:
+  size_t packets = 0;
+  size_t payloadBytes = 0;
+  size_t violations = 0;
+  uint32_t checksum = 0;
+
+  void _onConnAck(bool, uint8_t, const AsyncMqttClientInternals::ConnAckProperties&) override { packets++; }
+  void _onPingResp() override { packets++; }
+  void _onSubAck(uint16_t packetId, char) override { Ack(packetId); }
+  void _onUnsubAck(uint16_t packetId) override { Ack(packetId); }
+  void _onMessage(char* topic, char* payload, uint8_t, bool, bool, size_t len, size_t, size_t, uint16_t) override
+  {
+    checksum += static_cast<uint8_t>(topic[0]);
+    for (size_t i = 0; i < len; i++)
+    {
+      checksum += static_cast<uint8_t>(payload[i]);
+    }
+    payloadBytes += len;
+  }
+  void _onPublish(uint16_t packetId, uint8_t) override { Ack(packetId); }
+  void _onPubRel(uint16_t packetId) override { Ack(packetId); }
+  void _onPubAck(uint16_t packetId) override { Ack(packetId); }
+  void _onPubRec(uint16_t packetId) override { Ack(packetId); }
+  void _onPubComp(uint16_t packetId) override { Ack(packetId); }
+  void _onServerDisconnect(uint8_t) override { packets++; }
+  void _onProtocolViolation() override { violations++; }
+
+private:
+  void Ack(uint16_t packetId)
+  {
+    packets++;
+    checksum += packetId;
+  }
+};
+
+static void appendPublish(std::string& stream, const std::string& topic, uint8_t qos, uint16_t packetId, const std::string& payload, bool retain)
+{
+  const size_t remaining = 2 + topic.size() + (qos > 0 ? 2 : 0) + payload.size();
+  stream += static_cast<char>(0x30 | (qos << 1) | (retain ? 1 : 0));
+  size_t length = remaining;
+  do
+  {
+    const uint8_t encoded = length % 128;
+    length /= 128;
+    stream += static_cast<char>(length > 0 ? encoded | 0x80 : encoded);
+  } while (length > 0);
+  stream += static_cast<char>(topic.size() >> 8);
+  stream += static_cast<char>(topic.size() & 0xFF);
+  stream += topic;
+  if (qos > 0)
+  {
+    stream += static_cast<char>(packetId >> 8);
+    stream += static_cast<char>(packetId & 0xFF);
+  }
+  stream += payload;
+}
+
+/// <summary>
+/// What the pump receives in a busy minute: level updates, commands, acks for its own
+/// state publishes and keepalive responses.
+/// </summary>
+static std::string capturedStream(size_t& packets)
+{
+  static const char* PREFIX = "a1b2c3d4-0000-0000-0000-000000000000/WateringController/";
+  std::string stream;
+  packets = 0;
+  for (uint16_t i = 1; i <= 200; i++)
+  {
+    appendPublish(stream, std::string(PREFIX) + "waterlevel/state", 0, 0,
+                  "{\"levelPercent\":63,\"sensors\":[true,true,false,false],\"measuredAt\":\"2026-01-15T06:55:00Z\","
+                  "\"reportedAt\":\"2026-01-15T06:55:01Z\"}",
+                  true);
+    packets++;
+    if (i % 4 == 0)
+    {
+      appendPublish(stream, std::string(PREFIX) + "pump/cmd", 1, i,
+                    "{\"action\":\"start\",\"runSeconds\":30,\"requestId\":\"0f8fad5b-d9cb-469f-a165-70867728950e\"}", false);
+      packets++;
+    }
+    const char puback[] = { 0x40, 0x02, static_cast<char>(i >> 8), static_cast<char>(i & 0xFF) };
+    stream.append(puback, sizeof(puback));
+    packets++;
+    if (i % 20 == 0)
+    {
+      stream.append("\xD0\x00", 2);
+      packets++;
+    }
+  }
+  return stream;
+}
+
+/// <summary>
+/// Cuts the stream into segments of 1..maxSegment bytes, like TCP reads of varying size.
+/// </summary>
+static std::vector<size_t> fragment(size_t total, size_t maxSegment, uint32_t seed)
+{
+  std::mt19937 random(seed);
+  std::uniform_int_distribution<size_t> length(1, maxSegment);
+  std::vector<size_t> segments;
+  for (size_t position = 0; position < total;)
+  {
+    const size_t segment = std::min(length(random), total - position);
+    segments.push_back(segment);
+    position += segment;
+  }
+  return segments;
+}
+
+static const int ROUNDS = 200;
+static char topicBuffer[128 + 1];
+
+static void runBench(const char* label, std::string& stream, const std::vector<size_t>& segments, size_t expectedPackets)
+{
+  CountingHandler handler;
+  PacketParser parser(&handler);
+  parser.setTopicBuffer(topicBuffer, 128);
+
+  const size_t allocationsBefore = allocationCount;
+  const auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; round++)
+  {
+    size_t position = 0;
+    for (size_t segment : segments)
+    {
+      parser.parse(&stream[position], segment);
+      position += segment;
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const size_t allocations = allocationCount - allocationsBefore;
+
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  char message[160];
+  snprintf(message, sizeof(message), "%-14s %7.1f MB/s %6.2f M packets/s, %zu allocations",
+           label, stream.size() * ROUNDS / seconds / 1e6, expectedPackets * ROUNDS / seconds / 1e6, allocations);
+  TEST_MESSAGE(message);
+
+  TEST_ASSERT_EQUAL_UINT32(0, handler.violations);
+  TEST_ASSERT_EQUAL_UINT32(expectedPackets * ROUNDS, handler.packets);
+  TEST_ASSERT_EQUAL_UINT32(0, allocations);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_throughput_across_fragmentations()
+{
+  size_t packets = 0;
+  std::string stream = capturedStream(packets);
+
+  runBench("whole stream", stream, { stream.size() }, packets);
+  runBench("mss 1460", stream, fragment(stream.size(), 1460, 1), packets);
+  runBench("random 1-64", stream, fragment(stream.size(), 64, 2), packets);
+  runBench("random 1-8", stream, fragment(stream.size(), 8, 3), packets);
+  runBench("byte by byte", stream, std::vector<size_t>(stream.size(), 1), packets);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_throughput_across_fragmentations);
+  return UNITY_END();
+}
@@ -0,0 +1,177 @@
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include "mqtt_payload_parser.h"
+#include "../counting_allocator.h"
+
+static const char* START_CMD =
+  "{\"action\":\"start\",\"runSeconds\":30,\"requestId\":\"0f8fad5b-d9cb-469f-a165-70867728950e\","
+  "\"reason\":\"schedule\",\"issuedAt\":\"2026-01-15T07:00:00Z\"}";
+
+static const char* LEVEL_STATE =
+  "{\"levelPercent\":63,\"sensors\":[true,true,false,false],"
+  "\"measuredAt\":\"2026-01-15T06:55:00Z\",\"reportedAt\":\"2026-01-15T06:55:01Z\"}";
+
+static bool parseCommand(const char* json, size_t chunkSize, PumpCommand& command)
+{
+  PumpCommandParser parser;
+  const size_t total = strlen(json);
+  for (size_t index = 0; index < total; index += chunkSize)
+  {
+    const size_t len = total - index < chunkSize ? total - index : chunkSize;
+    parser.Feed(json + index, len);
+  }
+  return parser.Finish(command);
+}
+
+static bool parseLevel(const char* json, size_t chunkSize, LevelReading& reading)
+{
+  LevelReadingParser parser;
+  const size_t total = strlen(json);
+  for (size_t index = 0; index < total; index += chunkSize)
+  {
+    const size_t len = total - index < chunkSize ? total - index : chunkSize;
+    parser.Feed(json + index, len);
+  }
+  return parser.Finish(reading);
+}
+
+void test_start_command_any_fragmentation()
+{
+  for (size_t chunk = 1; chunk <= strlen(START_CMD); chunk++)
+  {
+    PumpCommand command;
+    TEST_ASSERT_TRUE(parseCommand(START_CMD, chunk, command));
+    TEST_ASSERT_TRUE(command.action == PumpCommandAction::Start);
+    TEST_ASSERT_EQUAL_INT(30, command.runSeconds);
+    TEST_ASSERT_EQUAL_STRING("0f8fad5b-d9cb-469f-a165-70867728950e", command.requestId.CStr());
+  }
+}
+
+void test_stop_command_and_defaults()
+{
+  PumpCommand command;
+  TEST_ASSERT_TRUE(parseCommand("{ \"action\" : \"stop\", \"requestId\": \"abc\" }", 3, command));
+  TEST_ASSERT_TRUE(command.action == PumpCommandAction::Stop);
+  TEST_ASSERT_EQUAL_INT(0, command.runSeconds);
+  TEST_ASSERT_EQUAL_STRING("abc", command.requestId.CStr());
+
+  TEST_ASSERT_TRUE(parseCommand("{}", 1, command));
+  TEST_ASSERT_TRUE(command.action == PumpCommandAction::Start);
+  TEST_ASSERT_EQUAL_INT(0, command.runSeconds);
+  TEST_ASSERT_TRUE(command.requestId.Empty());
+}
+
+void test_command_ignores_nested_and_escaped_values()
+{
+  PumpCommand command;
+  const char* json =
+    "{\"meta\":{\"action\":\"stop\",\"list\":[1,\"]}\",{}]},"
+    "\"note\":\"say \\\"stop\\\" \\u00e9\",\"runSeconds\":-5,\"action\":\"start\"}";
+  TEST_ASSERT_TRUE(parseCommand(json, 2, command));
+  TEST_ASSERT_TRUE(command.action == PumpCommandAction::Start);
+  TEST_ASSERT_EQUAL_INT(-5, command.runSeconds);
+}
+
+void test_command_number_edge_cases()
+{
+  PumpCommand command;
+  TEST_ASSERT_TRUE(parseCommand("{\"runSeconds\":-12}", 1, command));
+  TEST_ASSERT_EQUAL_INT(-12, command.runSeconds);
+
+  TEST_ASSERT_TRUE(parseCommand("{\"runSeconds\":12.9}", 1, command));
+  TEST_ASSERT_EQUAL_INT(0, command.runSeconds);
+
+  TEST_ASSERT_TRUE(parseCommand("{\"runSeconds\":99999999999999}", 4, command));
+  TEST_ASSERT_EQUAL_INT(0, command.runSeconds);
+
+  TEST_ASSERT_TRUE(parseCommand("{\"runSeconds\":\"30\"}", 4, command));
+  TEST_ASSERT_EQUAL_INT(0, command.runSeconds);
+}
+
+void test_issued_at_is_parsed_to_unix_seconds()
+{
+  PumpCommand command;
+  TEST_ASSERT_TRUE(parseCommand(START_CMD, 5, command));
+  TEST_ASSERT_TRUE(command.issuedAtSeconds == 1768460400);
+
+  // System.Text.Json writes DateTimeOffset with a fraction and a numeric offset.
+  TEST_ASSERT_TRUE(parseCommand("{\"issuedAt\":\"2026-01-15T09:00:00.1234567+02:00\"}", 3, command));
+  TEST_ASSERT_TRUE(command.issuedAtSeconds == 1768460400);
+
+  TEST_ASSERT_TRUE(parseCommand("{\"issuedAt\":\"2026-01-15T07:00:00\"}", 3, command));
+  TEST_ASSERT_TRUE(command.issuedAtSeconds == -1);
+  TEST_ASSERT_TRUE(parseCommand("{\"issuedAt\":\"yesterday\"}", 3, command));
+  TEST_ASSERT_TRUE(command.issuedAtSeconds == -1);
+  TEST_ASSERT_TRUE(parseCommand("{\"action\":\"stop\"}", 3, command));
+  TEST_ASSERT_TRUE(command.issuedAtSeconds == -1);
+
+  int64_t seconds = 0;
+  TEST_ASSERT_TRUE(ParseIsoUtcSeconds("1970-01-01T00:00:00Z", seconds));
+  TEST_ASSERT_TRUE(seconds == 0);
+  TEST_ASSERT_TRUE(ParseIsoUtcSeconds("2024-02-29T23:59:59Z", seconds));
+  TEST_ASSERT_TRUE(seconds == 1709251199);
+  TEST_ASSERT_FALSE(ParseIsoUtcSeconds("2026-13-01T00:00:00Z", seconds));
+  TEST_ASSERT_FALSE(ParseIsoUtcSeconds("2026-01-15T07:00:00Zjunk", seconds));
+  TEST_ASSERT_FALSE(ParseIsoUtcSeconds("2026-01-15T07:00:00.Z", seconds));
+}
+
+void test_invalid_payloads_are_rejected()
+{
+  PumpCommand command;
+  TEST_ASSERT_FALSE(parseCommand("", 1, command));
+  TEST_ASSERT_FALSE(parseCommand("{\"action\":\"stop\"", 1, command));
+  TEST_ASSERT_FALSE(parseCommand("{\"action\" \"stop\"}", 1, command));
+  TEST_ASSERT_FALSE(parseCommand("[1,2]", 1, command));
+  TEST_ASSERT_FALSE(parseCommand("{\"a\":1} x", 1, command));
+}
+
+void test_level_reading_any_fragmentation()
+{
+  for (size_t chunk = 1; chunk <= strlen(LEVEL_STATE); chunk++)
+  {
+    LevelReading reading;
+    TEST_ASSERT_TRUE(parseLevel(LEVEL_STATE, chunk, reading));
+    TEST_ASSERT_EQUAL_INT(63, reading.levelPercent);
+  }
+
+  LevelReading reading;
+  TEST_ASSERT_TRUE(parseLevel("{\"sensors\":[]}", 1, reading));
+  TEST_ASSERT_EQUAL_INT(-1, reading.levelPercent);
+}
+
+void test_parsers_do_not_allocate()
+{
+  PumpCommandParser commandParser;
+  LevelReadingParser levelParser;
+  PumpCommand command;
+  LevelReading reading;
+
+  const size_t before = allocationCount;
+  for (int i = 0; i < 100; i++)
+  {
+    commandParser.Reset();
+    commandParser.Feed(START_CMD, 7);
+    commandParser.Feed(START_CMD + 7, strlen(START_CMD) - 7);
+    TEST_ASSERT_TRUE(commandParser.Finish(command));
+
+    levelParser.Reset();
+    levelParser.Feed(LEVEL_STATE, strlen(LEVEL_STATE));
+    TEST_ASSERT_TRUE(levelParser.Finish(reading));
+  }
+  TEST_ASSERT_EQUAL_INT(before, allocationCount);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_start_command_any_fragmentation);
+  RUN_TEST(test_stop_command_and_defaults);
+  RUN_TEST(test_command_ignores_nested_and_escaped_values);
+  RUN_TEST(test_command_number_edge_cases);
+  RUN_TEST(test_issued_at_is_parsed_to_unix_seconds);
+  RUN_TEST(test_invalid_payloads_are_rejected);
+  RUN_TEST(test_level_reading_any_fragmentation);
+  RUN_TEST(test_parsers_do_not_allocate);
+  return UNITY_END();
+}
@@ -0,0 +1,196 @@
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "mqtt_payload_parser.h"
+#include "../counting_allocator.h"
+
+// Compares the streaming parser against the previous reassemble-then-deserialize path.
+// Run with: pio test -e native -f test_mqtt_payload_parser_bench -v
+
+static const char* START_CMD =
+  "{\"action\":\"start\",\"runSeconds\":30,\"requestId\":\"0f8fad5b-d9cb-469f-a165-70867728950e\","
+  "\"reason\":\"schedule\",\"issuedAt\":\"2026-01-15T07:00:00Z\"}";
+
+static const char* LEVEL_STATE =
+  "{\"levelPercent\":63,\"sensors\":[true,true,false,false],"
+  "\"measuredAt\":\"2026-01-15T06:55:00Z\",\"reportedAt\":\"2026-01-15T06:55:01Z\"}";
+
+static const int ITERATIONS = 20000;
+static volatile int sink = 0;
+
+struct BenchResult
+{
+  double nsPerMessage;
+  double allocationsPerMessage;
+};
+
+/// <summary>
+/// Mirrors the old mqttCallback: append chunks into one string, then deserializeJson.
+/// </summary>
+static BenchResult benchArduinoJson(const char* json, size_t chunkSize, bool command)
+{
+  const size_t total = strlen(json);
+  const size_t allocationsBefore = allocationCount;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; i++)
+  {
+    std::string payload;
+    payload.reserve(total);
+    for (size_t index = 0; index < total; index += chunkSize)
+    {
+      const size_t len = total - index < chunkSize ? total - index : chunkSize;
+      payload.append(json + index, len);
+    }
+
+    JsonDocument doc;
+    if (deserializeJson(doc, payload))
+    {
+      continue;
+    }
+
+    if (command)
+    {
+      const char* action = doc["action"] | "start";
+      const char* requestId = doc["requestId"] | "";
+      const int runSeconds = doc["runSeconds"] | 0;
+      const std::string actionCopy(action);
+      const std::string requestIdCopy(requestId);
+      sink = sink + runSeconds + static_cast<int>(actionCopy.size() + requestIdCopy.size());
+    }
+    else
+    {
+      sink = sink + (doc["levelPercent"] | -1);
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return {
+    std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS,
+    static_cast<double>(allocationCount - allocationsBefore) / ITERATIONS
+  };
+}
+
+static BenchResult benchStreaming(const char* json, size_t chunkSize, bool command)
+{
+  PumpCommandParser commandParser;
+  LevelReadingParser levelParser;
+  const size_t total = strlen(json);
+  const size_t allocationsBefore = allocationCount;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; i++)
+  {
+    if (command)
+    {
+      commandParser.Reset();
+    }
+    else
+    {
+      levelParser.Reset();
+    }
+
+    for (size_t index = 0; index < total; index += chunkSize)
+    {
+      const size_t len = total - index < chunkSize ? total - index : chunkSize;
+      if (command)
+      {
+        commandParser.Feed(json + index, len);
+      }
+      else
+      {
+        levelParser.Feed(json + index, len);
+      }
+    }
+
+    if (command)
+    {
+      PumpCommand parsed;
+      if (commandParser.Finish(parsed))
+      {
+        sink = sink + parsed.runSeconds + static_cast<int>(parsed.requestId.Length());
+      }
+    }
+    else
+    {
+      LevelReading parsed;
+      if (levelParser.Finish(parsed))
+      {
+        sink = sink + parsed.levelPercent;
+      }
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return {
+    std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS,
+    static_cast<double>(allocationCount - allocationsBefore) / ITERATIONS
+  };
+}
+
+static void runCase(const char* name, const char* json, bool command)
+{
+  const size_t chunkSizes[] = { strlen(json), 64, 16, 4, 1 };
+  for (size_t chunkSize : chunkSizes)
+  {
+    const BenchResult baseline = benchArduinoJson(json, chunkSize, command);
+    const BenchResult streaming = benchStreaming(json, chunkSize, command);
+    char line[160];
+    snprintf(
+      line,
+      sizeof(line),
+      "%-8s chunk=%3zu  arduinojson %7.0f ns %5.1f allocs | streaming %7.0f ns %5.1f allocs",
+      name,
+      chunkSize,
+      baseline.nsPerMessage,
+      baseline.allocationsPerMessage,
+      streaming.nsPerMessage,
+      streaming.allocationsPerMessage);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_INT(0, static_cast<int>(streaming.allocationsPerMessage * ITERATIONS));
+  }
+}
+
+void test_bench_pump_cmd()
+{
+  runCase("pump/cmd", START_CMD, true);
+}
+
+void test_bench_waterlevel_state()
+{
+  runCase("level", LEVEL_STATE, false);
+}
+
+void test_results_match_arduinojson()
+{
+  const char* commands[] = {
+    START_CMD,
+    "{\"action\":\"stop\",\"requestId\":\"r-1\"}",
+    "{\"runSeconds\":-3,\"meta\":{\"a\":[1,2,{\"b\":\"}\"}]}}",
+    "{\"action\":\"stop\\u0041\",\"runSeconds\":7.5}",
+    "{\"runSeconds\":99999999999}",
+    "{}"
+  };
+  for (const char* json : commands)
+  {
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, json));
+    PumpCommandParser parser;
+    parser.Feed(json, strlen(json));
+    PumpCommand parsed;
+    TEST_ASSERT_TRUE(parser.Finish(parsed));
+
+    const PumpCommandAction expectedAction = ParsePumpCommandAction(doc["action"] | "start");
+    TEST_ASSERT_TRUE(expectedAction == parsed.action);
+    TEST_ASSERT_EQUAL_INT(doc["runSeconds"] | 0, parsed.runSeconds);
+    TEST_ASSERT_EQUAL_STRING(doc["requestId"] | "", parsed.requestId.CStr());
+  }
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_results_match_arduinojson);
+  RUN_TEST(test_bench_pump_cmd);
+  RUN_TEST(test_bench_waterlevel_state);
+  return UNITY_END();
+}
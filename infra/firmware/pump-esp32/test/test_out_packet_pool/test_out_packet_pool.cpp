@@ -0,0 +1,194 @@
+#include <unity.h>
+#include <cstring>
+#include <new>
+#include "AsyncMqttClient/Packets/Out/OutPacketPool.hpp"
+#include "AsyncMqttClient/Packets/Out/PubAck.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+#include "AsyncMqttClient/Packets/Out/Subscribe.hpp"
+
+using AsyncMqttClientInternals::OutPacket;
+using AsyncMqttClientInternals::OutPacketPool;
+using AsyncMqttClientInternals::PublishOutPacket;
+
+static size_t hookLiveBytes = 0;
+static size_t hookCalls = 0;
+
+static void countingHook(size_t bytes, bool allocated)
+{
+  hookCalls++;
+  hookLiveBytes = allocated ? hookLiveBytes + bytes : hookLiveBytes - bytes;
+}
+
+void setUp()
+{
+  hookLiveBytes = 0;
+  hookCalls = 0;
+  OutPacket::setAllocationHook(nullptr);
+}
+
+void tearDown()
+{
+  OutPacket::setAllocationHook(nullptr);
+}
+
+static OutPacket* makePublish(OutPacketPool& pool, const char* topic, const char* payload, OutPacketPool::Result* result)
+{
+  const size_t length = strlen(payload);
+  void* slot = pool.acquire(sizeof(PublishOutPacket) + PublishOutPacket::neededSpace(topic, 1, payload, length), false, result);
+  if (!slot)
+  {
+    return nullptr;
+  }
+  return new (slot) PublishOutPacket(topic, 1, false, payload, length, static_cast<uint8_t*>(slot) + sizeof(PublishOutPacket));
+}
+
+static void destroy(OutPacketPool& pool, OutPacket* packet)
+{
+  packet->~OutPacket();
+  pool.release(packet);
+}
+
+void test_publish_in_slot_encodes_wire_bytes()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(4, 256, 1));
+
+  OutPacketPool::Result result;
+  OutPacket* packet = makePublish(pool, "a/b", "hi", &result);
+  TEST_ASSERT_NOT_NULL(packet);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(OutPacketPool::Result::OK), static_cast<uint8_t>(result));
+  TEST_ASSERT_TRUE(pool.owns(packet));
+
+  // Fixed header, remaining length, topic, packet id, payload.
+  const uint8_t expected[] = { 0x32, 9, 0, 3, 'a', '/', 'b', 0, 0, 'h', 'i' };
+  TEST_ASSERT_EQUAL_UINT32(sizeof(expected), packet->size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, packet->data(), 7);
+  TEST_ASSERT_EQUAL_UINT8(packet->packetId() >> 8, packet->data()[7]);
+  TEST_ASSERT_EQUAL_UINT8(packet->packetId() & 0xFF, packet->data()[8]);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected + 9, packet->data(9), 2);
+
+  destroy(pool, packet);
+  TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+}
+
+void test_reserved_slots_are_kept_for_protocol_packets()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(3, 128, 1));
+
+  OutPacketPool::Result result;
+  OutPacket* first = makePublish(pool, "t", "1", &result);
+  OutPacket* second = makePublish(pool, "t", "2", &result);
+  TEST_ASSERT_NOT_NULL(first);
+  TEST_ASSERT_NOT_NULL(second);
+
+  TEST_ASSERT_NULL(makePublish(pool, "t", "3", &result));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(OutPacketPool::Result::EXHAUSTED), static_cast<uint8_t>(result));
+
+  void* ack = pool.acquire(sizeof(AsyncMqttClientInternals::PubAckOutPacket), true, &result);
+  TEST_ASSERT_NOT_NULL(ack);
+  TEST_ASSERT_NULL(pool.acquire(sizeof(AsyncMqttClientInternals::PubAckOutPacket), true, &result));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(OutPacketPool::Result::EXHAUSTED), static_cast<uint8_t>(result));
+  TEST_ASSERT_EQUAL_UINT32(3, pool.highWaterMark());
+  TEST_ASSERT_EQUAL_UINT32(2, pool.failedAcquires());
+
+  pool.release(ack);
+  destroy(pool, first);
+  TEST_ASSERT_NOT_NULL(first = makePublish(pool, "t", "4", &result));
+  destroy(pool, first);
+  destroy(pool, second);
+  TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+}
+
+void test_oversized_packet_fails_fast()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(2, 64, 0));
+
+  char payload[128];
+  memset(payload, 'x', sizeof(payload) - 1);
+  payload[sizeof(payload) - 1] = '\0';
+  OutPacketPool::Result result;
+  TEST_ASSERT_NULL(makePublish(pool, "t", payload, &result));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(OutPacketPool::Result::TOO_LARGE), static_cast<uint8_t>(result));
+  TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+}
+
+void test_begin_rejects_invalid_or_repeated_sizing()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_FALSE(pool.begin(0, 64, 0));
+  TEST_ASSERT_FALSE(pool.begin(2, 64, 2));
+  TEST_ASSERT_TRUE(pool.begin(2, 60, 1));
+  TEST_ASSERT_EQUAL_UINT32(0, pool.slotSize() % alignof(max_align_t));
+  TEST_ASSERT_TRUE(pool.slotSize() >= 60);
+  TEST_ASSERT_FALSE(pool.begin(4, 64, 1));
+  TEST_ASSERT_EQUAL_UINT32(2, pool.slotCount());
+}
+
+void test_heap_fallback_reports_to_hook()
+{
+  OutPacket::setAllocationHook(countingHook);
+  OutPacketPool pool;
+  TEST_ASSERT_FALSE(pool.pooled());
+
+  OutPacketPool::Result result;
+  OutPacket* packet = makePublish(pool, "heap/topic", "payload", &result);
+  TEST_ASSERT_NOT_NULL(packet);
+  TEST_ASSERT_FALSE(pool.owns(packet));
+  TEST_ASSERT_EQUAL_UINT32(1, hookCalls);
+  TEST_ASSERT_TRUE(hookLiveBytes > sizeof(PublishOutPacket));
+
+  destroy(pool, packet);
+  TEST_ASSERT_EQUAL_UINT32(2, hookCalls);
+  TEST_ASSERT_EQUAL_UINT32(0, hookLiveBytes);
+}
+
+void test_slab_is_reported_once()
+{
+  OutPacket::setAllocationHook(countingHook);
+  {
+    OutPacketPool pool;
+    TEST_ASSERT_TRUE(pool.begin(4, 128, 1));
+    const size_t slabBytes = hookLiveBytes;
+    TEST_ASSERT_TRUE(slabBytes >= 4 * 128);
+
+    for (int i = 0; i < 10; i++)
+    {
+      OutPacketPool::Result result;
+      destroy(pool, makePublish(pool, "t", "x", &result));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, hookCalls);
+    TEST_ASSERT_EQUAL_UINT32(slabBytes, hookLiveBytes);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, hookLiveBytes);
+}
+
+void test_subscribe_in_slot_encodes_wire_bytes()
+{
+  OutPacketPool pool;
+  TEST_ASSERT_TRUE(pool.begin(2, 128, 0));
+
+  const char* topic = "x/y";
+  void* slot = pool.acquire(sizeof(AsyncMqttClientInternals::SubscribeOutPacket) + AsyncMqttClientInternals::SubscribeOutPacket::neededSpace(topic), false);
+  TEST_ASSERT_NOT_NULL(slot);
+  OutPacket* packet = new (slot) AsyncMqttClientInternals::SubscribeOutPacket(topic, 1, static_cast<uint8_t*>(slot) + sizeof(AsyncMqttClientInternals::SubscribeOutPacket));
+  TEST_ASSERT_EQUAL_UINT32(AsyncMqttClientInternals::SubscribeOutPacket::neededSpace(topic), packet->size());
+  TEST_ASSERT_EQUAL_HEX8(0x82, packet->data()[0]);
+  TEST_ASSERT_EQUAL_UINT8(8, packet->data()[1]);
+  TEST_ASSERT_EQUAL_UINT8(1, packet->data(packet->size() - 1)[0]);
+  destroy(pool, packet);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_publish_in_slot_encodes_wire_bytes);
+  RUN_TEST(test_reserved_slots_are_kept_for_protocol_packets);
+  RUN_TEST(test_oversized_packet_fails_fast);
+  RUN_TEST(test_begin_rejects_invalid_or_repeated_sizing);
+  RUN_TEST(test_heap_fallback_reports_to_hook);
+  RUN_TEST(test_slab_is_reported_once);
+  RUN_TEST(test_subscribe_in_slot_encodes_wire_bytes);
+  return UNITY_END();
+}
@@ -0,0 +1,117 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include "AsyncMqttClient/Packets/Out/OutPacketPool.hpp"
+#include "AsyncMqttClient/Packets/Out/PubAck.hpp"
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+#include "../counting_allocator.h"
+
+// Pushes publish/ack cycles through the out packet pool the way AsyncMqttClient does and
+// compares it with the heap path. Run with: pio test -e native -f test_out_packet_pool_bench -v
+
+using AsyncMqttClientInternals::OutPacket;
+using AsyncMqttClientInternals::OutPacketPool;
+using AsyncMqttClientInternals::PubAckOutPacket;
+using AsyncMqttClientInternals::PublishOutPacket;
+
+static const char* TOPIC = "a1b2c3d4-0000-0000-0000-000000000000/WateringController/pump/state";
+static const char* PAYLOAD =
+  "{\"running\":true,\"runSeconds\":30,\"lastRequestId\":\"0f8fad5b-d9cb-469f-a165-70867728950e\","
+  "\"reportedAt\":\"2026-01-15T07:00:00Z\"}";
+
+static const int CYCLES = 1000000;
+static volatile uint32_t sink = 0;
+
+struct BenchResult
+{
+  double nsPerCycle;
+  size_t allocations;
+  uint32_t refused;
+};
+
+/// <summary>
+/// One cycle: queue a QoS 1 publish, queue the PUBACK for an inbound QoS 1 message,
+/// then release both as the client does once they are sent and acknowledged.
+/// </summary>
+static BenchResult runCycles(OutPacketPool& pool)
+{
+  const size_t payloadLength = strlen(PAYLOAD);
+  const size_t publishSize = sizeof(PublishOutPacket) + PublishOutPacket::neededSpace(TOPIC, 1, PAYLOAD, payloadLength);
+  AsyncMqttClientInternals::PendingAck pendingAck;
+  pendingAck.packetType = AsyncMqttClientInternals::PacketType.PUBACK;
+  pendingAck.headerFlag = AsyncMqttClientInternals::HeaderFlag.PUBACK_RESERVED;
+
+  BenchResult result = { 0, 0, 0 };
+  const size_t allocationsBefore = allocationCount;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < CYCLES; i++)
+  {
+    void* publishSlot = pool.acquire(publishSize, false);
+    void* ackSlot = pool.acquire(sizeof(PubAckOutPacket), true);
+    if (!publishSlot || !ackSlot)
+    {
+      result.refused++;
+      pool.release(publishSlot);
+      pool.release(ackSlot);
+      continue;
+    }
+
+    OutPacket* publish = new (publishSlot) PublishOutPacket(TOPIC, 1, false, PAYLOAD, payloadLength,
+                                                            static_cast<uint8_t*>(publishSlot) + sizeof(PublishOutPacket));
+    pendingAck.packetId = static_cast<uint16_t>(i | 1);
+    OutPacket* ack = new (ackSlot) PubAckOutPacket(pendingAck);
+    sink += publish->size() + ack->packetId();
+
+    ack->~OutPacket();
+    pool.release(ack);
+    publish->release();
+    publish->~OutPacket();
+    pool.release(publish);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  result.nsPerCycle = std::chrono::duration<double, std::nano>(elapsed).count() / CYCLES;
+  result.allocations = allocationCount - allocationsBefore;
+  return result;
+}
+
+static void report(const char* label, const BenchResult& result)
+{
+  char message[160];
+  snprintf(message, sizeof(message), "%-6s %8.1f ns/cycle, %zu heap allocations over %d cycles",
+           label, result.nsPerCycle, result.allocations, CYCLES);
+  TEST_MESSAGE(message);
+}
+
+void test_pooled_cycles_do_not_touch_the_heap()
+{
+  OutPacketPool pool;
+  const size_t allocationsBeforeBegin = allocationCount;
+  TEST_ASSERT_TRUE(pool.begin(8, 512, 2));
+  TEST_ASSERT_EQUAL_UINT32(2, allocationCount - allocationsBeforeBegin);
+
+  const BenchResult pooled = runCycles(pool);
+  report("pool", pooled);
+  TEST_ASSERT_EQUAL_UINT32(0, pooled.refused);
+  TEST_ASSERT_EQUAL_UINT32(0, pooled.allocations);
+  TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+  TEST_ASSERT_EQUAL_UINT32(2, pool.highWaterMark());
+}
+
+void test_heap_path_allocates_per_packet()
+{
+  OutPacketPool heap;
+  const BenchResult unpooled = runCycles(heap);
+  report("heap", unpooled);
+  TEST_ASSERT_EQUAL_UINT32(0, unpooled.refused);
+  TEST_ASSERT_EQUAL_UINT32(2 * static_cast<size_t>(CYCLES), unpooled.allocations);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pooled_cycles_do_not_touch_the_heap);
+  RUN_TEST(test_heap_path_allocates_per_packet);
+  return UNITY_END();
+}
@@ -0,0 +1,82 @@
+#include <unity.h>
+#include "publish_ack_tracker.h"
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_ack_commits_the_sent_value()
+{
+  PublishAckTracker tracker(30000);
+  TEST_ASSERT_FALSE(tracker.Pending());
+
+  tracker.Sent(7, 0x3, 1000);
+  TEST_ASSERT_TRUE(tracker.Pending());
+  TEST_ASSERT_EQUAL_UINT32(0x3, tracker.PendingValue());
+
+  PublishAck ack{};
+  TEST_ASSERT_TRUE(tracker.Acked(7, 1042, ack));
+  TEST_ASSERT_EQUAL_UINT32(0x3, ack.value);
+  TEST_ASSERT_EQUAL_UINT32(1000, ack.sentMs);
+  TEST_ASSERT_EQUAL_UINT32(42, ack.latencyMs);
+  TEST_ASSERT_FALSE(tracker.Pending());
+  TEST_ASSERT_EQUAL_UINT32(1, tracker.AckCount());
+  TEST_ASSERT_EQUAL_UINT32(42, tracker.LastLatencyMs());
+
+  // A duplicate ack changes nothing.
+  TEST_ASSERT_FALSE(tracker.Acked(7, 1100, ack));
+  TEST_ASSERT_EQUAL_UINT32(1, tracker.AckCount());
+}
+
+void test_newer_publish_replaces_the_awaited_one()
+{
+  PublishAckTracker tracker(30000);
+  PublishAck ack{};
+  tracker.Sent(7, 0x1, 1000);
+  tracker.Sent(8, 0x3, 1010);
+
+  TEST_ASSERT_FALSE(tracker.Acked(7, 1020, ack));
+  TEST_ASSERT_TRUE(tracker.Pending());
+  TEST_ASSERT_TRUE(tracker.Acked(8, 1030, ack));
+  TEST_ASSERT_EQUAL_UINT32(0x3, ack.value);
+  TEST_ASSERT_EQUAL_UINT32(20, ack.latencyMs);
+}
+
+void test_refused_publish_and_reset_leave_nothing_pending()
+{
+  PublishAckTracker tracker(30000);
+  PublishAck ack{};
+  tracker.Sent(0, 0x1, 1000);
+  TEST_ASSERT_FALSE(tracker.Pending());
+  TEST_ASSERT_FALSE(tracker.Acked(0, 1010, ack));
+
+  tracker.Sent(9, 0x1, 1000);
+  tracker.Reset();
+  TEST_ASSERT_FALSE(tracker.Pending());
+  TEST_ASSERT_FALSE(tracker.Acked(9, 1010, ack));
+}
+
+void test_overdue_after_timeout()
+{
+  PublishAckTracker tracker(30000);
+  TEST_ASSERT_FALSE(tracker.Overdue(100000));
+
+  tracker.Sent(5, 0, 0xFFFFF000u);
+  TEST_ASSERT_FALSE(tracker.Overdue(0xFFFFF000u + 29999));
+  // Across the millis() wrap.
+  TEST_ASSERT_TRUE(tracker.Overdue(0xFFFFF000u + 30000));
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_ack_commits_the_sent_value);
+  RUN_TEST(test_newer_publish_replaces_the_awaited_one);
+  RUN_TEST(test_refused_publish_and_reset_leave_nothing_pending);
+  RUN_TEST(test_overdue_after_timeout);
+  return UNITY_END();
+}
@@ -0,0 +1,133 @@
+#include <unity.h>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "AsyncMqttClient/Packets/Out/Publish.hpp"
+
+using AsyncMqttClientInternals::PublishOutPacket;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static std::string makePayload(size_t length)
+{
+  std::string payload(length, '\0');
+  for (size_t i = 0; i < length; i++)
+  {
+    payload[i] = static_cast<char>('a' + i % 26);
+  }
+  return payload;
+}
+
+static std::vector<uint8_t> bytesOf(const PublishOutPacket& packet)
+{
+  return std::vector<uint8_t>(packet.data(), packet.data() + packet.size());
+}
+
+/// <summary>
+/// Encodes the same publish with the copying constructor and with reserve + commit
+/// (reserving `slack` more payload bytes than used) and checks the wire bytes match.
+/// </summary>
+static void assertEquivalent(const char* topic, uint8_t qos, bool retain, size_t length, size_t slack)
+{
+  const std::string payload = makePayload(length);
+
+  std::vector<uint8_t> copiedBuffer(PublishOutPacket::neededSpace(topic, qos, payload.data(), length));
+  PublishOutPacket copied(topic, qos, retain, payload.data(), length, copiedBuffer.data());
+  std::vector<uint8_t> expected = bytesOf(copied);
+
+  std::vector<uint8_t> reservedBuffer(PublishOutPacket::reservedSpace(topic, qos, length + slack));
+  PublishOutPacket reserved(topic, qos, retain, length + slack, reservedBuffer.data());
+  TEST_ASSERT_EQUAL_UINT32(length + slack, reserved.maxPayloadLength());
+  memcpy(reserved.payload(), payload.data(), length);
+  reserved.commit(length);
+
+  if (qos != 0)
+  {
+    // Each packet takes the next packet id; align them before comparing.
+    const size_t idIndex = expected.size() - length - 2;
+    expected[idIndex] = reserved.packetId() >> 8;
+    expected[idIndex + 1] = reserved.packetId() & 0xFF;
+  }
+
+  const std::vector<uint8_t> actual = bytesOf(reserved);
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected.data(), actual.data(), expected.size());
+}
+
+void test_reserved_publish_matches_copy_for_small_payloads()
+{
+  assertEquivalent("home/WateringController/pump/state", 0, false, 0, 0);
+  assertEquivalent("home/WateringController/pump/state", 1, true, 42, 0);
+  assertEquivalent("home/WateringController/pump/state", 1, false, 42, 17);
+  assertEquivalent("a", 0, true, 1, 3);
+}
+
+void test_reserved_publish_matches_copy_across_length_boundaries()
+{
+  const char* topic = "t";
+  // Remaining length = 2 + topic + (2 for QoS 1) + payload; probe each side of 127/128 and 16383/16384.
+  const size_t overhead1 = 2 + strlen(topic) + 2;
+  const size_t overhead0 = 2 + strlen(topic);
+  const size_t boundaries[] = { 127, 128, 16383, 16384 };
+  for (size_t boundary : boundaries)
+  {
+    assertEquivalent(topic, 1, true, boundary - overhead1, 0);
+    assertEquivalent(topic, 0, false, boundary - overhead0, 0);
+  }
+}
+
+void test_reserved_publish_shrinks_length_bytes_on_commit()
+{
+  // Reserved for three length bytes, committed with one or two.
+  assertEquivalent("home/WateringController/waterlevel/state", 1, true, 10, 20000);
+  assertEquivalent("home/WateringController/waterlevel/state", 1, true, 200, 20000);
+  assertEquivalent("home/WateringController/waterlevel/state", 0, false, 0, 20000);
+}
+
+void test_reserved_publish_dup_sets_flag_at_packet_start()
+{
+  const char* topic = "a/b";
+  std::vector<uint8_t> buffer(PublishOutPacket::reservedSpace(topic, 1, 500));
+  PublishOutPacket packet(topic, 1, false, 500, buffer.data());
+  memcpy(packet.payload(), "hi", 2);
+  packet.commit(2);
+
+  TEST_ASSERT_EQUAL_UINT32(2 + 2 + 3 + 2 + 2, packet.size());
+  TEST_ASSERT_EQUAL_HEX8(0x32, packet.data()[0]);
+  TEST_ASSERT_EQUAL_HEX8(9, packet.data()[1]);
+  TEST_ASSERT_TRUE(packet.data() > buffer.data());
+
+  packet.setDup();
+  TEST_ASSERT_EQUAL_HEX8(0x3A, packet.data()[0]);
+  TEST_ASSERT_EQUAL_HEX8('h', packet.data(packet.size() - 2)[0]);
+}
+
+void test_reserved_publish_clamps_commit_to_reservation()
+{
+  const char* topic = "a/b";
+  std::vector<uint8_t> buffer(PublishOutPacket::reservedSpace(topic, 0, 4));
+  PublishOutPacket packet(topic, 0, false, 4, buffer.data());
+  memcpy(packet.payload(), "abcd", 4);
+  packet.commit(100);
+
+  TEST_ASSERT_EQUAL_UINT32(buffer.size(), packet.size());
+  TEST_ASSERT_EQUAL_HEX8(2 + 3 + 4, packet.data()[1]);
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_reserved_publish_matches_copy_for_small_payloads);
+  RUN_TEST(test_reserved_publish_matches_copy_across_length_boundaries);
+  RUN_TEST(test_reserved_publish_shrinks_length_bytes_on_commit);
+  RUN_TEST(test_reserved_publish_dup_sets_flag_at_packet_start);
+  RUN_TEST(test_reserved_publish_clamps_commit_to_reservation);
+  return UNITY_END();
+}
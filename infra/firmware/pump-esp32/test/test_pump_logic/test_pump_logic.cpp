@@ -0,0 +1,474 @@
+#include <unity.h>
+#include <cstdlib>
+#include <string>
+#include "pump_logic.h"
+#include "../counting_allocator.h"
+
+static void assert_action(PumpDecision::Action expected, PumpDecision::Action actual)
+{
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(expected), static_cast<int>(actual));
+}
+
+void test_start_requires_safe()
+{
+  PumpLogic logic(60000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000);
+  assert_action(PumpDecision::Action::None, decision.action);
+
+  logic.UpdateWaterLevel(50, 1000);
+  decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 2000);
+  assert_action(PumpDecision::Action::Start, decision.action);
+  logic.ApplyDecision(decision, 2000, "2026-02-10T10:00:00Z");
+  TEST_ASSERT_TRUE(logic.State().pumpRunning);
+}
+
+void test_start_blocks_when_stale_or_empty()
+{
+  PumpLogic logic(5000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 7000);
+  assert_action(PumpDecision::Action::None, decision.action);
+
+  logic.UpdateWaterLevel(0, 8000);
+  decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 9000);
+  assert_action(PumpDecision::Action::None, decision.action);
+}
+
+void test_stop_command_always_stops()
+{
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 10, "req", 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+  TEST_ASSERT_TRUE(logic.State().pumpRunning);
+
+  decision = logic.EvaluateCommand(PumpCommandAction::Stop, 0, "req", 2000);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+}
+
+void test_start_held_back_by_the_broker_expires()
+{
+  PumpLogic logic(60000, 0, 120);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000, 0, 120);
+  assert_action(PumpDecision::Action::Start, decision.action);
+
+  decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000, 0, 121);
+  assert_action(PumpDecision::Action::None, decision.action);
+  TEST_ASSERT_EQUAL_STRING("command_expired", PumpDecisionReasonName(decision.reason));
+
+  // An unknown age (no issuedAt, clock not set) is not held against the command.
+  decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000, 0, -1);
+  assert_action(PumpDecision::Action::Start, decision.action);
+
+  decision = logic.EvaluateCommand(PumpCommandAction::Stop, 0, "req", 1000, 0, 86400);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+
+  PumpLogic unlimited(60000);
+  unlimited.UpdateWaterLevel(50, 1000);
+  decision = unlimited.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000, 0, 86400);
+  assert_action(PumpDecision::Action::Start, decision.action);
+}
+
+void test_mqtt_disconnect_stops_when_running()
+{
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 10, "req", 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+
+  decision = logic.OnMqttDisconnected(2000);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+}
+
+void test_tick_stops_after_duration()
+{
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 5, "req", 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+
+  decision = logic.OnTick(4000);
+  assert_action(PumpDecision::Action::None, decision.action);
+
+  decision = logic.OnTick(7000);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+}
+
+void test_tick_stops_with_millisecond_precision()
+{
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 5, "req", 1000, 1500);
+  assert_action(PumpDecision::Action::Start, decision.action);
+  TEST_ASSERT_EQUAL_INT(1500, decision.runMs);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+
+  assert_action(PumpDecision::Action::None, logic.OnTick(2499).action);
+  assert_action(PumpDecision::Action::Stop, logic.OnTick(2500).action);
+  TEST_ASSERT_EQUAL_INT(2500, logic.StopDeadlineMs());
+}
+
+void test_run_seconds_converted_to_ms()
+{
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000);
+  TEST_ASSERT_EQUAL_INT(30000, decision.runMs);
+
+  decision = logic.EvaluateCommand(PumpCommandAction::Start, 0, "req", 1000, -5);
+  assert_action(PumpDecision::Action::None, decision.action);
+}
+
+void test_run_without_deadline_still_stops()
+{
+  // Every accepted start has runMs > 0; a run that somehow had none must still stop.
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000);
+  decision.runMs = 0;
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+  TEST_ASSERT_TRUE(logic.HasStopDeadline());
+  assert_action(PumpDecision::Action::Stop, logic.OnTick(1000).action);
+  assert_action(PumpDecision::Action::Stop, logic.OnMqttDisconnected(1000).action);
+}
+
+void test_water_level_known_and_stale()
+{
+  PumpLogic logic(5000);
+  TEST_ASSERT_FALSE(logic.IsWaterLevelKnown());
+  TEST_ASSERT_TRUE(logic.IsWaterLevelStale(1000));
+
+  logic.UpdateWaterLevel(10, 1000);
+  TEST_ASSERT_TRUE(logic.IsWaterLevelKnown());
+  TEST_ASSERT_FALSE(logic.IsWaterLevelStale(2000));
+  TEST_ASSERT_TRUE(logic.IsWaterLevelStale(7001));
+}
+
+static void assert_reason(PumpDecision::Reason expected, PumpDecision::Reason actual)
+{
+  TEST_ASSERT_EQUAL_STRING(PumpDecisionReasonName(expected), PumpDecisionReasonName(actual));
+}
+
+void test_empty_level_update_stops_running_pump()
+{
+  PumpLogic logic(60000);
+  assert_action(PumpDecision::Action::None, logic.UpdateWaterLevel(0, 500).action);
+
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+
+  assert_action(PumpDecision::Action::None, logic.UpdateWaterLevel(25, 2000).action);
+
+  decision = logic.UpdateWaterLevel(0, 3000);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+  assert_reason(PumpDecision::Reason::WaterLevelEmpty, decision.reason);
+  TEST_ASSERT_EQUAL_STRING("req", decision.requestId.CStr());
+  logic.ApplyDecision(decision, 3000, "");
+  TEST_ASSERT_FALSE(logic.State().pumpRunning);
+  assert_reason(PumpDecision::Reason::WaterLevelEmpty, logic.State().lastStopReason);
+
+  logic.UpdateWaterLevel(50, 4000);
+  decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req-2", 4000);
+  logic.ApplyDecision(decision, 4000, "2026-02-10T10:00:03Z");
+  assert_reason(PumpDecision::Reason::None, logic.State().lastStopReason);
+
+  decision = logic.UpdateWaterLevel(-1, 5000);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+  assert_reason(PumpDecision::Reason::WaterLevelUnknown, decision.reason);
+}
+
+void test_stale_level_stops_at_exact_deadline()
+{
+  PumpLogic logic(5000);
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 60, "req", 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+
+  // The level turns stale 1 ms after the stale window, well before the run ends.
+  TEST_ASSERT_EQUAL_INT(6001, logic.StopDeadlineMs());
+  TEST_ASSERT_EQUAL_INT(5001, logic.MsUntilStop(1000));
+
+  logic.UpdateWaterLevel(40, 4000);
+  TEST_ASSERT_EQUAL_INT(9001, logic.StopDeadlineMs());
+  assert_action(PumpDecision::Action::None, logic.OnTick(9000).action);
+
+  decision = logic.OnTick(9001);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+  assert_reason(PumpDecision::Reason::WaterLevelStale, decision.reason);
+  TEST_ASSERT_EQUAL_INT(0, logic.MsUntilStop(9001));
+}
+
+void test_run_completion_takes_precedence_over_stale()
+{
+  PumpLogic logic(1000);
+  logic.UpdateWaterLevel(50, 0);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 0, "req", 0, 500);
+  logic.ApplyDecision(decision, 0, "2026-02-10T10:00:00Z");
+  TEST_ASSERT_EQUAL_INT(500, logic.StopDeadlineMs());
+
+  decision = logic.OnTick(5000);
+  assert_reason(PumpDecision::Reason::RunCompleted, decision.reason);
+}
+
+void test_decisions_carry_reason_codes()
+{
+  PumpLogic logic(5000);
+  assert_reason(PumpDecision::Reason::WaterLevelUnknown,
+    logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 0).reason);
+
+  logic.UpdateWaterLevel(0, 1000);
+  assert_reason(PumpDecision::Reason::WaterLevelEmpty,
+    logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 1000).reason);
+  assert_reason(PumpDecision::Reason::WaterLevelStale,
+    logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 7000).reason);
+
+  logic.UpdateWaterLevel(50, 8000);
+  assert_reason(PumpDecision::Reason::InvalidDuration,
+    logic.EvaluateCommand(PumpCommandAction::Start, 0, "req", 8000).reason);
+  assert_reason(PumpDecision::Reason::Command,
+    logic.EvaluateCommand(PumpCommandAction::Stop, 0, "req", 8000).reason);
+
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 30, "req", 8000);
+  logic.ApplyDecision(decision, 8000, "2026-02-10T10:00:00Z");
+  assert_reason(PumpDecision::Reason::MqttDisconnected, logic.OnMqttDisconnected(8000).reason);
+  TEST_ASSERT_EQUAL_STRING("water_level_stale", PumpDecisionReasonName(PumpDecision::Reason::WaterLevelStale));
+  TEST_ASSERT_EQUAL_STRING("queue_full", PumpDecisionReasonName(PumpDecision::Reason::QueueFull));
+}
+
+/// <summary>
+/// Random level traces: the pump must stop on the very event that reports empty,
+/// and no later than the stale deadline when readings stop arriving.
+/// </summary>
+void test_interlock_timing_bound_on_random_traces()
+{
+  srand(7);
+  const uint32_t staleMs = 3000;
+  for (int trace = 0; trace < 500; trace++)
+  {
+    PumpLogic logic(staleMs);
+    uint32_t now = static_cast<uint32_t>(rand());
+    logic.UpdateWaterLevel(100, now);
+    auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 0, "req", now, 600000);
+    logic.ApplyDecision(decision, now, "2026-02-10T10:00:00Z");
+
+    uint32_t lastSeen = now;
+    int level = 100;
+    while (logic.State().pumpRunning)
+    {
+      const bool gap = rand() % 10 == 0;
+      const uint32_t nextEventMs = now + (gap ? staleMs + 1 + rand() % 2000 : 100 + rand() % 900);
+
+      // Ticks before the next event happen only on the armed deadline.
+      if (static_cast<int32_t>(nextEventMs - logic.StopDeadlineMs()) > 0)
+      {
+        now = logic.StopDeadlineMs();
+        decision = logic.OnTick(now);
+        assert_action(PumpDecision::Action::Stop, decision.action);
+        assert_reason(PumpDecision::Reason::WaterLevelStale, decision.reason);
+        TEST_ASSERT_EQUAL_INT(lastSeen + staleMs + 1, now);
+        break;
+      }
+
+      now = nextEventMs;
+      level = level - rand() % 30;
+      decision = logic.UpdateWaterLevel(level < 0 ? 0 : level, now);
+      lastSeen = now;
+      if (level <= 0)
+      {
+        assert_action(PumpDecision::Action::Stop, decision.action);
+        assert_reason(PumpDecision::Reason::WaterLevelEmpty, decision.reason);
+        break;
+      }
+      assert_action(PumpDecision::Action::None, decision.action);
+    }
+  }
+}
+
+static void startRun(PumpLogic& logic, int runSeconds, uint32_t nowMs)
+{
+  logic.UpdateWaterLevel(50, nowMs);
+  const PumpDecision decision = logic.EvaluateCommand(PumpCommandAction::Start, runSeconds, "req", nowMs);
+  logic.ApplyDecision(decision, nowMs, "2026-02-10T10:00:00Z");
+}
+
+/// <summary>
+/// Drives a running pump through link drops [downAt[i], upAt[i]) in 100 ms steps the
+/// way loop() does: the disconnect path while the link is down, OnTick while it is up.
+/// Returns when the pump stopped.
+/// </summary>
+static uint32_t runThroughLinkPattern(
+  PumpLogic& logic,
+  const uint32_t* downAt,
+  const uint32_t* upAt,
+  size_t drops,
+  uint32_t fromMs,
+  uint32_t untilMs)
+{
+  size_t drop = 0;
+  bool down = false;
+  for (uint32_t now = fromMs; now <= untilMs; now += 100)
+  {
+    if (!down && drop < drops && now >= downAt[drop])
+    {
+      down = true;
+    }
+    else if (down && now >= upAt[drop])
+    {
+      logic.OnMqttConnected(now);
+      down = false;
+      drop++;
+    }
+
+    const PumpDecision decision = down ? logic.OnMqttDisconnected(now) : logic.OnTick(now);
+    logic.ApplyDecision(decision, now, "");
+    if (!logic.State().pumpRunning)
+    {
+      return now;
+    }
+  }
+  return 0;
+}
+
+void test_ride_through_keeps_run_to_its_deadline()
+{
+  PumpLogic logic(600000, 5000);
+  startRun(logic, 60, 1000);
+
+  const uint32_t downAt[] = { 10000, 25000, 40000 };
+  const uint32_t upAt[] = { 13000, 29000, 44000 };
+  TEST_ASSERT_EQUAL_UINT32(61000, runThroughLinkPattern(logic, downAt, upAt, 3, 1000, 120000));
+  assert_reason(PumpDecision::Reason::RunCompleted, logic.State().lastStopReason);
+  TEST_ASSERT_EQUAL_UINT32(60000, logic.DeliveredMs(90000));
+  TEST_ASSERT_EQUAL_UINT32(11000, logic.State().lastRunOfflineMs);
+}
+
+void test_ride_through_is_capped()
+{
+  PumpLogic logic(600000, 5000);
+  startRun(logic, 60, 1000);
+
+  const uint32_t downAt[] = { 10000, 30000 };
+  const uint32_t upAt[] = { 13000, 45000 };
+  TEST_ASSERT_EQUAL_UINT32(35000, runThroughLinkPattern(logic, downAt, upAt, 2, 1000, 120000));
+  assert_reason(PumpDecision::Reason::MqttDisconnected, logic.State().lastStopReason);
+  TEST_ASSERT_EQUAL_UINT32(34000, logic.DeliveredMs(50000));
+  TEST_ASSERT_EQUAL_UINT32(8000, logic.State().lastRunOfflineMs);
+
+  // The partial run is still reported after the reconnect; a new run starts from zero.
+  logic.OnMqttConnected(45000);
+  TEST_ASSERT_EQUAL_UINT32(34000, logic.DeliveredMs(45000));
+  startRun(logic, 10, 46000);
+  TEST_ASSERT_EQUAL_UINT32(0, logic.State().lastRunOfflineMs);
+  TEST_ASSERT_EQUAL_UINT32(2000, logic.DeliveredMs(48000));
+}
+
+void test_ride_through_deadline_is_the_earliest_stop()
+{
+  PumpLogic logic(600000, 5000);
+  startRun(logic, 60, 1000);
+  TEST_ASSERT_EQUAL_UINT32(61000, logic.StopDeadlineMs());
+
+  assert_action(PumpDecision::Action::None, logic.OnMqttDisconnected(2000).action);
+  TEST_ASSERT_EQUAL_UINT32(7000, logic.StopDeadlineMs());
+  TEST_ASSERT_EQUAL_UINT32(1000, logic.MsUntilStop(6000));
+  assert_action(PumpDecision::Action::None, logic.OnMqttDisconnected(6999).action);
+  assert_action(PumpDecision::Action::Stop, logic.OnTick(7000).action);
+
+  logic.OnMqttConnected(6999);
+  TEST_ASSERT_EQUAL_UINT32(61000, logic.StopDeadlineMs());
+  assert_action(PumpDecision::Action::None, logic.OnTick(7000).action);
+}
+
+void test_ride_through_requires_fresh_safe_level()
+{
+  PumpLogic logic(5000, 60000);
+  startRun(logic, 60, 1000);
+
+  // No readings arrive while the link is down, so the stale window ends the ride-through.
+  assert_action(PumpDecision::Action::None, logic.OnMqttDisconnected(2000).action);
+  TEST_ASSERT_EQUAL_UINT32(6001, logic.StopDeadlineMs());
+  const PumpDecision decision = logic.OnMqttDisconnected(6001);
+  assert_action(PumpDecision::Action::Stop, decision.action);
+  assert_reason(PumpDecision::Reason::WaterLevelStale, decision.reason);
+
+  // A run that was already unsafe when the link dropped is not ridden through.
+  PumpLogic empty(600000, 60000);
+  startRun(empty, 60, 1000);
+  empty.UpdateWaterLevel(0, 1500);
+  assert_reason(PumpDecision::Reason::WaterLevelEmpty, empty.OnMqttDisconnected(2000).reason);
+}
+
+void test_request_id_is_stored_inline()
+{
+  PumpLogic logic(60000);
+  logic.UpdateWaterLevel(50, 1000);
+  const std::string uuid = "0f8fad5b-d9cb-469f-a165-70867728950e";
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 10, uuid, 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+
+  TEST_ASSERT_TRUE(logic.State().lastRequestId.View() == uuid);
+  TEST_ASSERT_EQUAL_STRING("2026-02-10T10:00:00Z", logic.State().pumpStartIso.CStr());
+
+  const std::string tooLong = uuid + "-extra";
+  decision = logic.EvaluateCommand(PumpCommandAction::Stop, 0, tooLong, 2000);
+  TEST_ASSERT_EQUAL_INT(PUMP_REQUEST_ID_MAX_LENGTH, decision.requestId.Length());
+}
+
+void test_parse_command_action()
+{
+  TEST_ASSERT_TRUE(ParsePumpCommandAction("stop") == PumpCommandAction::Stop);
+  TEST_ASSERT_TRUE(ParsePumpCommandAction("start") == PumpCommandAction::Start);
+  TEST_ASSERT_TRUE(ParsePumpCommandAction("") == PumpCommandAction::Start);
+}
+
+void test_tick_and_evaluate_do_not_allocate()
+{
+  PumpLogic logic(60000);
+  const char* uuid = "0f8fad5b-d9cb-469f-a165-70867728950e";
+
+  const size_t before = allocationCount;
+  logic.UpdateWaterLevel(50, 1000);
+  auto decision = logic.EvaluateCommand(PumpCommandAction::Start, 5, uuid, 1000);
+  logic.ApplyDecision(decision, 1000, "2026-02-10T10:00:00Z");
+  for (uint32_t now = 1000; now < 10000; now += 10)
+  {
+    decision = logic.OnTick(now);
+    logic.ApplyDecision(decision, now, "");
+  }
+  decision = logic.EvaluateCommand(PumpCommandAction::Stop, 0, uuid, 10000);
+  logic.ApplyDecision(decision, 10000, "");
+  decision = logic.OnMqttDisconnected(10000);
+
+  TEST_ASSERT_EQUAL_INT(before, allocationCount);
+  TEST_ASSERT_FALSE(logic.State().pumpRunning);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_start_requires_safe);
+  RUN_TEST(test_start_blocks_when_stale_or_empty);
+  RUN_TEST(test_stop_command_always_stops);
+  RUN_TEST(test_start_held_back_by_the_broker_expires);
+  RUN_TEST(test_mqtt_disconnect_stops_when_running);
+  RUN_TEST(test_tick_stops_after_duration);
+  RUN_TEST(test_tick_stops_with_millisecond_precision);
+  RUN_TEST(test_run_seconds_converted_to_ms);
+  RUN_TEST(test_run_without_deadline_still_stops);
+  RUN_TEST(test_water_level_known_and_stale);
+  RUN_TEST(test_empty_level_update_stops_running_pump);
+  RUN_TEST(test_stale_level_stops_at_exact_deadline);
+  RUN_TEST(test_run_completion_takes_precedence_over_stale);
+  RUN_TEST(test_decisions_carry_reason_codes);
+  RUN_TEST(test_interlock_timing_bound_on_random_traces);
+  RUN_TEST(test_ride_through_keeps_run_to_its_deadline);
+  RUN_TEST(test_ride_through_is_capped);
+  RUN_TEST(test_ride_through_deadline_is_the_earliest_stop);
+  RUN_TEST(test_ride_through_requires_fresh_safe_level);
+  RUN_TEST(test_request_id_is_stored_inline);
+  RUN_TEST(test_parse_command_action);
+  RUN_TEST(test_tick_and_evaluate_do_not_allocate);
+  return UNITY_END();
+}
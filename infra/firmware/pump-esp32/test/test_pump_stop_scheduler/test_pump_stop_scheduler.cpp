@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include "pump_stop_scheduler.h"
+
+/// <summary>
+/// Fake one-shot timer driven by a simulated clock.
+/// </summary>
+class FakeTimer : public OneShotTimer
+{
+public:
+  void Arm(uint32_t delayMs) override
+  {
+    armed = true;
+    armCount++;
+    lastDelayMs = delayMs;
+    dueMs = nowMs + delayMs;
+  }
+
+  void Cancel() override
+  {
+    armed = false;
+    cancelCount++;
+  }
+
+  bool FireIfDue()
+  {
+    if (armed && static_cast<int32_t>(nowMs - dueMs) >= 0)
+    {
+      armed = false;
+      return true;
+    }
+    return false;
+  }
+
+  uint32_t nowMs = 0;
+  uint32_t dueMs = 0;
+  uint32_t lastDelayMs = 0;
+  int armCount = 0;
+  int cancelCount = 0;
+  bool armed = false;
+};
+
+static void startPump(PumpLogic& logic, PumpStopScheduler& scheduler, int runMs, uint32_t nowMs)
+{
+  logic.UpdateWaterLevel(50, nowMs);
+  const PumpDecision decision = logic.EvaluateCommand(PumpCommandAction::Start, 0, "req", nowMs, runMs);
+  logic.ApplyDecision(decision, nowMs, "2026-02-10T10:00:00Z");
+  scheduler.Sync(logic, nowMs);
+}
+
+void test_start_arms_timer_with_run_duration()
+{
+  FakeTimer timer;
+  PumpLogic logic(60000);
+  PumpStopScheduler scheduler(timer);
+
+  timer.nowMs = 1000;
+  startPump(logic, scheduler, 1500, 1000);
+  TEST_ASSERT_TRUE(timer.armed);
+  TEST_ASSERT_EQUAL_INT(1500, timer.lastDelayMs);
+
+  scheduler.Sync(logic, 1200);
+  TEST_ASSERT_EQUAL_INT(1, timer.armCount);
+}
+
+void test_stop_cancels_timer()
+{
+  FakeTimer timer;
+  PumpLogic logic(60000);
+  PumpStopScheduler scheduler(timer);
+
+  startPump(logic, scheduler, 5000, 0);
+  const PumpDecision stop = logic.EvaluateCommand(PumpCommandAction::Stop, 0, "req", 100);
+  logic.ApplyDecision(stop, 100, "");
+  scheduler.Sync(logic, 100);
+
+  TEST_ASSERT_FALSE(timer.armed);
+  TEST_ASSERT_EQUAL_INT(1, timer.cancelCount);
+}
+
+void test_restart_rearms_remaining_time()
+{
+  FakeTimer timer;
+  PumpLogic logic(60000);
+  PumpStopScheduler scheduler(timer);
+
+  startPump(logic, scheduler, 5000, 0);
+  timer.nowMs = 2000;
+  startPump(logic, scheduler, 4000, 2000);
+  TEST_ASSERT_EQUAL_INT(2, timer.armCount);
+  TEST_ASSERT_EQUAL_INT(4000, timer.lastDelayMs);
+}
+
+void test_timer_fire_yields_stop_at_exact_deadline()
+{
+  FakeTimer timer;
+  PumpLogic logic(60000);
+  PumpStopScheduler scheduler(timer);
+
+  timer.nowMs = 10;
+  startPump(logic, scheduler, 1234, 10);
+  for (; !timer.FireIfDue(); timer.nowMs++)
+  {
+    TEST_ASSERT_TRUE(logic.OnTick(timer.nowMs).action == PumpDecision::Action::None);
+  }
+
+  TEST_ASSERT_EQUAL_INT(1244, timer.nowMs);
+  const PumpDecision decision = logic.OnTick(timer.nowMs);
+  TEST_ASSERT_TRUE(decision.action == PumpDecision::Action::Stop);
+  scheduler.RecordDeadlineStop(logic.StopDeadlineMs(), timer.nowMs);
+  TEST_ASSERT_EQUAL_INT(0, scheduler.Jitter().maxMs);
+}
+
+void test_timer_armed_for_stale_level()
+{
+  FakeTimer timer;
+  PumpLogic logic(2000);
+  PumpStopScheduler scheduler(timer);
+
+  timer.nowMs = 100;
+  startPump(logic, scheduler, 60000, 100);
+  TEST_ASSERT_EQUAL_INT(2001, timer.lastDelayMs);
+
+  // A fresh reading pushes the stale deadline out and re-arms.
+  timer.nowMs = 1500;
+  logic.UpdateWaterLevel(80, 1500);
+  scheduler.Sync(logic, 1500);
+  TEST_ASSERT_EQUAL_INT(2, timer.armCount);
+  TEST_ASSERT_EQUAL_INT(2001, timer.lastDelayMs);
+
+  while (!timer.FireIfDue())
+  {
+    timer.nowMs++;
+  }
+  TEST_ASSERT_EQUAL_INT(3501, timer.nowMs);
+  const PumpDecision decision = logic.OnTick(timer.nowMs);
+  TEST_ASSERT_TRUE(decision.action == PumpDecision::Action::Stop);
+  TEST_ASSERT_TRUE(decision.reason == PumpDecision::Reason::WaterLevelStale);
+}
+
+void test_wait_is_bounded_by_deadline()
+{
+  FakeTimer timer;
+  PumpLogic logic(60000);
+  PumpStopScheduler scheduler(timer);
+
+  TEST_ASSERT_EQUAL_INT(50, scheduler.WaitMs(logic, 0, 50));
+  startPump(logic, scheduler, 1000, 0);
+  TEST_ASSERT_EQUAL_INT(50, scheduler.WaitMs(logic, 100, 50));
+  TEST_ASSERT_EQUAL_INT(20, scheduler.WaitMs(logic, 980, 50));
+  TEST_ASSERT_EQUAL_INT(0, scheduler.WaitMs(logic, 1005, 50));
+}
+
+void test_deadline_survives_millis_wraparound()
+{
+  FakeTimer timer;
+  PumpLogic logic(60000);
+  PumpStopScheduler scheduler(timer);
+
+  const uint32_t start = 0xFFFFFF00u;
+  startPump(logic, scheduler, 1000, start);
+  TEST_ASSERT_TRUE(logic.OnTick(start + 999).action == PumpDecision::Action::None);
+  TEST_ASSERT_TRUE(logic.OnTick(start + 1000).action == PumpDecision::Action::Stop);
+}
+
+/// <summary>
+/// Stop lateness of the old busy loop (poll OnTick once per iteration, iterations
+/// stretched by stalls) against a timer wake-up followed by OnTick.
+/// </summary>
+void test_stop_jitter_report()
+{
+  const int runs = 2000;
+  srand(42);
+
+  FakeTimer timer;
+  PumpStopScheduler scheduler(timer);
+  PumpStopScheduler pollingRecorder(timer);
+
+  for (int run = 0; run < runs; run++)
+  {
+    const int runMs = 500 + rand() % 60000;
+
+    PumpLogic polled(600000);
+    uint32_t now = static_cast<uint32_t>(rand());
+    startPump(polled, pollingRecorder, runMs, now);
+    const uint32_t deadline = polled.StopDeadlineMs();
+    while (polled.OnTick(now).action != PumpDecision::Action::Stop)
+    {
+      // Typical iteration 1-5 ms; every 20th includes a 50-250 ms stall (handleClient, OTA).
+      now += 1 + rand() % 5;
+      if (rand() % 20 == 0)
+      {
+        now += 50 + rand() % 200;
+      }
+    }
+    pollingRecorder.RecordDeadlineStop(deadline, now);
+
+    PumpLogic timed(600000);
+    timer.nowMs = static_cast<uint32_t>(rand());
+    startPump(timed, scheduler, runMs, timer.nowMs);
+    while (!timer.FireIfDue())
+    {
+      timer.nowMs++;
+    }
+    // Wake-up latency of the notified loop task (0-2 ms).
+    timer.nowMs += rand() % 3;
+    TEST_ASSERT_TRUE(timed.OnTick(timer.nowMs).action == PumpDecision::Action::Stop);
+    scheduler.RecordDeadlineStop(timed.StopDeadlineMs(), timer.nowMs);
+    timed.ApplyDecision(timed.OnTick(timer.nowMs), timer.nowMs, "");
+    scheduler.Sync(timed, timer.nowMs);
+  }
+  const StopJitterStats& polling = pollingRecorder.Jitter();
+  const StopJitterStats& timed = scheduler.Jitter();
+
+  char line[128];
+  snprintf(line, sizeof(line), "polling loop : mean %.1f ms, max %u ms over %u runs",
+    static_cast<double>(polling.totalMs) / polling.count, static_cast<unsigned>(polling.maxMs), static_cast<unsigned>(polling.count));
+  TEST_MESSAGE(line);
+  snprintf(line, sizeof(line), "timer wakeup : mean %.1f ms, max %u ms over %u runs",
+    static_cast<double>(timed.totalMs) / timed.count, static_cast<unsigned>(timed.maxMs), static_cast<unsigned>(timed.count));
+  TEST_MESSAGE(line);
+
+  TEST_ASSERT_LESS_OR_EQUAL(2, timed.maxMs);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_start_arms_timer_with_run_duration);
+  RUN_TEST(test_stop_cancels_timer);
+  RUN_TEST(test_restart_rearms_remaining_time);
+  RUN_TEST(test_timer_fire_yields_stop_at_exact_deadline);
+  RUN_TEST(test_timer_armed_for_stale_level);
+  RUN_TEST(test_wait_is_bounded_by_deadline);
+  RUN_TEST(test_deadline_survives_millis_wraparound);
+  RUN_TEST(test_stop_jitter_report);
+  return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "spsc_ring.h"
+
+void test_push_pop_in_order()
+{
+  SpscRing<int, 4> ring;
+  int value = 0;
+  TEST_ASSERT_FALSE(ring.TryPop(value));
+
+  TEST_ASSERT_TRUE(ring.TryPush(1));
+  TEST_ASSERT_TRUE(ring.TryPush(2));
+  TEST_ASSERT_TRUE(ring.TryPop(value));
+  TEST_ASSERT_EQUAL_INT(1, value);
+  TEST_ASSERT_TRUE(ring.TryPop(value));
+  TEST_ASSERT_EQUAL_INT(2, value);
+  TEST_ASSERT_FALSE(ring.TryPop(value));
+  TEST_ASSERT_EQUAL_INT(0, ring.Size());
+}
+
+void test_full_ring_drops_and_counts()
+{
+  SpscRing<int, 4> ring;
+  for (int i = 0; i < 4; i++)
+  {
+    TEST_ASSERT_TRUE(ring.TryPush(i));
+  }
+  TEST_ASSERT_FALSE(ring.TryPush(99));
+  TEST_ASSERT_EQUAL_INT(1, ring.DroppedCount());
+  TEST_ASSERT_EQUAL_INT(4, ring.HighWaterMark());
+
+  int value = 0;
+  TEST_ASSERT_TRUE(ring.TryPop(value));
+  TEST_ASSERT_EQUAL_INT(0, value);
+  TEST_ASSERT_TRUE(ring.TryPush(4));
+  for (int expected = 1; expected <= 4; expected++)
+  {
+    TEST_ASSERT_TRUE(ring.TryPop(value));
+    TEST_ASSERT_EQUAL_INT(expected, value);
+  }
+}
+
+void test_high_water_mark_tracks_peak()
+{
+  SpscRing<int, 8> ring;
+  int value = 0;
+  ring.TryPush(1);
+  ring.TryPush(2);
+  ring.TryPush(3);
+  ring.TryPop(value);
+  ring.TryPop(value);
+  ring.TryPush(4);
+  TEST_ASSERT_EQUAL_INT(3, ring.HighWaterMark());
+  TEST_ASSERT_EQUAL_INT(2, ring.Size());
+}
+
+struct Sample
+{
+  uint32_t sequence;
+  uint32_t check;
+};
+
+template <size_t Capacity>
+static void runTwoThreadStress(uint32_t count)
+{
+  static SpscRing<Sample, Capacity> ring;
+  std::atomic<bool> failed(false);
+
+  std::thread consumer([&]()
+  {
+    uint32_t expected = 0;
+    Sample sample;
+    while (expected < count && !failed)
+    {
+      if (!ring.TryPop(sample))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      if (sample.sequence != expected || sample.check != ~expected)
+      {
+        failed = true;
+        return;
+      }
+      expected++;
+    }
+  });
+
+  uint32_t rejected = 0;
+  for (uint32_t i = 0; i < count && !failed; i++)
+  {
+    while (!ring.TryPush({ i, ~i }) && !failed)
+    {
+      rejected++;
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+
+  TEST_ASSERT_FALSE(failed.load());
+  TEST_ASSERT_EQUAL_INT(0, ring.Size());
+  TEST_ASSERT_EQUAL_INT(rejected, ring.DroppedCount());
+  TEST_ASSERT_LESS_OR_EQUAL(Capacity, ring.HighWaterMark());
+  TEST_ASSERT_GREATER_OR_EQUAL(1, ring.HighWaterMark());
+}
+
+void test_two_thread_stress_small_ring()
+{
+  runTwoThreadStress<4>(20000);
+}
+
+void test_two_thread_stress_large_ring()
+{
+  runTwoThreadStress<1024>(1000000);
+}
+
+int main(int argc, char** argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_push_pop_in_order);
+  RUN_TEST(test_full_ring_drops_and_counts);
+  RUN_TEST(test_high_water_mark_tracks_peak);
+  RUN_TEST(test_two_thread_stress_small_ring);
+  RUN_TEST(test_two_thread_stress_large_ring);
+  return UNITY_END();
+}
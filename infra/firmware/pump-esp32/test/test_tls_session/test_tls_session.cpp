@@ -0,0 +1,173 @@
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "AsyncMqttClient/Tls/TlsSession.hpp"
+#include "AsyncMqttClient/Tls/TlsStats.hpp"
+
+using AsyncMqttClientInternals::TlsHandshakeMeter;
+using AsyncMqttClientInternals::TlsHandshakeStats;
+using AsyncMqttClientInternals::TlsSessionCache;
+using AsyncMqttClientInternals::TlsSessionRecord;
+
+static TlsSessionRecord record;
+
+void setUp()
+{
+  // RTC memory after a power-on: whatever was there.
+  memset(&record, 0xA5, sizeof(record));
+}
+
+void tearDown()
+{
+}
+
+static void save(TlsSessionCache& cache, const char* host, uint16_t port, const std::vector<uint8_t>& session)
+{
+  size_t capacity = 0;
+  uint8_t* storage = cache.storage(&capacity);
+  TEST_ASSERT_NOT_NULL(storage);
+  TEST_ASSERT_TRUE(capacity >= session.size());
+  memcpy(storage, session.data(), session.size());
+  cache.commit(host, port, session.size());
+}
+
+void test_session_is_found_only_for_the_server_it_was_saved_for()
+{
+  TlsSessionCache cache;
+  cache.attach(&record);
+  size_t length = 0;
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+
+  const std::vector<uint8_t> session(300, 0x42);
+  save(cache, "broker.lan", 8883, session);
+  const uint8_t* found = cache.find("broker.lan", 8883, &length);
+  TEST_ASSERT_NOT_NULL(found);
+  TEST_ASSERT_EQUAL_UINT32(session.size(), length);
+  TEST_ASSERT_EQUAL_MEMORY(session.data(), found, length);
+
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8884, &length));
+  TEST_ASSERT_NULL(cache.find("other.lan", 8883, &length));
+
+  // The record itself is the cache: a new cache on it after a reset or deep sleep finds it.
+  TlsSessionCache afterWake;
+  afterWake.attach(&record);
+  TEST_ASSERT_NOT_NULL(afterWake.find("broker.lan", 8883, &length));
+}
+
+void test_damaged_or_unfinished_records_are_not_offered()
+{
+  TlsSessionCache cache;
+  cache.attach(&record);
+  size_t length = 0;
+  save(cache, "broker.lan", 8883, std::vector<uint8_t>(200, 0x17));
+
+  record.data[57] ^= 0x01;
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+
+  // Reset while a new session was being written: storage() has already invalidated it.
+  save(cache, "broker.lan", 8883, std::vector<uint8_t>(200, 0x17));
+  size_t capacity = 0;
+  cache.storage(&capacity);
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+
+  save(cache, "broker.lan", 8883, std::vector<uint8_t>(200, 0x17));
+  record.length = TlsSessionRecord::MAX_BYTES + 1;
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+
+  save(cache, "broker.lan", 8883, std::vector<uint8_t>(200, 0x17));
+  cache.invalidate();
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+}
+
+void test_cache_without_a_record_keeps_nothing()
+{
+  TlsSessionCache cache;
+  TEST_ASSERT_FALSE(cache.attached());
+  size_t capacity = 0;
+  size_t length = 0;
+  TEST_ASSERT_NULL(cache.storage(&capacity));
+  cache.commit("broker.lan", 8883, 10);
+  cache.invalidate();
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+
+  cache.attach(&record);
+  TEST_ASSERT_TRUE(cache.attached());
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+  // Lengths outside the record are never committed.
+  cache.storage(&capacity);
+  cache.commit("broker.lan", 8883, 0);
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+  cache.commit("broker.lan", 8883, TlsSessionRecord::MAX_BYTES + 1);
+  TEST_ASSERT_NULL(cache.find("broker.lan", 8883, &length));
+}
+
+void test_meter_separates_full_and_resumed_handshakes()
+{
+  TlsHandshakeMeter meter;
+  meter.setContextHeap(21000);
+
+  meter.start(1000, 150000);
+  TEST_ASSERT_TRUE(meter.running());
+  meter.sample(140000);
+  meter.sample(118000);  // certificate parsed, ECDHE done
+  meter.sample(146000);
+  meter.succeed(3400, false);
+  TEST_ASSERT_FALSE(meter.running());
+
+  meter.start(10000, 150000);
+  meter.sample(147500);
+  meter.succeed(10180, true);
+
+  meter.start(20000, 150000);
+  meter.sample(149000);
+  meter.succeed(20220, true);
+
+  const TlsHandshakeStats& stats = meter.stats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.full);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.resumed);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.failed);
+  TEST_ASSERT_EQUAL_UINT32(220, stats.lastMs);
+  TEST_ASSERT_TRUE(stats.lastResumed);
+  TEST_ASSERT_EQUAL_UINT32(1000, stats.lastHeapBytes);
+  TEST_ASSERT_EQUAL_UINT32(32000, stats.maxHeapBytes);
+  TEST_ASSERT_EQUAL_UINT32(2400, stats.maxFullMs);
+  TEST_ASSERT_EQUAL_UINT32(220, stats.maxResumedMs);
+  TEST_ASSERT_EQUAL_UINT64(2400, stats.totalFullMs);
+  TEST_ASSERT_EQUAL_UINT64(400, stats.totalResumedMs);
+  TEST_ASSERT_EQUAL_UINT32(21000, stats.contextHeapBytes);
+}
+
+void test_meter_counts_failures_and_ignores_samples_between_handshakes()
+{
+  TlsHandshakeMeter meter;
+  meter.sample(1000);
+  meter.succeed(50, true);  // nothing was started
+  TEST_ASSERT_EQUAL_UINT32(0, meter.stats().resumed);
+
+  meter.start(100, 90000);
+  meter.sample(80000);
+  meter.fail(-0x2700);
+  TEST_ASSERT_FALSE(meter.running());
+  TEST_ASSERT_EQUAL_UINT32(1, meter.stats().failed);
+  TEST_ASSERT_EQUAL_INT(-0x2700, meter.stats().lastError);
+  TEST_ASSERT_EQUAL_UINT32(0, meter.stats().maxHeapBytes);
+
+  // Heap that comes back during a handshake does not count as taken.
+  meter.start(200, 90000);
+  meter.sample(95000);
+  meter.succeed(260, false);
+  TEST_ASSERT_EQUAL_UINT32(0, meter.stats().lastHeapBytes);
+  TEST_ASSERT_EQUAL_UINT32(60, meter.stats().lastMs);
+  TEST_ASSERT_EQUAL_UINT32(1, meter.stats().full);
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_session_is_found_only_for_the_server_it_was_saved_for);
+  RUN_TEST(test_damaged_or_unfinished_records_are_not_offered);
+  RUN_TEST(test_cache_without_a_record_keeps_nothing);
+  RUN_TEST(test_meter_separates_full_and_resumed_handshakes);
+  RUN_TEST(test_meter_counts_failures_and_ignores_samples_between_handshakes);
+  return UNITY_END();
+}
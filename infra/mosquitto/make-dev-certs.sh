@@ -0,0 +1,34 @@
+#!/bin/sh
+# Creates a throwaway CA and a broker certificate for the local TLS listener.
+# Usage: make-dev-certs.sh [host name or IP the nodes use as MQTT_HOST]...
+# The firmware checks the certificate against MQTT_HOST, so list every name it may use.
+set -eu
+
+dir="$(cd "$(dirname "$0")" && pwd)/certs"
+mkdir -p "$dir"
+cd "$dir"
+
+san="DNS:localhost,IP:127.0.0.1"
+for host in "$@"; do
+  case "$host" in
+    *[!0-9.]*) san="$san,DNS:$host" ;;
+    *) san="$san,IP:$host" ;;
+  esac
+done
+
+if [ ! -f ca.key ]; then
+  # EC keys keep the full handshake on the ESP32 short.
+  openssl ecparam -name prime256v1 -genkey -noout -out ca.key
+  openssl req -x509 -new -key ca.key -sha256 -days 3650 -subj "/CN=WateringController dev CA" -out ca.crt
+fi
+
+openssl ecparam -name prime256v1 -genkey -noout -out server.key
+openssl req -new -key server.key -subj "/CN=${1:-localhost}" -out server.csr
+printf "subjectAltName=%s\nextendedKeyUsage=serverAuth\n" "$san" > server.ext
+openssl x509 -req -in server.csr -CA ca.crt -CAkey ca.key -CAcreateserial -sha256 -days 825 -extfile server.ext -out server.crt
+rm -f server.csr server.ext
+# The broker runs as the mosquitto user inside the container.
+chmod 644 server.key
+
+echo "Broker certificate for: $san"
+echo "Paste certs/ca.crt into MQTT_TLS_CA_CERT (include/config.h) as R\"(...)\"."
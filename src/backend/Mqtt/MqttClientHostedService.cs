@@ -3,6 +3,7 @@ using Microsoft.Extensions.Logging;
 using Microsoft.Extensions.Options;
 using MQTTnet;
 using MQTTnet.Client;
+using MQTTnet.Formatter;
 
 namespace WateringController.Backend.Mqtt;
 
@@ -44,6 +45,8 @@ public sealed class MqttClientHostedService : BackgroundService, IMqttPublisher
 
     public bool IsConnected => _client.IsConnected;
 
+    private bool UseMqtt5 => _options.ProtocolVersion == 5;
+
     /// <summary>
     /// Publishes a message if connected, otherwise logs and drops the message.
     /// </summary>
@@ -55,12 +58,19 @@ public sealed class MqttClientHostedService : BackgroundService, IMqttPublisher
             return;
         }
 
-        var message = new MqttApplicationMessageBuilder()
+        var builder = new MqttApplicationMessageBuilder()
             .WithTopic(topic)
             .WithPayload(payload)
             .WithQualityOfServiceLevel(MQTTnet.Protocol.MqttQualityOfServiceLevel.AtLeastOnce)
-            .WithRetainFlag(retain)
-            .Build();
+            .WithRetainFlag(retain);
+
+        // A command the pump only receives after an outage must not start it late.
+        if (UseMqtt5 && topic == _topics.PumpCommand && _options.PumpCommandExpirySeconds > 0)
+        {
+            builder = builder.WithMessageExpiryInterval(_options.PumpCommandExpirySeconds);
+        }
+
+        var message = builder.Build();
 
         await _client.PublishAsync(message, cancellationToken);
     }
@@ -156,7 +166,8 @@ public sealed class MqttClientHostedService : BackgroundService, IMqttPublisher
             var builder = new MqttClientOptionsBuilder()
                 .WithTcpServer(_options.Host, _options.Port)
                 .WithKeepAlivePeriod(TimeSpan.FromSeconds(_options.KeepAliveSeconds))
-                .WithClientId(_options.ClientId ?? $"watering-backend-{Guid.NewGuid():N}");
+                .WithClientId(_options.ClientId ?? $"watering-backend-{Guid.NewGuid():N}")
+                .WithProtocolVersion(UseMqtt5 ? MqttProtocolVersion.V500 : MqttProtocolVersion.V311);
 
             if (!string.IsNullOrWhiteSpace(_options.Username))
             {
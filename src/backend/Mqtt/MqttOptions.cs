@@ -16,4 +16,14 @@ public sealed class MqttOptions
     public int KeepAliveSeconds { get; init; } = 30;
     public int ReconnectSeconds { get; init; } = 5;
     public string TopicPrefix { get; init; } = "home/veranda";
+
+    /// <summary>
+    /// 5 for MQTT 5, 4 for MQTT 3.1.1.
+    /// </summary>
+    public int ProtocolVersion { get; init; } = 4;
+
+    /// <summary>
+    /// With MQTT 5 the broker drops a pump command not delivered within this many seconds (0 = never).
+    /// </summary>
+    public uint PumpCommandExpirySeconds { get; init; } = 120;
 }